@@ -13,6 +13,8 @@
 #include <chrono>
 #include <mutex>
 #include <algorithm>
+#include <string_view>
+#include <memory_resource>
 
 // Platform-specific socket headers
 #ifdef _WIN32
@@ -47,6 +49,7 @@ namespace AppConstants {
     constexpr int DEFAULT_PORT = 8080;
     constexpr int MAX_PENDING_CONNECTIONS = 10;
     constexpr const char* MESSAGE_DELIMITER = "\n";
+    constexpr uint16_t PROTOCOL_VERSION = 1;      // wire format revision; part of cached replies' keys
 }
 
 // User roles
@@ -129,6 +132,25 @@ namespace Utils {
         }
         return tokens;
     }
+
+    // Non-allocating trim: a view into str
+    inline std::string_view trimView(std::string_view str) {
+        size_t first = str.find_first_not_of(" \t\n\r");
+        if (first == std::string_view::npos) return std::string_view();
+        size_t last = str.find_last_not_of(" \t\n\r");
+        return str.substr(first, last - first + 1);
+    }
+
+    // Split into views of str; parts takes its memory from whatever resource it was built with
+    inline void splitView(std::string_view str, char delimiter, std::pmr::vector<std::string_view>& parts) {
+        parts.clear();
+        if (str.empty()) return;
+        size_t start = 0;
+        for (size_t pos; (pos = str.find(delimiter, start)) != std::string_view::npos; start = pos + 1) {
+            parts.push_back(str.substr(start, pos - start));
+        }
+        if (start < str.size()) parts.push_back(str.substr(start));   // like split, no empty last field
+    }
 }
 
 #endif // COMMON_HPP
@@ -2,81 +2,107 @@
 #define MESSAGE_STRUCTS_HPP
 
 #include "common.hpp"
+#include <charconv>
+
+// Every message type: X(name, code, direction, reply). The code's high byte is its category
+// (0x01xx-0x09xx); reply is the type the server normally answers a request with, UNKNOWN for
+// anything that is not a request. The enum and the metadata table in
+// src/protocol/MessageTypeInfo.hpp are both generated from this list, so they cannot drift.
+#define MESSAGE_TYPE_LIST(X) \
+    /* Authentication and account management (0x01xx) */ \
+    X(REGISTER_REQUEST,             0x0101, REQUEST,  REGISTER_SUCCESS) \
+    X(REGISTER_SUCCESS,             0x0102, RESPONSE, UNKNOWN) \
+    X(REGISTER_FAILED,              0x0103, RESPONSE, UNKNOWN) \
+    X(LOGIN_REQUEST,                0x0111, REQUEST,  LOGIN_SUCCESS) \
+    X(LOGIN_SUCCESS,                0x0112, RESPONSE, UNKNOWN) \
+    X(LOGIN_FAILED,                 0x0113, RESPONSE, UNKNOWN) \
+    X(LOGOUT_REQUEST,               0x0121, REQUEST,  LOGOUT_SUCCESS) \
+    X(LOGOUT_SUCCESS,               0x0122, RESPONSE, UNKNOWN) \
+    /* Reconnect with the token from LOGIN_SUCCESS instead of a password */ \
+    X(RESUME_REQUEST,               0x0131, REQUEST,  RESUME_SUCCESS) \
+    X(RESUME_SUCCESS,               0x0132, RESPONSE, UNKNOWN) \
+    X(RESUME_FAILED,                0x0133, RESPONSE, UNKNOWN) \
+    /* Study setup (0x02xx) */ \
+    X(SET_LEVEL_REQUEST,            0x0201, REQUEST,  SET_LEVEL_SUCCESS) \
+    X(SET_LEVEL_SUCCESS,            0x0202, RESPONSE, UNKNOWN) \
+    X(SET_LEVEL_FAILED,             0x0203, RESPONSE, UNKNOWN) \
+    /* Content access (0x03xx) */ \
+    X(GET_LESSON_LIST_REQUEST,      0x0301, REQUEST,  GET_LESSON_LIST_RESPONSE) \
+    X(GET_LESSON_LIST_RESPONSE,     0x0302, RESPONSE, UNKNOWN) \
+    X(GET_LESSON_CONTENT_REQUEST,   0x0311, REQUEST,  GET_LESSON_CONTENT_RESPONSE) \
+    X(GET_LESSON_CONTENT_RESPONSE,  0x0312, RESPONSE, UNKNOWN) \
+    X(SEARCH_REQUEST,               0x0321, REQUEST,  SEARCH_RESPONSE) \
+    X(SEARCH_RESPONSE,              0x0322, RESPONSE, UNKNOWN) \
+    X(AUTOCOMPLETE_REQUEST,         0x0331, REQUEST,  AUTOCOMPLETE_RESPONSE) \
+    X(AUTOCOMPLETE_RESPONSE,        0x0332, RESPONSE, UNKNOWN) \
+    X(LOOKUP_WORD_REQUEST,          0x0341, REQUEST,  LOOKUP_WORD_RESPONSE) \
+    X(LOOKUP_WORD_RESPONSE,         0x0342, RESPONSE, UNKNOWN) \
+    /* Exercises and tests (0x04xx) */ \
+    X(SUBMIT_QUIZ_REQUEST,          0x0401, REQUEST,  SUBMIT_QUIZ_RESPONSE) \
+    X(SUBMIT_QUIZ_RESPONSE,         0x0402, RESPONSE, UNKNOWN) \
+    X(SUBMIT_EXERCISE_REQUEST,      0x0411, REQUEST,  SUBMIT_EXERCISE_RESPONSE) \
+    X(SUBMIT_EXERCISE_RESPONSE,     0x0412, RESPONSE, UNKNOWN) \
+    /* Streamed pronunciation: chunks are Base64 16-bit little-endian mono PCM */ \
+    X(PRONUNCIATION_START_REQUEST,  0x0421, REQUEST,  PRONUNCIATION_START_RESPONSE) \
+    X(PRONUNCIATION_START_RESPONSE, 0x0422, RESPONSE, UNKNOWN) \
+    X(PRONUNCIATION_CHUNK,          0x0423, REQUEST,  PRONUNCIATION_CHUNK_ACK) \
+    X(PRONUNCIATION_CHUNK_ACK,      0x0424, RESPONSE, UNKNOWN) \
+    X(PRONUNCIATION_END_REQUEST,    0x0425, REQUEST,  PRONUNCIATION_RESULT) \
+    X(PRONUNCIATION_RESULT,         0x0426, RESPONSE, UNKNOWN) \
+    /* Games (0x05xx) */ \
+    X(GAME_START_REQUEST,           0x0501, REQUEST,  GAME_START_RESPONSE) \
+    X(GAME_START_RESPONSE,          0x0502, RESPONSE, UNKNOWN) \
+    X(GAME_MOVE_REQUEST,            0x0511, REQUEST,  GAME_MOVE_RESPONSE) \
+    X(GAME_MOVE_RESPONSE,           0x0512, RESPONSE, UNKNOWN) \
+    X(GAME_END_NOTIFICATION,        0x0521, PUSH,     UNKNOWN) \
+    /* Feedback and assessment (0x06xx) */ \
+    X(GET_SCORE_REQUEST,            0x0601, REQUEST,  GET_SCORE_RESPONSE) \
+    X(GET_SCORE_RESPONSE,           0x0602, RESPONSE, UNKNOWN) \
+    X(GET_FEEDBACK_REQUEST,         0x0611, REQUEST,  GET_FEEDBACK_RESPONSE) \
+    X(GET_FEEDBACK_RESPONSE,        0x0612, RESPONSE, UNKNOWN) \
+    /* Teacher sends feedback */ \
+    X(SEND_FEEDBACK_REQUEST,        0x0621, REQUEST,  SEND_FEEDBACK_SUCCESS) \
+    X(SEND_FEEDBACK_SUCCESS,        0x0622, RESPONSE, UNKNOWN) \
+    /* Spaced-repetition items due for review */ \
+    X(GET_REVIEW_QUEUE_REQUEST,     0x0631, REQUEST,  GET_REVIEW_QUEUE_RESPONSE) \
+    X(GET_REVIEW_QUEUE_RESPONSE,    0x0632, RESPONSE, UNKNOWN) \
+    /* Top K / neighbours on a score board */ \
+    X(GET_LEADERBOARD_REQUEST,      0x0641, REQUEST,  GET_LEADERBOARD_RESPONSE) \
+    X(GET_LEADERBOARD_RESPONSE,     0x0642, RESPONSE, UNKNOWN) \
+    /* Teacher sends many notes at once; one status per note */ \
+    X(SEND_FEEDBACK_BATCH_REQUEST,  0x0651, REQUEST,  SEND_FEEDBACK_BATCH_RESPONSE) \
+    X(SEND_FEEDBACK_BATCH_RESPONSE, 0x0652, RESPONSE, UNKNOWN) \
+    /* Communication (0x07xx); call signals are also relayed to the other party */ \
+    X(CHAT_MESSAGE,                 0x0701, REQUEST,  CHAT_MESSAGE_ACK) \
+    X(CHAT_MESSAGE_ACK,             0x0702, RESPONSE, UNKNOWN) \
+    X(VOICE_CALL_REQUEST,           0x0711, RELAYED,  VOICE_CALL_RINGING) \
+    X(VOICE_CALL_ACCEPT,            0x0712, RELAYED,  VOICE_CALL_ACCEPT) \
+    X(VOICE_CALL_REJECT,            0x0713, RELAYED,  VOICE_CALL_REJECT) \
+    X(VOICE_CALL_END,               0x0714, RELAYED,  VOICE_CALL_END) \
+    /* Caller's ack: callee is being notified */ \
+    X(VOICE_CALL_RINGING,           0x0715, RESPONSE, UNKNOWN) \
+    /* Admin operations (0x08xx) */ \
+    X(ADD_GAME_ITEM_REQUEST,        0x0801, REQUEST,  ADD_GAME_ITEM_SUCCESS) \
+    X(ADD_GAME_ITEM_SUCCESS,        0x0802, RESPONSE, UNKNOWN) \
+    X(ADD_GAME_ITEM_FAILED,         0x0803, RESPONSE, UNKNOWN) \
+    X(ADD_GAME_ITEMS_REQUEST,       0x0811, REQUEST,  ADD_GAME_ITEMS_RESPONSE) \
+    X(ADD_GAME_ITEMS_RESPONSE,      0x0812, RESPONSE, UNKNOWN) \
+    /* Load a CSV/JSONL curriculum file from the server's import directory */ \
+    X(IMPORT_CONTENT_REQUEST,       0x0821, REQUEST,  IMPORT_CONTENT_RESPONSE) \
+    X(IMPORT_CONTENT_RESPONSE,      0x0822, RESPONSE, UNKNOWN) \
+    /* System messages (0x09xx) */ \
+    X(HEARTBEAT_REQUEST,            0x0901, REQUEST,  HEARTBEAT_RESPONSE) \
+    X(HEARTBEAT_RESPONSE,           0x0902, RESPONSE, UNKNOWN) \
+    X(ERROR_MESSAGE,                0x0911, RESPONSE, UNKNOWN) \
+    X(DISCONNECT_NOTIFICATION,      0x0921, PUSH,     UNKNOWN) \
+    X(NOT_MODIFIED,                 0x0931, RESPONSE, UNKNOWN)   /* the version the client sent is current */
 
 // Message type codes following protocol design principles
 enum class MessageType : uint16_t {
-    // Authentication and account management (0x01xx)
-    REGISTER_REQUEST = 0x0101,
-    REGISTER_SUCCESS = 0x0102,
-    REGISTER_FAILED = 0x0103,
-    
-    LOGIN_REQUEST = 0x0111,
-    LOGIN_SUCCESS = 0x0112,
-    LOGIN_FAILED = 0x0113,
-    
-    LOGOUT_REQUEST = 0x0121,
-    LOGOUT_SUCCESS = 0x0122,
-    
-    // Study setup (0x02xx)
-    SET_LEVEL_REQUEST = 0x0201,
-    SET_LEVEL_SUCCESS = 0x0202,
-    SET_LEVEL_FAILED = 0x0203,
-    
-    // Content access (0x03xx)
-    GET_LESSON_LIST_REQUEST = 0x0301,
-    GET_LESSON_LIST_RESPONSE = 0x0302,
-    
-    GET_LESSON_CONTENT_REQUEST = 0x0311,
-    GET_LESSON_CONTENT_RESPONSE = 0x0312,
-    
-    // Exercises and tests (0x04xx)
-    SUBMIT_QUIZ_REQUEST = 0x0401,
-    SUBMIT_QUIZ_RESPONSE = 0x0402,
-    
-    SUBMIT_EXERCISE_REQUEST = 0x0411,
-    SUBMIT_EXERCISE_RESPONSE = 0x0412,
-    
-    // Games (0x05xx)
-    GAME_START_REQUEST = 0x0501,
-    GAME_START_RESPONSE = 0x0502,
-    
-    GAME_MOVE_REQUEST = 0x0511,
-    GAME_MOVE_RESPONSE = 0x0512,
-    
-    GAME_END_NOTIFICATION = 0x0521,
-    
-    // Feedback and assessment (0x06xx)
-    GET_SCORE_REQUEST = 0x0601,
-    GET_SCORE_RESPONSE = 0x0602,
-    
-    GET_FEEDBACK_REQUEST = 0x0611,
-    GET_FEEDBACK_RESPONSE = 0x0612,
-    
-    SEND_FEEDBACK_REQUEST = 0x0621, // Teacher sends feedback
-    SEND_FEEDBACK_SUCCESS = 0x0622,
-    
-    // Communication (0x07xx)
-    CHAT_MESSAGE = 0x0701,
-    CHAT_MESSAGE_ACK = 0x0702,
-    
-    VOICE_CALL_REQUEST = 0x0711,
-    VOICE_CALL_ACCEPT = 0x0712,
-    VOICE_CALL_REJECT = 0x0713,
-    VOICE_CALL_END = 0x0714,
-    
-    // Admin operations (0x08xx)
-    ADD_GAME_ITEM_REQUEST = 0x0801,
-    ADD_GAME_ITEM_SUCCESS = 0x0802,
-    ADD_GAME_ITEM_FAILED = 0x0803,
-    
-    // System messages (0x09xx)
-    HEARTBEAT_REQUEST = 0x0901,
-    HEARTBEAT_RESPONSE = 0x0902,
-    
-    ERROR_MESSAGE = 0x0911,
-    
-    DISCONNECT_NOTIFICATION = 0x0921,
-    
+#define MESSAGE_TYPE_ENUMERATOR(name, code, direction, reply) name = code,
+    MESSAGE_TYPE_LIST(MESSAGE_TYPE_ENUMERATOR)
+#undef MESSAGE_TYPE_ENUMERATOR
+
     // Unknown/invalid message
     UNKNOWN = 0xFFFF
 };
@@ -93,7 +119,10 @@ enum class ErrorCode : uint16_t {
     RESOURCE_NOT_FOUND = 7,
     INTERNAL_ERROR = 8,
     DATABASE_ERROR = 9,
-    INVALID_PARAMETER = 10
+    INVALID_PARAMETER = 10,
+    SERVER_BUSY = 11,
+    RATE_LIMITED = 12,
+    ALREADY_EXISTS = 13
 };
 
 // Message header structure (fixed size for efficient parsing)
@@ -115,56 +144,114 @@ struct Message {
     Message() = default;
     Message(MessageType type, const std::string& data = "") 
         : header(type, static_cast<uint16_t>(data.length())), payload(data) {}
+    Message(MessageType type, std::string&& data)
+        : header(type, static_cast<uint16_t>(data.length())), payload(std::move(data)) {}
     
     // Serialize message to wire format: TYPE|LENGTH|SEQUENCE|PAYLOAD\n
     std::string serialize() const {
-        std::ostringstream oss;
-        oss << static_cast<uint16_t>(header.type) << "|"
-            << header.payloadLength << "|"
-            << header.sequenceNumber << "|"
-            << payload << "\n";
-        return oss.str();
+        std::string out;
+        serializeInto(out);
+        return out;
     }
     
-    // Deserialize message from wire format
-    static Message deserialize(const std::string& data) {
+    // Append the wire format to out; reusing out's capacity avoids allocating per message
+    void serializeInto(std::string& out) const {
+        // Each field gets room for a uint32_t and its '|', so the writes provably fit
+        constexpr size_t FIELD = 11;
+        char prefix[3 * FIELD];
+        char* p = prefix;
+        for (uint32_t value : {uint32_t(header.type), uint32_t(header.payloadLength), header.sequenceNumber}) {
+            p = std::to_chars(p, p + FIELD - 1, value).ptr;
+            *p++ = '|';
+        }
+        
+        out.reserve(out.size() + static_cast<size_t>(p - prefix) + payload.size() + 1);
+        out.append(prefix, p);
+        out += payload;
+        out += '\n';
+    }
+    
+    // Deserialize one frame (without its newline); type UNKNOWN when the header is malformed
+    static Message deserialize(std::string_view data) {
         Message msg;
         
         // Find first three delimiters to split header from payload
         size_t pos1 = data.find('|');
-        if (pos1 == std::string::npos) {
-            msg.header.type = MessageType::UNKNOWN;
-            return msg;
-        }
-        
-        size_t pos2 = data.find('|', pos1 + 1);
-        if (pos2 == std::string::npos) {
-            msg.header.type = MessageType::UNKNOWN;
+        size_t pos2 = pos1 == std::string_view::npos ? pos1 : data.find('|', pos1 + 1);
+        size_t pos3 = pos2 == std::string_view::npos ? pos2 : data.find('|', pos2 + 1);
+        if (pos3 == std::string_view::npos) {
             return msg;
         }
         
-        size_t pos3 = data.find('|', pos2 + 1);
-        if (pos3 == std::string::npos) {
-            msg.header.type = MessageType::UNKNOWN;
+        uint16_t type = 0;
+        const char* end1 = data.data() + pos1;
+        const char* end2 = data.data() + pos2;
+        const char* end3 = data.data() + pos3;
+        auto typeParsed = std::from_chars(data.data(), end1, type);
+        auto lengthParsed = std::from_chars(end1 + 1, end2, msg.header.payloadLength);
+        auto sequenceParsed = std::from_chars(end2 + 1, end3, msg.header.sequenceNumber);
+        if (typeParsed.ec != std::errc() || typeParsed.ptr != end1 ||
+            lengthParsed.ec != std::errc() || lengthParsed.ptr != end2 ||
+            sequenceParsed.ec != std::errc() || sequenceParsed.ptr != end3) {
             return msg;
         }
         
-        try {
-            // Parse header fields
-            msg.header.type = static_cast<MessageType>(std::stoi(data.substr(0, pos1)));
-            msg.header.payloadLength = static_cast<uint16_t>(std::stoi(data.substr(pos1 + 1, pos2 - pos1 - 1)));
-            msg.header.sequenceNumber = static_cast<uint32_t>(std::stoi(data.substr(pos2 + 1, pos3 - pos2 - 1)));
-            
-            // Payload is everything after the 3rd delimiter (may contain '|')
-            msg.payload = data.substr(pos3 + 1);
-        } catch (...) {
-            msg.header.type = MessageType::UNKNOWN;
-        }
-        
+        // Payload is everything after the 3rd delimiter (may contain '|')
+        msg.header.type = static_cast<MessageType>(type);
+        msg.payload.assign(data.substr(pos3 + 1));
         return msg;
     }
 };
 
+// One teacher note in a user's feedback log; ids count up from 1 per user
+struct FeedbackEntry {
+    uint64_t id;
+    std::string text;
+};
+
+// A teacher's note for one student, as submitted in a batch
+struct FeedbackSubmission {
+    std::string student;
+    std::string exerciseId;
+    std::string text;
+};
+
+// A game item for a bulk import
+struct GameItemSubmission {
+    std::string gameType;
+    std::string data;
+    ProficiencyLevel level = ProficiencyLevel::BEGINNER;
+};
+
+// What a search hit refers to
+enum class SearchKind : uint8_t {
+    LESSON = 0,      // key = lesson id, title = lesson title
+    GAME_ITEM = 1    // key = game type, title = item data
+};
+
+// One search hit, best first
+struct SearchResult {
+    uint8_t kind;         // SearchKind
+    std::string key;
+    std::string title;
+    uint8_t level;        // 1-3
+    uint32_t score;       // BM25 score x 1000
+};
+
+// One dictionary word, from a completion or a lookup
+struct DictionaryEntry {
+    std::string word;
+    std::string gloss;
+    uint8_t distance;     // edits from the looked-up word, 0 for completions
+};
+
+// One ranked row of a leaderboard
+struct LeaderboardEntry {
+    size_t rank;          // 1-based
+    std::string username;
+    int score;
+};
+
 // User data structure
 struct UserData {
     std::string username;
@@ -179,6 +266,7 @@ struct UserData {
 // Session data for connected clients
 struct SessionData {
     SOCKET socket;
+    uint64_t connectionId;     // the connection holding the session
     std::string username;
     UserRole role;
     ConnectionState state;
@@ -186,7 +274,7 @@ struct SessionData {
     std::string receiveBuffer;
     std::string sendBuffer;
     
-    SessionData() : socket(INVALID_SOCKET), role(UserRole::STUDENT), 
+    SessionData() : socket(INVALID_SOCKET), connectionId(0), role(UserRole::STUDENT), 
                     state(ConnectionState::DISCONNECTED) {}
 };
 
@@ -1,10 +1,72 @@
 #include "Client.hpp"
 #include <thread>
 #include <sstream>
-#include <iomanip>
+#include <charconv>
+
+namespace {
+    // Records of a batch request
+    PayloadCodec::List<FeedbackNote>& recordsOf(FeedbackBatch& batch) { return batch.notes; }
+    PayloadCodec::List<GameItemRecord>& recordsOf(GameItemBatch& batch) { return batch.items; }
+    
+    // The ErrorCode of an ERROR_MESSAGE ("code|description")
+    ErrorCode errorCodeOf(const Message& response) {
+        int code = static_cast<int>(ErrorCode::INTERNAL_ERROR);
+        if (response.header.type == MessageType::ERROR_MESSAGE) {
+            std::from_chars(response.payload.data(), response.payload.data() + response.payload.size(), code);
+        }
+        return static_cast<ErrorCode>(code);
+    }
+    
+    // Review items arrive as a list of strings
+    template <MessageType TYPE>
+    std::vector<std::string> decodeTextList(const Message& response) {
+        TextList list;
+        if (response.header.type != TYPE || !PayloadCodec::decode<TYPE>(response.payload, list)) {
+            return {};
+        }
+        return std::vector<std::string>(list.items.begin(), list.items.end());
+    }
+    
+    // Lesson lists arrive with their content version
+    template <MessageType TYPE>
+    std::vector<std::string> decodeVersionedList(const Message& response) {
+        VersionedList list;
+        if (response.header.type != TYPE || !PayloadCodec::decode<TYPE>(response.payload, list)) {
+            return {};
+        }
+        return std::vector<std::string>(list.items.begin(), list.items.end());
+    }
+    
+    // The version a reply carries; false when it does not decode
+    template <MessageType TYPE>
+    bool schemaVersion(const std::string& payload, uint64_t& version) {
+        PayloadCodec::PayloadType<TYPE> reply;
+        if (!PayloadCodec::decode<TYPE>(payload, reply)) return false;
+        version = reply.version;
+        return true;
+    }
+    
+    // A whole field as a number; false on anything else, where std::stoul would throw
+    template <typename T>
+    bool parseField(std::string_view text, T& value) {
+        auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+        return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+    }
+    
+    // Set on the prefetch thread: its requests do not hold back others
+    thread_local bool prefetching = false;
+    
+    // Lesson list entries are "id:title"
+    std::string lessonIdOf(const std::string& lesson) {
+        return lesson.substr(0, lesson.find(':'));
+    }
+}
 
 Client::Client() 
-    : socket_(INVALID_SOCKET), serverPort_(0), connected_(false) {
+    : socket_(INVALID_SOCKET), serverPort_(0), connected_(false),
+      autoReconnect_(false), rng_(std::random_device{}()),
+      level_(ProficiencyLevel::BEGINNER), contentCache_(256, 8 * 1024 * 1024),
+      contentVersion_(0), feedbackEpoch_(0), prefetchStopping_(false), foregroundRequests_(0) {
 }
 
 Client::~Client() {
@@ -25,6 +87,17 @@ bool Client::connect(const std::string& serverAddress, int serverPort) {
     serverAddress_ = serverAddress;
     serverPort_ = serverPort;
     
+    if (!openSocket()) {
+        return false;
+    }
+    
+    autoReconnect_ = true;
+    Logger::getInstance().info("Connected to server " + serverAddress_ + ":" + std::to_string(serverPort_));
+    
+    return true;
+}
+
+bool Client::openSocket() {
     socket_ = Network::createSocket();
     if (!Network::isValidSocket(socket_)) {
         return false;
@@ -39,13 +112,19 @@ bool Client::connect(const std::string& serverAddress, int serverPort) {
     // Set socket to non-blocking for receiving
     Network::setNonBlocking(socket_);
     
+    receiveBuffer_.clear();
     connected_ = true;
-    Logger::getInstance().info("Connected to server " + serverAddress_ + ":" + std::to_string(serverPort_));
-    
     return true;
 }
 
 void Client::disconnect() {
+    stopPrefetch();
+    
+    // A request still waiting finds itself dropped and gives up without reconnecting
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    autoReconnect_ = false;
+    inFlight_.clear();
+    replies_.clear();
     if (!connected_) return;
     
     connected_ = false;
@@ -59,61 +138,209 @@ void Client::disconnect() {
     Logger::getInstance().info("Disconnected from server");
 }
 
-Message Client::sendMessageSync(const Message& message) {
-    if (!connected_) {
-        return Message(MessageType::ERROR_MESSAGE, 
-                      Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Not connected"));
+void Client::connectionLost() {
+    if (!connected_) return;
+    
+    Logger::getInstance().warning("Connection to server lost");
+    connected_ = false;
+    Network::closeSocket(socket_);
+    socket_ = INVALID_SOCKET;
+    receiveBuffer_.clear();   // a partial frame from the old connection is useless
+}
+
+Client::ReconnectResult Client::reconnect(int& attemptsLeft) {
+    if (!autoReconnect_) return ReconnectResult::FAILED;
+    
+    // Requests that may have taken effect cannot be repeated blindly
+    for (auto it = inFlight_.begin(); it != inFlight_.end(); ) {
+        if (protocol_.isIdempotent(it->second.header.type)) {
+            ++it;
+            continue;
+        }
+        Logger::getInstance().warning("Not replaying " + std::string(Protocol::getMessageTypeName(it->second.header.type)) +
+                                      " after reconnect");
+        it = inFlight_.erase(it);
     }
     
-    std::lock_guard<std::mutex> lock(socketMutex_);
+    while (attemptsLeft > 0) {
+        int attempt = reconnectPolicy_.maxAttempts - attemptsLeft--;
+        
+        // Full jitter: uniform in [0, min(max, base * 2^attempt)]
+        int64_t cap = std::min<int64_t>(reconnectPolicy_.maxDelayMs,
+                                        static_cast<int64_t>(reconnectPolicy_.baseDelayMs) << std::min(attempt, 20));
+        int64_t delayMs = std::uniform_int_distribution<int64_t>(0, std::max<int64_t>(cap, 0))(rng_);
+        Logger::getInstance().info("Reconnecting in " + std::to_string(delayMs) + " ms (attempt " +
+                                   std::to_string(attempt + 1) + "/" + std::to_string(reconnectPolicy_.maxAttempts) + ")");
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        
+        if (!openSocket()) continue;
+        
+        if (!resumeToken_.empty()) {
+            Message request(MessageType::RESUME_REQUEST, resumeToken_);
+            request.header.sequenceNumber = protocol_.getNextSequenceNumber();
+            
+            Message reply;
+            if (!sendFrame(request)) continue;
+            WaitResult result = waitForReply(request.header.sequenceNumber, reply);
+            if (result == WaitResult::CONNECTION_LOST) continue;
+            
+            // Payload: role|level|resumeToken
+            std::vector<std::string> parts = Utils::split(reply.payload, '|');
+            if (result != WaitResult::REPLY || reply.header.type != MessageType::RESUME_SUCCESS || parts.size() < 3) {
+                // Refused or unanswered: this is a new, unauthenticated connection and the
+                // user has to log in again, so nothing is replayed
+                resumeToken_.clear();
+                inFlight_.clear();
+                Logger::getInstance().warning("Session could not be resumed: " +
+                                              (result == WaitResult::REPLY ? reply.payload : std::string("timeout")));
+                return ReconnectResult::SESSION_LOST;
+            }
+            resumeToken_ = parts[2];
+            Logger::getInstance().info("Session resumed after reconnect");
+        }
+        
+        // Same sequence numbers as before, so waiting callers still match their replies
+        bool replayed = true;
+        for (const auto& entry : inFlight_) {
+            if (!sendFrame(entry.second)) {
+                replayed = false;
+                break;
+            }
+        }
+        if (!replayed) continue;
+        
+        Logger::getInstance().info("Reconnected to server " + serverAddress_ + ":" + std::to_string(serverPort_));
+        return ReconnectResult::RECONNECTED;
+    }
     
-    // Send message
+    Logger::getInstance().error("Giving up reconnecting after " + std::to_string(reconnectPolicy_.maxAttempts) + " attempts");
+    return ReconnectResult::FAILED;
+}
+
+bool Client::sendFrame(const Message& message) {
     std::string data = protocol_.encodeMessage(message);
     int bytesSent = Network::sendData(socket_, data.c_str(), data.length());
     
     if (bytesSent <= 0) {
         Logger::getInstance().error("Failed to send message");
+        connectionLost();
+        return false;
+    }
+    
+    Logger::getInstance().debug("Sent message type " + std::string(Protocol::getMessageTypeName(message.header.type)));
+    return true;
+}
+
+Message Client::sendMessageSync(const Message& message) {
+    // Announced before queueing for the socket, so the prefetcher holds off
+    struct Foreground {
+        std::atomic<int>& count;
+        bool counted;
+        Foreground(std::atomic<int>& c) : count(c), counted(!prefetching) { if (counted) ++count; }
+        ~Foreground() { if (counted) --count; }
+    } foreground(foregroundRequests_);
+    
+    std::unique_lock<std::mutex> lock(socketMutex_);
+    
+    // One budget of reconnect attempts for the whole call, however often the link drops.
+    // A new request is still sent when the session was lost: the server answers it
+    // (a login works, anything else gets NOT_AUTHENTICATED). The prefetcher never
+    // reconnects: its backoff would hold up the user's requests and a disconnect.
+    int attemptsLeft = reconnectPolicy_.maxAttempts;
+    if (!connected_ && (prefetching || reconnect(attemptsLeft) == ReconnectResult::FAILED)) {
         return Message(MessageType::ERROR_MESSAGE, 
-                      Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Send failed"));
+                      Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Not connected"));
     }
     
-    Logger::getInstance().debug("Sent message type " + std::to_string(static_cast<int>(message.header.type)));
+    // Number the request so the reply can be told apart from server pushes
+    Message request = message;
+    request.header.sequenceNumber = protocol_.getNextSequenceNumber();
+    inFlight_[request.header.sequenceNumber] = request;
     
-    // Wait for response with timeout
+    bool sent = sendFrame(request);
+    
+    while (true) {
+        if (sent) {
+            Message reply;
+            WaitResult result = waitForReply(request.header.sequenceNumber, reply, &lock);
+            if (result != WaitResult::CONNECTION_LOST) {
+                inFlight_.erase(request.header.sequenceNumber);
+                replies_.erase(request.header.sequenceNumber);
+                if (result == WaitResult::REPLY) return reply;
+                if (result == WaitResult::CANCELLED) {
+                    return Message(MessageType::ERROR_MESSAGE,
+                                  Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Cancelled"));
+                }
+                
+                Logger::getInstance().error("Response timeout");
+                return Message(MessageType::ERROR_MESSAGE, 
+                              Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Timeout"));
+            }
+        }
+        
+        // reconnect() resends the request only when it is idempotent and the session resumed.
+        // Another request's reconnect may already have done so while this one waited.
+        ReconnectResult reconnected = ReconnectResult::RECONNECTED;
+        if (!connected_) {
+            reconnected = prefetching ? ReconnectResult::FAILED : reconnect(attemptsLeft);
+        }
+        if (reconnected == ReconnectResult::SESSION_LOST) {
+            return Message(MessageType::ERROR_MESSAGE,
+                          Parser::createErrorMessage(ErrorCode::NOT_AUTHENTICATED, "Session expired, please log in again"));
+        }
+        if (reconnected == ReconnectResult::FAILED || !inFlight_.count(request.header.sequenceNumber)) {
+            inFlight_.erase(request.header.sequenceNumber);
+            return Message(MessageType::ERROR_MESSAGE, 
+                          Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Connection lost"));
+        }
+        sent = true;
+    }
+}
+
+void Client::routeMessages(uint32_t awaited) {
+    for (Message& message : protocol_.extractMessages(receiveBuffer_)) {
+        uint32_t sequenceNumber = message.header.sequenceNumber;
+        if (sequenceNumber != 0 && (sequenceNumber == awaited || inFlight_.count(sequenceNumber))) {
+            replies_[sequenceNumber] = std::move(message);
+        } else {
+            pendingMessages_.push_back(std::move(message));
+        }
+    }
+}
+
+Client::WaitResult Client::waitForReply(uint32_t sequenceNumber, Message& reply, std::unique_lock<std::mutex>* lock) {
     auto startTime = std::chrono::steady_clock::now();
     const int timeoutSeconds = 10;
     
     while (true) {
-        receiveData();
-        
-        // Log buffer contents
-        std::ostringstream bufferHex;
-        for (unsigned char c : receiveBuffer_) {
-            bufferHex << std::hex << std::setw(2) << std::setfill('0') << (int)c << " ";
+        // Another waiter or a poll may have read it off the socket
+        auto it = replies_.find(sequenceNumber);
+        if (it != replies_.end()) {
+            reply = std::move(it->second);
+            replies_.erase(it);
+            return WaitResult::REPLY;
         }
-        Logger::getInstance().debug("CLIENT receiveBuffer_ size=" + std::to_string(receiveBuffer_.size()) + 
-                                   " hex=[" + bufferHex.str() + "]");
         
-        std::vector<Message> messages = protocol_.extractMessages(receiveBuffer_);
-        Logger::getInstance().debug("CLIENT extracted " + std::to_string(messages.size()) + " messages, " +
-                                   "remaining buffer size=" + std::to_string(receiveBuffer_.size()));
+        // Dropped by another request's reconnect, or by disconnect()
+        if (lock && !inFlight_.count(sequenceNumber)) return WaitResult::CONNECTION_LOST;
+        if (prefetching && prefetchStopping_) return WaitResult::CANCELLED;
         
-        if (!messages.empty()) {
-            Logger::getInstance().debug("CLIENT returning message type " + std::to_string((int)messages[0].header.type));
-            return messages[0]; // Return first message
-        }
+        receiveData();
+        if (!connected_) return WaitResult::CONNECTION_LOST;
+        routeMessages(sequenceNumber);
+        if (replies_.count(sequenceNumber)) continue;
         
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::steady_clock::now() - startTime).count();
         
         if (elapsed > timeoutSeconds) {
-            Logger::getInstance().error("Response timeout");
-            return Message(MessageType::ERROR_MESSAGE, 
-                          Parser::createErrorMessage(ErrorCode::INTERNAL_ERROR, "Timeout"));
+            return WaitResult::TIMEOUT;
         }
         
-        // Small delay to avoid busy waiting
+        // Small delay to avoid busy waiting; the socket is free for others meanwhile
+        if (lock) lock->unlock();
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (lock) lock->lock();
     }
 }
 
@@ -129,22 +356,29 @@ bool Client::sendMessageAsync(const Message& message) {
 }
 
 bool Client::receiveMessage(Message& message) {
-    if (!receiveData()) {
-        return false;
-    }
+    std::lock_guard<std::mutex> lock(socketMutex_);
     
-    std::vector<Message> messages = protocol_.extractMessages(receiveBuffer_);
-    if (messages.empty()) {
-        return false;
+    if (pendingMessages_.empty()) {
+        receiveData();
+        routeMessages(0);
+        if (pendingMessages_.empty()) {
+            return false;
+        }
     }
     
-    message = messages[0];
+    message = pendingMessages_.front();
+    pendingMessages_.erase(pendingMessages_.begin());
     return true;
 }
 
 std::vector<Message> Client::pollMessages() {
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    
     receiveData();
-    return protocol_.extractMessages(receiveBuffer_);
+    routeMessages(0);
+    std::vector<Message> messages;
+    messages.swap(pendingMessages_);
+    return messages;
 }
 
 bool Client::receiveData() {
@@ -159,6 +393,10 @@ bool Client::receiveData() {
         return true;
     }
     
+    // 0: orderly shutdown by the server; an error other than "no data yet": connection broken
+    if (bytesReceived == 0 || !Network::wouldBlock()) {
+        connectionLost();
+    }
     return false;
 }
 
@@ -184,7 +422,7 @@ bool Client::login(const std::string& username, const std::string& password, Use
     Message response = sendMessageSync(request);
     
     if (response.header.type == MessageType::LOGIN_SUCCESS) {
-        // Parse response: role|level|score
+        // Parse response: role|level|score|resumeToken
         std::vector<std::string> parts = Utils::split(response.payload, '|');
         if (parts.size() >= 3) {
             userData.username = username;
@@ -192,6 +430,9 @@ bool Client::login(const std::string& username, const std::string& password, Use
             userData.level = static_cast<ProficiencyLevel>(std::stoi(parts[1]));
             userData.score = std::stoi(parts[2]);
         }
+        resumeToken_ = parts.size() >= 4 ? parts[3] : "";
+        level_ = userData.level;
+        forgetFeedback();
         
         Logger::getInstance().info("Logged in successfully: " + username);
         return true;
@@ -206,6 +447,8 @@ bool Client::logout() {
     Message response = sendMessageSync(request);
     
     if (response.header.type == MessageType::LOGOUT_SUCCESS) {
+        resumeToken_.clear();
+        forgetFeedback();
         Logger::getInstance().info("Logged out successfully");
         return true;
     }
@@ -213,47 +456,215 @@ bool Client::logout() {
     return false;
 }
 
+bool Client::resumeSession(UserData& userData) {
+    if (resumeToken_.empty()) return false;
+    
+    Message request(MessageType::RESUME_REQUEST, resumeToken_);
+    Message response = sendMessageSync(request);
+    
+    if (response.header.type == MessageType::RESUME_SUCCESS) {
+        // Parse response: role|level|resumeToken
+        std::vector<std::string> parts = Utils::split(response.payload, '|');
+        if (parts.size() >= 3) {
+            userData.role = static_cast<UserRole>(std::stoi(parts[0]));
+            userData.level = static_cast<ProficiencyLevel>(std::stoi(parts[1]));
+            resumeToken_ = parts[2];
+            level_ = userData.level;
+        }
+        
+        Logger::getInstance().info("Session resumed: " + userData.username);
+        return true;
+    }
+    
+    // Expired or revoked: the caller has to log in again
+    resumeToken_.clear();
+    Logger::getInstance().warning("Session resume failed: " + response.payload);
+    return false;
+}
+
 bool Client::setLevel(ProficiencyLevel level) {
     std::string payload = Parser::createSetLevelRequest(level);
     Message request(MessageType::SET_LEVEL_REQUEST, payload);
     
     Message response = sendMessageSync(request);
-    return response.header.type == MessageType::SET_LEVEL_SUCCESS;
+    if (response.header.type != MessageType::SET_LEVEL_SUCCESS) return false;
+    
+    // Payload: 0|resumeToken (the old token carries the previous level)
+    std::vector<std::string> parts = Utils::split(response.payload, '|');
+    if (parts.size() >= 2) resumeToken_ = parts[1];
+    level_ = level;
+    return true;
+}
+
+template <MessageType TYPE, MessageType REPLY>
+Message Client::fetchVersioned(PayloadCodec::PayloadType<TYPE> request, const std::string& key) {
+    ContentCache::Entry kept;
+    contentCache_.get(key, kept);
+    request.version = kept.version;
+    
+    Message response = sendMessageSync(Message(TYPE, PayloadCodec::encode<TYPE>(request)));
+    if (response.header.type == MessageType::NOT_MODIFIED && kept.version != 0) {
+        return Message(REPLY, std::move(kept.payload));
+    }
+    
+    uint64_t version = 0;
+    if (response.header.type == REPLY && schemaVersion<REPLY>(response.payload, version)) {
+        contentCache_.put(key, version, response.payload);
+    }
+    return response;
+}
+
+void Client::forgetFeedback() {
+    std::lock_guard<std::mutex> lock(feedbackMutex_);
+    feedback_.clear();
+    feedbackEpoch_ = 0;
+}
+
+void Client::noteContentVersion(uint64_t version) {
+    // Versions only grow, also across server restarts
+    uint64_t seen = contentVersion_.load();
+    while (version > seen && !contentVersion_.compare_exchange_weak(seen, version)) {}
 }
 
 std::vector<std::string> Client::getLessonList() {
-    Message request(MessageType::GET_LESSON_LIST_REQUEST);
-    Message response = sendMessageSync(request);
+    Message response = fetchVersioned<MessageType::GET_LESSON_LIST_REQUEST, MessageType::GET_LESSON_LIST_RESPONSE>(
+        ContentVersion(), "lessons:" + std::to_string(static_cast<int>(level_)));
     
-    if (response.header.type == MessageType::GET_LESSON_LIST_RESPONSE) {
-        return Utils::split(response.payload, ';');
+    uint64_t version = 0;
+    if (response.header.type == MessageType::GET_LESSON_LIST_RESPONSE &&
+        schemaVersion<MessageType::GET_LESSON_LIST_RESPONSE>(response.payload, version)) {
+        noteContentVersion(version);
     }
     
-    return {};
+    std::vector<std::string> lessons = decodeVersionedList<MessageType::GET_LESSON_LIST_RESPONSE>(response);
+    schedulePrefetch(lessons);
+    return lessons;
+}
+
+Message Client::fetchLessonContent(const std::string& lessonId) {
+    LessonQuery query;
+    query.lessonId = lessonId;
+    Message response = fetchVersioned<MessageType::GET_LESSON_CONTENT_REQUEST, MessageType::GET_LESSON_CONTENT_RESPONSE>(
+        query, "lesson:" + lessonId);
+    
+    uint64_t version = 0;
+    if (response.header.type == MessageType::GET_LESSON_CONTENT_RESPONSE &&
+        schemaVersion<MessageType::GET_LESSON_CONTENT_RESPONSE>(response.payload, version)) {
+        noteContentVersion(version);
+    }
+    return response;
 }
 
 std::string Client::getLessonContent(const std::string& lessonId) {
-    Message request(MessageType::GET_LESSON_CONTENT_REQUEST, lessonId);
-    Message response = sendMessageSync(request);
+    {
+        std::lock_guard<std::mutex> lock(lastLessonMutex_);
+        lastLesson_ = lessonId;
+    }
     
-    if (response.header.type == MessageType::GET_LESSON_CONTENT_RESPONSE) {
-        return response.payload;
+    // Always asked with the kept version: the lesson may have changed since the last list
+    // came, and an unchanged one costs only a NOT_MODIFIED reply
+    Message response = fetchLessonContent(lessonId);
+    
+    LessonContent content;
+    if (response.header.type == MessageType::GET_LESSON_CONTENT_RESPONSE &&
+        PayloadCodec::decode<MessageType::GET_LESSON_CONTENT_RESPONSE>(response.payload, content)) {
+        return std::string(content.text);
     }
     
     return "";
 }
 
-bool Client::submitQuiz(const std::string& quizId, const std::string& answers, int& score) {
-    std::string payload = quizId + "|" + answers;
-    Message request(MessageType::SUBMIT_QUIZ_REQUEST, payload);
+void Client::schedulePrefetch(const std::vector<std::string>& lessons) {
+    if (lessons.empty()) return;
     
-    Message response = sendMessageSync(request);
+    // Lessons are listed in study order: the likely next ones follow the last one opened
+    size_t start = 0;
+    {
+        std::lock_guard<std::mutex> lock(lastLessonMutex_);
+        for (size_t i = 0; i < lessons.size(); ++i) {
+            if (lessonIdOf(lessons[i]) == lastLesson_) start = i + 1;
+        }
+    }
     
-    if (response.header.type == MessageType::SUBMIT_QUIZ_RESPONSE) {
-        std::vector<std::string> parts = Utils::split(response.payload, '|');
-        if (!parts.empty()) {
-            score = std::stoi(parts[0]);
+    uint64_t current = contentVersion_.load();
+    std::vector<std::string> wanted;
+    for (size_t i = 0; i < lessons.size() && wanted.size() < PREFETCH_LESSONS; ++i) {
+        std::string lessonId = lessonIdOf(lessons[(start + i) % lessons.size()]);
+        if (contentCache_.versionOf("lesson:" + lessonId) != current) {
+            wanted.push_back(lessonId);
+        }
+    }
+    if (wanted.empty()) return;
+    
+    std::lock_guard<std::mutex> lock(prefetchMutex_);
+    if (prefetchStopping_) return;
+    prefetchQueue_.assign(wanted.begin(), wanted.end());   // a newer list supersedes the old plan
+    if (!prefetchThread_.joinable()) {
+        prefetchThread_ = std::thread(&Client::prefetchLoop, this);
+    }
+    prefetchReady_.notify_one();
+}
+
+void Client::prefetchLoop() {
+    prefetching = true;
+    
+    std::unique_lock<std::mutex> lock(prefetchMutex_);
+    while (true) {
+        prefetchReady_.wait(lock, [this] { return prefetchStopping_ || !prefetchQueue_.empty(); });
+        if (prefetchStopping_) return;
+        
+        // Low priority: spaced out, and only while nothing else waits for the connection
+        if (prefetchReady_.wait_for(lock, std::chrono::milliseconds(PREFETCH_INTERVAL_MS),
+                                    [this] { return prefetchStopping_.load(); })) {
+            return;
         }
+        if (foregroundRequests_.load() > 0 || !connected_ || prefetchQueue_.empty()) continue;
+        
+        std::string lessonId = prefetchQueue_.front();
+        prefetchQueue_.pop_front();
+        lock.unlock();
+        
+        uint64_t current = contentVersion_.load();
+        bool cached = contentCache_.versionOf("lesson:" + lessonId) == current;
+        Message response = cached ? Message() : fetchLessonContent(lessonId);
+        
+        lock.lock();
+        if (!cached && response.header.type != MessageType::GET_LESSON_CONTENT_RESPONSE) {
+            // Busy, limited or disconnected: the user will fetch what they open
+            Logger::getInstance().debug("Lesson prefetch stopped: " + std::string(Protocol::getMessageTypeName(response.header.type)));
+            prefetchQueue_.clear();
+        }
+    }
+}
+
+void Client::stopPrefetch() {
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchStopping_ = true;
+        prefetchQueue_.clear();
+    }
+    prefetchReady_.notify_all();
+    
+    if (prefetchThread_.joinable()) {
+        prefetchThread_.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(prefetchMutex_);
+    prefetchStopping_ = false;
+}
+
+bool Client::submitQuiz(const std::string& quizId, const std::vector<std::string>& answers, int& score) {
+    QuizSubmission submission;
+    submission.quizId = quizId;
+    submission.answers = PayloadCodec::List<std::string_view>::of(answers);
+    Message request(MessageType::SUBMIT_QUIZ_REQUEST, PayloadCodec::encode<MessageType::SUBMIT_QUIZ_REQUEST>(submission));
+    
+    Message response = sendMessageSync(request);
+    
+    QuizResult result;
+    if (response.header.type == MessageType::SUBMIT_QUIZ_RESPONSE &&
+        PayloadCodec::decode<MessageType::SUBMIT_QUIZ_RESPONSE>(response.payload, result)) {
+        score = result.score;
         return true;
     }
     
@@ -261,28 +672,80 @@ bool Client::submitQuiz(const std::string& quizId, const std::string& answers, i
 }
 
 bool Client::submitExercise(const std::string& exerciseId, const std::string& content, int& score) {
-    std::string payload = exerciseId + "|" + content;
-    Message request(MessageType::SUBMIT_EXERCISE_REQUEST, payload);
+    ExerciseSubmission submission;
+    submission.exerciseId = exerciseId;
+    submission.answer = content;
+    Message request(MessageType::SUBMIT_EXERCISE_REQUEST,
+                   PayloadCodec::encode<MessageType::SUBMIT_EXERCISE_REQUEST>(submission));
     
     Message response = sendMessageSync(request);
     
-    if (response.header.type == MessageType::SUBMIT_EXERCISE_RESPONSE) {
-        score = std::stoi(response.payload);
+    ExerciseResult result;
+    if (response.header.type == MessageType::SUBMIT_EXERCISE_RESPONSE &&
+        PayloadCodec::decode<MessageType::SUBMIT_EXERCISE_RESPONSE>(response.payload, result)) {
+        score = result.score;
         return true;
     }
     
     return false;
 }
 
-std::string Client::startGame(const std::string& gameType) {
-    Message request(MessageType::GAME_START_REQUEST, gameType);
+bool Client::submitPronunciation(const std::string& sentenceId, const std::vector<int16_t>& samples,
+                                 int sampleRate, bool reference, int& score, int& similarity) {
+    const size_t CHUNK_SAMPLES = 2048;   // 4 KB of PCM, well under the payload limit once encoded
+    
+    RecordingStart start;
+    start.sentenceId = sentenceId;
+    start.sampleRate = static_cast<uint32_t>(sampleRate);
+    start.reference = reference;
+    Message response = sendMessageSync(Message(MessageType::PRONUNCIATION_START_REQUEST,
+                                               PayloadCodec::encode<MessageType::PRONUNCIATION_START_REQUEST>(start)));
+    if (response.header.type != MessageType::PRONUNCIATION_START_RESPONSE) {
+        return false;
+    }
+    
+    for (size_t offset = 0; offset < samples.size(); offset += CHUNK_SAMPLES) {
+        size_t count = std::min(CHUNK_SAMPLES, samples.size() - offset);
+        std::string bytes(count * 2, '\0');
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t raw = static_cast<uint16_t>(samples[offset + i]);
+            bytes[2 * i] = static_cast<char>(raw & 0xFF);
+            bytes[2 * i + 1] = static_cast<char>(raw >> 8);
+        }
+        
+        response = sendMessageSync(Message(MessageType::PRONUNCIATION_CHUNK, Parser::encodeBase64(bytes)));
+        if (response.header.type != MessageType::PRONUNCIATION_CHUNK_ACK) {
+            return false;
+        }
+    }
+    
+    response = sendMessageSync(Message(MessageType::PRONUNCIATION_END_REQUEST));
+    PronunciationScore result;
+    if (response.header.type != MessageType::PRONUNCIATION_RESULT ||
+        !PayloadCodec::decode<MessageType::PRONUNCIATION_RESULT>(response.payload, result)) {
+        return false;
+    }
+    
+    score = result.score;
+    similarity = static_cast<int>(result.similarity);
+    return true;
+}
+
+bool Client::startGame(const std::string& gameType, uint64_t& sessionId, std::vector<std::string>& items) {
+    GameQuery query;
+    query.gameType = gameType;
+    Message request(MessageType::GAME_START_REQUEST, PayloadCodec::encode<MessageType::GAME_START_REQUEST>(query));
     Message response = sendMessageSync(request);
     
-    if (response.header.type == MessageType::GAME_START_RESPONSE) {
-        return response.payload;
+    GameDeal deal;
+    if (response.header.type != MessageType::GAME_START_RESPONSE ||
+        !PayloadCodec::decode<MessageType::GAME_START_RESPONSE>(response.payload, deal)) {
+        return false;
     }
     
-    return "";
+    sessionId = deal.sessionId;
+    items = std::vector<std::string>(deal.items.begin(), deal.items.end());
+    return true;
 }
 
 bool Client::sendGameMove(const std::string& moveData, std::string& response) {
@@ -298,40 +761,284 @@ bool Client::sendGameMove(const std::string& moveData, std::string& response) {
 }
 
 bool Client::sendChatMessage(const std::string& recipient, const std::string& message) {
-    std::string payload = Parser::createChatMessage(recipient, message);
-    Message request(MessageType::CHAT_MESSAGE, payload);
+    ChatPayload chat;
+    chat.recipient = recipient;
+    chat.text = message;
+    Message request(MessageType::CHAT_MESSAGE, PayloadCodec::encode<MessageType::CHAT_MESSAGE>(chat));
     
     Message response = sendMessageSync(request);
     return response.header.type == MessageType::CHAT_MESSAGE_ACK;
 }
 
+bool Client::sendFeedback(const std::string& student, const std::string& exerciseId, const std::string& text) {
+    FeedbackNote note;
+    note.student = student;
+    note.exerciseId = exerciseId;
+    note.text = text;
+    Message request(MessageType::SEND_FEEDBACK_REQUEST, PayloadCodec::encode<MessageType::SEND_FEEDBACK_REQUEST>(note));
+    
+    Message response = sendMessageSync(request);
+    return response.header.type == MessageType::SEND_FEEDBACK_SUCCESS;
+}
+
+size_t Client::sendFeedbackBatch(const std::vector<FeedbackSubmission>& notes, std::vector<ErrorCode>& statuses) {
+    std::vector<FeedbackNote> records(notes.size());
+    for (size_t i = 0; i < notes.size(); ++i) {
+        records[i].student = notes[i].student;
+        records[i].exerciseId = notes[i].exerciseId;
+        records[i].text = notes[i].text;
+    }
+    return sendBatches<MessageType::SEND_FEEDBACK_BATCH_REQUEST>(records, statuses);
+}
+
+size_t Client::addGameItems(const std::vector<GameItemSubmission>& items, std::vector<ErrorCode>& statuses) {
+    std::vector<GameItemRecord> records(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        records[i].gameType = items[i].gameType;
+        records[i].data = items[i].data;
+        records[i].level = static_cast<uint8_t>(items[i].level);
+    }
+    return sendBatches<MessageType::ADD_GAME_ITEMS_REQUEST>(records, statuses);
+}
+
+bool Client::importContent(const std::string& fileName, std::string& report) {
+    Message response = sendMessageSync(Message(MessageType::IMPORT_CONTENT_REQUEST, fileName));
+    
+    // Both replies are "code|text"
+    size_t bar = response.payload.find('|');
+    report = bar == std::string::npos ? "" : response.payload.substr(bar + 1);
+    return response.header.type == MessageType::IMPORT_CONTENT_RESPONSE;
+}
+
+template <MessageType TYPE, typename Record>
+size_t Client::sendBatches(const std::vector<Record>& records, std::vector<ErrorCode>& statuses) {
+    constexpr MessageType REPLY = MessageTypes::replyTo(TYPE);
+    // Room for the record count in front of the records
+    const size_t budget = AppConstants::MAX_MESSAGE_SIZE - 10;
+    
+    statuses.assign(records.size(), ErrorCode::INTERNAL_ERROR);
+    size_t applied = 0;
+    std::string encoded;
+    for (size_t begin = 0; begin < records.size(); ) {
+        size_t end = begin;
+        size_t bytes = 0;
+        for (; end < records.size(); ++end) {
+            encoded.clear();
+            PayloadCodec::Codec<Record>::put(encoded, records[end]);
+            if (bytes + encoded.size() > budget) break;
+            bytes += encoded.size();
+        }
+        if (end == begin) {
+            // Larger than a message on its own
+            statuses[begin++] = ErrorCode::INVALID_PARAMETER;
+            continue;
+        }
+        
+        std::vector<Record> run(records.begin() + begin, records.begin() + end);
+        PayloadCodec::PayloadType<TYPE> batch;
+        recordsOf(batch) = PayloadCodec::List<Record>::of(run);
+        Message request(TYPE, PayloadCodec::encode<TYPE>(batch));
+        
+        Message response;
+        for (int attempt = 0; ; ++attempt) {
+            response = sendMessageSync(request);
+            ErrorCode error = errorCodeOf(response);
+            if (response.header.type == REPLY || attempt >= BATCH_RETRIES ||
+                (error != ErrorCode::RATE_LIMITED && error != ErrorCode::SERVER_BUSY)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(BATCH_RETRY_MS << attempt));
+        }
+        
+        BatchResult result;
+        if (response.header.type != REPLY || !PayloadCodec::decode<REPLY>(response.payload, result) ||
+            result.statuses.size() != run.size()) {
+            // Records from here on were not applied
+            std::fill(statuses.begin() + begin, statuses.end(), errorCodeOf(response));
+            Logger::getInstance().warning("Batch request failed after " + std::to_string(applied) + " records");
+            break;
+        }
+        
+        size_t i = begin;
+        for (uint16_t status : result.statuses) {
+            statuses[i++] = static_cast<ErrorCode>(status);
+        }
+        applied += result.applied;
+        begin = end;
+    }
+    return applied;
+}
+
 bool Client::initiateVoiceCall(const std::string& targetUser) {
-    Message request(MessageType::VOICE_CALL_REQUEST, targetUser);
+    uint32_t callId = 0;
+    return initiateVoiceCall(targetUser, callId);
+}
+
+bool Client::initiateVoiceCall(const std::string& targetUser, uint32_t& callId) {
+    CallOffer offer;
+    offer.user = targetUser;
+    Message request(MessageType::VOICE_CALL_REQUEST, PayloadCodec::encode<MessageType::VOICE_CALL_REQUEST>(offer));
     Message response = sendMessageSync(request);
     
-    return response.header.type == MessageType::VOICE_CALL_ACCEPT;
+    // The callee's answer arrives later as a VOICE_CALL_ACCEPT / VOICE_CALL_REJECT push
+    return response.header.type == MessageType::VOICE_CALL_RINGING && parseField(response.payload, callId);
+}
+
+bool Client::acceptVoiceCall(uint32_t callId, int& relayPort, uint32_t& token) {
+    CallAnswer answer;
+    answer.callId = callId;
+    Message request(MessageType::VOICE_CALL_ACCEPT, PayloadCodec::encode<MessageType::VOICE_CALL_ACCEPT>(answer));
+    Message response = sendMessageSync(request);
+    
+    if (response.header.type != MessageType::VOICE_CALL_ACCEPT ||
+        !PayloadCodec::decode<MessageType::VOICE_CALL_ACCEPT>(response.payload, answer)) {
+        return false;
+    }
+    
+    relayPort = static_cast<int>(answer.relayPort);
+    token = answer.token;
+    return true;
+}
+
+bool Client::rejectVoiceCall(uint32_t callId) {
+    Message request(MessageType::VOICE_CALL_REJECT, std::to_string(callId));
+    Message response = sendMessageSync(request);
+    
+    return response.header.type == MessageType::VOICE_CALL_REJECT;
+}
+
+bool Client::endVoiceCall(uint32_t callId) {
+    Message request(MessageType::VOICE_CALL_END, std::to_string(callId));
+    Message response = sendMessageSync(request);
+    
+    return response.header.type == MessageType::VOICE_CALL_END;
 }
 
 int Client::getScore() {
     Message request(MessageType::GET_SCORE_REQUEST);
     Message response = sendMessageSync(request);
     
-    if (response.header.type == MessageType::GET_SCORE_RESPONSE) {
-        return std::stoi(response.payload);
+    ScoreReport report;
+    if (response.header.type == MessageType::GET_SCORE_RESPONSE &&
+        PayloadCodec::decode<MessageType::GET_SCORE_RESPONSE>(response.payload, report)) {
+        return report.score;
     }
     
     return 0;
 }
 
 std::vector<std::string> Client::getFeedback() {
-    Message request(MessageType::GET_FEEDBACK_REQUEST);
+    std::lock_guard<std::mutex> lock(feedbackMutex_);
+    
+    // Only entries after the newest one kept travel, a page at a time
+    while (true) {
+        FeedbackQuery query;
+        query.epoch = feedbackEpoch_;
+        query.after = feedback_.empty() ? 0 : feedback_.back().id;
+        Message response = sendMessageSync(Message(MessageType::GET_FEEDBACK_REQUEST,
+                                                   PayloadCodec::encode<MessageType::GET_FEEDBACK_REQUEST>(query)));
+        
+        FeedbackPage page;
+        if (response.header.type != MessageType::GET_FEEDBACK_RESPONSE ||
+            !PayloadCodec::decode<MessageType::GET_FEEDBACK_RESPONSE>(response.payload, page)) {
+            break;
+        }
+        
+        // A new epoch: the server restarted and sent its log from the start
+        if (page.epoch != feedbackEpoch_) {
+            feedback_.clear();
+            feedbackEpoch_ = page.epoch;
+        }
+        feedback_.insert(feedback_.end(), page.entries.begin(), page.entries.end());
+        if (!page.more || page.entries.empty()) break;
+    }
+    
+    std::vector<std::string> texts;
+    texts.reserve(feedback_.size());
+    for (const auto& entry : feedback_) {
+        texts.push_back(entry.text);
+    }
+    return texts;
+}
+
+std::vector<std::string> Client::getReviewQueue(size_t count) {
+    Message request(MessageType::GET_REVIEW_QUEUE_REQUEST, std::to_string(count));
+    Message response = sendMessageSync(request);
+    
+    return decodeTextList<MessageType::GET_REVIEW_QUEUE_RESPONSE>(response);
+}
+
+std::vector<SearchResult> Client::search(const std::string& query, uint8_t level, size_t limit, size_t& matches) {
+    SearchQuery request;
+    request.text = query;
+    request.level = level;
+    request.limit = static_cast<uint32_t>(limit);
+    Message response = sendMessageSync(Message(MessageType::SEARCH_REQUEST,
+                                               PayloadCodec::encode<MessageType::SEARCH_REQUEST>(request)));
+    
+    matches = 0;
+    SearchResults results;
+    if (response.header.type != MessageType::SEARCH_RESPONSE ||
+        !PayloadCodec::decode<MessageType::SEARCH_RESPONSE>(response.payload, results)) {
+        return {};
+    }
+    
+    matches = results.matches;
+    return std::vector<SearchResult>(results.hits.begin(), results.hits.end());
+}
+
+std::vector<DictionaryEntry> Client::autocomplete(const std::string& prefix, size_t limit) {
+    AutocompleteQuery query;
+    query.prefix = prefix;
+    query.limit = static_cast<uint32_t>(limit);
+    Message response = sendMessageSync(Message(MessageType::AUTOCOMPLETE_REQUEST,
+                                               PayloadCodec::encode<MessageType::AUTOCOMPLETE_REQUEST>(query)));
+    
+    DictionaryEntries reply;
+    if (response.header.type != MessageType::AUTOCOMPLETE_RESPONSE ||
+        !PayloadCodec::decode<MessageType::AUTOCOMPLETE_RESPONSE>(response.payload, reply)) {
+        return {};
+    }
+    return std::vector<DictionaryEntry>(reply.entries.begin(), reply.entries.end());
+}
+
+std::vector<DictionaryEntry> Client::lookupWord(const std::string& word, uint8_t maxDistance, size_t limit) {
+    WordQuery query;
+    query.word = word;
+    query.maxDistance = maxDistance;
+    query.limit = static_cast<uint32_t>(limit);
+    Message response = sendMessageSync(Message(MessageType::LOOKUP_WORD_REQUEST,
+                                               PayloadCodec::encode<MessageType::LOOKUP_WORD_REQUEST>(query)));
+    
+    DictionaryEntries reply;
+    if (response.header.type != MessageType::LOOKUP_WORD_RESPONSE ||
+        !PayloadCodec::decode<MessageType::LOOKUP_WORD_RESPONSE>(response.payload, reply)) {
+        return {};
+    }
+    return std::vector<DictionaryEntry>(reply.entries.begin(), reply.entries.end());
+}
+
+std::vector<LeaderboardEntry> Client::getLeaderboard(const std::string& mode, const std::string& board,
+                                                     size_t count, size_t& myRank, size_t& total) {
+    LeaderboardQuery query;
+    query.mode = mode;
+    query.board = board;
+    query.count = static_cast<uint32_t>(count);
+    Message request(MessageType::GET_LEADERBOARD_REQUEST,
+                    PayloadCodec::encode<MessageType::GET_LEADERBOARD_REQUEST>(query));
     Message response = sendMessageSync(request);
     
-    if (response.header.type == MessageType::GET_FEEDBACK_RESPONSE) {
-        return Utils::split(response.payload, ';');
+    myRank = 0;
+    total = 0;
+    LeaderboardPage page;
+    if (response.header.type != MessageType::GET_LEADERBOARD_RESPONSE ||
+        !PayloadCodec::decode<MessageType::GET_LEADERBOARD_RESPONSE>(response.payload, page)) {
+        return {};
     }
     
-    return {};
+    myRank = page.rank;
+    total = page.total;
+    return std::vector<LeaderboardEntry>(page.entries.begin(), page.entries.end());
 }
 
 bool Client::sendHeartbeat() {
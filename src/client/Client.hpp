@@ -7,6 +7,20 @@
 #include "../protocol/Network.hpp"
 #include "../utils/Logger.hpp"
 #include "../utils/Parser.hpp"
+#include "ContentCache.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <random>
+#include <thread>
+
+// Reconnecting after a dropped connection: each attempt waits a random time up to an
+// exponentially growing cap, so clients dropped together do not reconnect together
+struct ReconnectPolicy {
+    int maxAttempts = 3;      // 0 = never reconnect
+    int baseDelayMs = 250;
+    int maxDelayMs = 8000;
+};
 
 // Client class for connecting to server and handling communication
 class Client {
@@ -23,7 +37,15 @@ public:
     // Check if connected
     bool isConnected() const { return connected_; }
     
-    // Send message and wait for response
+    void setReconnectPolicy(const ReconnectPolicy& policy) { reconnectPolicy_ = policy; }
+    
+    // Keep lesson lists and lesson content on disk as well, across runs
+    bool setContentCacheDirectory(const std::string& directory) { return contentCache_.setDirectory(directory); }
+    
+    // Send message and wait for the response carrying its sequence number;
+    // server pushes arriving meanwhile are kept for pollMessages()/receiveMessage().
+    // A dropped connection is re-established (and the session resumed); the request is
+    // sent again only if it is idempotent, otherwise the call fails.
     Message sendMessageSync(const Message& message);
     
     // Send message asynchronously
@@ -40,41 +62,173 @@ public:
     bool login(const std::string& username, const std::string& password, UserData& userData);
     bool logout();
     
-    // Study operations
+    // Re-authenticate a new connection with the token from the last login (no password);
+    // fills role and level, keeps the other userData fields
+    bool resumeSession(UserData& userData);
+    const std::string& getResumeToken() const { return resumeToken_; }
+    
+    // Study operations. Fetching the lesson list prefetches the next few lessons in the
+    // background; lesson content known to be current is answered without a round trip.
     bool setLevel(ProficiencyLevel level);
     std::vector<std::string> getLessonList();
     std::string getLessonContent(const std::string& lessonId);
     
     // Exercise operations
-    bool submitQuiz(const std::string& quizId, const std::string& answers, int& score);
+    bool submitQuiz(const std::string& quizId, const std::vector<std::string>& answers, int& score);
     bool submitExercise(const std::string& exerciseId, const std::string& content, int& score);
     
+    // Stream a recording (16-bit mono PCM) of a sentence for pronunciation scoring.
+    // reference = true (teachers) makes it the sentence's template instead of scoring it.
+    bool submitPronunciation(const std::string& sentenceId, const std::vector<int16_t>& samples,
+                             int sampleRate, bool reference, int& score, int& similarity);
+    
     // Game operations
-    std::string startGame(const std::string& gameType);
+    bool startGame(const std::string& gameType, uint64_t& sessionId, std::vector<std::string>& items);
     bool sendGameMove(const std::string& moveData, std::string& response);
     
     // Communication operations
     bool sendChatMessage(const std::string& recipient, const std::string& message);
     bool initiateVoiceCall(const std::string& targetUser);
+    bool initiateVoiceCall(const std::string& targetUser, uint32_t& callId);
+    
+    // Answer an incoming VOICE_CALL_REQUEST; relayPort/token address the UDP media relay
+    bool acceptVoiceCall(uint32_t callId, int& relayPort, uint32_t& token);
+    bool rejectVoiceCall(uint32_t callId);
+    bool endVoiceCall(uint32_t callId);
     
-    // Score and feedback
+    // Score and feedback (sendFeedback: teachers, text may be multi-line). getFeedback keeps
+    // the history and asks only for entries newer than the ones it has.
     int getScore();
+    bool sendFeedback(const std::string& student, const std::string& exerciseId, const std::string& text);
     std::vector<std::string> getFeedback();
+    std::vector<std::string> getReviewQueue(size_t count = 10);
+    
+    // Bulk writes (sendFeedbackBatch: teachers, addGameItems: admins), sent in as few requests
+    // as the message size allows. statuses gets one ErrorCode per record, in order; returns
+    // the number of records applied.
+    size_t sendFeedbackBatch(const std::vector<FeedbackSubmission>& notes, std::vector<ErrorCode>& statuses);
+    size_t addGameItems(const std::vector<GameItemSubmission>& items, std::vector<ErrorCode>& statuses);
+    
+    // Admins: have the server import a curriculum file from its import directory; report is
+    // the server's summary and first errors, or the error description
+    bool importContent(const std::string& fileName, std::string& report);
+    
+    // Lessons and game items containing every word of query, best match first; level 1-3
+    // searches one level, 0 all of them. matches gets the number found in all.
+    std::vector<SearchResult> search(const std::string& query, uint8_t level, size_t limit, size_t& matches);
+    
+    // Dictionary words starting with prefix, alphabetically
+    std::vector<DictionaryEntry> autocomplete(const std::string& prefix, size_t limit = 10);
+    
+    // The word with its gloss; when it is not in the dictionary, the words within
+    // maxDistance (at most 2) typos of it, closest first. Empty when nothing matches.
+    std::vector<DictionaryEntry> lookupWord(const std::string& word, uint8_t maxDistance = 1, size_t limit = 10);
+    
+    // Leaderboard rows; mode is "top" or "around", board is "global", "level" (own level) or "level:N"
+    std::vector<LeaderboardEntry> getLeaderboard(const std::string& mode, const std::string& board,
+                                                 size_t count, size_t& myRank, size_t& total);
     
     // Heartbeat
     bool sendHeartbeat();
 
 private:
+    enum class WaitResult {
+        REPLY,
+        TIMEOUT,
+        CONNECTION_LOST,
+        CANCELLED       // a prefetch given up because the client is disconnecting
+    };
+    
+    // Receive into receiveBuffer_; notices a closed or failed connection
     bool receiveData();
     
+    // Socket helpers; the caller holds socketMutex_ (except in connect())
+    bool openSocket();
+    bool sendFrame(const Message& message);
+    void connectionLost();
+    
+    // Move complete frames out of receiveBuffer_: replies to awaited or in-flight requests
+    // into replies_, anything else into pendingMessages_
+    void routeMessages(uint32_t awaited);
+    
+    // Wait for the reply to sequenceNumber. With lock, socketMutex_ is released between polls,
+    // so other requests (and a disconnect) are not held up for the whole wait.
+    WaitResult waitForReply(uint32_t sequenceNumber, Message& reply, std::unique_lock<std::mutex>* lock = nullptr);
+    
+    enum class ReconnectResult {
+        RECONNECTED,    // session resumed (or there was none) and idempotent requests resent
+        SESSION_LOST,   // connected, but the session could not be resumed: nothing was resent
+        FAILED
+    };
+    
+    // Reconnect with backoff, spending at most attemptsLeft connects (shared by the whole
+    // request), resume the session and resend idempotent in-flight requests
+    ReconnectResult reconnect(int& attemptsLeft);
+    
+    // Send request with the version of the reply kept in contentCache_ under key; a
+    // NOT_MODIFIED answer returns the kept reply instead, a fresh REPLY is kept
+    template <MessageType TYPE, MessageType REPLY>
+    Message fetchVersioned(PayloadCodec::PayloadType<TYPE> request, const std::string& key);
+    
+    // Lesson content from the server (conditionally), remembering the content version seen
+    Message fetchLessonContent(const std::string& lessonId);
+    void noteContentVersion(uint64_t version);
+    void forgetFeedback();
+    
+    // Queue the lessons after the one opened last that are not cached at the current version
+    void schedulePrefetch(const std::vector<std::string>& lessons);
+    
+    // Background thread: fetch queued lessons one at a time while no other request is waiting
+    void prefetchLoop();
+    void stopPrefetch();
+    
+    // Send records as TYPE batch requests, each filled up to the message size; a batch the
+    // server is too busy for is retried after a pause
+    template <MessageType TYPE, typename Record>
+    size_t sendBatches(const std::vector<Record>& records, std::vector<ErrorCode>& statuses);
+    
+    static constexpr int BATCH_RETRIES = 5;
+    static constexpr int BATCH_RETRY_MS = 250;         // doubled after each retry
+    
+    static constexpr size_t PREFETCH_LESSONS = 3;
+    static constexpr int PREFETCH_INTERVAL_MS = 100;   // spreads prefetches out for the server
+    
     SOCKET socket_;
     std::string serverAddress_;
     int serverPort_;
-    bool connected_;
+    std::atomic<bool> connected_;               // read by the prefetch thread
     
     std::string receiveBuffer_;
+    std::vector<Message> pendingMessages_;   // pushes received while waiting for a response
+    std::map<uint32_t, Message> replies_;    // replies received for another waiting request
+    std::string resumeToken_;
+    
+    ReconnectPolicy reconnectPolicy_;
+    bool autoReconnect_;                        // between connect() and disconnect()
+    // Requests sent but not answered, by sequence number, one per waiting sendMessageSync
+    // call (a foreground request and the prefetcher can both wait); a reconnect replays the
+    // idempotent ones and drops the rest.
+    std::map<uint32_t, Message> inFlight_;
+    std::mt19937 rng_;
     Protocol protocol_;
     
+    ProficiencyLevel level_;                     // picks the lesson list entry
+    ContentCache contentCache_;                  // lessons:<level>, lesson:<id>; shared by users
+    std::atomic<uint64_t> contentVersion_;       // newest lesson content version the server reported
+    std::string lastLesson_;                     // opened last, prefetching continues after it
+    std::mutex lastLessonMutex_;
+    
+    std::vector<FeedbackEntry> feedback_;        // this user's history, oldest first
+    uint64_t feedbackEpoch_;                     // server epoch the history was read in
+    std::mutex feedbackMutex_;
+    
+    std::deque<std::string> prefetchQueue_;      // lesson ids
+    std::thread prefetchThread_;
+    std::mutex prefetchMutex_;
+    std::condition_variable prefetchReady_;
+    std::atomic<bool> prefetchStopping_;         // also ends a prefetch waiting for its reply
+    std::atomic<int> foregroundRequests_;        // sendMessageSync calls not made by the prefetcher
+    
     std::mutex socketMutex_;
 };
 
@@ -14,6 +14,17 @@
 ConsoleClient::ConsoleClient() 
     : running_(true), connected_(false), authenticated_(false) {
     client_ = std::make_unique<Client>();
+    
+    std::map<std::string, std::string> config;
+    if (Parser::parseConfigFile("config/client_config.json", config)) {
+        ReconnectPolicy policy;
+        if (config.count("reconnect_attempts")) policy.maxAttempts = std::stoi(config["reconnect_attempts"]);
+        if (config.count("reconnect_base_ms")) policy.baseDelayMs = std::stoi(config["reconnect_base_ms"]);
+        if (config.count("reconnect_max_ms")) policy.maxDelayMs = std::stoi(config["reconnect_max_ms"]);
+        client_->setReconnectPolicy(policy);
+        
+        if (config.count("content_cache_dir")) client_->setContentCacheDirectory(config["content_cache_dir"]);
+    }
 }
 
 ConsoleClient::~ConsoleClient() {
@@ -218,24 +229,34 @@ void ConsoleClient::studentMenu() {
     printMenu({
         "Set Proficiency Level",
         "Browse Lessons",
+        "Search Lessons & Vocabulary",
+        "Dictionary",
         "Submit Quiz",
         "Submit Exercise",
+        "Pronunciation Practice",
         "Play Game",
         "Chat",
         "View Score & Feedback",
+        "Review Due Items",
+        "Leaderboard",
         "Logout"
     });
     
-    int choice = getChoice(8);
+    int choice = getChoice(13);
     switch (choice) {
         case 1: setLevel(); break;
         case 2: browseLessons(); break;
-        case 3: submitQuiz(); break;
-        case 4: submitExercise(); break;
-        case 5: playGame(); break;
-        case 6: chat(); break;
-        case 7: viewScoreAndFeedback(); break;
-        case 8: logout(); break;
+        case 3: searchContent(); break;
+        case 4: useDictionary(); break;
+        case 5: submitQuiz(); break;
+        case 6: submitExercise(); break;
+        case 7: practicePronunciation(); break;
+        case 8: playGame(); break;
+        case 9: chat(); break;
+        case 10: viewScoreAndFeedback(); break;
+        case 11: viewReviewQueue(); break;
+        case 12: viewLeaderboard(); break;
+        case 13: logout(); break;
     }
 }
 
@@ -310,17 +331,95 @@ void ConsoleClient::browseLessons() {
     }
 }
 
+void ConsoleClient::searchContent() {
+    clearScreen();
+    printHeader("Search Lessons & Vocabulary");
+    
+    std::string query = getInput("Search for: ");
+    if (query.empty()) {
+        return;
+    }
+    std::string scope = getInput("Only my level? (y/n): ");
+    uint8_t level = (scope == "y" || scope == "Y") ? static_cast<uint8_t>(currentUser_.level) : 0;
+    
+    size_t matches = 0;
+    std::vector<SearchResult> results = client_->search(query, level, 10, matches);
+    if (results.empty()) {
+        printError("Nothing found for \"" + query + "\"");
+        pause();
+        return;
+    }
+    
+    std::cout << "\n" << matches << " found, best " << results.size() << ":\n" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SearchResult& result = results[i];
+        std::cout << "  " << (i + 1) << ". [L" << static_cast<int>(result.level) << "] ";
+        if (result.kind == static_cast<uint8_t>(SearchKind::LESSON)) {
+            std::cout << result.title << " (lesson " << result.key << ")" << std::endl;
+        } else {
+            std::cout << result.title << " (" << result.key << ")" << std::endl;
+        }
+    }
+    
+    std::cout << "\n  0. Back" << std::endl;
+    
+    int choice = getChoice(results.size());
+    if (choice > 0 && results[choice - 1].kind == static_cast<uint8_t>(SearchKind::LESSON)) {
+        clearScreen();
+        printHeader("Lesson: " + results[choice - 1].key + ":" + results[choice - 1].title);
+        
+        std::string content = client_->getLessonContent(results[choice - 1].key);
+        std::cout << "\n" << content << "\n" << std::endl;
+        
+        pause();
+    }
+}
+
+void ConsoleClient::useDictionary() {
+    clearScreen();
+    printHeader("Dictionary");
+    std::cout << "Enter a word to look it up, or the start of one followed by * to complete it." << std::endl;
+    
+    while (true) {
+        std::string input = getInput("\nWord (empty to go back): ");
+        if (input.empty()) {
+            return;
+        }
+        
+        std::vector<DictionaryEntry> entries;
+        if (input.back() == '*') {
+            input.pop_back();
+            if (!input.empty()) entries = client_->autocomplete(input);
+        } else {
+            entries = client_->lookupWord(input, 2);
+        }
+        if (entries.empty()) {
+            printError("No words found for \"" + input + "\"");
+            continue;
+        }
+        
+        if (entries[0].distance > 0) {
+            std::cout << "Not found. Did you mean:" << std::endl;
+        }
+        for (const DictionaryEntry& entry : entries) {
+            std::cout << "  " << entry.word;
+            if (!entry.gloss.empty()) std::cout << " - " << entry.gloss;
+            std::cout << std::endl;
+        }
+    }
+}
+
 void ConsoleClient::submitQuiz() {
     clearScreen();
     printHeader("Submit Quiz");
     
     std::string quizId = getInput("Quiz ID: ");
-    std::string answers = getInput("Your answers: ");
+    std::string answers = getInput("Your answers (separated by ';', e.g. B;AC;free text): ");
     
     std::cout << "\nSubmitting quiz..." << std::endl;
     
     int score = 0;
-    if (client_->submitQuiz(quizId, answers, score)) {
+    if (client_->submitQuiz(quizId, Utils::split(answers, ';'), score)) {
         printSuccess("✓ Quiz submitted successfully!");
         std::cout << "Score: +" << score << " points" << std::endl;
         currentUser_.score += score;
@@ -358,6 +457,36 @@ void ConsoleClient::submitExercise() {
     pause();
 }
 
+void ConsoleClient::practicePronunciation() {
+    clearScreen();
+    printHeader("Pronunciation Practice");
+    
+    std::string sentenceId = getInput("Sentence ID: ");
+    std::string path = getInput("Recording (16-bit PCM .wav): ");
+    
+    std::vector<int16_t> samples;
+    int sampleRate = 0;
+    if (!loadWavFile(path, samples, sampleRate)) {
+        printError("✗ Could not read a 16-bit PCM WAV file from " + path);
+        pause();
+        return;
+    }
+    
+    std::cout << "Uploading " << samples.size() / static_cast<size_t>(sampleRate) << "s of audio..." << std::endl;
+    
+    int score = 0, similarity = 0;
+    if (client_->submitPronunciation(sentenceId, samples, sampleRate, false, score, similarity)) {
+        printSuccess("✓ Recording scored!");
+        std::cout << "Similarity to reference: " << similarity << "%" << std::endl;
+        std::cout << "Score: +" << score << " points" << std::endl;
+        currentUser_.score += score;
+    } else {
+        printError("✗ Failed to score recording");
+    }
+    
+    pause();
+}
+
 void ConsoleClient::playGame() {
     clearScreen();
     printHeader("Play Game");
@@ -378,12 +507,16 @@ void ConsoleClient::playGame() {
     
     std::cout << "\nStarting " << gameType << "..." << std::endl;
     
-    std::string gameData = client_->startGame(gameType);
-    if (!gameData.empty()) {
-        std::cout << "\nGame started!" << std::endl;
-        std::cout << gameData << "\n" << std::endl;
+    uint64_t sessionId = 0;
+    std::vector<std::string> items;
+    if (client_->startGame(gameType, sessionId, items)) {
+        std::cout << "\nGame " << sessionId << " started!" << std::endl;
+        for (const auto& item : items) {
+            std::cout << "  " << item << std::endl;
+        }
+        std::cout << std::endl;
         
-        std::string move = getInput("Enter your move: ");
+        std::string move = getInput("Enter your move (word=answer): ");
         std::string response;
         
         if (client_->sendGameMove(move, response)) {
@@ -434,6 +567,66 @@ void ConsoleClient::viewScoreAndFeedback() {
     pause();
 }
 
+void ConsoleClient::viewReviewQueue() {
+    clearScreen();
+    printHeader("Review Due Items");
+    
+    std::vector<std::string> items = client_->getReviewQueue(10);
+    
+    if (items.empty()) {
+        std::cout << "Nothing to review right now. Keep practicing!" << std::endl;
+    } else {
+        std::cout << "Items due for review (most overdue first):\n" << std::endl;
+        for (size_t i = 0; i < items.size(); ++i) {
+            std::cout << "  " << (i + 1) << ". " << items[i] << std::endl;
+        }
+    }
+    
+    pause();
+}
+
+void ConsoleClient::viewLeaderboard() {
+    clearScreen();
+    printHeader("Leaderboard");
+    
+    printMenu({
+        "Global Top 10",
+        "My Level Top 10",
+        "Around Me (global)",
+        "Beginner / Intermediate / Advanced Board"
+    });
+    
+    int choice = getChoice(4);
+    std::string mode = "top";
+    std::string board = "global";
+    switch (choice) {
+        case 2: board = "level"; break;
+        case 3: mode = "around"; break;
+        case 4: {
+            std::string levelStr = getInput("Level (1-3): ");
+            board = "level:" + levelStr;
+            break;
+        }
+        default: break;
+    }
+    
+    size_t myRank = 0, total = 0;
+    std::vector<LeaderboardEntry> rows = client_->getLeaderboard(mode, board, mode == "top" ? 10 : 3, myRank, total);
+    
+    std::cout << "\n  Rank  Student              Score" << std::endl;
+    std::cout << "  ----  -------------------  -----" << std::endl;
+    for (const auto& row : rows) {
+        std::cout << "  " << std::setw(4) << row.rank << "  " << std::left << std::setw(19) << row.username
+                  << std::right << "  " << std::setw(5) << row.score << std::endl;
+    }
+    
+    std::cout << "\n" << total << " students on this board";
+    if (myRank > 0) std::cout << ", you are #" << myRank;
+    std::cout << std::endl;
+    
+    pause();
+}
+
 // ==================== Teacher Menu ====================
 void ConsoleClient::teacherMenu() {
     clearScreen();
@@ -444,14 +637,18 @@ void ConsoleClient::teacherMenu() {
     printMenu({
         "Provide Feedback to Student",
         "Chat with Student",
+        "View Leaderboard",
+        "Record Pronunciation Reference",
         "Logout"
     });
     
-    int choice = getChoice(3);
+    int choice = getChoice(5);
     switch (choice) {
         case 1: provideFeedback(); break;
         case 2: chatWithStudent(); break;
-        case 3: logout(); break;
+        case 3: viewLeaderboard(); break;
+        case 4: recordPronunciationReference(); break;
+        case 5: logout(); break;
     }
 }
 
@@ -470,12 +667,7 @@ void ConsoleClient::provideFeedback() {
         feedback += line + "\n";
     }
     
-    // Send feedback using SEND_FEEDBACK_REQUEST
-    std::string payload = studentName + "|" + exerciseId + "|" + feedback;
-    Message request(MessageType::SEND_FEEDBACK_REQUEST, payload);
-    Message response = client_->sendMessageSync(request);
-    
-    if (response.header.type == MessageType::SEND_FEEDBACK_SUCCESS) {
+    if (client_->sendFeedback(studentName, exerciseId, feedback)) {
         printSuccess("✓ Feedback sent to " + studentName);
     } else {
         printError("✗ Failed to send feedback");
@@ -500,6 +692,31 @@ void ConsoleClient::chatWithStudent() {
     pause();
 }
 
+void ConsoleClient::recordPronunciationReference() {
+    clearScreen();
+    printHeader("Record Pronunciation Reference");
+    
+    std::string sentenceId = getInput("Sentence ID: ");
+    std::string path = getInput("Reference recording (16-bit PCM .wav): ");
+    
+    std::vector<int16_t> samples;
+    int sampleRate = 0;
+    if (!loadWavFile(path, samples, sampleRate)) {
+        printError("✗ Could not read a 16-bit PCM WAV file from " + path);
+        pause();
+        return;
+    }
+    
+    int score = 0, similarity = 0;
+    if (client_->submitPronunciation(sentenceId, samples, sampleRate, true, score, similarity)) {
+        printSuccess("✓ Reference saved for " + sentenceId);
+    } else {
+        printError("✗ Failed to save reference");
+    }
+    
+    pause();
+}
+
 // ==================== Admin Menu ====================
 void ConsoleClient::adminMenu() {
     clearScreen();
@@ -509,14 +726,34 @@ void ConsoleClient::adminMenu() {
     
     printMenu({
         "Add Game Content",
+        "Import Content File",
         "Logout"
     });
     
-    int choice = getChoice(2);
+    int choice = getChoice(3);
     switch (choice) {
         case 1: addGameContent(); break;
-        case 2: logout(); break;
+        case 2: importContent(); break;
+        case 3: logout(); break;
+    }
+}
+
+void ConsoleClient::importContent() {
+    clearScreen();
+    printHeader("Import Content File");
+    
+    std::cout << "Lessons and game items in CSV or JSONL, from the server's import directory.\n" << std::endl;
+    std::string fileName = getInput("File name: ");
+    
+    std::string report;
+    if (client_->importContent(fileName, report)) {
+        printSuccess("✓ Import finished");
+    } else {
+        printError("✗ Import failed");
     }
+    std::cout << report << std::endl;
+    
+    pause();
 }
 
 void ConsoleClient::addGameContent() {
@@ -560,9 +797,14 @@ void ConsoleClient::addGameContent() {
             break;
     }
     
+    std::string levelStr = getInput("Difficulty level (1=Beginner, 2=Intermediate, 3=Advanced) [1]: ");
+    
     // Send to server
-    std::string payload = gameType + "|" + itemData;
-    Message request(MessageType::ADD_GAME_ITEM_REQUEST, payload);
+    GameItemRecord record;
+    record.gameType = gameType;
+    record.data = itemData;
+    record.level = static_cast<uint8_t>(levelStr.empty() ? 1 : std::atoi(levelStr.c_str()));
+    Message request(MessageType::ADD_GAME_ITEM_REQUEST, PayloadCodec::encode<MessageType::ADD_GAME_ITEM_REQUEST>(record));
     Message response = client_->sendMessageSync(request);
     
     if (response.header.type == MessageType::ADD_GAME_ITEM_SUCCESS) {
@@ -574,6 +816,60 @@ void ConsoleClient::addGameContent() {
     pause();
 }
 
+// ==================== Audio ====================
+bool ConsoleClient::loadWavFile(const std::string& path, std::vector<int16_t>& samples, int& sampleRate) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    
+    auto readU32 = [&file](uint32_t& value) {
+        unsigned char b[4];
+        if (!file.read(reinterpret_cast<char*>(b), 4)) return false;
+        value = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+        return true;
+    };
+    
+    char tag[4];
+    uint32_t size = 0;
+    if (!file.read(tag, 4) || std::string(tag, 4) != "RIFF" || !readU32(size) ||
+        !file.read(tag, 4) || std::string(tag, 4) != "WAVE") {
+        return false;
+    }
+    
+    uint16_t channels = 0, bitsPerSample = 0, format = 0;
+    while (file.read(tag, 4) && readU32(size)) {
+        std::string chunk(tag, 4);
+        if (chunk == "fmt ") {
+            std::vector<unsigned char> fmt(size);
+            if (size < 16 || !file.read(reinterpret_cast<char*>(fmt.data()), size)) return false;
+            format = fmt[0] | (fmt[1] << 8);
+            channels = fmt[2] | (fmt[3] << 8);
+            sampleRate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | (fmt[7] << 24);
+            bitsPerSample = fmt[14] | (fmt[15] << 8);
+        } else if (chunk == "data") {
+            if (format != 1 || bitsPerSample != 16 || channels == 0) return false;
+            
+            std::vector<unsigned char> data(size);
+            file.read(reinterpret_cast<char*>(data.data()), size);
+            size_t frames = static_cast<size_t>(file.gcount()) / (2 * channels);
+            
+            samples.resize(frames);
+            for (size_t i = 0; i < frames; ++i) {
+                int sum = 0;
+                for (size_t c = 0; c < channels; ++c) {
+                    size_t at = (i * channels + c) * 2;
+                    sum += static_cast<int16_t>(data[at] | (data[at + 1] << 8));
+                }
+                samples[i] = static_cast<int16_t>(sum / channels);
+            }
+            return frames > 0 && sampleRate > 0;
+        } else {
+            file.seekg(size + (size & 1), std::ios::cur);   // chunks are word aligned
+        }
+    }
+    
+    return false;
+}
+
 // ==================== UI Helpers ====================
 void ConsoleClient::clearScreen() {
     #ifdef _WIN32
@@ -32,20 +32,30 @@ private:
     void setLevel();
     void browseLessons();
     void viewLesson();
+    void searchContent();
+    void useDictionary();
     void submitQuiz();
     void submitExercise();
+    void practicePronunciation();
     void playGame();
     void chat();
     void viewScoreAndFeedback();
+    void viewReviewQueue();
+    void viewLeaderboard();
     
     // Teacher features
     void teacherMenu();
     void provideFeedback();
     void chatWithStudent();
+    void recordPronunciationReference();
     
     // Admin features
     void adminMenu();
     void addGameContent();
+    void importContent();
+    
+    // Load a 16-bit PCM WAV file, mixing stereo down to mono
+    static bool loadWavFile(const std::string& path, std::vector<int16_t>& samples, int& sampleRate);
     
     // UI helpers
     void clearScreen();
@@ -0,0 +1,163 @@
+#include "ContentCache.hpp"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char* const FILE_MAGIC = "ELPC1";
+    const char* const FILE_EXTENSION = ".cache";
+
+    // FNV-1a; only names files, the key inside the file is what counts
+    uint64_t hashKey(const std::string& key) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : key) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+ContentCache::ContentCache(size_t maxEntries, size_t maxBytes)
+    : maxEntries_(std::max<size_t>(1, maxEntries)), maxBytes_(maxBytes), bytes_(0) {
+}
+
+bool ContentCache::setDirectory(const std::string& directory) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error || !fs::is_directory(directory, error)) {
+        Logger::getInstance().warning("Content cache directory unusable: " + directory);
+        return false;
+    }
+
+    // Newest files first, so the caps keep what was used last
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    for (const auto& item : fs::directory_iterator(directory, error)) {
+        if (item.path().extension() == FILE_EXTENSION) {
+            files.emplace_back(item.last_write_time(error), item.path());
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+    for (const auto& file : files) {
+        std::string key;
+        Entry entry;
+        bool keep = slots_.size() < maxEntries_ && readFile(file.second.string(), key, entry) &&
+                    pathFor(key) == file.second.string() && !slots_.count(key);
+        if (!keep) {
+            fs::remove(file.second, error);
+            continue;
+        }
+        insert(key, std::move(entry), false);
+    }
+
+    Logger::getInstance().info("Content cache: " + std::to_string(slots_.size()) + " entries loaded from " + directory);
+    return true;
+}
+
+bool ContentCache::get(const std::string& key, Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = slots_.find(key);
+    if (it == slots_.end()) return false;
+
+    order_.splice(order_.begin(), order_, it->second.position);
+    entry = it->second.entry;
+    return true;
+}
+
+uint64_t ContentCache::versionOf(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = slots_.find(key);
+    return it == slots_.end() ? 0 : it->second.entry.version;
+}
+
+void ContentCache::put(const std::string& key, uint64_t version, const std::string& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Entry entry;
+    entry.version = version;
+    entry.payload = payload;
+    if (!directory_.empty() && !writeFile(key, entry)) {
+        Logger::getInstance().warning("Failed to write content cache entry " + key);
+    }
+    insert(key, std::move(entry), true);
+}
+
+void ContentCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    while (!slots_.empty()) {
+        remove(slots_.begin());
+    }
+}
+
+void ContentCache::insert(const std::string& key, Entry entry, bool mostRecent) {
+    auto it = slots_.find(key);
+    if (it != slots_.end()) {
+        bytes_ -= it->second.entry.payload.size();
+        order_.erase(it->second.position);
+        slots_.erase(it);
+    }
+
+    bytes_ += entry.payload.size();
+    Order::iterator position = mostRecent ? order_.insert(order_.begin(), key) : order_.insert(order_.end(), key);
+    slots_.emplace(key, Slot{std::move(entry), position});
+
+    // Least recent first (while loading that is the entry just read); a single entry over
+    // the byte cap is still kept
+    while (slots_.size() > 1 && (slots_.size() > maxEntries_ || bytes_ > maxBytes_)) {
+        remove(slots_.find(order_.back()));
+    }
+}
+
+void ContentCache::remove(Slots::iterator slot) {
+    if (!directory_.empty()) {
+        std::error_code error;
+        fs::remove(pathFor(slot->first), error);
+    }
+    bytes_ -= slot->second.entry.payload.size();
+    order_.erase(slot->second.position);
+    slots_.erase(slot);
+}
+
+std::string ContentCache::pathFor(const std::string& key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hashKey(key)));
+    return (fs::path(directory_) / (std::string(name) + FILE_EXTENSION)).string();
+}
+
+bool ContentCache::writeFile(const std::string& key, const Entry& entry) const {
+    // Write a temporary file and rename it, so a crash never leaves a torn entry
+    std::string path = pathFor(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << FILE_MAGIC << ' ' << entry.version << ' ' << key.size() << '\n';
+        out.write(key.data(), key.size());
+        out.write(entry.payload.data(), entry.payload.size());
+        if (!out) return false;
+    }
+
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    return !error;
+}
+
+bool ContentCache::readFile(const std::string& path, std::string& key, Entry& entry) {
+    std::ifstream in(path, std::ios::binary);
+    std::string magic;
+    size_t keyLength = 0;
+    if (!(in >> magic >> entry.version >> keyLength) || magic != FILE_MAGIC || in.get() != '\n') {
+        return false;
+    }
+
+    std::string rest((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (keyLength > rest.size()) return false;
+    key = rest.substr(0, keyLength);
+    entry.payload = rest.substr(keyLength);
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef CONTENT_CACHE_HPP
+#define CONTENT_CACHE_HPP
+
+#include "../../include/common.hpp"
+#include "../utils/Logger.hpp"
+#include <list>
+#include <unordered_map>
+
+// Replies to conditional requests, kept by request key with the content version they were
+// built from. The least recently used entries go once the entry or byte cap is reached.
+// With a directory set, entries are mirrored to one file each and survive restarts.
+// Thread-safe.
+class ContentCache {
+public:
+    struct Entry {
+        uint64_t version = 0;
+        std::string payload;
+    };
+
+    ContentCache(size_t maxEntries, size_t maxBytes);
+
+    // Mirror entries to directory (created if missing), loading the ones an earlier run left
+    // there; false when the directory cannot be used, the cache then stays in memory
+    bool setDirectory(const std::string& directory);
+
+    // Copy out the entry for key and mark it recently used
+    bool get(const std::string& key, Entry& entry);
+
+    // Version of the entry for key without touching its recency (0: none)
+    uint64_t versionOf(const std::string& key);
+
+    void put(const std::string& key, uint64_t version, const std::string& payload);
+
+    // Drop every entry, on disk too
+    void clear();
+
+private:
+    using Order = std::list<std::string>;   // keys, most recently used first
+
+    struct Slot {
+        Entry entry;
+        Order::iterator position;
+    };
+    using Slots = std::unordered_map<std::string, Slot>;
+
+    // Insert or replace without touching the disk; evicts down to the caps
+    void insert(const std::string& key, Entry entry, bool mostRecent);
+    void remove(Slots::iterator slot);
+
+    // Entry files are named after a hash of the key, which is stored inside to catch collisions
+    std::string pathFor(const std::string& key) const;
+    bool writeFile(const std::string& key, const Entry& entry) const;
+    static bool readFile(const std::string& path, std::string& key, Entry& entry);
+
+    Slots slots_;
+    Order order_;
+    size_t maxEntries_;
+    size_t maxBytes_;
+    size_t bytes_;
+    std::string directory_;
+    std::mutex mutex_;
+};
+
+#endif // CONTENT_CACHE_HPP
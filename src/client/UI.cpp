@@ -4,6 +4,7 @@ MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent), authenticated_(false) {
     
     client_ = std::make_unique<Client>();
+    client_->setContentCacheDirectory("cache/content");   // lessons open instantly on the next run too
     
     setupUI();
     updateConnectionStatus(false);
@@ -497,7 +498,7 @@ void MainWindow::onSubmitQuizClicked() {
     std::string answers = quizAnswersEdit_->toPlainText().toStdString();
     
     int score;
-    if (client_->submitQuiz(quizId, answers, score)) {
+    if (client_->submitQuiz(quizId, Utils::split(answers, ';'), score)) {
         exerciseScoreLabel_->setText(QString("Score: +%1").arg(score));
         showMessage("Success", QString("Quiz submitted! Score: %1").arg(score));
     } else {
@@ -531,10 +532,15 @@ void MainWindow::onStartGameClicked() {
     }
     
     std::string gameType = gameTypeComboBox_->currentText().toStdString();
-    std::string gameData = client_->startGame(gameType);
-    
-    if (!gameData.empty()) {
-        gameStateText_->setPlainText(QString::fromStdString("Game started!\n" + gameData));
+    uint64_t sessionId = 0;
+    std::vector<std::string> items;
+    
+    if (client_->startGame(gameType, sessionId, items)) {
+        std::string gameData = "Game " + std::to_string(sessionId) + " started!";
+        for (const auto& item : items) {
+            gameData += "\n" + item;
+        }
+        gameStateText_->setPlainText(QString::fromStdString(gameData));
         sendMoveButton_->setEnabled(true);
     } else {
         showMessage("Error", "Failed to start game");
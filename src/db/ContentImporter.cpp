@@ -0,0 +1,404 @@
+#include "ContentImporter.hpp"
+#include "../utils/Parser.hpp"
+#include <charconv>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <thread>
+
+namespace {
+    // One block's records, with its errors by line within the block
+    struct ParsedBlock {
+        ImportedContent content;
+        size_t lines = 0;
+        size_t records = 0;
+        size_t rejected = 0;
+        std::vector<std::pair<size_t, std::string>> errors;
+    };
+
+    // A record's fields by name, whichever format they came from
+    struct RecordFields {
+        std::string kind, level, id, title, body, game, data;
+
+        std::string* slot(std::string_view key) {
+            if (key == "kind") return &kind;
+            if (key == "level") return &level;
+            if (key == "id") return &id;
+            if (key == "title") return &title;
+            if (key == "body") return &body;
+            if (key == "game") return &game;
+            if (key == "data") return &data;
+            return nullptr;
+        }
+    };
+
+    bool hasAny(std::string_view text, std::string_view chars) {
+        return text.find_first_of(chars) != std::string_view::npos;
+    }
+
+    bool parseLevel(std::string_view text, ProficiencyLevel& level) {
+        text = Utils::trimView(text);
+        std::string upper(text);
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+        if (upper == "BEGINNER") { level = ProficiencyLevel::BEGINNER; return true; }
+        if (upper == "INTERMEDIATE") { level = ProficiencyLevel::INTERMEDIATE; return true; }
+        if (upper == "ADVANCED") { level = ProficiencyLevel::ADVANCED; return true; }
+        return text.size() == 1 && Parser::parseSetLevelRequest(text, level);
+    }
+
+    // Comma-separated fields; a quoted field may hold commas and "" for a quote
+    bool splitCsv(std::string_view line, std::vector<std::string>& fields, std::string& error) {
+        fields.clear();
+        size_t pos = 0;
+        while (true) {
+            std::string field;
+            if (pos < line.size() && line[pos] == '"') {
+                ++pos;
+                while (true) {
+                    if (pos >= line.size()) {
+                        error = "unterminated quoted field";
+                        return false;
+                    }
+                    if (line[pos] == '"') {
+                        if (pos + 1 < line.size() && line[pos + 1] == '"') {
+                            field += '"';
+                            pos += 2;
+                            continue;
+                        }
+                        ++pos;
+                        break;
+                    }
+                    field += line[pos++];
+                }
+                if (pos < line.size() && line[pos] != ',') {
+                    error = "text after a quoted field";
+                    return false;
+                }
+            } else {
+                size_t end = std::min(line.find(',', pos), line.size());
+                field.assign(line.substr(pos, end - pos));
+                pos = end;
+            }
+            fields.push_back(std::move(field));
+            if (pos >= line.size()) return true;
+            ++pos;   // the comma
+        }
+    }
+
+    bool csvRecord(std::string_view line, RecordFields& record, std::vector<std::string>& fields, std::string& error) {
+        if (!splitCsv(line, fields, error)) return false;
+        record.kind = Utils::trim(fields[0]);
+        if (record.kind == "lesson" && (fields.size() == 4 || fields.size() == 5)) {
+            record.level = fields[1];
+            record.id = fields[2];
+            record.title = fields[3];
+            if (fields.size() == 5) record.body = fields[4];
+            return true;
+        }
+        if (record.kind == "item" && fields.size() == 4) {
+            record.level = fields[1];
+            record.game = fields[2];
+            record.data = fields[3];
+            return true;
+        }
+        if (record.kind == "lesson" || record.kind == "item") {
+            error = "wrong number of fields";
+            return false;
+        }
+        return true;   // the kind is checked with the other fields
+    }
+
+    void skipSpace(std::string_view& in) {
+        while (!in.empty() && (in.front() == ' ' || in.front() == '\t')) in.remove_prefix(1);
+    }
+
+    bool takeHex4(std::string_view& in, uint32_t& value) {
+        if (in.size() < 4) return false;
+        auto parsed = std::from_chars(in.data(), in.data() + 4, value, 16);
+        if (parsed.ec != std::errc() || parsed.ptr != in.data() + 4) return false;
+        in.remove_prefix(4);
+        return true;
+    }
+
+    void appendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // A JSON string at the front of in, quotes included, unescaped into out
+    bool takeJsonString(std::string_view& in, std::string& out) {
+        if (in.empty() || in.front() != '"') return false;
+        in.remove_prefix(1);
+        out.clear();
+        while (!in.empty()) {
+            // Copy the run up to the next quote or escape at once
+            size_t run = std::min(in.find_first_of("\"\\"), in.size());
+            if (std::any_of(in.begin(), in.begin() + run, [](char c) { return static_cast<unsigned char>(c) < 0x20; })) {
+                return false;
+            }
+            out.append(in.data(), run);
+            in.remove_prefix(run);
+            if (in.empty()) return false;
+
+            char c = in.front();
+            in.remove_prefix(1);
+            if (c == '"') return true;
+            if (in.empty()) return false;
+            char escape = in.front();
+            in.remove_prefix(1);
+            switch (escape) {
+                case '"': case '\\': case '/': out += escape; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!takeHex4(in, cp) || (cp >= 0xDC00 && cp <= 0xDFFF)) return false;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        // A high surrogate: the low half must follow
+                        uint32_t low = 0;
+                        if (in.size() < 2 || in[0] != '\\' || in[1] != 'u') return false;
+                        in.remove_prefix(2);
+                        if (!takeHex4(in, low) || low < 0xDC00 || low > 0xDFFF) return false;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    // A flat JSON object whose values are strings or numbers (kept as text); unknown keys
+    // are ignored, nested values are not supported
+    bool jsonRecord(std::string_view line, RecordFields& record, std::string& error) {
+        error = "malformed JSON object";
+        skipSpace(line);
+        if (line.empty() || line.front() != '{') return false;
+        line.remove_prefix(1);
+        skipSpace(line);
+
+        std::string key, value;
+        if (!line.empty() && line.front() == '}') {
+            line.remove_prefix(1);
+        } else {
+            while (true) {
+                if (!takeJsonString(line, key)) return false;
+                skipSpace(line);
+                if (line.empty() || line.front() != ':') return false;
+                line.remove_prefix(1);
+                skipSpace(line);
+                if (!line.empty() && line.front() == '"') {
+                    if (!takeJsonString(line, value)) return false;
+                } else {
+                    size_t end = line.find_first_of(",} \t");
+                    if (end == 0 || end == std::string_view::npos) return false;
+                    value.assign(line.substr(0, end));
+                    if (value.find_first_not_of("0123456789.-+eE") != std::string::npos &&
+                        value != "true" && value != "false" && value != "null") {
+                        error = "unsupported value for \"" + key + "\"";
+                        return false;
+                    }
+                    line.remove_prefix(end);
+                }
+                if (std::string* slot = record.slot(key)) {
+                    *slot = std::move(value);
+                }
+
+                skipSpace(line);
+                if (line.empty()) return false;
+                char next = line.front();
+                line.remove_prefix(1);
+                if (next == '}') break;
+                if (next != ',') return false;
+                skipSpace(line);
+            }
+        }
+        skipSpace(line);
+        return line.empty();
+    }
+
+    // Validate a record and add it to content
+    bool addRecord(RecordFields& record, ImportedContent& content, std::string& error) {
+        ProficiencyLevel level;
+        if (record.kind == "lesson") {
+            std::string_view id = Utils::trimView(record.id);
+            std::string_view title = Utils::trimView(record.title);
+            if (!parseLevel(record.level, level)) error = "invalid level";
+            else if (id.empty() || title.empty()) error = "a lesson needs an id and a title";
+            else if (hasAny(id, ":|\n")) error = "a lesson id may not contain ':', '|' or a newline";
+            else if (hasAny(title, "\n")) error = "a lesson title may not contain a newline";
+            else if (record.body.size() > ContentImporter::MAX_LESSON_BODY) error = "lesson body too large";
+            else {
+                content.lessons.push_back(Lesson{std::string(id), std::string(title), std::move(record.body), level});
+                return true;
+            }
+            return false;
+        }
+        if (record.kind == "item") {
+            std::string_view game = Utils::trimView(record.game);
+            std::string_view data = Utils::trimView(record.data);
+            if (!parseLevel(record.level, level)) error = "invalid level";
+            else if (ContentImporter::validItem(game, data, error)) {
+                content.items.emplace_back(std::string(game), GameItem(std::string(data), level));
+                return true;
+            }
+            return false;
+        }
+        error = record.kind.empty() ? "missing kind" : "unknown kind \"" + record.kind.substr(0, 32) + "\"";
+        return false;
+    }
+
+    // Complete lines only, except in the last block of a file
+    ParsedBlock parseBlock(std::string_view block, ContentImporter::Format format) {
+        ParsedBlock out;
+        std::vector<std::string> fields;
+        std::string error;
+
+        size_t start = 0;
+        while (start < block.size()) {
+            size_t end = std::min(block.find('\n', start), block.size());
+            std::string_view line = block.substr(start, end - start);
+            size_t lineIndex = out.lines++;
+            start = end + 1;
+
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            std::string_view trimmed = Utils::trimView(line);
+            if (trimmed.empty() || trimmed.front() == '#') continue;
+
+            RecordFields record;
+            bool parsed = format == ContentImporter::Format::CSV ? csvRecord(line, record, fields, error)
+                                                                 : jsonRecord(line, record, error);
+            if (format == ContentImporter::Format::CSV && parsed && record.kind == "kind") {
+                continue;   // header
+            }
+
+            ++out.records;
+            if (!parsed || !addRecord(record, out.content, error)) {
+                ++out.rejected;
+                if (out.errors.size() < ImportReport::MAX_ERRORS) {
+                    out.errors.emplace_back(lineIndex, error);
+                }
+            }
+        }
+        return out;
+    }
+}
+
+std::string ImportReport::summary() const {
+    return std::to_string(records) + " records: " + std::to_string(lessons) + " lessons, " +
+           std::to_string(items) + " items, " + std::to_string(duplicates) + " duplicates, " +
+           std::to_string(rejected) + " rejected in " + std::to_string(elapsedMs) + " ms";
+}
+
+bool ContentImporter::validItem(std::string_view gameType, std::string_view data, std::string& error) {
+    if (gameType.empty() || data.empty()) error = "an item needs a game type and data";
+    else if (hasAny(gameType, "|\n")) error = "a game type may not contain '|' or a newline";
+    else if (hasAny(data, ";|\n")) error = "item data may not contain ';', '|' or a newline";
+    else if (data.size() > MAX_ITEM_BYTES) error = "item data too large";
+    else return true;
+    return false;
+}
+
+bool ContentImporter::formatOf(const std::string& path, Format& format) {
+    auto endsWith = [&path](std::string_view suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (endsWith(".csv")) {
+        format = Format::CSV;
+        return true;
+    }
+    if (endsWith(".jsonl") || endsWith(".ndjson")) {
+        format = Format::JSONL;
+        return true;
+    }
+    return false;
+}
+
+bool ContentImporter::parseFile(const std::string& path, ImportedContent& content, ImportReport& report,
+                                size_t threads) {
+    Format format;
+    if (!formatOf(path, format)) {
+        report.errors.push_back(path + ": unknown format, expected .csv or .jsonl");
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        report.errors.push_back(path + ": cannot open");
+        return false;
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Blocks are parsed as they are read, at most threads at a time, and merged in file
+    // order so line numbers and "last record wins" follow the file
+    std::deque<std::future<ParsedBlock>> pending;
+    size_t lineOffset = 0;
+    auto collect = [&]() {
+        ParsedBlock block = pending.front().get();
+        pending.pop_front();
+
+        report.records += block.records;
+        report.rejected += block.rejected;
+        for (auto& error : block.errors) {
+            if (report.errors.size() < ImportReport::MAX_ERRORS) {
+                report.errors.push_back("line " + std::to_string(lineOffset + error.first + 1) + ": " + error.second);
+            }
+        }
+        lineOffset += block.lines;
+
+        std::move(block.content.lessons.begin(), block.content.lessons.end(), std::back_inserter(content.lessons));
+        std::move(block.content.items.begin(), block.content.items.end(), std::back_inserter(content.items));
+    };
+
+    std::string carry;
+    while (true) {
+        std::string text = std::move(carry);
+        carry.clear();
+        size_t kept = text.size();
+        text.resize(kept + BLOCK_SIZE);
+        in.read(&text[kept], BLOCK_SIZE);
+        text.resize(kept + static_cast<size_t>(in.gcount()));
+        bool last = !in;
+
+        // A block ends after its last newline; the partial line starts the next one
+        if (!last) {
+            size_t cut = text.rfind('\n');
+            if (cut == std::string::npos) {
+                carry = std::move(text);
+                continue;
+            }
+            carry.assign(text, cut + 1, std::string::npos);
+            text.resize(cut + 1);
+        }
+
+        if (!text.empty()) {
+            if (pending.size() >= threads) collect();
+            pending.push_back(std::async(std::launch::async, [format, block = std::move(text)]() {
+                return parseBlock(block, format);
+            }));
+        }
+        if (last) break;
+    }
+    while (!pending.empty()) collect();
+
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef CONTENT_IMPORTER_HPP
+#define CONTENT_IMPORTER_HPP
+
+#include "../../include/common.hpp"
+#include "LessonCatalog.hpp"
+#include "GameCatalog.hpp"
+
+// What an import read and did
+struct ImportReport {
+    size_t records = 0;                 // lines holding a record
+    size_t lessons = 0;                 // lessons added or replaced
+    size_t items = 0;                   // game items added
+    size_t duplicates = 0;              // repeated in the file or already in the catalog
+    size_t rejected = 0;                // malformed records
+    std::vector<std::string> errors;    // the first MAX_ERRORS, "line N: reason"
+    uint64_t elapsedMs = 0;
+
+    static constexpr size_t MAX_ERRORS = 20;
+
+    std::string summary() const;
+};
+
+// Records parsed from a content file, in file order
+struct ImportedContent {
+    std::vector<Lesson> lessons;
+    std::vector<std::pair<std::string, GameItem>> items;   // (game type, item)
+};
+
+// Reads lesson and game item files, one record per line:
+//   CSV:   lesson,<level>,<id>,<title>[,<body>]   or   item,<level>,<game type>,<data>
+//          fields may be double-quoted ("" inside quotes is a quote); a first line starting
+//          with "kind" is a header
+//   JSONL: {"kind":"lesson","level":1,"id":"...","title":"...","body":"..."}
+//          {"kind":"item","level":"BEGINNER","game":"...","data":"..."}
+// Levels are 1-3 or BEGINNER / INTERMEDIATE / ADVANCED; empty lines and lines starting
+// with '#' are skipped. The file is streamed in blocks that are parsed on several threads,
+// so memory holds the parsed records and only a few blocks of raw text.
+class ContentImporter {
+public:
+    enum class Format { CSV, JSONL };
+
+    // By extension: .csv, .jsonl / .ndjson
+    static bool formatOf(const std::string& path, Format& format);
+
+    // false when the file cannot be opened or has an unknown extension (reported in errors);
+    // threads 0 = one per core
+    static bool parseFile(const std::string& path, ImportedContent& content, ImportReport& report,
+                          size_t threads = 0);
+
+    // Largest lesson body and item that still fit the replies that carry them
+    static constexpr size_t MAX_LESSON_BODY = AppConstants::MAX_MESSAGE_SIZE - 16;
+    static constexpr size_t MAX_ITEM_BYTES = 256;
+
+    // Whether a game item (type and data already trimmed) can be stored and sent in a
+    // GAME_START_RESPONSE; error says why not. Used for imports and ADD_GAME_ITEM(S) alike.
+    static bool validItem(std::string_view gameType, std::string_view data, std::string& error);
+
+    // Raw text handed to one parsing task
+    static constexpr size_t BLOCK_SIZE = 4 * 1024 * 1024;
+};
+
+#endif // CONTENT_IMPORTER_HPP
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <unordered_set>
 
 Database& Database::getInstance() {
     static Database instance;
@@ -9,32 +10,69 @@ Database& Database::getInstance() {
 }
 
 bool Database::initialize(const std::string& dbFile) {
+    // Versions count from the time the database was initialized, so one a client kept
+    // from an earlier run does not match by accident
+    versionEpoch_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    
     // No lock needed here - this is only called once at startup before any concurrent access
     dbFilePath_ = dbFile;
     
-    // Initialize sample lessons for each level
-    lessons_["BEGINNER"] = {
-        "lesson_b1:Greetings and Introductions",
-        "lesson_b2:Numbers and Time",
-        "lesson_b3:Family and Friends"
-    };
-    
-    lessons_["INTERMEDIATE"] = {
-        "lesson_i1:Travel and Transportation",
-        "lesson_i2:Food and Cooking",
-        "lesson_i3:Work and Career"
-    };
-    
-    lessons_["ADVANCED"] = {
-        "lesson_a1:Business Communication",
-        "lesson_a2:Academic Writing",
-        "lesson_a3:Cultural Studies"
+    // Sample lessons for each level; imports add to them or replace them by id
+    std::vector<Lesson> samples = {
+        {"lesson_b1", "Greetings and Introductions", "", ProficiencyLevel::BEGINNER},
+        {"lesson_b2", "Numbers and Time", "", ProficiencyLevel::BEGINNER},
+        {"lesson_b3", "Family and Friends", "", ProficiencyLevel::BEGINNER},
+        {"lesson_i1", "Travel and Transportation", "", ProficiencyLevel::INTERMEDIATE},
+        {"lesson_i2", "Food and Cooking", "", ProficiencyLevel::INTERMEDIATE},
+        {"lesson_i3", "Work and Career", "", ProficiencyLevel::INTERMEDIATE},
+        {"lesson_a1", "Business Communication", "", ProficiencyLevel::ADVANCED},
+        {"lesson_a2", "Academic Writing", "", ProficiencyLevel::ADVANCED},
+        {"lesson_a3", "Cultural Studies", "", ProficiencyLevel::ADVANCED}
     };
+    lessonCatalog_.addLessons(samples);
+    searchIndex_.addLessons(samples);
+    
+    // Initialize sample quizzes (one per beginner lesson) and exercises
+    quizBank_.addQuiz("quiz_b1", {
+        {QuestionKind::MULTIPLE_CHOICE, "B"},
+        {QuestionKind::MULTIPLE_CHOICE, "AC"},
+        {QuestionKind::SHORT_ANSWER, "Nice to meet you"}
+    });
+    quizBank_.addQuiz("quiz_b2", {
+        {QuestionKind::MULTIPLE_CHOICE, "C"},
+        {QuestionKind::SHORT_ANSWER, "twelve"},
+        {QuestionKind::SHORT_ANSWER, "half past three"}
+    });
+    quizBank_.addQuiz("quiz_b3", {
+        {QuestionKind::MULTIPLE_CHOICE, "A"},
+        {QuestionKind::MULTIPLE_CHOICE, "BD"},
+        {QuestionKind::SHORT_ANSWER, "brother"}
+    });
+    
+    quizBank_.addExercise("ex_b1", {"Hello, my name is", "Hi, my name is"});
+    quizBank_.addExercise("ex_b2", {"It is seven o'clock", "It's seven o'clock"});
+    quizBank_.addExercise("ex_b3", {"This is my sister"});
+    
+    // Spelling practice: partial credit for answers within two edits
+    ExerciseGrading spelling(GradingMode::FUZZY, 2);
+    quizBank_.addExercise("spell_b1", {"beautiful"}, 10, spelling);
+    quizBank_.addExercise("spell_b2", {"necessary"}, 10, spelling);
+    quizBank_.addExercise("spell_b3", {"definitely"}, 10, spelling);
+    
+    // Boards exist even before the first student joins them
+    leaderboards_["global"];
+    for (ProficiencyLevel level : {ProficiencyLevel::BEGINNER, ProficiencyLevel::INTERMEDIATE,
+                                   ProficiencyLevel::ADVANCED}) {
+        leaderboards_[levelBoardName(level)];
+    }
     
     // Create default admin user (these call createUser which has its own locking)
+    dummyHash_ = hashPassword(Crypto::toHex(Crypto::randomBytes(16)));
     createUser("admin", hashPassword("admin123"), UserRole::ADMIN);
     createUser("teacher1", hashPassword("teacher123"), UserRole::TEACHER);
     
+    lessonVersion_.store(versionEpoch_, std::memory_order_release);
     initialized_ = true;
     Logger::getInstance().info("Database initialized");
     
@@ -57,19 +95,47 @@ bool Database::createUser(const std::string& username, const std::string& passwo
     
     users_[username] = user;
     
+    if (role == UserRole::STUDENT) {
+        leaderboards_["global"].update(username, 0);
+        leaderboards_[levelBoardName(user.level)].update(username, 0);
+    }
+    
     Logger::getInstance().info("User created: " + username + " with role " + std::to_string(static_cast<int>(role)));
     return true;
 }
 
-bool Database::authenticateUser(const std::string& username, const std::string& passwordHash) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+bool Database::verifyPassword(const std::string& username, const std::string& password) {
+    std::string stored;
+    {
+        std::lock_guard<std::mutex> lock(dbMutex_);
+        auto it = users_.find(username);
+        if (it != users_.end()) {
+            stored = it->second.passwordHash;
+        }
+    }
     
-    auto it = users_.find(username);
-    if (it == users_.end()) {
+    // Unknown users still pay for one hash so response time does not reveal which names exist
+    if (stored.empty()) {
+        Crypto::verifyPassword(password, dummyHash_);
+        return false;
+    }
+    
+    // The expensive part runs without dbMutex_
+    if (!Crypto::verifyPassword(password, stored)) {
         return false;
     }
     
-    return it->second.passwordHash == passwordHash;
+    if (Crypto::needsRehash(stored, hashParams_)) {
+        std::string upgraded = hashPassword(password);
+        std::lock_guard<std::mutex> lock(dbMutex_);
+        auto it = users_.find(username);
+        if (it != users_.end() && it->second.passwordHash == stored) {
+            it->second.passwordHash = upgraded;
+            Logger::getInstance().info("Password hash upgraded for " + username);
+        }
+    }
+    
+    return true;
 }
 
 bool Database::getUserData(const std::string& username, UserData& userData) {
@@ -92,6 +158,11 @@ bool Database::updateUserLevel(const std::string& username, ProficiencyLevel lev
         return false;
     }
     
+    if (it->second.role == UserRole::STUDENT && it->second.level != level) {
+        leaderboards_[levelBoardName(it->second.level)].remove(username);
+        leaderboards_[levelBoardName(level)].update(username, it->second.score);
+    }
+    
     it->second.level = level;
     Logger::getInstance().info("User " + username + " level updated to " + std::to_string(static_cast<int>(level)));
     return true;
@@ -106,20 +177,65 @@ bool Database::updateUserScore(const std::string& username, int score) {
     }
     
     it->second.score += score;
+    if (it->second.role == UserRole::STUDENT) {
+        leaderboards_["global"].update(username, it->second.score);
+        leaderboards_[levelBoardName(it->second.level)].update(username, it->second.score);
+    }
+    
     Logger::getInstance().info("User " + username + " score updated: +" + std::to_string(score));
     return true;
 }
 
+bool Database::getUserScore(const std::string& username, int& score, size_t& rank) {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    
+    auto it = users_.find(username);
+    if (it == users_.end()) {
+        return false;
+    }
+    
+    score = it->second.score;
+    rank = leaderboards_["global"].getRank(username);
+    return true;
+}
+
+bool Database::queryLeaderboard(const std::string& board, const std::string& username, bool around,
+                                size_t count, LeaderboardView& view) {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    
+    auto it = leaderboards_.find(board);
+    if (it == leaderboards_.end()) {
+        return false;
+    }
+    
+    const Leaderboard& leaderboard = it->second;
+    view.rank = leaderboard.getRank(username);
+    view.total = leaderboard.size();
+    view.entries = around ? leaderboard.getAround(username, count) : leaderboard.getTop(count);
+    return true;
+}
+
+std::string Database::levelBoardName(ProficiencyLevel level) {
+    return "level:" + std::to_string(static_cast<int>(level));
+}
+
 bool Database::userExists(const std::string& username) {
     std::lock_guard<std::mutex> lock(dbMutex_);
     return users_.find(username) != users_.end();
 }
 
-bool Database::createSession(const std::string& username, SOCKET socket) {
+bool Database::createSession(const std::string& username, SOCKET socket, uint64_t connectionId) {
     std::lock_guard<std::mutex> lock(dbMutex_);
     
+    // Taking over from another connection: its socket no longer names this user
+    auto previous = sessions_.find(username);
+    if (previous != sessions_.end() && previous->second.socket != socket) {
+        socketToUser_.erase(previous->second.socket);
+    }
+    
     SessionData session;
     session.socket = socket;
+    session.connectionId = connectionId;
     session.username = username;
     session.state = ConnectionState::AUTHENTICATED;
     session.lastActivity = std::chrono::steady_clock::now();
@@ -136,11 +252,11 @@ bool Database::createSession(const std::string& username, SOCKET socket) {
     return true;
 }
 
-bool Database::removeSession(const std::string& username) {
+bool Database::removeSession(const std::string& username, uint64_t connectionId) {
     std::lock_guard<std::mutex> lock(dbMutex_);
     
     auto it = sessions_.find(username);
-    if (it == sessions_.end()) {
+    if (it == sessions_.end() || it->second.connectionId != connectionId) {
         return false;
     }
     
@@ -152,6 +268,13 @@ bool Database::removeSession(const std::string& username) {
     return true;
 }
 
+bool Database::holdsSession(const std::string& username, uint64_t connectionId) {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    
+    auto it = sessions_.find(username);
+    return it != sessions_.end() && it->second.connectionId == connectionId;
+}
+
 bool Database::getSessionByUsername(const std::string& username, SessionData& session) {
     std::lock_guard<std::mutex> lock(dbMutex_);
     
@@ -172,7 +295,13 @@ bool Database::getSessionBySocket(SOCKET socket, SessionData& session) {
         return false;
     }
     
-    return getSessionByUsername(it->second, session);
+    // dbMutex_ is held already, so not through getSessionByUsername
+    auto sessionIt = sessions_.find(it->second);
+    if (sessionIt == sessions_.end()) {
+        return false;
+    }
+    session = sessionIt->second;
+    return true;
 }
 
 std::vector<std::string> Database::getOnlineUsers() {
@@ -186,27 +315,59 @@ std::vector<std::string> Database::getOnlineUsers() {
     return users;
 }
 
-std::vector<std::string> Database::getLessonList(ProficiencyLevel level) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
-    
-    std::string levelStr;
-    switch (level) {
-        case ProficiencyLevel::BEGINNER: levelStr = "BEGINNER"; break;
-        case ProficiencyLevel::INTERMEDIATE: levelStr = "INTERMEDIATE"; break;
-        case ProficiencyLevel::ADVANCED: levelStr = "ADVANCED"; break;
+bool Database::hasLesson(const std::string& lessonId) const {
+    LessonCatalog::SnapshotPtr snapshot = lessonCatalog_.getSnapshot();
+    return snapshot->lessons.count(lessonId) > 0;
+}
+
+bool Database::getLessonContent(const std::string& lessonId, std::string& content) {
+    LessonCatalog::SnapshotPtr snapshot = lessonCatalog_.getSnapshot();
+    auto it = snapshot->lessons.find(lessonId);
+    if (it == snapshot->lessons.end()) {
+        return false;
     }
     
-    auto it = lessons_.find(levelStr);
-    if (it == lessons_.end()) {
-        return {};
+    if (!it->second.body.empty()) {
+        content = it->second.body;
+    } else {
+        // Lessons imported without a body, and the samples
+        content = "Content for lesson: " + lessonId + "\nVideo: video_url\nAudio: audio_url\nText: lesson_text";
     }
-    
-    return it->second;
+    return true;
+}
+
+bool Database::gradeQuiz(const std::string& quizId, const std::string_view* answers, size_t answerCount,
+                         GradeResult& result) {
+    // The quiz bank has its own reader/writer lock, grading does not contend on dbMutex_
+    return quizBank_.gradeQuiz(quizId, answers, answerCount, result);
+}
+
+bool Database::gradeExercise(const std::string& exerciseId, std::string_view answer, GradeResult& result) {
+    return quizBank_.gradeExercise(exerciseId, answer, result);
 }
 
-std::string Database::getLessonContent(const std::string& lessonId) {
-    // In a real implementation, this would fetch from a content database
-    return "Content for lesson: " + lessonId + "\nVideo: video_url\nAudio: audio_url\nText: lesson_text";
+bool Database::setPronunciationReference(const std::string& sentenceId, std::vector<float> features) {
+    return pronunciationBank_.setReference(sentenceId, std::move(features));
+}
+
+bool Database::hasPronunciationReference(const std::string& sentenceId) {
+    return pronunciationBank_.hasReference(sentenceId);
+}
+
+bool Database::scorePronunciation(const std::string& sentenceId, const std::vector<float>& features,
+                                  PronunciationResult& result) {
+    // Called from worker threads; the bank has its own lock and scores outside it
+    return pronunciationBank_.score(sentenceId, features, result);
+}
+
+void Database::recordReview(const std::string& username, const std::string& itemKey, int quality) {
+    // The scheduler has its own lock, reviews do not contend on dbMutex_
+    reviewScheduler_.recordReview(username, itemKey, quality, ReviewScheduler::currentMinute());
+}
+
+std::pmr::vector<std::pmr::string> Database::getReviewQueue(const std::string& username, size_t count,
+                                                            std::pmr::memory_resource* resource) {
+    return reviewScheduler_.getDueItems(username, count, ReviewScheduler::currentMinute(), resource);
 }
 
 bool Database::saveScore(const std::string& username, const std::string& exerciseId, int score) {
@@ -216,43 +377,153 @@ bool Database::saveScore(const std::string& username, const std::string& exercis
 
 bool Database::saveFeedback(const std::string& username, const std::string& exerciseId, 
                            const std::string& feedback, const std::string& fromUser) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+    // The log has its own lock, dbMutex_ is not needed here
+    uint64_t id = feedbackLog_.append(username, "Exercise: " + exerciseId + " | From: " + fromUser + " | " + feedback);
     
-    std::string feedbackEntry = "Exercise: " + exerciseId + " | From: " + fromUser + " | " + feedback;
-    feedbacks_[username].push_back(feedbackEntry);
-    
-    Logger::getInstance().info("Feedback saved for " + username + " from " + fromUser);
+    Logger::getInstance().info("Feedback " + std::to_string(id) + " saved for " + username + " from " + fromUser);
     return true;
 }
 
-std::vector<std::string> Database::getFeedback(const std::string& username) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+std::vector<ErrorCode> Database::saveFeedbackBatch(const std::vector<FeedbackSubmission>& notes,
+                                                   const std::string& fromUser) {
+    std::vector<ErrorCode> statuses(notes.size(), ErrorCode::SUCCESS);
+    std::vector<std::pair<std::string, std::string>> entries;
+    entries.reserve(notes.size());
+    {
+        std::lock_guard<std::mutex> lock(dbMutex_);
+        for (size_t i = 0; i < notes.size(); ++i) {
+            if (users_.find(notes[i].student) == users_.end()) {
+                statuses[i] = ErrorCode::USER_NOT_FOUND;
+                continue;
+            }
+            entries.emplace_back(notes[i].student, "Exercise: " + notes[i].exerciseId + " | From: " + fromUser +
+                                                   " | " + notes[i].text);
+        }
+    }
     
-    auto it = feedbacks_.find(username);
-    if (it == feedbacks_.end()) {
-        return {};
+    size_t saved = entries.size();
+    feedbackLog_.appendAll(std::move(entries));
+    
+    Logger::getInstance().info(std::to_string(saved) + " of " + std::to_string(notes.size()) +
+                               " feedback entries saved from " + fromUser);
+    return statuses;
+}
+
+std::vector<FeedbackEntry> Database::getFeedbackAfter(const std::string& username, uint64_t after, size_t limit,
+                                                      size_t maxBytes, bool& more) {
+    return feedbackLog_.readAfter(username, after, limit, maxBytes, more);
+}
+
+bool Database::addGameItem(const std::string& gameType, const std::string& itemData,
+                           ProficiencyLevel level) {
+    // The catalog serializes writers itself, dbMutex_ is not needed here
+    if (!gameCatalog_.addItem(gameType, itemData, level)) {
+        return false;
+    }
+    searchIndex_.addItems({{gameType, {GameItem(itemData, level)}}});
+    Logger::getInstance().info("Game item added to " + gameType);
+    return true;
+}
+
+std::vector<ErrorCode> Database::addGameItems(std::vector<std::pair<std::string, GameItem>> items) {
+    size_t requested = items.size();
+    std::vector<bool> kept;
+    std::map<std::string, std::vector<GameItem>> itemsByType = gameCatalog_.addNewItems(std::move(items), &kept);
+    
+    std::vector<ErrorCode> statuses(requested, ErrorCode::SUCCESS);
+    size_t count = 0;
+    for (size_t i = 0; i < requested; ++i) {
+        if (kept[i]) {
+            ++count;
+        } else {
+            statuses[i] = ErrorCode::ALREADY_EXISTS;
+        }
+    }
+    if (!itemsByType.empty()) {
+        searchIndex_.addItems(itemsByType);
+    }
+    Logger::getInstance().info(std::to_string(count) + " of " + std::to_string(requested) + " game items added to " +
+                               std::to_string(itemsByType.size()) + " game types");
+    return statuses;
+}
+
+bool Database::loadDictionary(const std::string& path, std::string& error) {
+    std::shared_ptr<const Dictionary> dictionary = Dictionary::load(path, error);
+    if (!dictionary) {
+        Logger::getInstance().warning("Dictionary not loaded: " + error);
+        return false;
     }
     
-    return it->second;
+    std::atomic_store(&dictionary_, dictionary);
+    Logger::getInstance().info("Dictionary loaded: " + std::to_string(dictionary->size()) + " words, " +
+                               std::to_string(dictionary->bytes() / 1024) + " KB");
+    return true;
 }
 
-bool Database::addGameItem(const std::string& gameType, const std::string& itemData) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
+bool Database::importContent(const std::string& path, ImportReport& report) {
+    auto started = std::chrono::steady_clock::now();
     
-    gameItems_[gameType].push_back(itemData);
-    Logger::getInstance().info("Game item added to " + gameType);
+    ImportedContent content;
+    if (!ContentImporter::parseFile(path, content, report, importThreads_)) {
+        Logger::getInstance().warning("Import failed: " + (report.errors.empty() ? path : report.errors.back()));
+        return false;
+    }
+    
+    // For lessons the last record of an id wins
+    {
+        std::unordered_set<std::string_view> ids;
+        for (const Lesson& lesson : content.lessons) {
+            ids.insert(lesson.id);
+        }
+        report.lessons = ids.size();
+        report.duplicates += content.lessons.size() - ids.size();
+    }
+    
+    // Each catalog builds its per-level indexes and swaps in its new snapshot, so an import
+    // is atomic per catalog: readers may briefly see the lessons before the items, or either
+    // before search finds them.
+    if (!content.lessons.empty()) {
+        lessonCatalog_.addLessons(content.lessons);
+        searchIndex_.addLessons(content.lessons);
+    }
+    
+    // Items repeated in the file or already in the catalog are skipped (the first one counts);
+    // the catalog checks under its write lock, so a concurrent import or add cannot slip in
+    size_t parsedItems = content.items.size();
+    std::map<std::string, std::vector<GameItem>> itemsByType = gameCatalog_.addNewItems(std::move(content.items));
+    for (const auto& group : itemsByType) {
+        report.items += group.second.size();
+    }
+    report.duplicates += parsedItems - report.items;
+    if (!itemsByType.empty()) {
+        searchIndex_.addItems(itemsByType);
+    }
+    if (report.lessons > 0) {
+        lessonVersion_.fetch_add(1, std::memory_order_release);
+    }
+    
+    report.elapsedMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    Logger::getInstance().info("Imported " + path + ": " + report.summary());
     return true;
 }
 
 std::vector<std::string> Database::getGameItems(const std::string& gameType) {
-    std::lock_guard<std::mutex> lock(dbMutex_);
-    
-    auto it = gameItems_.find(gameType);
-    if (it == gameItems_.end()) {
+    GameCatalog::SnapshotPtr snapshot = gameCatalog_.getSnapshot(gameType);
+    if (!snapshot) {
         return {};
     }
     
-    return it->second;
+    std::vector<std::string> items;
+    items.reserve(snapshot->items.size());
+    for (size_t i = 0; i < snapshot->items.size(); ++i) {
+        items.push_back(snapshot->items[i].data);
+    }
+    return items;
+}
+
+GameCatalog::SnapshotPtr Database::getGameSnapshot(const std::string& gameType) const {
+    return gameCatalog_.getSnapshot(gameType);
 }
 
 void Database::clearSessions() {
@@ -264,12 +535,7 @@ void Database::clearSessions() {
 }
 
 std::string Database::hashPassword(const std::string& password) {
-    // Simple hash function (in production, use proper crypto like bcrypt/scrypt)
-    std::hash<std::string> hasher;
-    size_t hash = hasher(password + "salt_value");
-    
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0') << std::setw(16) << hash;
-    return ss.str();
+    // Per-user random salt, memory-hard scrypt at the configured cost
+    return Crypto::hashPassword(password, hashParams_);
 }
 
@@ -4,6 +4,18 @@
 #include "../../include/common.hpp"
 #include "../../include/message_structs.hpp"
 #include "../utils/Logger.hpp"
+#include "GameCatalog.hpp"
+#include "LessonCatalog.hpp"
+#include "ContentImporter.hpp"
+#include "SearchIndex.hpp"
+#include "Dictionary.hpp"
+#include "QuizBank.hpp"
+#include "ReviewScheduler.hpp"
+#include "Leaderboard.hpp"
+#include "PronunciationBank.hpp"
+#include "FeedbackLog.hpp"
+#include "../utils/Crypto.hpp"
+#include <atomic>
 
 // Simple in-memory database for user management
 // In production, this would be replaced with SQLite or other DB
@@ -17,33 +29,103 @@ public:
     
     // User management
     bool createUser(const std::string& username, const std::string& passwordHash, UserRole role);
-    bool authenticateUser(const std::string& username, const std::string& passwordHash);
+    // Check a password against the user's salted hash; upgrades the hash if the cost
+    // parameters changed. Slow by design: call from a hashing thread, not the event loop.
+    bool verifyPassword(const std::string& username, const std::string& password);
     bool getUserData(const std::string& username, UserData& userData);
     bool updateUserLevel(const std::string& username, ProficiencyLevel level);
     bool updateUserScore(const std::string& username, int score);
+    bool getUserScore(const std::string& username, int& score, size_t& rank);
     bool userExists(const std::string& username);
     std::string hashPassword(const std::string& password);
     
-    // Session management (in-memory)
-    bool createSession(const std::string& username, SOCKET socket);
-    bool removeSession(const std::string& username);
+    // scrypt cost for new hashes; set before initialize()
+    void setPasswordHashParams(const PasswordHashParams& params) { hashParams_ = params; }
+    
+    // Where IMPORT_CONTENT requests find their files, and the threads an import parses with
+    // (0 = one per core); set before the server starts
+    void setImportOptions(const std::string& directory, size_t threads) { importDirectory_ = directory; importThreads_ = threads; }
+    const std::string& getImportDirectory() const { return importDirectory_; }
+    
+    // Session management (in-memory). A session belongs to the connection that created it;
+    // a login or resume on another connection takes it over, and only the holder removes it.
+    bool createSession(const std::string& username, SOCKET socket, uint64_t connectionId);
+    bool removeSession(const std::string& username, uint64_t connectionId);
+    bool holdsSession(const std::string& username, uint64_t connectionId);
     bool getSessionByUsername(const std::string& username, SessionData& session);
     bool getSessionBySocket(SOCKET socket, SessionData& session);
     std::vector<std::string> getOnlineUsers();
     
     // Lesson and content management
-    std::vector<std::string> getLessonList(ProficiencyLevel level);
-    std::string getLessonContent(const std::string& lessonId);
+    LessonCatalog::SnapshotPtr getLessonSnapshot() const { return lessonCatalog_.getSnapshot(); }
+    bool hasLesson(const std::string& lessonId) const;
+    // False for an unknown lesson
+    bool getLessonContent(const std::string& lessonId, std::string& content);
+    
+    // Full-text index over lessons and game items, updated with every content write
+    SearchIndex::SnapshotPtr getSearchSnapshot() const { return searchIndex_.getSnapshot(); }
+    
+    // Vocabulary for autocomplete and word lookups (see Dictionary::load); a successful load
+    // replaces the current dictionary, which readers holding it keep until they let go
+    bool loadDictionary(const std::string& path, std::string& error);
+    std::shared_ptr<const Dictionary> getDictionary() const { return std::atomic_load(&dictionary_); }
+    
+    // Quiz and exercise grading
+    bool gradeQuiz(const std::string& quizId, const std::string_view* answers, size_t answerCount, GradeResult& result);
+    bool gradeExercise(const std::string& exerciseId, std::string_view answer, GradeResult& result);
+    
+    // Pronunciation references (teacher recordings) and scoring
+    bool setPronunciationReference(const std::string& sentenceId, std::vector<float> features);
+    bool hasPronunciationReference(const std::string& sentenceId);
+    bool scorePronunciation(const std::string& sentenceId, const std::vector<float>& features,
+                            PronunciationResult& result);
+    
+    // Spaced-repetition reviews
+    void recordReview(const std::string& username, const std::string& itemKey, int quality);
+    std::pmr::vector<std::pmr::string> getReviewQueue(const std::string& username, size_t count,
+                                                      std::pmr::memory_resource* resource);
+    
+    // Leaderboards: "global" and "level:N" (students only).
+    // around == false returns the top count entries, otherwise count entries on each side of the user.
+    bool queryLeaderboard(const std::string& board, const std::string& username, bool around,
+                          size_t count, LeaderboardView& view);
+    static std::string levelBoardName(ProficiencyLevel level);
     
     // Score and feedback management
     bool saveScore(const std::string& username, const std::string& exerciseId, int score);
     bool saveFeedback(const std::string& username, const std::string& exerciseId, 
                      const std::string& feedback, const std::string& fromUser);
-    std::vector<std::string> getFeedback(const std::string& username);
     
-    // Game content management
-    bool addGameItem(const std::string& gameType, const std::string& itemData);
+    // Notes from one teacher, applied together; one status per note (USER_NOT_FOUND for
+    // students that do not exist)
+    std::vector<ErrorCode> saveFeedbackBatch(const std::vector<FeedbackSubmission>& notes,
+                                             const std::string& fromUser);
+    
+    // Up to limit of the user's feedback entries with ids above after (see FeedbackLog)
+    std::vector<FeedbackEntry> getFeedbackAfter(const std::string& username, uint64_t after, size_t limit, size_t maxBytes,
+                                                bool& more);
+    
+    // Load lessons and game items from a CSV or JSONL file (see ContentImporter). Items
+    // already present are skipped, a lesson replaces the one with its id. Each catalog is
+    // published in one step, so readers never see part of an import. false when the file
+    // cannot be read.
+    bool importContent(const std::string& path, ImportReport& report);
+    
+    // Game content management; an item the type already holds is not added again
+    bool addGameItem(const std::string& gameType, const std::string& itemData,
+                     ProficiencyLevel level = ProficiencyLevel::BEGINNER);
+    // (game type, item) pairs, published at once; one status per pair, in order:
+    // SUCCESS, or ALREADY_EXISTS for an item held already or earlier in the list
+    std::vector<ErrorCode> addGameItems(std::vector<std::pair<std::string, GameItem>> items);
     std::vector<std::string> getGameItems(const std::string& gameType);
+    GameCatalog::SnapshotPtr getGameSnapshot(const std::string& gameType) const;
+    
+    // Bumped by every lesson write; lesson replies cached under an older version are stale.
+    // Game items are versioned per type by their catalog and do not touch it.
+    uint64_t getLessonVersion() const { return lessonVersion_.load(std::memory_order_acquire); }
+    
+    // Changes on every start; ids and cursors from another run are meaningless
+    uint64_t getVersionEpoch() const { return versionEpoch_; }
     
     // Cleanup
     void clearSessions();
@@ -62,11 +144,26 @@ private:
     std::map<std::string, UserData> users_;           // username -> user data
     std::map<std::string, SessionData> sessions_;      // username -> session
     std::map<SOCKET, std::string> socketToUser_;       // socket -> username
-    std::map<std::string, std::vector<std::string>> lessons_;  // level -> lesson list
-    std::map<std::string, std::vector<std::string>> gameItems_; // game type -> items
-    std::map<std::string, std::vector<std::string>> feedbacks_; // username -> feedbacks
+    std::map<std::string, Leaderboard> leaderboards_;  // board name -> ranking
+    
+    QuizBank quizBank_;                                // compiled answer keys
+    ReviewScheduler reviewScheduler_;                  // (user, item) -> review state
+    GameCatalog gameCatalog_;                          // game type -> items (lock-free reads)
+    LessonCatalog lessonCatalog_;                      // lessons by level and id (lock-free reads)
+    SearchIndex searchIndex_;                          // words -> lessons and game items (lock-free reads)
+    std::shared_ptr<const Dictionary> dictionary_;     // null until loaded (std::atomic_load/store only)
+    PronunciationBank pronunciationBank_;              // sentence id -> reference MFCCs
+    FeedbackLog feedbackLog_;                          // username -> feedback entries
+    
+    PasswordHashParams hashParams_;
+    std::string dummyHash_;                            // verified for unknown users, equalizing timing
+    
+    std::atomic<uint64_t> lessonVersion_{0};
+    uint64_t versionEpoch_ = 0;                        // all versions count from here
     
     std::string dbFilePath_;
+    std::string importDirectory_ = "content";
+    size_t importThreads_ = 0;
     bool initialized_;
     std::mutex dbMutex_;
 };
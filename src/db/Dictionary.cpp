@@ -0,0 +1,486 @@
+#include "Dictionary.hpp"
+#include "../utils/Logger.hpp"
+#include <filesystem>
+#include <unordered_map>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+namespace {
+    const char MAGIC[8] = {'E', 'L', 'P', 'D', 'I', 'C', 'T', 1};
+
+    std::string lowered(std::string_view text) {
+        std::string out(text);
+        for (char& c : out) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        }
+        return out;
+    }
+
+    bool validWord(std::string_view word) {
+        if (word.empty() || word.size() > Dictionary::MAX_WORD_BYTES) return false;
+        return std::none_of(word.begin(), word.end(), [](char c) { return static_cast<unsigned char>(c) < 0x20; });
+    }
+
+    template <typename T>
+    void appendArray(std::string& out, const std::vector<T>& values) {
+        out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    // Builds the minimized automaton from words in sorted order (Daciuk et al.): the path
+    // of the previous word stays editable, and once a new word leaves it, the states past
+    // the shared prefix can no longer change and are frozen, reusing an equal frozen state
+    // when there is one. Frozen states are numbered children first.
+    class DawgBuilder {
+    public:
+        DawgBuilder() : path_(1) {}
+
+        void add(std::string_view word) {
+            size_t common = 0;
+            while (common < word.size() && common < previous_.size() && word[common] == previous_[common]) {
+                ++common;
+            }
+            freezeBelow(common);
+            for (size_t i = common; i < word.size(); ++i) {
+                path_.back().arcs.emplace_back(static_cast<uint8_t>(word[i]), 0);
+                path_.emplace_back();
+            }
+            path_.back().final = true;
+            previous_.assign(word);
+        }
+
+        // Freezes the rest and returns the root
+        uint32_t finish() {
+            freezeBelow(0);
+            uint32_t root = freeze(path_.back());
+            firstArc.push_back(static_cast<uint32_t>(labels.size()));
+            return root;
+        }
+
+        std::vector<uint32_t> firstArc;
+        std::vector<uint32_t> counts;
+        std::vector<uint32_t> targets;
+        std::vector<uint8_t> labels;
+
+    private:
+        struct Draft {
+            bool final = false;
+            std::vector<std::pair<uint8_t, uint32_t>> arcs;   // the last one leads to the next draft
+        };
+
+        void freezeBelow(size_t depth) {
+            while (path_.size() > depth + 1) {
+                uint32_t state = freeze(path_.back());
+                path_.pop_back();
+                path_.back().arcs.back().second = state;
+            }
+        }
+
+        uint32_t freeze(const Draft& draft) {
+            std::string& key = key_;
+            key.assign(1, draft.final ? '\1' : '\0');
+            for (const auto& arc : draft.arcs) {
+                key.push_back(static_cast<char>(arc.first));
+                key.append(reinterpret_cast<const char*>(&arc.second), sizeof(arc.second));
+            }
+            auto found = register_.find(key);
+            if (found != register_.end()) {
+                return found->second;
+            }
+
+            uint32_t state = static_cast<uint32_t>(counts.size());
+            uint32_t count = draft.final ? 1 : 0;
+            firstArc.push_back(static_cast<uint32_t>(labels.size()));
+            for (const auto& arc : draft.arcs) {
+                labels.push_back(arc.first);
+                targets.push_back(arc.second);
+                count += counts[arc.second] & ~uint32_t(0x80000000u);
+            }
+            counts.push_back(count | (draft.final ? 0x80000000u : 0));
+            register_.emplace(key, state);
+            return state;
+        }
+
+        std::vector<Draft> path_;       // path_[i]: the state after i bytes of previous_
+        std::string previous_;
+        std::unordered_map<std::string, uint32_t> register_;   // frozen states by content
+        std::string key_;
+    };
+}
+
+Dictionary::~Dictionary() {
+    #ifndef _WIN32
+    if (mapping_) {
+        munmap(mapping_, size_);
+    }
+    #endif
+}
+
+std::string Dictionary::compile(std::vector<std::pair<std::string, std::string>> entries, size_t& rejected) {
+    for (auto& entry : entries) {
+        entry.first = lowered(entry.first);
+        if (entry.second.size() > MAX_GLOSS_BYTES) {
+            entry.second.resize(MAX_GLOSS_BYTES);
+        }
+    }
+    size_t before = entries.size();
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const auto& entry) { return !validWord(entry.first); }),
+                  entries.end());
+    rejected = before - entries.size();
+
+    // Sorted and unique by word; stable, so the first gloss of a word is the one kept
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  entries.end());
+
+    DawgBuilder builder;
+    std::vector<uint32_t> glossOffsets;
+    std::string glosses;
+    glossOffsets.reserve(entries.size() + 1);
+    for (const auto& entry : entries) {
+        builder.add(entry.first);
+        glossOffsets.push_back(static_cast<uint32_t>(glosses.size()));
+        glosses += entry.second;
+    }
+    glossOffsets.push_back(static_cast<uint32_t>(glosses.size()));
+    uint32_t root = builder.finish();
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.states = static_cast<uint32_t>(builder.counts.size());
+    header.arcs = static_cast<uint32_t>(builder.labels.size());
+    header.words = static_cast<uint32_t>(entries.size());
+    header.root = root;
+    header.glossBytes = static_cast<uint32_t>(glosses.size());
+
+    std::string image(reinterpret_cast<const char*>(&header), sizeof(header));
+    appendArray(image, builder.firstArc);
+    appendArray(image, builder.counts);
+    appendArray(image, builder.targets);
+    appendArray(image, glossOffsets);
+    appendArray(image, builder.labels);
+    image += glosses;
+    return image;
+}
+
+std::shared_ptr<const Dictionary> Dictionary::load(const std::string& path, std::string& error) {
+    namespace fs = std::filesystem;
+    auto dictionary = std::make_shared<Dictionary>();
+
+    bool compiled = path.size() >= 5 && path.compare(path.size() - 5, 5, ".dict") == 0;
+    if (compiled) {
+        if (!dictionary->map(path, error)) return nullptr;
+        return dictionary;
+    }
+
+    std::ifstream source(path, std::ios::binary);
+    if (!source) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+
+    // A compiled copy at least as new as the word list is used as it is
+    std::string imagePath = path + ".dict";
+    std::error_code ec;
+    auto sourceTime = fs::last_write_time(path, ec);
+    auto imageTime = fs::last_write_time(imagePath, ec);
+    if (!ec && imageTime >= sourceTime && dictionary->map(imagePath, error)) {
+        return dictionary;
+    }
+
+    std::vector<std::pair<std::string, std::string>> entries;
+    std::string line;
+    while (std::getline(source, line)) {
+        std::string_view text = Utils::trimView(line);
+        if (text.empty() || text.front() == '#') continue;
+
+        size_t split = text.find_first_of("\t=");
+        std::string_view word = Utils::trimView(text.substr(0, split));
+        std::string_view gloss = split == std::string_view::npos ? std::string_view() : Utils::trimView(text.substr(split + 1));
+        entries.emplace_back(std::string(word), std::string(gloss));
+    }
+
+    size_t rejected = 0;
+    std::string image = compile(std::move(entries), rejected);
+    if (rejected > 0) {
+        Logger::getInstance().warning(std::to_string(rejected) + " invalid words skipped in " + path);
+    }
+
+    // Write a temporary file and rename it, so a reader never maps a torn image
+    std::string temporary = imagePath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        written = out.write(image.data(), static_cast<std::streamsize>(image.size())) && out.flush();
+    }
+    if (written) {
+        fs::rename(temporary, imagePath, ec);
+        written = !ec;
+    }
+    if (written && dictionary->map(imagePath, error)) {
+        return dictionary;
+    }
+    fs::remove(temporary, ec);
+    Logger::getInstance().warning("Cannot write " + imagePath + ", keeping the dictionary in memory");
+    if (!dictionary->assign(std::move(image), error)) return nullptr;
+    return dictionary;
+}
+
+bool Dictionary::map(const std::string& path, std::string& error) {
+    #ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        error = "cannot read " + path;
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    if (!attach(static_cast<const char*>(data), size, error)) {
+        munmap(data, size);
+        error += " in " + path;
+        return false;
+    }
+    mapping_ = data;
+    return true;
+    #else
+    // No mapping here: the image is read into memory
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return assign(std::move(image), error);
+    #endif
+}
+
+bool Dictionary::assign(std::string image, std::string& error) {
+    owned_ = std::move(image);
+    return attach(owned_.data(), owned_.size(), error);
+}
+
+bool Dictionary::attach(const char* data, size_t size, std::string& error) {
+    if (size < sizeof(Header) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not a dictionary image";
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data);
+
+    // Sections are fixed-size arrays; the sizes must add up exactly
+    uint64_t expected = sizeof(Header) + 4ull * (header->states + 1) + 4ull * header->states +
+                        4ull * header->arcs + 4ull * (header->words + 1) + header->arcs + header->glossBytes;
+    if (expected != size || header->states == 0 || header->root >= header->states) {
+        error = "truncated or corrupt dictionary image";
+        return false;
+    }
+
+    const char* at = data + sizeof(Header);
+    firstArc_ = reinterpret_cast<const uint32_t*>(at);
+    at += 4ull * (header->states + 1);
+    counts_ = reinterpret_cast<const uint32_t*>(at);
+    at += 4ull * header->states;
+    targets_ = reinterpret_cast<const uint32_t*>(at);
+    at += 4ull * header->arcs;
+    glossOffsets_ = reinterpret_cast<const uint32_t*>(at);
+    at += 4ull * (header->words + 1);
+    labels_ = reinterpret_cast<const uint8_t*>(at);
+    at += header->arcs;
+    glosses_ = at;
+
+    // Checked once here so that walks need no bounds checks: arcs only lead to earlier states
+    // (children are numbered first, so every walk ends), each state's count adds up over its
+    // arcs, and the root counts every word, so each rank indexes the gloss table
+    bool valid = firstArc_[0] == 0 && firstArc_[header->states] == header->arcs &&
+                 glossOffsets_[0] == 0 && glossOffsets_[header->words] == header->glossBytes;
+    for (uint32_t state = 0; valid && state < header->states; ++state) {
+        uint64_t count = (counts_[state] & FINAL) ? 1 : 0;
+        uint32_t end = firstArc_[state + 1];
+        valid = firstArc_[state] <= end && end <= header->arcs;
+        for (uint32_t arc = firstArc_[state]; valid && arc < end; ++arc) {
+            valid = targets_[arc] < state && (arc == firstArc_[state] || labels_[arc - 1] < labels_[arc]);
+            count += valid ? counts_[targets_[arc]] & ~FINAL : 0;
+        }
+        valid = valid && count == (counts_[state] & ~FINAL);
+    }
+    valid = valid && (counts_[header->root] & ~FINAL) == header->words;
+    for (uint32_t word = 0; valid && word < header->words; ++word) {
+        valid = glossOffsets_[word] <= glossOffsets_[word + 1];
+    }
+    if (!valid) {
+        error = "truncated or corrupt dictionary image";
+        return false;
+    }
+    header_ = header;
+    size_ = size;
+    return true;
+}
+
+std::string_view Dictionary::glossOf(uint32_t rank) const {
+    return std::string_view(glosses_ + glossOffsets_[rank], glossOffsets_[rank + 1] - glossOffsets_[rank]);
+}
+
+bool Dictionary::lookup(std::string_view word, Match& match) const {
+    if (!header_) return false;
+    std::string key = lowered(word);
+
+    // rank = words that sort before the path taken so far
+    uint32_t state = header_->root;
+    uint32_t rank = 0;
+    for (char c : key) {
+        rank += isFinal(state) ? 1 : 0;
+        uint32_t arc = firstArc_[state];
+        uint32_t end = firstArc_[state + 1];
+        for (; arc < end && labels_[arc] < static_cast<uint8_t>(c); ++arc) {
+            rank += countOf(targets_[arc]);
+        }
+        if (arc == end || labels_[arc] != static_cast<uint8_t>(c)) return false;
+        state = targets_[arc];
+    }
+    if (!isFinal(state)) return false;
+
+    match.word = std::move(key);
+    match.gloss = glossOf(rank);
+    match.distance = 0;
+    return true;
+}
+
+std::vector<Dictionary::Match> Dictionary::complete(std::string_view prefix, size_t limit) const {
+    std::vector<Match> matches;
+    if (!header_ || limit == 0) return matches;
+    std::string word = lowered(prefix);
+
+    uint32_t state = header_->root;
+    uint32_t rank = 0;
+    for (char c : word) {
+        rank += isFinal(state) ? 1 : 0;
+        uint32_t arc = firstArc_[state];
+        uint32_t end = firstArc_[state + 1];
+        for (; arc < end && labels_[arc] < static_cast<uint8_t>(c); ++arc) {
+            rank += countOf(targets_[arc]);
+        }
+        if (arc == end || labels_[arc] != static_cast<uint8_t>(c)) return matches;
+        state = targets_[arc];
+    }
+
+    // Depth-first in label order yields the words alphabetically; a word comes before its
+    // extensions. next is the rank of the first word under the frame's next arc.
+    struct Frame {
+        uint32_t arc;
+        uint32_t end;
+        uint32_t next;
+    };
+    std::vector<Frame> stack;
+    size_t base = word.size();
+    auto enter = [&](uint32_t s, uint32_t r) {
+        if (isFinal(s)) {
+            matches.push_back({word, glossOf(r), 0});
+        }
+        stack.push_back({firstArc_[s], firstArc_[s + 1], r + (isFinal(s) ? 1 : 0)});
+    };
+    enter(state, rank);
+    while (!stack.empty() && matches.size() < limit) {
+        Frame& frame = stack.back();
+        if (frame.arc == frame.end) {
+            stack.pop_back();
+            if (word.size() > base) word.pop_back();
+            continue;
+        }
+        uint32_t arc = frame.arc++;
+        uint32_t target = targets_[arc];
+        uint32_t first = frame.next;
+        frame.next += countOf(target);
+        word.push_back(static_cast<char>(labels_[arc]));
+        enter(target, first);
+    }
+    return matches;
+}
+
+std::vector<Dictionary::Match> Dictionary::fuzzy(std::string_view query, size_t maxDistance, size_t limit) const {
+    std::vector<Match> matches;
+    std::string pattern = lowered(query);
+    maxDistance = std::min(maxDistance, MAX_DISTANCE);
+    if (!header_ || limit == 0 || pattern.size() > MAX_WORD_BYTES) return matches;
+
+    // rows[d] is the DP row after d bytes of the current path: rows[d][i] = distance between
+    // the path and pattern[0, i). Depth never exceeds the pattern length + maxDistance.
+    const size_t width = pattern.size() + 1;
+    const size_t maxDepth = std::min(pattern.size() + maxDistance, MAX_WORD_BYTES);
+    std::vector<uint8_t> rows((maxDepth + 2) * width);
+    for (size_t i = 0; i < width; ++i) {
+        rows[i] = static_cast<uint8_t>(i);
+    }
+
+    struct Frame {
+        uint32_t arc;
+        uint32_t end;
+        uint32_t next;   // rank of the first word under the next arc
+    };
+    std::vector<Frame> stack;
+    std::string word;
+    uint32_t root = header_->root;
+    stack.push_back({firstArc_[root], firstArc_[root + 1], isFinal(root) ? 1u : 0u});
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.arc == frame.end) {
+            stack.pop_back();
+            if (!word.empty()) word.pop_back();
+            continue;
+        }
+        uint32_t arc = frame.arc++;
+        uint32_t target = targets_[arc];
+        uint32_t first = frame.next;
+        frame.next += countOf(target);
+
+        size_t depth = stack.size();
+        const uint8_t* previous = &rows[(depth - 1) * width];
+        uint8_t* row = &rows[depth * width];
+        uint8_t label = labels_[arc];
+        row[0] = static_cast<uint8_t>(depth);
+        uint8_t best = row[0];
+        for (size_t i = 1; i < width; ++i) {
+            uint8_t substitute = previous[i - 1] + (static_cast<uint8_t>(pattern[i - 1]) != label ? 1 : 0);
+            row[i] = std::min<uint8_t>(substitute, std::min(previous[i], row[i - 1]) + 1);
+            best = std::min(best, row[i]);
+        }
+        if (best > maxDistance) continue;   // every longer path is at least this far
+
+        word.push_back(static_cast<char>(label));
+        if (isFinal(target) && row[width - 1] <= maxDistance) {
+            matches.push_back({word, glossOf(first), row[width - 1]});
+        }
+        if (depth < maxDepth) {
+            stack.push_back({firstArc_[target], firstArc_[target + 1], first + (isFinal(target) ? 1 : 0)});
+        } else {
+            word.pop_back();
+        }
+    }
+
+    auto closer = [](const Match& a, const Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.word < b.word;
+    };
+    if (matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), closer);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), closer);
+    }
+    return matches;
+}
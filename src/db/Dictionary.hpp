@@ -0,0 +1,91 @@
+#ifndef DICTIONARY_HPP
+#define DICTIONARY_HPP
+
+#include "../../include/common.hpp"
+
+// Read-only vocabulary with glosses, stored as a minimized DAWG (deterministic acyclic word
+// automaton: shared prefixes and shared suffixes). Each state records how many words its
+// suffixes complete, which gives every word its rank in sorted order on the way down; the
+// rank indexes the gloss table. The whole dictionary is one flat image of fixed-width arrays
+// that is used in place, so a compiled file is memory-mapped rather than loaded.
+//
+// Words are byte strings, lower-cased in ASCII; edit distances count bytes.
+class Dictionary {
+public:
+    static constexpr size_t MAX_WORD_BYTES = 64;
+    static constexpr size_t MAX_GLOSS_BYTES = 256;
+    static constexpr size_t MAX_DISTANCE = 3;
+
+    struct Match {
+        std::string word;
+        std::string_view gloss;     // points into the dictionary
+        size_t distance = 0;        // edits from the query (fuzzy lookups)
+    };
+
+    Dictionary() = default;
+    ~Dictionary();
+
+    Dictionary(const Dictionary&) = delete;
+    Dictionary& operator=(const Dictionary&) = delete;
+
+    // Image for (word, gloss) entries; a repeated word keeps its first gloss. Empty words,
+    // words over MAX_WORD_BYTES and words with control characters are counted in rejected.
+    static std::string compile(std::vector<std::pair<std::string, std::string>> entries, size_t& rejected);
+
+    // A compiled dictionary (.dict), or a word list to compile: one word per line, optionally
+    // followed by a tab or '=' and its gloss; empty lines and lines starting with '#' are
+    // skipped. A word list is compiled to <path>.dict when that is missing or older and the
+    // result mapped; if it cannot be written the image is kept in memory instead.
+    static std::shared_ptr<const Dictionary> load(const std::string& path, std::string& error);
+
+    // Use an image in place: map a file, or take ownership of one in memory
+    bool map(const std::string& path, std::string& error);
+    bool assign(std::string image, std::string& error);
+
+    size_t size() const { return header_ ? header_->words : 0; }
+    size_t bytes() const { return size_; }
+    size_t states() const { return header_ ? header_->states : 0; }
+
+    bool lookup(std::string_view word, Match& match) const;
+
+    // Up to limit words starting with prefix, in alphabetical order
+    std::vector<Match> complete(std::string_view prefix, size_t limit) const;
+
+    // Up to limit words within maxDistance (at most MAX_DISTANCE) Levenshtein edits of word,
+    // closest first, then alphabetical. The automaton is walked with one DP row per depth,
+    // so a branch is dropped as soon as no suffix can bring it back within maxDistance.
+    std::vector<Match> fuzzy(std::string_view word, size_t maxDistance, size_t limit) const;
+
+private:
+    struct Header {
+        char magic[8];          // "ELPDICT" and the format version
+        uint32_t states;
+        uint32_t arcs;
+        uint32_t words;
+        uint32_t root;
+        uint32_t glossBytes;
+    };
+
+    static constexpr uint32_t FINAL = 0x80000000u;   // in counts_: the state ends a word
+
+    bool attach(const char* data, size_t size, std::string& error);
+
+    bool isFinal(uint32_t state) const { return counts_[state] & FINAL; }
+    uint32_t countOf(uint32_t state) const { return counts_[state] & ~FINAL; }
+    std::string_view glossOf(uint32_t rank) const;
+
+    // Sections of the image: arcs of state s are firstArc_[s] .. firstArc_[s + 1], sorted by label
+    const Header* header_ = nullptr;
+    const uint32_t* firstArc_ = nullptr;     // states + 1
+    const uint32_t* counts_ = nullptr;       // words below each state, FINAL bit
+    const uint32_t* targets_ = nullptr;      // arcs
+    const uint32_t* glossOffsets_ = nullptr; // words + 1
+    const uint8_t* labels_ = nullptr;        // arcs
+    const char* glosses_ = nullptr;
+    size_t size_ = 0;
+
+    std::string owned_;                      // assign()ed image
+    void* mapping_ = nullptr;                // map()ped image
+};
+
+#endif // DICTIONARY_HPP
@@ -0,0 +1,44 @@
+#include "FeedbackLog.hpp"
+
+uint64_t FeedbackLog::append(const std::string& username, std::string text) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<FeedbackEntry>& log = logs_[username];
+    uint64_t id = log.size() + 1;
+    log.push_back(FeedbackEntry{id, std::move(text)});
+    return id;
+}
+
+void FeedbackLog::appendAll(std::vector<std::pair<std::string, std::string>> entries) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    for (auto& entry : entries) {
+        std::vector<FeedbackEntry>& log = logs_[entry.first];
+        log.push_back(FeedbackEntry{log.size() + 1, std::move(entry.second)});
+    }
+}
+
+std::vector<FeedbackEntry> FeedbackLog::readAfter(const std::string& username, uint64_t after, size_t limit,
+                                                  size_t maxBytes, bool& more) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    more = false;
+    auto it = logs_.find(username);
+    if (it == logs_.end() || after >= it->second.size()) {
+        return {};
+    }
+
+    // Entry id n sits at index n - 1, so the page starts at index after
+    const std::vector<FeedbackEntry>& log = it->second;
+    size_t begin = static_cast<size_t>(after);
+    size_t end = begin;
+    size_t bytes = 0;
+    while (end < log.size() && end - begin < limit) {
+        bytes += pageBytes(log[end]);
+        if (bytes > maxBytes && end > begin) break;
+        ++end;
+    }
+    more = end < log.size();
+    return std::vector<FeedbackEntry>(log.begin() + static_cast<std::ptrdiff_t>(begin),
+                                      log.begin() + static_cast<std::ptrdiff_t>(end));
+}
@@ -0,0 +1,33 @@
+#ifndef FEEDBACK_LOG_HPP
+#define FEEDBACK_LOG_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include <shared_mutex>
+
+// Append-only feedback history per user. Entry ids run 1, 2, 3... in each user's log, so
+// reading after a cursor is a direct index and costs only the entries returned.
+// Readers share a lock, appends take it exclusively.
+class FeedbackLog {
+public:
+    // Add an entry to the user's log; returns its id
+    uint64_t append(const std::string& username, std::string text);
+
+    // Add (username, text) entries under one lock
+    void appendAll(std::vector<std::pair<std::string, std::string>> entries);
+
+    // Encoded size of an entry in a page: its text and at most 15 bytes of varints
+    static size_t pageBytes(const FeedbackEntry& entry) { return entry.text.size() + 15; }
+
+    // Up to limit entries with ids above after, oldest first, as long as their pageBytes
+    // add up to at most maxBytes (the first entry is always taken, so a reader moves on);
+    // more is set when entries remain beyond the page
+    std::vector<FeedbackEntry> readAfter(const std::string& username, uint64_t after, size_t limit,
+                                         size_t maxBytes, bool& more) const;
+
+private:
+    std::map<std::string, std::vector<FeedbackEntry>> logs_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // FEEDBACK_LOG_HPP
@@ -0,0 +1,131 @@
+#include "GameCatalog.hpp"
+#include <random>
+
+namespace {
+    std::mt19937& threadRng() {
+        thread_local std::mt19937 rng(std::random_device{}());
+        return rng;
+    }
+
+    void takeAll(const SharedArray<uint32_t>& pool, std::vector<uint32_t>& out) {
+        for (size_t i = 0; i < pool.size(); ++i) {
+            out.push_back(pool[i]);
+        }
+    }
+
+    // Floyd's algorithm: k distinct picks from pool without touching the other entries
+    void samplePool(const SharedArray<uint32_t>& pool, size_t k, std::vector<uint32_t>& out) {
+        size_t n = pool.size();
+        if (k >= n) {
+            takeAll(pool, out);
+            return;
+        }
+
+        size_t start = out.size();
+        auto& rng = threadRng();
+        for (size_t j = n - k; j < n; ++j) {
+            size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+            uint32_t candidate = pool[t];
+            if (std::find(out.begin() + start, out.end(), candidate) != out.end()) {
+                candidate = pool[j];
+            }
+            out.push_back(candidate);
+        }
+    }
+}
+
+GameCatalog::GameCatalog() : types_(std::make_shared<const TypeMap>()) {}
+
+size_t GameCatalog::levelIndex(ProficiencyLevel level) {
+    size_t index = static_cast<size_t>(level) - 1;
+    return index < LEVEL_COUNT ? index : 0;
+}
+
+GameCatalog::SnapshotPtr GameCatalog::getSnapshot(const std::string& gameType) const {
+    std::shared_ptr<const TypeMap> types = std::atomic_load(&types_);
+
+    auto it = types->find(gameType);
+    if (it == types->end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+bool GameCatalog::addItem(const std::string& gameType, const std::string& data, ProficiencyLevel level) {
+    return !addNewItems({{gameType, GameItem(data, level)}}).empty();
+}
+
+std::map<std::string, std::vector<GameItem>> GameCatalog::addNewItems(std::vector<std::pair<std::string, GameItem>> items,
+                                                                      std::vector<bool>* kept) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    if (kept) {
+        kept->assign(items.size(), false);
+    }
+    std::map<std::string, std::vector<GameItem>> added;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!known_[items[i].first].insert(items[i].second.data).second) {
+            continue;
+        }
+        if (kept) {
+            (*kept)[i] = true;
+        }
+        added[items[i].first].push_back(std::move(items[i].second));
+    }
+
+    // Only writers change types_, so the snapshot read here is current
+    if (!added.empty()) {
+        publish(*std::atomic_load(&types_), added);
+    }
+    return added;
+}
+
+void GameCatalog::publish(const TypeMap& current, const std::map<std::string, std::vector<GameItem>>& itemsByType) {
+    auto types = std::make_shared<TypeMap>(current);
+    for (const auto& group : itemsByType) {
+        (*types)[group.first] = extend(current, group.first, group.second);
+    }
+    std::atomic_store(&types_, std::shared_ptr<const TypeMap>(std::move(types)));
+}
+
+GameCatalog::SnapshotPtr GameCatalog::extend(const TypeMap& types, const std::string& gameType,
+                                             const std::vector<GameItem>& items) {
+    auto next = std::make_shared<Snapshot>();
+
+    auto it = types.find(gameType);
+    if (it != types.end()) {
+        *next = *it->second;
+    }
+    next->version++;
+
+    for (const auto& item : items) {
+        uint32_t index = static_cast<uint32_t>(next->items.size());
+        size_t itemLevel = levelIndex(item.level);
+
+        next->items.push_back(GameItem(item.data, static_cast<ProficiencyLevel>(itemLevel + 1)));
+        next->exactLevel[itemLevel].push_back(index);
+        for (size_t l = itemLevel; l < LEVEL_COUNT; ++l) {
+            next->upToLevel[l].push_back(index);
+        }
+    }
+    return next;
+}
+
+std::vector<uint32_t> GameCatalog::sample(const Snapshot& snapshot, ProficiencyLevel level, size_t k) {
+    std::vector<uint32_t> picked;
+    size_t l = levelIndex(level);
+    const auto& exact = snapshot.exactLevel[l];
+
+    picked.reserve(std::min(k, snapshot.upToLevel[l].size()));
+
+    if (exact.size() >= k || l == 0) {
+        samplePool(exact, k, picked);
+    } else {
+        // Not enough items at this level: take them all and top up from easier levels
+        takeAll(exact, picked);
+        samplePool(snapshot.upToLevel[l - 1], k - exact.size(), picked);
+    }
+
+    std::shuffle(picked.begin(), picked.end(), threadRng());
+    return picked;
+}
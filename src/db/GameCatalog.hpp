@@ -0,0 +1,118 @@
+#ifndef GAME_CATALOG_HPP
+#define GAME_CATALOG_HPP
+
+#include "../../include/common.hpp"
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+// A single game item with the proficiency level it is meant for
+struct GameItem {
+    std::string data;
+    ProficiencyLevel level;
+
+    GameItem() : level(ProficiencyLevel::BEGINNER) {}
+    GameItem(const std::string& d, ProficiencyLevel l) : data(d), level(l) {}
+};
+
+// Append-only array whose copies share storage. Elements live in fixed-size chunks that never
+// move: a copy shares every chunk, and an append fills the next slot of the last chunk in
+// place unless another copy has taken that slot already. Extending a copy of an n-element
+// array thus costs n / CHUNK_SIZE pointer copies rather than n element copies. Readers may use
+// a copy while a later copy is appended to; appends must be serialized by the owner.
+template <typename T>
+class SharedArray {
+public:
+    static constexpr size_t CHUNK_SIZE = 256;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t index) const { return chunks_[index / CHUNK_SIZE]->slots[index % CHUNK_SIZE]; }
+
+    void push_back(T value) {
+        size_t slot = size_ % CHUNK_SIZE;
+        if (slot == 0) {
+            chunks_.push_back(std::make_shared<Chunk>());
+        } else if (chunks_.back()->used != slot) {
+            // Another copy has appended here: go on in a private copy of the chunk
+            auto chunk = std::make_shared<Chunk>();
+            std::copy_n(chunks_.back()->slots.begin(), slot, chunk->slots.begin());
+            chunks_.back() = std::move(chunk);
+        }
+        Chunk& chunk = *chunks_.back();
+        chunk.slots[slot] = std::move(value);
+        chunk.used = slot + 1;
+        ++size_;
+    }
+
+private:
+    struct Chunk {
+        std::array<T, CHUNK_SIZE> slots;
+        size_t used = 0;   // slots filled by the copy that appended last
+    };
+
+    std::vector<std::shared_ptr<Chunk>> chunks_;
+    size_t size_ = 0;
+};
+
+// Read-optimized catalog of game items.
+// Readers grab an immutable snapshot with a single atomic load and never take a lock;
+// writers build a new snapshot (copy-on-write) and publish it with an atomic store. Item and
+// index arrays are SharedArrays, so a new snapshot shares the old one's storage and an add
+// costs about the size of the items added, not of the whole type.
+class GameCatalog {
+public:
+    static constexpr size_t LEVEL_COUNT = 3;
+    static constexpr size_t DEFAULT_SAMPLE_SIZE = 10;
+
+    // Immutable item array for one game type, with per-level index arrays precomputed
+    struct Snapshot {
+        uint64_t version = 0;
+        SharedArray<GameItem> items;
+        std::array<SharedArray<uint32_t>, LEVEL_COUNT> exactLevel;   // items of exactly level L
+        std::array<SharedArray<uint32_t>, LEVEL_COUNT> upToLevel;    // items of level <= L
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    GameCatalog();
+
+    // Get the current snapshot for a game type (nullptr if the type has no items)
+    SnapshotPtr getSnapshot(const std::string& gameType) const;
+
+    // Append an item and publish a new snapshot; false when the type already holds its data
+    bool addItem(const std::string& gameType, const std::string& data, ProficiencyLevel level);
+
+    // Append the (game type, item) pairs whose data the type does not hold yet; of items
+    // repeated in the list the first counts, and readers see all of them or none. The check
+    // and the publish share the write lock, so concurrent writers cannot both add an item.
+    // Returns the items added, by type; kept, when given, gets one flag per item in order.
+    std::map<std::string, std::vector<GameItem>> addNewItems(std::vector<std::pair<std::string, GameItem>> items,
+                                                             std::vector<bool>* kept = nullptr);
+
+    // Draw up to k distinct item indices suited to the given level.
+    // Items of exactly that level are preferred; easier items fill in when the level is too sparse.
+    static std::vector<uint32_t> sample(const Snapshot& snapshot, ProficiencyLevel level, size_t k);
+
+private:
+    using TypeMap = std::map<std::string, SnapshotPtr>;
+
+    static size_t levelIndex(ProficiencyLevel level);
+
+    // gameType's snapshot in types with items appended and the version bumped; shares the
+    // storage of the snapshot it extends
+    static SnapshotPtr extend(const TypeMap& types, const std::string& gameType,
+                              const std::vector<GameItem>& items);
+
+    // Store current with itemsByType appended as the new type map; the caller holds writeMutex_
+    void publish(const TypeMap& current, const std::map<std::string, std::vector<GameItem>>& itemsByType);
+
+    std::shared_ptr<const TypeMap> types_;  // accessed only through std::atomic_load/store
+    std::mutex writeMutex_;                 // serializes writers, readers never touch it
+
+    // Item data held per game type, so a duplicate check costs one lookup per item added
+    // rather than a pass over the type; writers only, under writeMutex_
+    std::unordered_map<std::string, std::unordered_set<std::string>> known_;
+};
+
+#endif // GAME_CATALOG_HPP
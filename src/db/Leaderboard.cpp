@@ -0,0 +1,189 @@
+#include "Leaderboard.hpp"
+
+Leaderboard::Leaderboard() : root_(NIL), rngState_(0x9E3779B9u) {
+    nodes_.emplace_back();   // NIL sentinel, size 0
+}
+
+bool Leaderboard::ranksBefore(int scoreA, const std::string& userA, int scoreB, const std::string& userB) {
+    if (scoreA != scoreB) return scoreA > scoreB;
+    return userA < userB;
+}
+
+void Leaderboard::update(const std::string& username, int score) {
+    auto it = scores_.find(username);
+    if (it != scores_.end()) {
+        if (it->second == score) return;
+        remove(username);
+    }
+
+    uint32_t node = allocate(username, score);
+    uint32_t left, right;
+    split(root_, score, username, false, left, right);
+    root_ = merge(merge(left, node), right);
+    scores_[username] = score;
+}
+
+void Leaderboard::remove(const std::string& username) {
+    auto it = scores_.find(username);
+    if (it == scores_.end()) return;
+
+    int score = it->second;
+    uint32_t left, middle, right;
+    split(root_, score, username, false, left, right);
+    split(right, score, username, true, middle, right);
+    release(middle);
+    root_ = merge(left, right);
+    scores_.erase(it);
+}
+
+size_t Leaderboard::getRank(const std::string& username) const {
+    auto it = scores_.find(username);
+    if (it == scores_.end()) return 0;
+    return countBefore(it->second, username) + 1;
+}
+
+std::vector<LeaderboardEntry> Leaderboard::getTop(size_t k) const {
+    std::vector<LeaderboardEntry> out;
+    collectRange(0, k, out);
+    return out;
+}
+
+std::vector<LeaderboardEntry> Leaderboard::getAround(const std::string& username, size_t radius) const {
+    std::vector<LeaderboardEntry> out;
+    size_t rank = getRank(username);
+    if (rank == 0) return out;
+
+    size_t index = rank - 1;
+    size_t first = index > radius ? index - radius : 0;
+    collectRange(first, index - first + radius + 1, out);
+    return out;
+}
+
+void Leaderboard::pull(uint32_t node) {
+    if (node != NIL) {
+        nodes_[node].size = 1 + nodes_[nodes_[node].left].size + nodes_[nodes_[node].right].size;
+    }
+}
+
+uint32_t Leaderboard::merge(uint32_t a, uint32_t b) {
+    if (a == NIL) return b;
+    if (b == NIL) return a;
+
+    if (nodes_[a].priority > nodes_[b].priority) {
+        nodes_[a].right = merge(nodes_[a].right, b);
+        pull(a);
+        return a;
+    }
+    nodes_[b].left = merge(a, nodes_[b].left);
+    pull(b);
+    return b;
+}
+
+void Leaderboard::split(uint32_t node, int score, const std::string& username, bool inclusive,
+                        uint32_t& left, uint32_t& right) {
+    if (node == NIL) {
+        left = right = NIL;
+        return;
+    }
+
+    const Node& n = nodes_[node];
+    bool goesLeft = ranksBefore(n.score, n.username, score, username) ||
+                    (inclusive && n.score == score && n.username == username);
+
+    if (goesLeft) {
+        uint32_t subLeft, subRight;
+        split(n.right, score, username, inclusive, subLeft, subRight);
+        nodes_[node].right = subLeft;
+        pull(node);
+        left = node;
+        right = subRight;
+    } else {
+        uint32_t subLeft, subRight;
+        split(n.left, score, username, inclusive, subLeft, subRight);
+        nodes_[node].left = subRight;
+        pull(node);
+        left = subLeft;
+        right = node;
+    }
+}
+
+uint32_t Leaderboard::allocate(const std::string& username, int score) {
+    // xorshift32: cheap priorities are all a treap needs
+    rngState_ ^= rngState_ << 13;
+    rngState_ ^= rngState_ >> 17;
+    rngState_ ^= rngState_ << 5;
+
+    uint32_t node;
+    if (!freeList_.empty()) {
+        node = freeList_.back();
+        freeList_.pop_back();
+    } else {
+        node = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& n = nodes_[node];
+    n.score = score;
+    n.priority = rngState_;
+    n.left = n.right = NIL;
+    n.size = 1;
+    n.username = username;
+    return node;
+}
+
+void Leaderboard::release(uint32_t node) {
+    if (node == NIL) return;
+    nodes_[node].username.clear();
+    nodes_[node].left = nodes_[node].right = NIL;
+    nodes_[node].size = 0;
+    freeList_.push_back(node);
+}
+
+size_t Leaderboard::countBefore(int score, const std::string& username) const {
+    size_t count = 0;
+    uint32_t node = root_;
+    while (node != NIL) {
+        const Node& n = nodes_[node];
+        if (ranksBefore(n.score, n.username, score, username)) {
+            count += nodes_[n.left].size + 1;
+            node = n.right;
+        } else {
+            node = n.left;
+        }
+    }
+    return count;
+}
+
+void Leaderboard::collectRange(size_t first, size_t count, std::vector<LeaderboardEntry>& out) const {
+    if (count == 0 || first >= size()) return;
+
+    // Descend to the first entry, remembering every ancestor that comes after it,
+    // then continue as a plain in-order walk
+    std::vector<uint32_t> stack;
+    uint32_t node = root_;
+    size_t index = first;
+    while (node != NIL) {
+        size_t leftSize = nodes_[nodes_[node].left].size;
+        if (index < leftSize) {
+            stack.push_back(node);
+            node = nodes_[node].left;
+        } else if (index == leftSize) {
+            stack.push_back(node);
+            break;
+        } else {
+            index -= leftSize + 1;
+            node = nodes_[node].right;
+        }
+    }
+
+    size_t rank = first + 1;
+    while (!stack.empty() && out.size() < count) {
+        node = stack.back();
+        stack.pop_back();
+        out.push_back({rank++, nodes_[node].username, nodes_[node].score});
+
+        for (uint32_t child = nodes_[node].right; child != NIL; child = nodes_[child].left) {
+            stack.push_back(child);
+        }
+    }
+}
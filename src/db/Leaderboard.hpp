@@ -0,0 +1,75 @@
+#ifndef LEADERBOARD_HPP
+#define LEADERBOARD_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include <unordered_map>
+
+// Result of a leaderboard query for one board
+struct LeaderboardView {
+    size_t rank = 0;      // caller's 1-based rank, 0 if not on the board
+    size_t total = 0;     // number of users on the board
+    std::vector<LeaderboardEntry> entries;
+};
+
+// Score ranking backed by an order-statistic treap.
+// Nodes carry subtree sizes, so rank lookups, score updates and rank-based selection are
+// all O(log n) expected; top K and neighbourhood queries add O(K) for the rows returned.
+// Ties are broken by username so every user has a distinct, stable rank.
+// Not thread-safe: the owner (Database) serializes access.
+class Leaderboard {
+public:
+    Leaderboard();
+
+    // Insert a user or move them to a new score
+    void update(const std::string& username, int score);
+
+    // Remove a user from the board
+    void remove(const std::string& username);
+
+    // 1-based rank of a user, 0 if the user is not on the board
+    size_t getRank(const std::string& username) const;
+
+    // Highest k entries
+    std::vector<LeaderboardEntry> getTop(size_t k) const;
+
+    // Entries ranked within radius of the user (the user included); empty if not on the board
+    std::vector<LeaderboardEntry> getAround(const std::string& username, size_t radius) const;
+
+    size_t size() const { return scores_.size(); }
+
+private:
+    static constexpr uint32_t NIL = 0;
+
+    struct Node {
+        int score = 0;
+        uint32_t priority = 0;
+        uint32_t left = NIL;
+        uint32_t right = NIL;
+        uint32_t size = 0;
+        std::string username;
+    };
+
+    // true when (scoreA, userA) ranks ahead of (scoreB, userB)
+    static bool ranksBefore(int scoreA, const std::string& userA, int scoreB, const std::string& userB);
+
+    void pull(uint32_t node);
+    uint32_t merge(uint32_t a, uint32_t b);
+    // Split into nodes ranking before the key and the rest; inclusive moves the key itself left
+    void split(uint32_t node, int score, const std::string& username, bool inclusive,
+               uint32_t& left, uint32_t& right);
+
+    uint32_t allocate(const std::string& username, int score);
+    void release(uint32_t node);
+
+    size_t countBefore(int score, const std::string& username) const;
+    void collectRange(size_t first, size_t count, std::vector<LeaderboardEntry>& out) const;
+
+    std::vector<Node> nodes_;               // nodes_[0] is the NIL sentinel
+    std::vector<uint32_t> freeList_;
+    uint32_t root_;
+    uint32_t rngState_;
+    std::unordered_map<std::string, int> scores_;   // username -> score currently on the board
+};
+
+#endif // LEADERBOARD_HPP
@@ -0,0 +1,83 @@
+#include "LessonCatalog.hpp"
+#include <unordered_set>
+
+namespace {
+    std::string listEntry(const Lesson& lesson) {
+        return lesson.id + ":" + lesson.title;
+    }
+}
+
+LessonCatalog::LessonCatalog() : snapshot_(std::make_shared<const Snapshot>()) {}
+
+size_t LessonCatalog::levelIndex(ProficiencyLevel level) {
+    size_t index = static_cast<size_t>(level) - 1;
+    return index < LEVEL_COUNT ? index : 0;
+}
+
+LessonCatalog::SnapshotPtr LessonCatalog::getSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+uint64_t LessonCatalog::addLessons(const std::vector<Lesson>& lessons) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&snapshot_);
+    auto next = std::make_shared<Snapshot>(*current);
+    next->version++;
+
+    // The last lesson given for an id wins
+    std::unordered_map<std::string_view, size_t> latest;
+    for (size_t i = 0; i < lessons.size(); ++i) {
+        latest[lessons[i].id] = i;
+    }
+
+    // A replaced lesson keeps its place in the list unless it changes level; each touched
+    // list is rewritten once
+    std::unordered_map<std::string_view, const Lesson*> inPlace;
+    std::unordered_set<std::string_view> moved;
+    std::array<bool, LEVEL_COUNT> touched{};
+    for (const auto& entry : latest) {
+        auto it = next->lessons.find(std::string(entry.first));
+        if (it == next->lessons.end()) continue;
+        const Lesson& lesson = lessons[entry.second];
+        size_t oldLevel = levelIndex(it->second.level);
+        if (oldLevel == levelIndex(lesson.level)) {
+            inPlace.emplace(entry.first, &lesson);
+        } else {
+            moved.insert(entry.first);
+        }
+        touched[oldLevel] = true;
+    }
+    for (size_t l = 0; l < LEVEL_COUNT; ++l) {
+        if (!touched[l]) continue;
+        auto& list = next->lists[l];
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            std::string_view id = std::string_view(list[i]).substr(0, list[i].find(':'));
+            if (moved.count(id)) continue;
+            auto replaced = inPlace.find(id);
+            if (replaced != inPlace.end()) {
+                list[kept] = listEntry(*replaced->second);
+            } else if (kept != i) {
+                list[kept] = std::move(list[i]);
+            }
+            ++kept;
+        }
+        list.resize(kept);
+    }
+
+    for (size_t i = 0; i < lessons.size(); ++i) {
+        if (latest[lessons[i].id] != i) continue;
+        bool listed = inPlace.count(lessons[i].id) > 0;
+        Lesson& stored = next->lessons[lessons[i].id];
+        stored = lessons[i];
+        stored.level = static_cast<ProficiencyLevel>(levelIndex(stored.level) + 1);
+        if (!listed) {
+            next->lists[levelIndex(stored.level)].push_back(listEntry(stored));
+        }
+    }
+
+    uint64_t version = next->version;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)));
+    return version;
+}
@@ -0,0 +1,46 @@
+#ifndef LESSON_CATALOG_HPP
+#define LESSON_CATALOG_HPP
+
+#include "../../include/common.hpp"
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+// A lesson with the proficiency level it belongs to; an empty body means none was supplied
+struct Lesson {
+    std::string id;
+    std::string title;
+    std::string body;
+    ProficiencyLevel level = ProficiencyLevel::BEGINNER;
+};
+
+// Read-optimized lesson catalog, published the same way as GameCatalog: readers take an
+// immutable snapshot with one atomic load, writers copy it, apply their changes and store
+// the new one, so a whole import becomes visible at once.
+class LessonCatalog {
+public:
+    static constexpr size_t LEVEL_COUNT = 3;
+
+    struct Snapshot {
+        uint64_t version = 0;
+        std::array<std::vector<std::string>, LEVEL_COUNT> lists;   // "id:title", in insertion order
+        std::unordered_map<std::string, Lesson> lessons;           // by id
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    LessonCatalog();
+
+    SnapshotPtr getSnapshot() const;
+
+    // Add or replace lessons by id and publish a new snapshot; returns its version. A lesson
+    // that moves level leaves its old list.
+    uint64_t addLessons(const std::vector<Lesson>& lessons);
+
+    static size_t levelIndex(ProficiencyLevel level);
+
+private:
+    std::shared_ptr<const Snapshot> snapshot_;   // accessed only through std::atomic_load/store
+    std::mutex writeMutex_;                      // serializes writers, readers never touch it
+};
+
+#endif // LESSON_CATALOG_HPP
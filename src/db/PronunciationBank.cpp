@@ -0,0 +1,52 @@
+#include "PronunciationBank.hpp"
+
+bool PronunciationBank::setReference(const std::string& sentenceId, std::vector<float> features) {
+    if (sentenceId.empty() || features.empty() || features.size() % MfccExtractor::NUM_COEFFS != 0) {
+        return false;
+    }
+
+    auto reference = std::make_shared<const Template>(std::move(features));
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    references_[sentenceId] = std::move(reference);
+    return true;
+}
+
+bool PronunciationBank::hasReference(const std::string& sentenceId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return references_.count(sentenceId) > 0;
+}
+
+bool PronunciationBank::score(const std::string& sentenceId, const std::vector<float>& features,
+                              PronunciationResult& result) const {
+    std::shared_ptr<const Template> reference;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = references_.find(sentenceId);
+        if (it == references_.end()) {
+            return false;
+        }
+        reference = it->second;
+    }
+
+    const size_t dims = MfccExtractor::NUM_COEFFS;
+    const size_t refFrames = reference->size() / dims;
+    result = PronunciationResult();
+    result.frames = features.size() / dims;
+
+    // Silence, or a recording of wildly different length, cannot be the same sentence
+    if (result.frames == 0 || result.frames > 3 * refFrames || refFrames > 3 * result.frames) {
+        return true;
+    }
+
+    result.distance = dtwDistance(reference->data(), refFrames, features.data(), result.frames, dims, DTW_BAND);
+    if (result.distance < 0.0f) {
+        return true;
+    }
+
+    float similarity = (DISTANCE_ZERO - result.distance) / (DISTANCE_ZERO - DISTANCE_PERFECT);
+    similarity = std::max(0.0f, std::min(1.0f, similarity));
+    result.similarity = static_cast<int>(similarity * 100.0f + 0.5f);
+    result.score = (POINTS * result.similarity + 50) / 100;
+    return true;
+}
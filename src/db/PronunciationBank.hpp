@@ -0,0 +1,42 @@
+#ifndef PRONUNCIATION_BANK_HPP
+#define PRONUNCIATION_BANK_HPP
+
+#include "../../include/common.hpp"
+#include "../utils/SpeechFeatures.hpp"
+#include <shared_mutex>
+
+// Result of scoring one recording against its reference
+struct PronunciationResult {
+    int score = 0;          // points awarded
+    int similarity = 0;     // 0..100
+    float distance = 0.0f;  // normalized DTW distance
+    size_t frames = 0;      // speech frames in the recording
+};
+
+// Reference MFCC templates for pronunciation sentences, recorded by teachers.
+// Templates are immutable once published, so scoring copies a pointer under a shared
+// lock and runs the DTW without holding it.
+class PronunciationBank {
+public:
+    static constexpr int POINTS = 10;              // awarded at 100% similarity
+    static constexpr size_t DTW_BAND = 25;          // frames (250 ms) around the diagonal
+    static constexpr float DISTANCE_PERFECT = 3.0f; // at or below: 100%
+    static constexpr float DISTANCE_ZERO = 20.0f;   // at or above: 0%
+
+    // Publish (or replace) the reference for a sentence; features are frames x NUM_COEFFS
+    bool setReference(const std::string& sentenceId, std::vector<float> features);
+
+    bool hasReference(const std::string& sentenceId) const;
+
+    // Score normalized features against the sentence's reference; false if there is none
+    bool score(const std::string& sentenceId, const std::vector<float>& features,
+               PronunciationResult& result) const;
+
+private:
+    using Template = std::vector<float>;
+
+    std::map<std::string, std::shared_ptr<const Template>> references_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // PRONUNCIATION_BANK_HPP
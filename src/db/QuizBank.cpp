@@ -0,0 +1,207 @@
+#include "QuizBank.hpp"
+#include <array>
+#include <bitset>
+
+namespace {
+    // Character classes for normalization: 0 = drop, ' ' = whitespace, otherwise the mapped char
+    constexpr std::array<char, 256> makeNormalizeTable() {
+        std::array<char, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            if (c >= 'a' && c <= 'z') table[c] = static_cast<char>(c);
+            else if (c >= 'A' && c <= 'Z') table[c] = static_cast<char>(c - 'A' + 'a');
+            else if (c >= '0' && c <= '9') table[c] = static_cast<char>(c);
+            else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') table[c] = ' ';
+            else if (c == '\'' || c == '-') table[c] = static_cast<char>(c);
+            else if (c >= 0x80) table[c] = static_cast<char>(c);  // keep UTF-8 bytes as-is
+            else table[c] = 0;
+        }
+        return table;
+    }
+
+    constexpr std::array<char, 256> NORMALIZE_TABLE = makeNormalizeTable();
+
+    // Mask that can never equal a valid key (keys use at most MAX_OPTIONS bits)
+    constexpr uint32_t INVALID_CHOICE = 0xFFFFFFFFu;
+}
+
+void QuizBank::normalize(std::string_view text, std::string& out) {
+    out.clear();
+    out.reserve(text.size());
+
+    bool pendingSpace = false;
+    for (unsigned char c : text) {
+        char mapped = NORMALIZE_TABLE[c];
+        if (mapped == ' ') {
+            pendingSpace = !out.empty();
+        } else if (mapped != 0) {
+            if (pendingSpace) {
+                out.push_back(' ');
+                pendingSpace = false;
+            }
+            out.push_back(mapped);
+        }
+    }
+}
+
+bool QuizBank::parseChoices(std::string_view text, uint32_t& mask) {
+    mask = 0;
+    for (char c : text) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c >= 'A' && c < static_cast<char>('A' + MAX_OPTIONS)) {
+            mask |= 1u << (c - 'A');
+        } else if (c != ',' && c != ' ' && c != '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QuizBank::addQuiz(const std::string& quizId, const std::vector<QuizQuestion>& questions,
+                       int pointsPerQuestion) {
+    CompiledQuiz quiz;
+    quiz.pointsPerQuestion = pointsPerQuestion;
+    quiz.kinds.reserve(questions.size());
+    quiz.choiceKeys.reserve(questions.size());
+    quiz.textKeys.reserve(questions.size());
+
+    for (const auto& question : questions) {
+        uint32_t mask = 0;
+        std::string text;
+
+        if (question.kind == QuestionKind::MULTIPLE_CHOICE) {
+            if (!parseChoices(question.answer, mask) || mask == 0) {
+                return false;
+            }
+        } else {
+            normalize(question.answer, text);
+        }
+
+        quiz.kinds.push_back(question.kind);
+        quiz.choiceKeys.push_back(mask);
+        quiz.textKeys.push_back(std::move(text));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    quizzes_[quizId] = std::move(quiz);
+    return true;
+}
+
+bool QuizBank::addExercise(const std::string& exerciseId, const std::vector<std::string>& acceptedAnswers,
+                           int points, const ExerciseGrading& grading) {
+    CompiledExercise exercise;
+    exercise.points = points;
+    exercise.grading = grading;
+    for (const auto& answer : acceptedAnswers) {
+        std::string normalized;
+        normalize(answer, normalized);
+        if (grading.mode == GradingMode::FUZZY) {
+            exercise.patterns.emplace_back(normalized);
+        }
+        exercise.accepted.push_back(std::move(normalized));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    exercises_[exerciseId] = std::move(exercise);
+    return true;
+}
+
+bool QuizBank::gradeQuiz(const std::string& quizId, const std::string_view* answers, size_t answerCount,
+                         GradeResult& result) const {
+    // Scratch buffers are reused across calls so steady-state grading does not allocate
+    thread_local std::vector<uint32_t> submitted;
+    thread_local std::string normalized;
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = quizzes_.find(quizId);
+    if (it == quizzes_.end()) {
+        return false;
+    }
+    const CompiledQuiz& quiz = it->second;
+    const size_t count = quiz.kinds.size();
+
+    submitted.assign(count, INVALID_CHOICE);
+
+    // Pass 1: turn every answer into a mask comparable against the key.
+    // Short answers are checked here and mapped to 0 (matches their zero key) or INVALID_CHOICE.
+    const size_t answered = std::min(count, answerCount);
+    for (size_t i = 0; i < answered; ++i) {
+        if (quiz.kinds[i] == QuestionKind::MULTIPLE_CHOICE) {
+            uint32_t mask;
+            if (parseChoices(answers[i], mask)) {
+                submitted[i] = mask;
+            }
+        } else {
+            normalize(answers[i], normalized);
+            const std::string& key = quiz.textKeys[i];
+            bool match = normalized.size() == key.size() &&
+                         std::memcmp(normalized.data(), key.data(), key.size()) == 0;
+            submitted[i] = match ? 0 : INVALID_CHOICE;
+        }
+    }
+
+    // Pass 2: branch-free compare over the whole key, packed into 64-bit words for popcount
+    result.perQuestion.assign(count, '0');
+    result.correct = 0;
+    const uint32_t* keys = quiz.choiceKeys.data();
+    const uint32_t* given = submitted.data();
+    for (size_t base = 0; base < count; base += 64) {
+        size_t end = std::min(count, base + 64);
+        uint64_t word = 0;
+        for (size_t i = base; i < end; ++i) {
+            word |= static_cast<uint64_t>(keys[i] == given[i]) << (i - base);
+        }
+        result.correct += std::bitset<64>(word).count();
+        for (size_t i = base; i < end; ++i) {
+            result.perQuestion[i] = static_cast<char>('0' + ((word >> (i - base)) & 1));
+        }
+    }
+
+    result.total = count;
+    result.score = static_cast<int>(result.correct) * quiz.pointsPerQuestion;
+    return true;
+}
+
+bool QuizBank::gradeExercise(const std::string& exerciseId, std::string_view answer, GradeResult& result) const {
+    thread_local std::string normalized;
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = exercises_.find(exerciseId);
+    if (it == exercises_.end()) {
+        return false;
+    }
+    const CompiledExercise& exercise = it->second;
+
+    normalize(answer, normalized);
+    result.total = 1;
+
+    if (exercise.grading.mode == GradingMode::FUZZY) {
+        // Each pattern is searched with the best distance so far as its bound, so later
+        // accepted answers usually bail out after a few characters
+        const size_t maxDistance = exercise.grading.maxDistance;
+        size_t best = maxDistance + 1;
+        for (const auto& pattern : exercise.patterns) {
+            if (best == 0) break;
+            size_t distance = exercise.grading.transpositions ? pattern.damerau(normalized, best - 1)
+                                                              : pattern.levenshtein(normalized, best - 1);
+            best = std::min(best, distance);
+        }
+
+        // Linear partial credit: full points for an exact match, zero past maxDistance
+        result.distance = best;
+        result.correct = best == 0 ? 1 : 0;
+        result.perQuestion = result.correct ? "1" : "0";
+        result.score = static_cast<int>(exercise.points * (maxDistance + 1 - best) / (maxDistance + 1));
+        return true;
+    }
+
+    bool match = std::find(exercise.accepted.begin(), exercise.accepted.end(), normalized) !=
+                 exercise.accepted.end();
+
+    result.distance = 0;
+    result.correct = match ? 1 : 0;
+    result.perQuestion = match ? "1" : "0";
+    result.score = match ? exercise.points : 0;
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef QUIZ_BANK_HPP
+#define QUIZ_BANK_HPP
+
+#include "../../include/common.hpp"
+#include "../utils/EditDistance.hpp"
+#include <shared_mutex>
+#include <string_view>
+
+// Kind of question in a quiz
+enum class QuestionKind : uint8_t {
+    MULTIPLE_CHOICE = 1,   // answer is a set of option letters, e.g. "AC"
+    SHORT_ANSWER = 2       // answer is free text compared after normalization
+};
+
+// How an exercise answer is compared with the accepted answers
+enum class GradingMode : uint8_t {
+    EXACT = 1,     // normalized answer must equal an accepted answer
+    FUZZY = 2      // partial credit by bounded edit distance (spelling practice)
+};
+
+struct ExerciseGrading {
+    GradingMode mode = GradingMode::EXACT;
+    size_t maxDistance = 0;       // FUZZY: distances above this score zero
+    bool transpositions = true;   // FUZZY: count swapped adjacent letters as one edit
+
+    ExerciseGrading() = default;
+    ExerciseGrading(GradingMode m, size_t maxDist, bool transpose = true)
+        : mode(m), maxDistance(maxDist), transpositions(transpose) {}
+};
+
+// Question as authored (before compilation)
+struct QuizQuestion {
+    QuestionKind kind;
+    std::string answer;
+
+    QuizQuestion(QuestionKind k, const std::string& a) : kind(k), answer(a) {}
+};
+
+// Result of grading a submission
+struct GradeResult {
+    int score = 0;
+    size_t correct = 0;
+    size_t total = 0;
+    std::string perQuestion;   // one '1' (correct) or '0' (wrong) per question
+    size_t distance = 0;       // FUZZY exercises: edits to the closest accepted answer
+};
+
+// Quiz and exercise bank with compiled answer keys.
+// Multiple choice keys are stored as option bitmasks so a submission is checked with
+// one compare per question and counted with popcount; short answers are pre-normalized so
+// grading is a single normalize pass over the submission plus a length+memcmp check.
+class QuizBank {
+public:
+    static constexpr size_t MAX_OPTIONS = 26;  // options 'A'..'Z'
+
+    // Register a quiz; returns false if the key cannot be compiled
+    bool addQuiz(const std::string& quizId, const std::vector<QuizQuestion>& questions,
+                 int pointsPerQuestion = 10);
+
+    // Register an exercise with one or more accepted answers
+    bool addExercise(const std::string& exerciseId, const std::vector<std::string>& acceptedAnswers,
+                     int points = 5, const ExerciseGrading& grading = ExerciseGrading());
+
+    // Grade a quiz submission: answerCount answers in question order, missing ones count as
+    // wrong. Returns false if the quiz does not exist.
+    bool gradeQuiz(const std::string& quizId, const std::string_view* answers, size_t answerCount,
+                   GradeResult& result) const;
+
+    // Grade an exercise submission. Returns false if the exercise does not exist.
+    bool gradeExercise(const std::string& exerciseId, std::string_view answer, GradeResult& result) const;
+
+    // Lowercase, drop punctuation and collapse whitespace
+    static void normalize(std::string_view text, std::string& out);
+
+    // Parse option letters ("AC", "a, c") into a bitmask; false on invalid input
+    static bool parseChoices(std::string_view text, uint32_t& mask);
+
+private:
+    struct CompiledQuiz {
+        int pointsPerQuestion = 0;
+        std::vector<QuestionKind> kinds;
+        std::vector<uint32_t> choiceKeys;      // per question, 0 for short answers
+        std::vector<std::string> textKeys;     // per question, empty for multiple choice
+    };
+
+    struct CompiledExercise {
+        int points = 0;
+        ExerciseGrading grading;
+        std::vector<std::string> accepted;             // normalized
+        std::vector<EditDistancePattern> patterns;     // FUZZY: one per accepted answer
+    };
+
+    std::map<std::string, CompiledQuiz> quizzes_;
+    std::map<std::string, CompiledExercise> exercises_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // QUIZ_BANK_HPP
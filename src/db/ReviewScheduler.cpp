@@ -0,0 +1,223 @@
+#include "ReviewScheduler.hpp"
+#include <cmath>
+#include <queue>
+
+namespace {
+    constexpr uint32_t MINUTES_PER_DAY = 24 * 60;
+    constexpr uint16_t DEFAULT_EASE = 2500;
+    constexpr uint16_t MIN_EASE = 1300;
+    constexpr uint16_t MAX_INTERVAL_DAYS = 36500;
+
+    inline size_t hashKey(uint32_t userId, uint32_t itemId) {
+        uint64_t key = (static_cast<uint64_t>(userId) << 32) | itemId;
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+}
+
+uint32_t ReviewScheduler::currentMinute() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::minutes>(now).count());
+}
+
+void ReviewScheduler::recordReview(const std::string& username, const std::string& itemKey,
+                                   int quality, uint32_t nowMinute) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint32_t userId = internUser(username);
+    uint32_t itemId = internItem(itemKey);
+    UserQueue& queue = queues_[userId];
+
+    uint32_t slot = findSlot(userId, itemId);
+    if (slot == EMPTY_SLOT) {
+        slot = static_cast<uint32_t>(records_.size());
+
+        ReviewRecord record{};
+        record.itemId = itemId;
+        record.dueMinute = nowMinute;
+        record.easeFactor = DEFAULT_EASE;
+        records_.push_back(record);
+        heapPos_.push_back(static_cast<uint32_t>(queue.heap.size()));
+        queue.heap.push_back(slot);
+        insertIndex(userId, itemId, slot);
+    }
+
+    uint32_t oldDue = records_[slot].dueMinute;
+    applySm2(records_[slot], quality, nowMinute);
+
+    size_t pos = heapPos_[slot];
+    if (records_[slot].dueMinute < oldDue) {
+        siftUp(queue, pos);
+    } else {
+        siftDown(queue, pos);
+        siftUp(queue, heapPos_[slot]);  // a brand-new record starts at the bottom
+    }
+}
+
+std::pmr::vector<std::pmr::string> ReviewScheduler::getDueItems(const std::string& username, size_t count,
+                                                                uint32_t nowMinute,
+                                                                std::pmr::memory_resource* resource) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::pmr::vector<std::pmr::string> items(resource);
+    auto userIt = userIds_.find(username);
+    if (userIt == userIds_.end() || count == 0) {
+        return items;
+    }
+    const std::vector<uint32_t>& heap = queues_[userIt->second].heap;
+
+    // Best-first walk of the heap: the frontier only ever holds children of emitted
+    // nodes, so N results cost O(N log N) without mutating the user's heap
+    using Candidate = std::pair<uint32_t, size_t>;   // (dueMinute, heap position)
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+    if (!heap.empty()) {
+        frontier.emplace(records_[heap[0]].dueMinute, 0);
+    }
+
+    while (!frontier.empty() && items.size() < count) {
+        auto [due, pos] = frontier.top();
+        frontier.pop();
+        if (due > nowMinute) break;
+
+        items.emplace_back(itemKeys_[records_[heap[pos]].itemId]);
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); ++child) {
+            frontier.emplace(records_[heap[child]].dueMinute, child);
+        }
+    }
+
+    return items;
+}
+
+size_t ReviewScheduler::getItemCount(const std::string& username) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = userIds_.find(username);
+    return it == userIds_.end() ? 0 : queues_[it->second].heap.size();
+}
+
+void ReviewScheduler::applySm2(ReviewRecord& record, int quality, uint32_t nowMinute) {
+    quality = std::max(0, std::min(QUALITY_PERFECT, quality));
+
+    if (quality >= QUALITY_PARTIAL) {
+        if (record.repetitions == 0) {
+            record.intervalDays = 1;
+        } else if (record.repetitions == 1) {
+            record.intervalDays = 6;
+        } else {
+            double next = std::round(record.intervalDays * (record.easeFactor / 1000.0));
+            record.intervalDays = static_cast<uint16_t>(std::min<double>(next, MAX_INTERVAL_DAYS));
+        }
+        if (record.repetitions < 255) record.repetitions++;
+    } else {
+        record.repetitions = 0;
+        record.intervalDays = 1;
+        if (record.lapses < 255) record.lapses++;
+    }
+
+    // EF' = EF + (0.1 - (5 - q) * (0.08 + (5 - q) * 0.02)), in thousandths
+    int miss = QUALITY_PERFECT - quality;
+    int ease = record.easeFactor + 100 - miss * (80 + miss * 20);
+    record.easeFactor = static_cast<uint16_t>(std::max<int>(MIN_EASE, ease));
+
+    record.dueMinute = nowMinute + record.intervalDays * MINUTES_PER_DAY;
+}
+
+uint32_t ReviewScheduler::internUser(const std::string& username) {
+    auto it = userIds_.find(username);
+    if (it != userIds_.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(queues_.size());
+    queues_.emplace_back();
+    userIds_.emplace(username, id);
+    return id;
+}
+
+uint32_t ReviewScheduler::internItem(const std::string& itemKey) {
+    auto it = itemIds_.find(itemKey);
+    if (it != itemIds_.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(itemKeys_.size());
+    itemKeys_.push_back(itemKey);
+    itemIds_.emplace(itemKey, id);
+    return id;
+}
+
+uint32_t ReviewScheduler::findSlot(uint32_t userId, uint32_t itemId) const {
+    if (index_.empty()) return EMPTY_SLOT;
+
+    size_t mask = index_.size() - 1;
+    for (size_t i = hashKey(userId, itemId) & mask; ; i = (i + 1) & mask) {
+        const IndexEntry& entry = index_[i];
+        if (entry.slot == EMPTY_SLOT) return EMPTY_SLOT;
+        if (entry.userId == userId && entry.itemId == itemId) return entry.slot;
+    }
+}
+
+void ReviewScheduler::insertIndex(uint32_t userId, uint32_t itemId, uint32_t slot) {
+    // Keep the load factor under 0.7 so probe sequences stay short
+    if ((indexUsed_ + 1) * 10 > index_.size() * 7) {
+        growIndex();
+    }
+
+    size_t mask = index_.size() - 1;
+    size_t i = hashKey(userId, itemId) & mask;
+    while (index_[i].slot != EMPTY_SLOT) {
+        i = (i + 1) & mask;
+    }
+    index_[i] = {userId, itemId, slot};
+    indexUsed_++;
+}
+
+void ReviewScheduler::growIndex() {
+    std::vector<IndexEntry> old;
+    old.swap(index_);
+    index_.assign(old.empty() ? 1024 : old.size() * 2, IndexEntry{0, 0, EMPTY_SLOT});
+
+    size_t mask = index_.size() - 1;
+    for (const auto& entry : old) {
+        if (entry.slot == EMPTY_SLOT) continue;
+        size_t i = hashKey(entry.userId, entry.itemId) & mask;
+        while (index_[i].slot != EMPTY_SLOT) {
+            i = (i + 1) & mask;
+        }
+        index_[i] = entry;
+    }
+}
+
+void ReviewScheduler::placeAt(UserQueue& queue, size_t pos, uint32_t slot) {
+    queue.heap[pos] = slot;
+    heapPos_[slot] = static_cast<uint32_t>(pos);
+}
+
+void ReviewScheduler::siftUp(UserQueue& queue, size_t pos) {
+    uint32_t slot = queue.heap[pos];
+    uint32_t due = records_[slot].dueMinute;
+
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (records_[queue.heap[parent]].dueMinute <= due) break;
+        placeAt(queue, pos, queue.heap[parent]);
+        pos = parent;
+    }
+    placeAt(queue, pos, slot);
+}
+
+void ReviewScheduler::siftDown(UserQueue& queue, size_t pos) {
+    const size_t size = queue.heap.size();
+    uint32_t slot = queue.heap[pos];
+    uint32_t due = records_[slot].dueMinute;
+
+    while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && records_[queue.heap[child + 1]].dueMinute < records_[queue.heap[child]].dueMinute) {
+            child++;
+        }
+        if (records_[queue.heap[child]].dueMinute >= due) break;
+        placeAt(queue, pos, queue.heap[child]);
+        pos = child;
+    }
+    placeAt(queue, pos, slot);
+}
@@ -0,0 +1,85 @@
+#ifndef REVIEW_SCHEDULER_HPP
+#define REVIEW_SCHEDULER_HPP
+
+#include "../../include/common.hpp"
+#include <unordered_map>
+
+// Review state for one (user, item) pair, packed into 16 bytes
+struct ReviewRecord {
+    uint32_t itemId;          // interned item key
+    uint32_t dueMinute;       // minutes since the Unix epoch
+    uint16_t intervalDays;    // current SM-2 interval
+    uint16_t easeFactor;      // SM-2 easiness factor * 1000 (>= 1300)
+    uint8_t repetitions;      // successful reviews in a row
+    uint8_t lapses;           // times the item was forgotten
+    uint16_t reserved;
+};
+
+static_assert(sizeof(ReviewRecord) == 16, "ReviewRecord must stay compact");
+
+// SM-2 spaced-repetition scheduler.
+// Every graded quiz question, exercise and game move is recorded as a review; each user's
+// items live in an indexed min-heap keyed by due time, so rescheduling an item is O(log M)
+// and listing the next N due items is O(N log N) regardless of how many items a user has.
+class ReviewScheduler {
+public:
+    // Answer quality on the SM-2 scale (0 = blackout .. 5 = perfect)
+    static constexpr int QUALITY_PERFECT = 5;
+    static constexpr int QUALITY_PARTIAL = 3;
+    static constexpr int QUALITY_FAILED = 1;
+
+    // Record a review of an item and reschedule it
+    void recordReview(const std::string& username, const std::string& itemKey, int quality, uint32_t nowMinute);
+
+    // Up to count items that are due at nowMinute, most overdue first, allocated from resource
+    std::pmr::vector<std::pmr::string> getDueItems(const std::string& username, size_t count, uint32_t nowMinute,
+                                                   std::pmr::memory_resource* resource =
+                                                       std::pmr::get_default_resource()) const;
+
+    // Number of items tracked for a user
+    size_t getItemCount(const std::string& username) const;
+
+    // Current time in scheduler units
+    static uint32_t currentMinute();
+
+private:
+    // Open-addressing table mapping (user, item) to a record slot
+    struct IndexEntry {
+        uint32_t userId;
+        uint32_t itemId;
+        uint32_t slot;      // EMPTY_SLOT when unused
+    };
+
+    struct UserQueue {
+        std::vector<uint32_t> heap;     // record slots ordered by dueMinute
+    };
+
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    uint32_t internUser(const std::string& username);
+    uint32_t internItem(const std::string& itemKey);
+
+    uint32_t findSlot(uint32_t userId, uint32_t itemId) const;
+    void insertIndex(uint32_t userId, uint32_t itemId, uint32_t slot);
+    void growIndex();
+
+    void siftUp(UserQueue& queue, size_t pos);
+    void siftDown(UserQueue& queue, size_t pos);
+    void placeAt(UserQueue& queue, size_t pos, uint32_t slot);
+
+    static void applySm2(ReviewRecord& record, int quality, uint32_t nowMinute);
+
+    std::vector<ReviewRecord> records_;         // all records, addressed by slot
+    std::vector<uint32_t> heapPos_;             // slot -> position in its user's heap
+    std::vector<UserQueue> queues_;             // userId -> due-time heap
+    std::vector<IndexEntry> index_;             // (user, item) -> slot
+    size_t indexUsed_ = 0;
+
+    std::unordered_map<std::string, uint32_t> userIds_;
+    std::unordered_map<std::string, uint32_t> itemIds_;
+    std::vector<std::string> itemKeys_;         // itemId -> key
+
+    mutable std::mutex mutex_;
+};
+
+#endif // REVIEW_SCHEDULER_HPP
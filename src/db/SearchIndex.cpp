@@ -0,0 +1,505 @@
+#include "SearchIndex.hpp"
+#include <cmath>
+
+namespace {
+    using PostingList = SearchIndex::PostingList;
+
+    // BM25 parameters: term frequency saturation and length normalization
+    const double K1 = 1.2;
+    const double B = 0.75;
+
+    void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint32_t getVarint(const uint8_t*& p) {
+        uint32_t value = 0;
+        int shift = 0;
+        while (*p & 0x80) {
+            value |= static_cast<uint32_t>(*p++ & 0x7F) << shift;
+            shift += 7;
+        }
+        return value | static_cast<uint32_t>(*p++) << shift;
+    }
+
+    bool isWordByte(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+    }
+
+    // Calls fn with each word of text, lower-cased and cut to MAX_TERM_BYTES
+    template <typename F>
+    void forEachWord(std::string_view text, F&& fn) {
+        std::string word;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+            if (isWordByte(c)) {
+                if (word.size() < SearchIndex::MAX_TERM_BYTES) {
+                    word.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c));
+                }
+            } else if (!word.empty()) {
+                fn(word);
+                word.clear();
+            }
+        }
+    }
+
+    // Every posting of list in order; deltas continue across blocks, so no skip entry is needed
+    template <typename F>
+    void forEachPosting(const SearchIndex::Segment& segment, const PostingList& list, F&& fn) {
+        if (list.count == 0) return;
+        const uint8_t* p = segment.postings.data() + segment.skips[list.firstSkip].offset;
+        uint32_t doc = 0;
+        for (uint32_t i = 0; i < list.count; ++i) {
+            doc += getVarint(p);
+            uint32_t frequency = getVarint(p);
+            fn(doc, frequency);
+        }
+    }
+
+    // Forward-only reader over one posting list that decodes a block at a time
+    class PostingCursor {
+    public:
+        PostingCursor(const SearchIndex::Segment& segment, const PostingList& list, double idf)
+            : segment_(&segment), list_(&list), idf_(idf),
+              blocks_((list.count + SearchIndex::BLOCK_SIZE - 1) / SearchIndex::BLOCK_SIZE) {}
+
+        // Move to the first posting with an id of at least target; false when there is none
+        bool advance(uint32_t target) {
+            if (pos_ < size_ && docs_[pos_] >= target) return true;
+            if (pos_ + 1 < size_ && docs_[pos_ + 1] >= target) {   // the usual step to the next posting
+                ++pos_;
+                return true;
+            }
+            if (size_ > 0 && docs_[size_ - 1] >= target) {
+                pos_ = std::lower_bound(docs_.begin() + pos_, docs_.begin() + size_, target) - docs_.begin();
+                return true;
+            }
+
+            // Blocks that end below target are skipped undecoded
+            auto skips = segment_->skips.begin() + list_->firstSkip;
+            auto it = std::partition_point(skips + (size_ > 0 ? block_ + 1 : 0), skips + blocks_,
+                                           [target](const SearchIndex::Skip& skip) { return skip.lastDoc < target; });
+            if (it == skips + blocks_) return false;
+
+            decode(static_cast<size_t>(it - skips));
+            pos_ = std::lower_bound(docs_.begin(), docs_.begin() + size_, target) - docs_.begin();
+            return true;
+        }
+
+        uint32_t doc() const { return docs_[pos_]; }
+        uint32_t frequency() const { return frequencies_[pos_]; }
+        double idf() const { return idf_; }
+
+    private:
+        void decode(size_t block) {
+            const SearchIndex::Skip* skips = segment_->skips.data() + list_->firstSkip;
+            const uint8_t* p = segment_->postings.data() + skips[block].offset;
+            uint32_t doc = block > 0 ? skips[block - 1].lastDoc : 0;
+            block_ = block;
+            size_ = std::min<size_t>(SearchIndex::BLOCK_SIZE, list_->count - block * SearchIndex::BLOCK_SIZE);
+            for (size_t i = 0; i < size_; ++i) {
+                doc += getVarint(p);
+                docs_[i] = doc;
+                frequencies_[i] = getVarint(p);
+            }
+        }
+
+        const SearchIndex::Segment* segment_;
+        const PostingList* list_;
+        double idf_;
+        size_t blocks_;
+        size_t block_ = 0;
+        size_t pos_ = 0;
+        size_t size_ = 0;     // postings decoded from block_, 0 before the first
+        std::array<uint32_t, SearchIndex::BLOCK_SIZE> docs_;
+        std::array<uint32_t, SearchIndex::BLOCK_SIZE> frequencies_;
+    };
+
+    // Fills a segment: postings are collected in arrival order and encoded together by
+    // finish(), one term after another, so the lists need no allocations of their own
+    class SegmentBuilder {
+    public:
+        explicit SegmentBuilder(SearchIndex::Segment& segment) : segment_(segment) {}
+
+        // Index a document; fields are (text, weight of each of its words). Local ids follow
+        // the order documents are added in.
+        void addDocument(SearchIndex::Document document,
+                         std::initializer_list<std::pair<std::string_view, uint32_t>> fields) {
+            words_.clear();
+            for (const auto& field : fields) {
+                forEachWord(field.first, [&](const std::string& word) { words_.emplace_back(word, field.second); });
+            }
+            std::sort(words_.begin(), words_.end());
+
+            uint32_t local = static_cast<uint32_t>(segment_.documents.size());
+            for (size_t i = 0; i < words_.size();) {
+                uint32_t frequency = 0;
+                size_t j = i;
+                for (; j < words_.size() && words_[j].first == words_[i].first; ++j) {
+                    frequency += words_[j].second;
+                }
+                addPosting(term(words_[i].first), local, frequency);
+                document.length += frequency;
+                i = j;
+            }
+            segment_.documents.push_back(std::move(document));
+        }
+
+        // Until finish(), a list's firstSkip holds the term's ordinal
+        PostingList* term(const std::string& word) {
+            auto inserted = segment_.terms.try_emplace(word);
+            PostingList* list = &inserted.first->second;
+            if (inserted.second) {
+                list->firstSkip = static_cast<uint32_t>(lists_.size());
+                lists_.push_back(list);
+            }
+            return list;
+        }
+
+        // A term's postings must be added in ascending id order
+        void addPosting(PostingList* list, uint32_t doc, uint32_t frequency) {
+            pending_.push_back({list->firstSkip, doc, frequency});
+            list->count++;
+        }
+
+        void finish() {
+            // Counting sort by term; stable, so each term keeps its ascending ids
+            std::vector<uint32_t> next(lists_.size() + 1, 0);
+            for (size_t t = 0; t < lists_.size(); ++t) {
+                next[t + 1] = next[t] + lists_[t]->count;
+            }
+            std::vector<Posting> sorted(pending_.size());
+            for (const Posting& posting : pending_) {
+                sorted[next[posting.term]++] = posting;
+            }
+            std::vector<Posting>().swap(pending_);
+
+            segment_.postings.reserve(sorted.size() * 3);
+            segment_.skips.reserve(sorted.size() / SearchIndex::BLOCK_SIZE + lists_.size());
+            size_t at = 0;
+            for (PostingList* list : lists_) {
+                list->firstSkip = static_cast<uint32_t>(segment_.skips.size());
+                uint32_t previous = 0;
+                for (uint32_t i = 0; i < list->count; ++i, ++at) {
+                    const Posting& posting = sorted[at];
+                    if (i % SearchIndex::BLOCK_SIZE == 0) {
+                        segment_.skips.push_back({posting.doc, static_cast<uint32_t>(segment_.postings.size())});
+                    }
+                    putVarint(segment_.postings, posting.doc - previous);
+                    putVarint(segment_.postings, posting.frequency);
+                    segment_.skips.back().lastDoc = posting.doc;
+                    previous = posting.doc;
+                }
+            }
+        }
+
+    private:
+        struct Posting {
+            uint32_t term;
+            uint32_t doc;
+            uint32_t frequency;
+        };
+
+        SearchIndex::Segment& segment_;
+        std::vector<PostingList*> lists_;      // by ordinal
+        std::vector<Posting> pending_;
+        std::vector<std::pair<std::string, uint32_t>> words_;
+    };
+
+    ProficiencyLevel normalized(ProficiencyLevel level) {
+        return static_cast<ProficiencyLevel>(LessonCatalog::levelIndex(level) + 1);
+    }
+
+    // Heap order with the worst hit on top; equal scores rank the older document first
+    bool betterHit(const SearchIndex::Hit& a, const SearchIndex::Hit& b) {
+        return a.score > b.score || (a.score == b.score && a.id < b.id);
+    }
+}
+
+bool SearchIndex::Snapshot::isDeleted(uint32_t doc) const {
+    return deleted && doc / 64 < deleted->size() && ((*deleted)[doc / 64] >> (doc % 64) & 1);
+}
+
+const SearchIndex::Document& SearchIndex::Snapshot::document(uint32_t doc) const {
+    auto it = std::upper_bound(segments.begin(), segments.end(), doc,
+                               [](uint32_t id, const SegmentPtr& segment) { return id < segment->firstDoc; });
+    const Segment& segment = **(it - 1);
+    return segment.documents[doc - segment.firstDoc];
+}
+
+SearchIndex::SearchIndex() : snapshot_(std::make_shared<const Snapshot>()) {}
+
+SearchIndex::SnapshotPtr SearchIndex::getSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+void SearchIndex::addLessons(const std::vector<Lesson>& lessons) {
+    std::unordered_map<std::string_view, size_t> latest;
+    for (size_t i = 0; i < lessons.size(); ++i) {
+        latest[lessons[i].id] = i;
+    }
+
+    // Tokenizing needs no lock; ids are assigned when the segment is published
+    auto segment = std::make_shared<Segment>();
+    SegmentBuilder builder(*segment);
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < lessons.size(); ++i) {
+        const Lesson& lesson = lessons[i];
+        if (latest[lesson.id] != i) continue;
+
+        Document document;
+        document.key = lesson.id;
+        document.title = lesson.title;
+        document.level = normalized(lesson.level);
+        document.kind = SearchKind::LESSON;
+        builder.addDocument(std::move(document), {{lesson.title, TITLE_WEIGHT}, {lesson.body, 1}});
+        ids.push_back(lesson.id);
+    }
+    builder.finish();
+    if (!ids.empty()) {
+        publish(std::move(segment), ids);
+    }
+}
+
+void SearchIndex::addItems(const std::map<std::string, std::vector<GameItem>>& itemsByType) {
+    auto segment = std::make_shared<Segment>();
+    size_t count = 0;
+    for (const auto& group : itemsByType) {
+        count += group.second.size();
+    }
+    segment->documents.reserve(count);
+    segment->terms.reserve(count);   // about a new word per item, rehashing a large map is slow
+
+    SegmentBuilder builder(*segment);
+    for (const auto& group : itemsByType) {
+        for (const GameItem& item : group.second) {
+            Document document;
+            document.key = group.first;
+            document.title = item.data;
+            document.level = normalized(item.level);
+            document.kind = SearchKind::GAME_ITEM;
+            builder.addDocument(std::move(document), {{item.data, 1}});
+        }
+    }
+    builder.finish();
+    if (!segment->documents.empty()) {
+        publish(std::move(segment), {});
+    }
+}
+
+void SearchIndex::publish(std::shared_ptr<Segment> segment, const std::vector<std::string>& lessonIds) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::shared_ptr<const Snapshot> current = std::atomic_load(&snapshot_);
+    auto next = std::make_shared<Snapshot>(*current);
+    next->version++;
+
+    segment->firstDoc = nextDoc_;
+    nextDoc_ += static_cast<uint32_t>(segment->documents.size());
+
+    // lessonIds name the segment's first documents; earlier documents of those ids are deleted
+    if (!lessonIds.empty()) {
+        auto deleted = current->deleted ? std::make_shared<std::vector<uint64_t>>(*current->deleted)
+                                        : std::make_shared<std::vector<uint64_t>>();
+        for (size_t i = 0; i < lessonIds.size(); ++i) {
+            uint32_t doc = segment->firstDoc + static_cast<uint32_t>(i);
+            auto it = lessonDocs_.find(lessonIds[i]);
+            if (it == lessonDocs_.end()) {
+                lessonDocs_.emplace(lessonIds[i], doc);
+                continue;
+            }
+
+            uint32_t old = it->second;
+            if (deleted->size() <= old / 64) {
+                deleted->resize(old / 64 + 1, 0);
+            }
+            (*deleted)[old / 64] |= uint64_t(1) << (old % 64);
+            next->liveDocuments--;
+            next->liveLength -= current->document(old).length;
+            it->second = doc;
+        }
+        next->deleted = std::move(deleted);
+    }
+
+    next->liveDocuments += segment->documents.size();
+    for (const Document& document : segment->documents) {
+        next->liveLength += document.length;
+    }
+    next->segments.push_back(std::move(segment));
+
+    // Merge while the newest segment is at least as large as the one before it
+    auto& segments = next->segments;
+    while (segments.size() >= 2 &&
+           segments[segments.size() - 2]->documents.size() <= segments.back()->documents.size()) {
+        const Segment& older = *segments[segments.size() - 2];
+        SegmentPtr merged = merge(older, *segments.back(), *next);
+        if (merged->documents.size() < older.documents.size() + segments.back()->documents.size()) {
+            renumber(*next, *merged);
+        }
+        segments.pop_back();
+        segments.back() = std::move(merged);
+    }
+
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)));
+}
+
+SearchIndex::SegmentPtr SearchIndex::merge(const Segment& older, const Segment& newer, const Snapshot& snapshot) {
+    auto merged = std::make_shared<Segment>();
+    merged->firstDoc = older.firstDoc;
+    merged->documents.reserve(older.documents.size() + newer.documents.size());
+    merged->terms.reserve(std::max(older.terms.size(), newer.terms.size()));
+
+    // Deleted documents are dropped and the live ones renumbered densely from older's first id;
+    // locals holds the new local id of each document of older, then of newer
+    const uint32_t DROPPED = UINT32_MAX;
+    std::vector<uint32_t> locals;
+    locals.reserve(older.documents.size() + newer.documents.size());
+    for (const Segment* from : {&older, &newer}) {
+        for (size_t i = 0; i < from->documents.size(); ++i) {
+            if (snapshot.isDeleted(from->firstDoc + static_cast<uint32_t>(i))) {
+                locals.push_back(DROPPED);
+                continue;
+            }
+            locals.push_back(static_cast<uint32_t>(merged->documents.size()));
+            merged->documents.push_back(from->documents[i]);
+        }
+    }
+
+    // All of older's postings precede newer's and renumbering keeps the order, so each list
+    // stays in id order
+    SegmentBuilder builder(*merged);
+    auto copyPostings = [&](const Segment& from, size_t base) {
+        for (const auto& term : from.terms) {
+            PostingList* target = nullptr;
+            forEachPosting(from, term.second, [&](uint32_t local, uint32_t frequency) {
+                uint32_t doc = locals[base + local];
+                if (doc == DROPPED) return;
+                if (!target) target = builder.term(term.first);
+                builder.addPosting(target, doc, frequency);
+            });
+        }
+    };
+    copyPostings(older, 0);
+    copyPostings(newer, older.documents.size());
+    builder.finish();
+    return merged;
+}
+
+void SearchIndex::renumber(Snapshot& snapshot, const Segment& merged) {
+    for (size_t i = 0; i < merged.documents.size(); ++i) {
+        const Document& document = merged.documents[i];
+        if (document.kind == SearchKind::LESSON) {
+            lessonDocs_.find(document.key)->second = merged.firstDoc + static_cast<uint32_t>(i);
+        }
+    }
+
+    // The merged segment is the newest, so no id past it is in use and its own are all live
+    nextDoc_ = merged.firstDoc + static_cast<uint32_t>(merged.documents.size());
+    size_t words = (merged.firstDoc + 63) / 64;
+    auto deleted = std::make_shared<std::vector<uint64_t>>(
+        snapshot.deleted->begin(), snapshot.deleted->begin() + std::min(words, snapshot.deleted->size()));
+    if (merged.firstDoc % 64 != 0 && deleted->size() == words) {
+        deleted->back() &= (uint64_t(1) << (merged.firstDoc % 64)) - 1;
+    }
+    snapshot.deleted = std::move(deleted);
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::search(const Snapshot& snapshot, std::string_view query, uint8_t level,
+                                                  size_t limit, size_t& matches) {
+    matches = 0;
+    std::vector<std::string> words = tokenize(query);
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    if (words.empty() || limit == 0 || snapshot.liveDocuments == 0) {
+        return {};
+    }
+
+    // Document frequencies over the whole index; a word found nowhere matches nothing
+    double documents = static_cast<double>(snapshot.liveDocuments);
+    std::vector<double> idf(words.size());
+    for (size_t w = 0; w < words.size(); ++w) {
+        size_t frequency = 0;
+        for (const SegmentPtr& segment : snapshot.segments) {
+            auto it = segment->terms.find(words[w]);
+            if (it != segment->terms.end()) frequency += it->second.count;
+        }
+        if (frequency == 0) return {};
+        double df = std::min(static_cast<double>(frequency), documents);
+        idf[w] = std::log(1.0 + (documents - df + 0.5) / (df + 0.5));
+    }
+    double averageLength = std::max(1.0, static_cast<double>(snapshot.liveLength) / documents);
+    double lengthFactor = K1 * B / averageLength;
+
+    std::vector<Hit> top;   // heap, worst hit on top
+    std::vector<PostingCursor> cursors;
+    for (const SegmentPtr& segment : snapshot.segments) {
+        cursors.clear();
+        for (size_t w = 0; w < words.size(); ++w) {
+            auto it = segment->terms.find(words[w]);
+            if (it == segment->terms.end()) break;
+            cursors.emplace_back(*segment, it->second, idf[w]);
+        }
+        if (cursors.size() < words.size()) continue;
+
+        // The rarest word leads; the others are advanced to its candidates
+        std::sort(cursors.begin(), cursors.end(), [](const PostingCursor& a, const PostingCursor& b) {
+            return a.idf() > b.idf();
+        });
+
+        uint32_t target = 0;
+        for (bool exhausted = false; !exhausted;) {
+            bool aligned = true;
+            for (PostingCursor& cursor : cursors) {
+                if (!cursor.advance(target)) {
+                    exhausted = true;
+                    break;
+                }
+                if (cursor.doc() != target) {
+                    target = cursor.doc();
+                    aligned = false;
+                    break;
+                }
+            }
+            if (exhausted || !aligned) continue;
+
+            uint32_t id = segment->firstDoc + target;
+            const Document& document = segment->documents[target];
+            ++target;
+            if (snapshot.isDeleted(id) || (level != 0 && static_cast<uint8_t>(document.level) != level)) {
+                continue;
+            }
+            matches++;
+
+            double norm = K1 * (1.0 - B) + lengthFactor * document.length;
+            double score = 0;
+            for (const PostingCursor& cursor : cursors) {
+                double tf = cursor.frequency();
+                score += cursor.idf() * tf / (tf + norm);
+            }
+            score *= K1 + 1.0;
+
+            Hit hit{&document, id, score};
+            if (top.size() < limit) {
+                top.push_back(hit);
+                std::push_heap(top.begin(), top.end(), betterHit);
+            } else if (betterHit(hit, top.front())) {
+                std::pop_heap(top.begin(), top.end(), betterHit);
+                top.back() = hit;
+                std::push_heap(top.begin(), top.end(), betterHit);
+            }
+        }
+    }
+
+    std::sort_heap(top.begin(), top.end(), betterHit);
+    return top;
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text) {
+    std::vector<std::string> words;
+    forEachWord(text, [&words](const std::string& word) { words.push_back(word); });
+    return words;
+}
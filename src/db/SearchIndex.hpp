@@ -0,0 +1,108 @@
+#ifndef SEARCH_INDEX_HPP
+#define SEARCH_INDEX_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "LessonCatalog.hpp"
+#include "GameCatalog.hpp"
+#include <atomic>
+#include <unordered_map>
+
+// Full-text index over lesson titles and bodies and game item data.
+// Documents live in immutable segments, each with its own posting lists. A write indexes
+// the new documents into a segment and publishes a new snapshot (the segment list) with an
+// atomic store, so readers never lock. Segments are merged binary-counter style as they pile
+// up, which keeps their number logarithmic in the document count. A replaced lesson is only
+// marked deleted; the next merge over its segment drops the document and renumbers the ones
+// after it, so neither the segments nor the deleted bitmap keep growing with replacements.
+class SearchIndex {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;      // postings per skip entry
+    static constexpr size_t MAX_TERM_BYTES = 64;   // longer words are cut
+    static constexpr uint32_t TITLE_WEIGHT = 3;    // a lesson title word counts as this many body words
+
+    struct Document {
+        std::string key;        // lesson id or game type
+        std::string title;      // lesson title or item data
+        uint32_t length = 0;    // weighted word count
+        ProficiencyLevel level = ProficiencyLevel::BEGINNER;
+        SearchKind kind = SearchKind::LESSON;
+    };
+
+    // A term's postings in its segment: ascending local document ids with term frequencies,
+    // delta + varint coded in blocks of BLOCK_SIZE postings. Skip entry firstSkip + b holds
+    // the last id of block b and where the block starts, so an intersection steps over
+    // whole blocks without decoding them.
+    struct PostingList {
+        uint32_t count = 0;
+        uint32_t firstSkip = 0;
+    };
+    struct Skip {
+        uint32_t lastDoc;
+        uint32_t offset;    // in Segment::postings
+    };
+
+    // Postings use ids local to the segment; the global id is firstDoc + local id. All of a
+    // segment's lists share one byte array and one skip array.
+    struct Segment {
+        uint32_t firstDoc = 0;
+        std::vector<Document> documents;
+        std::unordered_map<std::string, PostingList> terms;
+        std::vector<uint8_t> postings;
+        std::vector<Skip> skips;
+    };
+    using SegmentPtr = std::shared_ptr<const Segment>;
+
+    struct Snapshot {
+        uint64_t version = 0;
+        std::vector<SegmentPtr> segments;                       // ascending firstDoc
+        std::shared_ptr<const std::vector<uint64_t>> deleted;   // one bit per global id
+        size_t liveDocuments = 0;
+        uint64_t liveLength = 0;                                // sum of live document lengths
+
+        bool isDeleted(uint32_t doc) const;
+        const Document& document(uint32_t doc) const;   // doc must be indexed
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    // document points into the snapshot searched, which must outlive the hit
+    struct Hit {
+        const Document* document;
+        uint32_t id;
+        double score;
+    };
+
+    SearchIndex();
+
+    SnapshotPtr getSnapshot() const;
+
+    // Index lessons, replacing any indexed under the same id (the last of several wins)
+    void addLessons(const std::vector<Lesson>& lessons);
+    void addItems(const std::map<std::string, std::vector<GameItem>>& itemsByType);
+
+    // Up to limit documents containing every word of query, best BM25 score first.
+    // level 1-3 keeps that level only, 0 any; matches gets the number of documents found.
+    static std::vector<Hit> search(const Snapshot& snapshot, std::string_view query, uint8_t level,
+                                   size_t limit, size_t& matches);
+
+    // Words of text: runs of ASCII letters and digits (lower-cased) and non-ASCII bytes
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    // Assigns global ids to segment, marks the documents it replaces deleted and publishes
+    void publish(std::shared_ptr<Segment> segment, const std::vector<std::string>& lessonIds);
+
+    // older and newer are adjacent; documents deleted in snapshot are left out
+    static SegmentPtr merge(const Segment& older, const Segment& newer, const Snapshot& snapshot);
+
+    // Moves lessonDocs_, nextDoc_ and the deleted bitmap of snapshot to the ids of merged,
+    // the newest segment, after merge dropped documents
+    void renumber(Snapshot& snapshot, const Segment& merged);
+
+    std::shared_ptr<const Snapshot> snapshot_;               // accessed only through std::atomic_load/store
+    std::mutex writeMutex_;                                  // serializes writers, readers never touch it
+    std::unordered_map<std::string, uint32_t> lessonDocs_;   // lesson id -> global id (writers only)
+    uint32_t nextDoc_ = 0;
+};
+
+#endif // SEARCH_INDEX_HPP
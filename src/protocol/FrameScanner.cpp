@@ -0,0 +1,147 @@
+#include "FrameScanner.hpp"
+#include <charconv>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRAME_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    using FindAnyFunction = size_t (*)(const char*, size_t, char, char);
+
+    size_t findAnyScalar(const char* data, size_t size, char a, char b) {
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] == a || data[i] == b) return i;
+        }
+        return size;
+    }
+
+#ifdef FRAME_SCANNER_X86
+    __attribute__((target("sse2")))
+    size_t findAnySse2(const char* data, size_t size, char a, char b) {
+        const __m128i wantA = _mm_set1_epi8(a);
+        const __m128i wantB = _mm_set1_epi8(b);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, wantA), _mm_cmpeq_epi8(chunk, wantB));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+            if (mask) return i + __builtin_ctz(mask);
+        }
+        return i + findAnyScalar(data + i, size - i, a, b);
+    }
+
+    __attribute__((target("avx2")))
+    size_t findAnyAvx2(const char* data, size_t size, char a, char b) {
+        const __m256i wantA = _mm256_set1_epi8(a);
+        const __m256i wantB = _mm256_set1_epi8(b);
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, wantA), _mm256_cmpeq_epi8(chunk, wantB));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+            if (mask) return i + __builtin_ctz(mask);
+        }
+        return i + findAnySse2(data + i, size - i, a, b);
+    }
+#endif
+
+    struct Implementation {
+        FindAnyFunction findAny;
+        const char* name;
+    };
+
+    const Implementation& selected() {
+        static const Implementation implementation = [] {
+#ifdef FRAME_SCANNER_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return Implementation{findAnyAvx2, "avx2"};
+            if (__builtin_cpu_supports("sse2")) return Implementation{findAnySse2, "sse2"};
+#endif
+            return Implementation{findAnyScalar, "scalar"};
+        }();
+        return implementation;
+    }
+
+    // The header window is shorter than one AVX2 step, so it is scanned with the baseline
+    // instructions, without the run-time dispatch
+    size_t findInHeader(const char* data, size_t size, char a, char b) {
+#if defined(FRAME_SCANNER_X86) && defined(__SSE2__)
+        return findAnySse2(data, size, a, b);
+#else
+        return findAnyScalar(data, size, a, b);
+#endif
+    }
+
+    // The whole field must be digits that fit in T
+    template <typename T>
+    bool parseField(std::string_view field, T& value) {
+        auto parsed = std::from_chars(field.data(), field.data() + field.size(), value);
+        return parsed.ec == std::errc() && parsed.ptr == field.data() + field.size() && !field.empty();
+    }
+
+    // Skip up to and including the next newline (everything when there is none)
+    FrameStatus malformed(std::string_view data, size_t from, size_t& frameLength) {
+        from = std::min(from, data.size());
+        size_t newline = from + FrameScanner::find(data.data() + from, data.size() - from, '\n');
+        frameLength = std::min(newline + 1, data.size());
+        return FrameStatus::MALFORMED;
+    }
+}
+
+size_t FrameScanner::findAny(const char* data, size_t size, char a, char b) {
+    return selected().findAny(data, size, a, b);
+}
+
+const char* FrameScanner::implementation() {
+    return selected().name;
+}
+
+FrameStatus FrameScanner::parseFrame(std::string_view data, MessageHeader& header,
+                                     std::string_view& payload, size_t& frameLength) {
+    // The three header delimiters, stopping early at a newline
+    size_t window = std::min(data.size(), MAX_HEADER_LENGTH);
+    size_t delimiters[3];
+    size_t start = 0;
+    for (size_t& delimiter : delimiters) {
+        delimiter = start + findInHeader(data.data() + start, window - start, '|', '\n');
+        if (delimiter == window) {
+            return window < MAX_HEADER_LENGTH ? FrameStatus::INCOMPLETE : malformed(data, window, frameLength);
+        }
+        if (data[delimiter] == '\n') {
+            frameLength = delimiter + 1;
+            return FrameStatus::MALFORMED;
+        }
+        start = delimiter + 1;
+    }
+
+    uint16_t type = 0;
+    uint16_t length = 0;
+    uint32_t sequence = 0;
+    if (!parseField(data.substr(0, delimiters[0]), type) ||
+        !parseField(data.substr(delimiters[0] + 1, delimiters[1] - delimiters[0] - 1), length) ||
+        !parseField(data.substr(delimiters[1] + 1, delimiters[2] - delimiters[1] - 1), sequence) ||
+        length > AppConstants::MAX_MESSAGE_SIZE) {
+        return malformed(data, delimiters[2], frameLength);
+    }
+
+    size_t payloadStart = delimiters[2] + 1;
+    size_t payloadEnd = payloadStart + length;
+    if (data.size() <= payloadEnd) return FrameStatus::INCOMPLETE;
+
+    size_t end = payloadEnd;
+    if (data[end] == '\r') {
+        if (data.size() <= end + 1) return FrameStatus::INCOMPLETE;
+        ++end;
+    }
+    if (data[end] != '\n') {
+        return malformed(data, payloadStart, frameLength);   // length does not match the payload
+    }
+
+    header.type = static_cast<MessageType>(type);
+    header.payloadLength = length;
+    header.sequenceNumber = sequence;
+    payload = data.substr(payloadStart, length);
+    frameLength = end + 1;
+    return FrameStatus::COMPLETE;
+}
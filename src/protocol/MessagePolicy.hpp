@@ -0,0 +1,139 @@
+#ifndef MESSAGE_POLICY_HPP
+#define MESSAGE_POLICY_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "MessageTypeInfo.hpp"
+#include <array>
+
+// Where a request's deferred work runs
+enum class ExecutionClass : uint8_t {
+    INLINE = 0,    // on the event loop, nothing deferred
+    WORKER = 1,    // CPU-heavy work on the worker pool
+    HASHING = 2    // password hashing on the bounded hashing pool
+};
+
+// Request classes that share a rate limit
+enum class MessageClass : uint8_t {
+    AUTH = 0,      // register, login, resume
+    READ = 1,      // lessons, scores, feedback, leaderboards
+    WRITE = 2,     // submissions, level changes, teacher/admin edits
+    GAME = 3,
+    CHAT = 4,      // chat and call signaling
+    STREAM = 5,    // pronunciation audio
+    SYSTEM = 6,    // heartbeat and anything unclassified
+    COUNT = 7
+};
+
+enum class RequestPriority : uint8_t {
+    HIGH = 0,      // sign-in, scores, chat, calls, work already submitted
+    NORMAL = 1,
+    LOW = 2        // refreshes a client can simply retry later
+};
+
+// Everything the server needs to know about one request type
+struct MessagePolicy {
+    MessageType type;
+    bool requiresAuth;
+    UserRole minRole;           // lowest role allowed once signed in (roles are ordered)
+    uint16_t maxPayload;
+    ExecutionClass execution;
+    MessageClass rateClass;
+    RequestPriority priority;
+    bool idempotent;            // safe for a client to resend after a reconnect
+};
+
+// The request types clients may send and their policies, indexed by MessageType at compile time
+namespace MessagePolicies {
+    constexpr uint16_t TINY = 256;
+    constexpr uint16_t TEXT = 4096;
+    constexpr uint16_t LARGE = static_cast<uint16_t>(AppConstants::MAX_MESSAGE_SIZE);
+
+    using MT = MessageType;
+    using EC = ExecutionClass;
+    using MC = MessageClass;
+    using RP = RequestPriority;
+    constexpr bool AUTH = true;
+    constexpr bool OPEN = false;
+    constexpr bool IDEMPOTENT = true;
+    constexpr bool ONCE = false;
+
+    inline constexpr MessagePolicy TABLE[] = {
+        {MT::REGISTER_REQUEST,            OPEN, UserRole::STUDENT, TINY,  EC::HASHING, MC::AUTH,   RP::NORMAL, ONCE},
+        {MT::LOGIN_REQUEST,               OPEN, UserRole::STUDENT, TINY,  EC::HASHING, MC::AUTH,   RP::HIGH,   ONCE},
+        {MT::LOGOUT_REQUEST,              AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::WRITE,  RP::HIGH,   IDEMPOTENT},
+        {MT::RESUME_REQUEST,              OPEN, UserRole::STUDENT, TINY,  EC::INLINE,  MC::AUTH,   RP::HIGH,   ONCE},
+        {MT::SET_LEVEL_REQUEST,           AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::WRITE,  RP::NORMAL, IDEMPOTENT},
+        {MT::GET_LESSON_LIST_REQUEST,     AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::LOW,    IDEMPOTENT},
+        {MT::GET_LESSON_CONTENT_REQUEST,  AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::NORMAL, IDEMPOTENT},
+        {MT::SEARCH_REQUEST,              AUTH, UserRole::STUDENT, TINY,  EC::WORKER,  MC::READ,   RP::NORMAL, IDEMPOTENT},
+        {MT::AUTOCOMPLETE_REQUEST,        AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::LOW,    IDEMPOTENT},
+        {MT::LOOKUP_WORD_REQUEST,         AUTH, UserRole::STUDENT, TINY,  EC::WORKER,  MC::READ,   RP::NORMAL, IDEMPOTENT},
+        {MT::SUBMIT_QUIZ_REQUEST,         AUTH, UserRole::STUDENT, TEXT,  EC::INLINE,  MC::WRITE,  RP::HIGH,   ONCE},
+        {MT::SUBMIT_EXERCISE_REQUEST,     AUTH, UserRole::STUDENT, LARGE, EC::INLINE,  MC::WRITE,  RP::HIGH,   ONCE},
+        {MT::PRONUNCIATION_START_REQUEST, AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::STREAM, RP::NORMAL, ONCE},
+        {MT::PRONUNCIATION_CHUNK,         AUTH, UserRole::STUDENT, LARGE, EC::WORKER,  MC::STREAM, RP::HIGH,   ONCE},
+        {MT::PRONUNCIATION_END_REQUEST,   AUTH, UserRole::STUDENT, TINY,  EC::WORKER,  MC::STREAM, RP::HIGH,   ONCE},
+        {MT::GAME_START_REQUEST,          AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::GAME,   RP::LOW,    ONCE},
+        {MT::GAME_MOVE_REQUEST,           AUTH, UserRole::STUDENT, TEXT,  EC::INLINE,  MC::GAME,   RP::NORMAL, ONCE},
+        {MT::GET_SCORE_REQUEST,           AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::HIGH,   IDEMPOTENT},
+        {MT::GET_FEEDBACK_REQUEST,        AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::LOW,    IDEMPOTENT},
+        {MT::GET_REVIEW_QUEUE_REQUEST,    AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::LOW,    IDEMPOTENT},
+        {MT::GET_LEADERBOARD_REQUEST,     AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::READ,   RP::LOW,    IDEMPOTENT},
+        {MT::SEND_FEEDBACK_REQUEST,       AUTH, UserRole::TEACHER, TEXT,  EC::INLINE,  MC::WRITE,  RP::NORMAL, ONCE},
+        {MT::SEND_FEEDBACK_BATCH_REQUEST, AUTH, UserRole::TEACHER, LARGE, EC::INLINE,  MC::WRITE,  RP::NORMAL, ONCE},
+        {MT::CHAT_MESSAGE,                AUTH, UserRole::STUDENT, TEXT,  EC::INLINE,  MC::CHAT,   RP::HIGH,   ONCE},
+        {MT::VOICE_CALL_REQUEST,          AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::CHAT,   RP::HIGH,   ONCE},
+        {MT::VOICE_CALL_ACCEPT,           AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::CHAT,   RP::HIGH,   ONCE},
+        {MT::VOICE_CALL_REJECT,           AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::CHAT,   RP::HIGH,   ONCE},
+        {MT::VOICE_CALL_END,              AUTH, UserRole::STUDENT, TINY,  EC::INLINE,  MC::CHAT,   RP::HIGH,   ONCE},
+        {MT::ADD_GAME_ITEM_REQUEST,       AUTH, UserRole::ADMIN,   TEXT,  EC::WORKER,  MC::WRITE,  RP::NORMAL, ONCE},
+        {MT::ADD_GAME_ITEMS_REQUEST,      AUTH, UserRole::ADMIN,   LARGE, EC::WORKER,  MC::WRITE,  RP::NORMAL, ONCE},
+        {MT::IMPORT_CONTENT_REQUEST,      AUTH, UserRole::ADMIN,   TINY,  EC::WORKER,  MC::WRITE,  RP::NORMAL, ONCE},
+        {MT::HEARTBEAT_REQUEST,           OPEN, UserRole::STUDENT, TINY,  EC::INLINE,  MC::SYSTEM, RP::HIGH,   IDEMPOTENT},
+    };
+
+    constexpr size_t COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+    constexpr size_t INDEX_SIZE = 0x0A00;   // one past the highest message group (0x09xx)
+
+    static_assert(COUNT < 255, "slots are stored in a uint8_t");
+
+    // INDEX[type] = slot in TABLE + 1, 0 for types clients may not send
+    constexpr std::array<uint8_t, INDEX_SIZE> buildIndex() {
+        std::array<uint8_t, INDEX_SIZE> index{};
+        for (size_t i = 0; i < COUNT; ++i) {
+            index[static_cast<uint16_t>(TABLE[i].type)] = static_cast<uint8_t>(i + 1);
+        }
+        return index;
+    }
+
+    constexpr bool isWellFormed() {
+        for (size_t i = 0; i < COUNT; ++i) {
+            if (static_cast<uint16_t>(TABLE[i].type) >= INDEX_SIZE) return false;
+            const MessageTypeInfo* info = MessageTypes::find(TABLE[i].type);
+            if (!info || info->direction == MessageDirection::RESPONSE || info->direction == MessageDirection::PUSH) {
+                return false;
+            }
+            for (size_t j = i + 1; j < COUNT; ++j) {
+                if (TABLE[i].type == TABLE[j].type) return false;
+            }
+        }
+        return true;
+    }
+    static_assert(isWellFormed(), "policies must cover unique request types below INDEX_SIZE");
+
+    inline constexpr std::array<uint8_t, INDEX_SIZE> INDEX = buildIndex();
+
+    // Position of type in TABLE, or -1 when clients may not send it
+    constexpr int slotOf(MessageType type) {
+        uint16_t raw = static_cast<uint16_t>(type);
+        return raw < INDEX_SIZE ? static_cast<int>(INDEX[raw]) - 1 : -1;
+    }
+
+    constexpr const MessagePolicy* find(MessageType type) {
+        int slot = slotOf(type);
+        return slot < 0 ? nullptr : &TABLE[slot];
+    }
+}
+
+#endif // MESSAGE_POLICY_HPP
@@ -0,0 +1,121 @@
+#ifndef MESSAGE_TYPE_INFO_HPP
+#define MESSAGE_TYPE_INFO_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include <array>
+#include <string_view>
+
+// Who sends a message type
+enum class MessageDirection : uint8_t {
+    REQUEST = 0,    // client to server, answered with a reply
+    RESPONSE = 1,   // server to client, answering a request
+    PUSH = 2,       // server to client, unsolicited
+    RELAYED = 3     // client to server, answered and also forwarded to another client
+};
+
+// The high byte of a message type code
+enum class MessageCategory : uint8_t {
+    NONE = 0,
+    AUTH = 1,
+    STUDY = 2,
+    CONTENT = 3,
+    EXERCISE = 4,
+    GAME = 5,
+    FEEDBACK = 6,
+    COMMUNICATION = 7,
+    ADMIN = 8,
+    SYSTEM = 9
+};
+
+struct MessageTypeInfo {
+    MessageType type;
+    std::string_view name;
+    MessageCategory category;
+    MessageDirection direction;
+    MessageType reply;          // usual answer to a request, UNKNOWN otherwise
+};
+
+// Metadata for every MessageType, generated from MESSAGE_TYPE_LIST and indexed at compile time
+namespace MessageTypes {
+    inline constexpr MessageTypeInfo TABLE[] = {
+#define MESSAGE_TYPE_INFO(type, code, direction, reply) \
+        {MessageType::type, #type, static_cast<MessageCategory>((code) >> 8), \
+         MessageDirection::direction, MessageType::reply},
+        MESSAGE_TYPE_LIST(MESSAGE_TYPE_INFO)
+#undef MESSAGE_TYPE_INFO
+    };
+
+    constexpr size_t COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+    constexpr size_t INDEX_SIZE = 0x0A00;   // one past the highest category (0x09xx)
+    constexpr std::string_view UNKNOWN_NAME = "UNKNOWN";
+
+    static_assert(COUNT < 255, "slots are stored in a uint8_t");
+
+    // INDEX[type] = slot in TABLE + 1, 0 for codes that are not message types
+    constexpr std::array<uint8_t, INDEX_SIZE> buildIndex() {
+        std::array<uint8_t, INDEX_SIZE> index{};
+        for (size_t i = 0; i < COUNT; ++i) {
+            index[static_cast<uint16_t>(TABLE[i].type)] = static_cast<uint8_t>(i + 1);
+        }
+        return index;
+    }
+
+    inline constexpr std::array<uint8_t, INDEX_SIZE> INDEX = buildIndex();
+
+    constexpr const MessageTypeInfo* find(MessageType type) {
+        uint16_t raw = static_cast<uint16_t>(type);
+        return raw < INDEX_SIZE && INDEX[raw] ? &TABLE[INDEX[raw] - 1] : nullptr;
+    }
+
+    constexpr bool isWellFormed() {
+        for (size_t i = 0; i < COUNT; ++i) {
+            const MessageTypeInfo& info = TABLE[i];
+            if (info.category < MessageCategory::AUTH || info.category > MessageCategory::SYSTEM) return false;
+            if (find(info.type) != &info) return false;   // duplicate code
+
+            // Requests name a reply the server sends; nothing else has one
+            bool asks = info.direction == MessageDirection::REQUEST || info.direction == MessageDirection::RELAYED;
+            if (asks != (info.reply != MessageType::UNKNOWN)) return false;
+            if (asks) {
+                const MessageTypeInfo* reply = find(info.reply);
+                if (!reply || reply->category != info.category) return false;
+                if (reply->direction == MessageDirection::REQUEST) return false;
+            }
+        }
+        return true;
+    }
+    static_assert(isWellFormed(),
+                  "message types need unique codes in 0x01xx-0x09xx and requests a reply in their own category");
+
+    // Every enumerator resolves to its own entry, so none can fall back to UNKNOWN_NAME
+#define MESSAGE_TYPE_COVERED(type, code, direction, reply) \
+    static_assert(find(MessageType::type) && find(MessageType::type)->name == #type, \
+                  "MessageType::" #type " has no metadata");
+    MESSAGE_TYPE_LIST(MESSAGE_TYPE_COVERED)
+#undef MESSAGE_TYPE_COVERED
+
+    constexpr std::string_view nameOf(MessageType type) {
+        const MessageTypeInfo* info = find(type);
+        return info ? info->name : UNKNOWN_NAME;
+    }
+
+    constexpr MessageCategory categoryOf(MessageType type) {
+        const MessageTypeInfo* info = find(type);
+        return info ? info->category : MessageCategory::NONE;
+    }
+
+    constexpr MessageType replyTo(MessageType type) {
+        const MessageTypeInfo* info = find(type);
+        return info ? info->reply : MessageType::UNKNOWN;
+    }
+
+    constexpr std::string_view categoryName(MessageCategory category) {
+        constexpr std::string_view NAMES[] = {"none", "auth", "study", "content", "exercise",
+                                              "game", "feedback", "communication", "admin", "system"};
+        size_t index = static_cast<size_t>(category);
+        return index < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[index] : NAMES[0];
+    }
+}
+
+#endif // MESSAGE_TYPE_INFO_HPP
@@ -1,5 +1,9 @@
 #include "Network.hpp"
 
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
 bool Network::initialize() {
     return Utils::initSocketLibrary();
 }
@@ -130,6 +134,43 @@ int Network::sendData(SOCKET sock, const char* data, size_t length) {
     return bytesSent;
 }
 
+int Network::sendSlices(SOCKET sock, const std::string_view* slices, size_t count) {
+    constexpr size_t MAX_SLICES = 32;
+    count = std::min(count, MAX_SLICES);
+    
+    #ifdef _WIN32
+        WSABUF buffers[MAX_SLICES];
+        for (size_t i = 0; i < count; ++i) {
+            buffers[i].buf = const_cast<char*>(slices[i].data());
+            buffers[i].len = static_cast<ULONG>(slices[i].size());
+        }
+        DWORD sent = 0;
+        int result = WSASend(sock, buffers, static_cast<DWORD>(count), &sent, 0, NULL, NULL);
+        int bytesSent = result == 0 ? static_cast<int>(sent) : SOCKET_ERROR;
+    #else
+        struct iovec buffers[MAX_SLICES];
+        for (size_t i = 0; i < count; ++i) {
+            buffers[i].iov_base = const_cast<char*>(slices[i].data());
+            buffers[i].iov_len = slices[i].size();
+        }
+        struct msghdr header;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_iov = buffers;
+        header.msg_iovlen = count;
+        // A peer that already closed must not take the process down with SIGPIPE
+        int bytesSent = static_cast<int>(sendmsg(sock, &header, MSG_NOSIGNAL));
+    #endif
+    
+    if (bytesSent == SOCKET_ERROR) {
+        if (!wouldBlock()) {
+            Logger::getInstance().error("Send failed: " + getLastError());
+        }
+        return -1;
+    }
+    
+    return bytesSent;
+}
+
 int Network::receiveData(SOCKET sock, char* buffer, size_t bufferSize) {
     int bytesReceived = recv(sock, buffer, static_cast<int>(bufferSize), 0);
     
@@ -195,3 +236,12 @@ std::string Network::getLastError() {
     #endif
 }
 
+
+bool Network::wouldBlock() {
+    int errorCode = SOCKET_ERROR_CODE;
+    #ifdef _WIN32
+        return errorCode == WSAEWOULDBLOCK;
+    #else
+        return errorCode == EWOULDBLOCK || errorCode == EAGAIN;
+    #endif
+}
@@ -32,6 +32,9 @@ public:
     // Send data through socket
     static int sendData(SOCKET sock, const char* data, size_t length);
     
+    // Send several buffers with one call, in order; returns bytes sent (maybe fewer than all) or -1
+    static int sendSlices(SOCKET sock, const std::string_view* slices, size_t count);
+    
     // Receive data from socket
     static int receiveData(SOCKET sock, char* buffer, size_t bufferSize);
     
@@ -53,6 +56,9 @@ public:
     // Get last socket error
     static std::string getLastError();
     
+    // true when the last failed send/receive only meant "try again later" (non-blocking socket)
+    static bool wouldBlock();
+    
 private:
     Network() = default;
 };
@@ -0,0 +1,233 @@
+#ifndef PAYLOAD_CODEC_HPP
+#define PAYLOAD_CODEC_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+// Binary payloads generated from schemas at compile time. Fields are written in schema order:
+// integers as LEB128 varints (signed ones zigzag encoded), strings as a varint length and the
+// bytes, lists as a varint count and the elements. There are no delimiters, so text fields
+// need no escaping. Decoding never allocates for string_view fields and lists: both are views
+// into the payload, which must outlive them.
+namespace PayloadCodec {
+    // Schema of a record: specialise with MEMBERS, a tuple of member pointers in wire order
+    template <typename T> struct Fields;
+
+    // Schema of a message type: specialise with Type, the record its payload carries
+    template <MessageType TYPE> struct PayloadOf;
+
+    template <MessageType TYPE> using PayloadType = typename PayloadOf<TYPE>::Type;
+
+    inline void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    inline bool getVarint(std::string_view& in, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(in.front());
+            in.remove_prefix(1);
+            if (shift == 63 && byte > 1) return false;   // more than 64 bits
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // put/get for one field type
+    template <typename T, typename = void> struct Codec;
+
+    // Repeated field. Decoded lists are lazy views: iterating decodes one element at a time.
+    // Lists to encode wrap a container with of(); the container must outlive the list.
+    template <typename E>
+    class List {
+    public:
+        List() = default;
+
+        template <typename Container>
+        static List of(const Container& items) {
+            List list;
+            list.count_ = std::size(items);
+            list.source_ = &items;
+            list.putSource_ = [](std::string& out, const void* source) {
+                for (const auto& item : *static_cast<const Container*>(source)) {
+                    Codec<E>::put(out, item);
+                }
+            };
+            return list;
+        }
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = E;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const E*;
+            using reference = const E&;
+
+            Iterator(std::string_view rest, size_t remaining) : rest_(rest), remaining_(remaining) { load(); }
+            const E& operator*() const { return current_; }
+            const E* operator->() const { return &current_; }
+            Iterator& operator++() { --remaining_; load(); return *this; }
+            bool operator==(const Iterator& other) const { return remaining_ == other.remaining_; }
+            bool operator!=(const Iterator& other) const { return remaining_ != other.remaining_; }
+
+        private:
+            void load() { if (remaining_ > 0) Codec<E>::get(rest_, current_); }   // validated by decode
+
+            std::string_view rest_;
+            size_t remaining_;
+            E current_{};
+        };
+
+        Iterator begin() const { return Iterator(encoded_, count_); }
+        Iterator end() const { return Iterator(std::string_view(), 0); }
+
+    private:
+        friend struct Codec<List<E>>;
+
+        size_t count_ = 0;
+        std::string_view encoded_;                                  // decoded lists
+        const void* source_ = nullptr;                              // lists built with of()
+        void (*putSource_)(std::string&, const void*) = nullptr;
+    };
+
+    template <typename T>
+    struct Codec<T, std::enable_if_t<std::is_unsigned_v<T> && !std::is_same_v<T, bool>>> {
+        static void put(std::string& out, T value) { putVarint(out, value); }
+        static bool get(std::string_view& in, T& value) {
+            uint64_t raw = 0;
+            if (!getVarint(in, raw) || raw > std::numeric_limits<T>::max()) return false;
+            value = static_cast<T>(raw);
+            return true;
+        }
+    };
+
+    // Zigzag: small magnitudes of either sign stay short
+    template <typename T>
+    struct Codec<T, std::enable_if_t<std::is_signed_v<T> && std::is_integral_v<T>>> {
+        static void put(std::string& out, T value) {
+            int64_t wide = value;
+            putVarint(out, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+        }
+        static bool get(std::string_view& in, T& value) {
+            uint64_t raw = 0;
+            if (!getVarint(in, raw)) return false;
+            int64_t wide = static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+            if (wide < std::numeric_limits<T>::min() || wide > std::numeric_limits<T>::max()) return false;
+            value = static_cast<T>(wide);
+            return true;
+        }
+    };
+
+    template <>
+    struct Codec<bool> {
+        static void put(std::string& out, bool value) { out += value ? '\1' : '\0'; }
+        static bool get(std::string_view& in, bool& value) {
+            uint8_t raw = 0;
+            if (!Codec<uint8_t>::get(in, raw) || raw > 1) return false;
+            value = raw == 1;
+            return true;
+        }
+    };
+
+    template <>
+    struct Codec<std::string_view> {
+        static void put(std::string& out, std::string_view value) {
+            putVarint(out, value.size());
+            out.append(value);
+        }
+        static bool get(std::string_view& in, std::string_view& value) {
+            uint64_t size = 0;
+            if (!getVarint(in, size) || size > in.size()) return false;
+            value = in.substr(0, size);
+            in.remove_prefix(size);
+            return true;
+        }
+    };
+
+    template <>
+    struct Codec<std::string> {
+        static void put(std::string& out, std::string_view value) { Codec<std::string_view>::put(out, value); }
+        static bool get(std::string_view& in, std::string& value) {
+            std::string_view view;
+            if (!Codec<std::string_view>::get(in, view)) return false;
+            value.assign(view);
+            return true;
+        }
+    };
+
+    template <typename E>
+    struct Codec<List<E>> {
+        static void put(std::string& out, const List<E>& list) {
+            putVarint(out, list.count_);
+            if (list.putSource_) {
+                list.putSource_(out, list.source_);
+            } else {
+                out.append(list.encoded_);
+            }
+        }
+        // Checks every element once, so iterating later cannot fail
+        static bool get(std::string_view& in, List<E>& list) {
+            uint64_t count = 0;
+            if (!getVarint(in, count) || count > in.size()) return false;   // elements take a byte at least
+            std::string_view start = in;
+            for (uint64_t i = 0; i < count; ++i) {
+                E element{};
+                if (!Codec<E>::get(in, element)) return false;
+            }
+            list = List<E>();
+            list.count_ = static_cast<size_t>(count);
+            list.encoded_ = start.substr(0, start.size() - in.size());
+            return true;
+        }
+    };
+
+    template <typename T>
+    struct Codec<T, std::void_t<decltype(Fields<T>::MEMBERS)>> {
+        template <typename Member>
+        using FieldType = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*std::declval<Member>())>>;
+
+        static void put(std::string& out, const T& value) {
+            std::apply([&](auto... members) {
+                (Codec<FieldType<decltype(members)>>::put(out, value.*members), ...);
+            }, Fields<T>::MEMBERS);
+        }
+        static bool get(std::string_view& in, T& value) {
+            return std::apply([&](auto... members) {
+                return (Codec<FieldType<decltype(members)>>::get(in, value.*members) && ...);
+            }, Fields<T>::MEMBERS);
+        }
+    };
+
+    template <MessageType TYPE>
+    void encodeInto(std::string& out, const PayloadType<TYPE>& payload) {
+        Codec<PayloadType<TYPE>>::put(out, payload);
+    }
+
+    template <MessageType TYPE>
+    std::string encode(const PayloadType<TYPE>& payload) {
+        std::string out;
+        encodeInto<TYPE>(out, payload);
+        return out;
+    }
+
+    // false unless the payload is exactly one well-formed record
+    template <MessageType TYPE>
+    bool decode(std::string_view payload, PayloadType<TYPE>& value) {
+        return Codec<PayloadType<TYPE>>::get(payload, value) && payload.empty();
+    }
+}
+
+#endif // PAYLOAD_CODEC_HPP
@@ -0,0 +1,351 @@
+#ifndef PAYLOADS_HPP
+#define PAYLOADS_HPP
+
+#include "PayloadCodec.hpp"
+
+// Records carried by schema-encoded payloads; string_view fields point into the payload
+// (decoding) or at strings the caller keeps alive (encoding)
+
+struct ChatPayload {
+    std::string_view recipient;
+    std::string_view text;
+};
+
+// A teacher's note on one exercise; the text is free form (any bytes, newlines included)
+struct FeedbackNote {
+    std::string_view student;
+    std::string_view exerciseId;
+    std::string_view text;
+};
+
+// Answers in question order: option letters ("AC") or free text
+struct QuizSubmission {
+    std::string_view quizId;
+    PayloadCodec::List<std::string_view> answers;
+};
+
+struct QuizResult {
+    int32_t score = 0;
+    uint32_t correct = 0;
+    uint32_t total = 0;
+    std::string_view perQuestion;   // '1' correct, '0' wrong, one per question
+};
+
+struct ExerciseSubmission {
+    std::string_view exerciseId;
+    std::string_view answer;
+};
+
+struct ExerciseResult {
+    int32_t score = 0;
+    bool correct = false;
+    uint32_t distance = 0;      // edits from the closest accepted answer (fuzzy grading)
+};
+
+// A recording about to be streamed; reference (teachers) makes it the sentence's template
+struct RecordingStart {
+    std::string_view sentenceId;
+    uint32_t sampleRate = 0;
+    bool reference = false;
+};
+
+struct PronunciationScore {
+    int32_t score = 0;
+    uint32_t similarity = 0;    // 0-100
+    uint64_t frames = 0;
+};
+
+struct GameQuery {
+    std::string_view gameType;
+    uint32_t itemCount = 0;     // 0 = server default, at most 100
+};
+
+// The items dealt for a game; moves are graded against them
+struct GameDeal {
+    uint64_t sessionId = 0;
+    PayloadCodec::List<std::string_view> items;
+};
+
+// VOICE_CALL_REQUEST: to the server with callId 0 and the callee, pushed to the callee with
+// the call's id and the caller
+struct CallOffer {
+    uint32_t callId = 0;
+    std::string_view user;
+};
+
+// VOICE_CALL_ACCEPT: to the server with the call id only; the reply and the push to the
+// caller add where each side sends its media (relayPort 0: no relay)
+struct CallAnswer {
+    uint32_t callId = 0;
+    uint32_t relayPort = 0;
+    uint32_t token = 0;
+};
+
+// Review items
+struct TextList {
+    PayloadCodec::List<std::string_view> items;
+};
+
+// Lessons ("id:title") with the content version they were read at; the client sends the
+// version back and gets NOT_MODIFIED while it is current
+struct VersionedList {
+    uint64_t version = 0;
+    PayloadCodec::List<std::string_view> items;
+};
+
+// A lesson, with the version of the copy the client already has (0: none)
+struct LessonQuery {
+    std::string_view lessonId;
+    uint64_t version = 0;
+};
+
+struct LessonContent {
+    uint64_t version = 0;
+    std::string_view text;
+};
+
+// Full-text search over lessons and game items; every word must match
+struct SearchQuery {
+    std::string_view text;
+    uint8_t level = 0;      // 1-3 for one level, 0 for all
+    uint32_t limit = 0;     // 0 = server default
+};
+
+struct SearchResults {
+    uint64_t matches = 0;   // documents found, of which the best are listed
+    PayloadCodec::List<SearchResult> hits;
+};
+
+// Dictionary words starting with prefix, alphabetically
+struct AutocompleteQuery {
+    std::string_view prefix;
+    uint32_t limit = 0;         // 0 = server default
+};
+
+// A dictionary word, or failing an exact match the words within maxDistance edits
+struct WordQuery {
+    std::string_view word;
+    uint8_t maxDistance = 0;
+    uint32_t limit = 0;         // 0 = server default
+};
+
+struct DictionaryEntries {
+    PayloadCodec::List<DictionaryEntry> entries;
+};
+
+// Feedback entries after the client's cursor. epoch is the one from the client's last page:
+// a different server epoch means the log restarted and reading begins at the first entry.
+struct FeedbackQuery {
+    uint64_t epoch = 0;
+    uint64_t after = 0;     // id of the newest entry the client has
+    uint32_t limit = 0;     // 0 = server default
+};
+
+struct FeedbackPage {
+    uint64_t epoch = 0;
+    bool more = false;      // entries remain after this page
+    PayloadCodec::List<FeedbackEntry> entries;
+};
+
+// NOT_MODIFIED: the version the client already has. Also the lesson list request, with the
+// version of the list the client has (0: none)
+struct ContentVersion {
+    uint64_t version = 0;
+};
+
+struct ScoreReport {
+    int32_t score = 0;
+    uint64_t rank = 0;      // 0 when not ranked
+};
+
+struct LeaderboardQuery {
+    std::string_view mode;  // "top" (default) or "around"
+    std::string_view board; // "global" (default), "level" or "level:N"
+    uint32_t count = 0;     // 0 = the mode's default
+};
+
+struct LeaderboardPage {
+    std::string_view board;
+    uint64_t rank = 0;      // caller's rank, 0 when not on the board
+    uint64_t total = 0;
+    PayloadCodec::List<LeaderboardEntry> entries;
+};
+
+// Bulk writes; the reply has one status per record, in request order
+struct FeedbackBatch {
+    PayloadCodec::List<FeedbackNote> notes;
+};
+
+struct GameItemRecord {
+    std::string_view gameType;
+    std::string_view data;
+    uint8_t level = 1;      // 1-3
+};
+
+struct GameItemBatch {
+    PayloadCodec::List<GameItemRecord> items;
+};
+
+struct BatchResult {
+    uint32_t applied = 0;
+    PayloadCodec::List<uint16_t> statuses;   // ErrorCode values, SUCCESS for applied records
+};
+
+namespace PayloadCodec {
+    template <> struct Fields<ChatPayload> {
+        static constexpr auto MEMBERS = std::make_tuple(&ChatPayload::recipient, &ChatPayload::text);
+    };
+    template <> struct Fields<FeedbackNote> {
+        static constexpr auto MEMBERS = std::make_tuple(&FeedbackNote::student, &FeedbackNote::exerciseId,
+                                                        &FeedbackNote::text);
+    };
+    template <> struct Fields<QuizSubmission> {
+        static constexpr auto MEMBERS = std::make_tuple(&QuizSubmission::quizId, &QuizSubmission::answers);
+    };
+    template <> struct Fields<QuizResult> {
+        static constexpr auto MEMBERS = std::make_tuple(&QuizResult::score, &QuizResult::correct, &QuizResult::total,
+                                                        &QuizResult::perQuestion);
+    };
+    template <> struct Fields<ExerciseSubmission> {
+        static constexpr auto MEMBERS = std::make_tuple(&ExerciseSubmission::exerciseId, &ExerciseSubmission::answer);
+    };
+    template <> struct Fields<ExerciseResult> {
+        static constexpr auto MEMBERS = std::make_tuple(&ExerciseResult::score, &ExerciseResult::correct,
+                                                        &ExerciseResult::distance);
+    };
+    template <> struct Fields<RecordingStart> {
+        static constexpr auto MEMBERS = std::make_tuple(&RecordingStart::sentenceId, &RecordingStart::sampleRate,
+                                                        &RecordingStart::reference);
+    };
+    template <> struct Fields<PronunciationScore> {
+        static constexpr auto MEMBERS = std::make_tuple(&PronunciationScore::score, &PronunciationScore::similarity,
+                                                        &PronunciationScore::frames);
+    };
+    template <> struct Fields<GameQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&GameQuery::gameType, &GameQuery::itemCount);
+    };
+    template <> struct Fields<GameDeal> {
+        static constexpr auto MEMBERS = std::make_tuple(&GameDeal::sessionId, &GameDeal::items);
+    };
+    template <> struct Fields<CallOffer> {
+        static constexpr auto MEMBERS = std::make_tuple(&CallOffer::callId, &CallOffer::user);
+    };
+    template <> struct Fields<CallAnswer> {
+        static constexpr auto MEMBERS = std::make_tuple(&CallAnswer::callId, &CallAnswer::relayPort, &CallAnswer::token);
+    };
+    template <> struct Fields<TextList> {
+        static constexpr auto MEMBERS = std::make_tuple(&TextList::items);
+    };
+    template <> struct Fields<VersionedList> {
+        static constexpr auto MEMBERS = std::make_tuple(&VersionedList::version, &VersionedList::items);
+    };
+    template <> struct Fields<LessonQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&LessonQuery::lessonId, &LessonQuery::version);
+    };
+    template <> struct Fields<LessonContent> {
+        static constexpr auto MEMBERS = std::make_tuple(&LessonContent::version, &LessonContent::text);
+    };
+    template <> struct Fields<SearchQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&SearchQuery::text, &SearchQuery::level, &SearchQuery::limit);
+    };
+    template <> struct Fields<SearchResult> {
+        static constexpr auto MEMBERS = std::make_tuple(&SearchResult::kind, &SearchResult::key, &SearchResult::title,
+                                                        &SearchResult::level, &SearchResult::score);
+    };
+    template <> struct Fields<SearchResults> {
+        static constexpr auto MEMBERS = std::make_tuple(&SearchResults::matches, &SearchResults::hits);
+    };
+    template <> struct Fields<AutocompleteQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&AutocompleteQuery::prefix, &AutocompleteQuery::limit);
+    };
+    template <> struct Fields<WordQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&WordQuery::word, &WordQuery::maxDistance, &WordQuery::limit);
+    };
+    template <> struct Fields<DictionaryEntry> {
+        static constexpr auto MEMBERS = std::make_tuple(&DictionaryEntry::word, &DictionaryEntry::gloss,
+                                                        &DictionaryEntry::distance);
+    };
+    template <> struct Fields<DictionaryEntries> {
+        static constexpr auto MEMBERS = std::make_tuple(&DictionaryEntries::entries);
+    };
+    template <> struct Fields<FeedbackQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&FeedbackQuery::epoch, &FeedbackQuery::after,
+                                                        &FeedbackQuery::limit);
+    };
+    template <> struct Fields<FeedbackEntry> {
+        static constexpr auto MEMBERS = std::make_tuple(&FeedbackEntry::id, &FeedbackEntry::text);
+    };
+    template <> struct Fields<FeedbackPage> {
+        static constexpr auto MEMBERS = std::make_tuple(&FeedbackPage::epoch, &FeedbackPage::more,
+                                                        &FeedbackPage::entries);
+    };
+    template <> struct Fields<FeedbackBatch> {
+        static constexpr auto MEMBERS = std::make_tuple(&FeedbackBatch::notes);
+    };
+    template <> struct Fields<GameItemRecord> {
+        static constexpr auto MEMBERS = std::make_tuple(&GameItemRecord::gameType, &GameItemRecord::data,
+                                                        &GameItemRecord::level);
+    };
+    template <> struct Fields<GameItemBatch> {
+        static constexpr auto MEMBERS = std::make_tuple(&GameItemBatch::items);
+    };
+    template <> struct Fields<BatchResult> {
+        static constexpr auto MEMBERS = std::make_tuple(&BatchResult::applied, &BatchResult::statuses);
+    };
+    template <> struct Fields<ContentVersion> {
+        static constexpr auto MEMBERS = std::make_tuple(&ContentVersion::version);
+    };
+    template <> struct Fields<ScoreReport> {
+        static constexpr auto MEMBERS = std::make_tuple(&ScoreReport::score, &ScoreReport::rank);
+    };
+    template <> struct Fields<LeaderboardQuery> {
+        static constexpr auto MEMBERS = std::make_tuple(&LeaderboardQuery::mode, &LeaderboardQuery::board,
+                                                        &LeaderboardQuery::count);
+    };
+    template <> struct Fields<LeaderboardEntry> {
+        static constexpr auto MEMBERS = std::make_tuple(&LeaderboardEntry::rank, &LeaderboardEntry::username,
+                                                        &LeaderboardEntry::score);
+    };
+    template <> struct Fields<LeaderboardPage> {
+        static constexpr auto MEMBERS = std::make_tuple(&LeaderboardPage::board, &LeaderboardPage::rank,
+                                                        &LeaderboardPage::total, &LeaderboardPage::entries);
+    };
+
+    // Message types whose payload is schema encoded; the rest are short '|'-separated text
+    template <> struct PayloadOf<MessageType::CHAT_MESSAGE> { using Type = ChatPayload; };
+    template <> struct PayloadOf<MessageType::SEND_FEEDBACK_REQUEST> { using Type = FeedbackNote; };
+    template <> struct PayloadOf<MessageType::GET_LESSON_LIST_REQUEST> { using Type = ContentVersion; };
+    template <> struct PayloadOf<MessageType::GET_LESSON_LIST_RESPONSE> { using Type = VersionedList; };
+    template <> struct PayloadOf<MessageType::GET_LESSON_CONTENT_REQUEST> { using Type = LessonQuery; };
+    template <> struct PayloadOf<MessageType::GET_LESSON_CONTENT_RESPONSE> { using Type = LessonContent; };
+    template <> struct PayloadOf<MessageType::SEARCH_REQUEST> { using Type = SearchQuery; };
+    template <> struct PayloadOf<MessageType::SEARCH_RESPONSE> { using Type = SearchResults; };
+    template <> struct PayloadOf<MessageType::AUTOCOMPLETE_REQUEST> { using Type = AutocompleteQuery; };
+    template <> struct PayloadOf<MessageType::AUTOCOMPLETE_RESPONSE> { using Type = DictionaryEntries; };
+    template <> struct PayloadOf<MessageType::LOOKUP_WORD_REQUEST> { using Type = WordQuery; };
+    template <> struct PayloadOf<MessageType::LOOKUP_WORD_RESPONSE> { using Type = DictionaryEntries; };
+    template <> struct PayloadOf<MessageType::SUBMIT_QUIZ_REQUEST> { using Type = QuizSubmission; };
+    template <> struct PayloadOf<MessageType::SUBMIT_QUIZ_RESPONSE> { using Type = QuizResult; };
+    template <> struct PayloadOf<MessageType::SUBMIT_EXERCISE_REQUEST> { using Type = ExerciseSubmission; };
+    template <> struct PayloadOf<MessageType::SUBMIT_EXERCISE_RESPONSE> { using Type = ExerciseResult; };
+    template <> struct PayloadOf<MessageType::PRONUNCIATION_START_REQUEST> { using Type = RecordingStart; };
+    template <> struct PayloadOf<MessageType::PRONUNCIATION_RESULT> { using Type = PronunciationScore; };
+    template <> struct PayloadOf<MessageType::GAME_START_REQUEST> { using Type = GameQuery; };
+    template <> struct PayloadOf<MessageType::GAME_START_RESPONSE> { using Type = GameDeal; };
+    template <> struct PayloadOf<MessageType::GET_FEEDBACK_REQUEST> { using Type = FeedbackQuery; };
+    template <> struct PayloadOf<MessageType::GET_FEEDBACK_RESPONSE> { using Type = FeedbackPage; };
+    template <> struct PayloadOf<MessageType::GET_REVIEW_QUEUE_RESPONSE> { using Type = TextList; };
+    template <> struct PayloadOf<MessageType::GET_SCORE_RESPONSE> { using Type = ScoreReport; };
+    template <> struct PayloadOf<MessageType::GET_LEADERBOARD_REQUEST> { using Type = LeaderboardQuery; };
+    template <> struct PayloadOf<MessageType::GET_LEADERBOARD_RESPONSE> { using Type = LeaderboardPage; };
+    template <> struct PayloadOf<MessageType::SEND_FEEDBACK_BATCH_REQUEST> { using Type = FeedbackBatch; };
+    template <> struct PayloadOf<MessageType::SEND_FEEDBACK_BATCH_RESPONSE> { using Type = BatchResult; };
+    template <> struct PayloadOf<MessageType::VOICE_CALL_REQUEST> { using Type = CallOffer; };
+    template <> struct PayloadOf<MessageType::VOICE_CALL_ACCEPT> { using Type = CallAnswer; };
+    template <> struct PayloadOf<MessageType::ADD_GAME_ITEM_REQUEST> { using Type = GameItemRecord; };
+    template <> struct PayloadOf<MessageType::ADD_GAME_ITEMS_REQUEST> { using Type = GameItemBatch; };
+    template <> struct PayloadOf<MessageType::ADD_GAME_ITEMS_RESPONSE> { using Type = BatchResult; };
+    template <> struct PayloadOf<MessageType::NOT_MODIFIED> { using Type = ContentVersion; };
+}
+
+#endif // PAYLOADS_HPP
@@ -4,6 +4,17 @@
 #include "../../include/common.hpp"
 #include "../../include/message_structs.hpp"
 #include "../utils/Logger.hpp"
+#include "MessagePolicy.hpp"
+#include "MessageTypeInfo.hpp"
+#include "FrameScanner.hpp"
+#include "Payloads.hpp"
+
+// A reply encoded once and sent on many connections; each send writes its own sequence
+// number at sequenceAt (bytes holds the frame without one)
+struct EncodedFrame {
+    std::string bytes;
+    size_t sequenceAt;
+};
 
 // Protocol handler class for message encoding/decoding and validation
 class Protocol {
@@ -13,23 +24,30 @@ public:
     
     // Encode a message to wire format
     std::string encodeMessage(const Message& message);
+    void encodeMessage(const Message& message, std::string& out);   // appends to out
+    
+    // Encode a message for sharing; its sequence number is left out
+    static std::shared_ptr<const EncodedFrame> encodeShared(const Message& message);
     
     // Decode a message from wire format
-    Message decodeMessage(const std::string& data);
+    Message decodeMessage(std::string_view data);
     
     // Extract complete messages from a buffer (handles partial messages)
-    // Returns vector of complete messages and updates the buffer
+    // Returns vector of complete messages and updates the buffer; malformed frames are skipped
     std::vector<Message> extractMessages(std::string& buffer);
     
     // Validate message format and content
     bool validateMessage(const Message& message);
     
     // Get message type name for logging
-    std::string getMessageTypeName(MessageType type);
+    static std::string_view getMessageTypeName(MessageType type);
     
     // Check if message type requires authentication
     bool requiresAuthentication(MessageType type);
     
+    // Check if a request can be sent again without changing its effect (safe to replay after a reconnect)
+    bool isIdempotent(MessageType type);
+    
     // Get next sequence number
     uint32_t getNextSequenceNumber();
 
@@ -0,0 +1,152 @@
+#include "CallManager.hpp"
+#include "../utils/Crypto.hpp"
+
+CallManager& CallManager::getInstance() {
+    static CallManager instance;
+    return instance;
+}
+
+CallManager::CallManager()
+    : nextCallId_(1), relay_(nullptr) {
+}
+
+void CallManager::attachRelay(MediaRelay* relay) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    relay_ = relay;
+}
+
+int CallManager::getRelayPort() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return relay_ && relay_->isRunning() ? relay_->getPort() : 0;
+}
+
+ErrorCode CallManager::startCall(const std::string& caller, const std::string& callee, uint32_t& callId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (caller == callee || userCalls_.count(caller) || userCalls_.count(callee)) {
+        return ErrorCode::INVALID_PARAMETER;
+    }
+
+    CallInfo call;
+    call.id = nextCallId_++;
+    call.caller = caller;
+    call.callee = callee;
+    call.state = CallState::RINGING;
+
+    calls_[call.id] = call;
+    userCalls_[caller] = call.id;
+    userCalls_[callee] = call.id;
+    ringing_.emplace_back(std::chrono::steady_clock::now(), call.id);
+
+    callId = call.id;
+    Logger::getInstance().info("Call " + std::to_string(callId) + " ringing: " + caller + " -> " + callee);
+    return ErrorCode::SUCCESS;
+}
+
+bool CallManager::acceptCall(uint32_t callId, const std::string& callee, CallInfo& call) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = calls_.find(callId);
+    if (it == calls_.end() || it->second.callee != callee || it->second.state != CallState::RINGING) {
+        return false;
+    }
+
+    CallInfo& info = it->second;
+    info.state = CallState::ACTIVE;
+    info.callerToken = nextToken();
+    do {
+        info.calleeToken = nextToken();
+    } while (info.calleeToken == info.callerToken);
+
+    if (relay_ && relay_->isRunning()) {
+        relay_->addCall(info.id, info.callerToken, info.calleeToken);
+    }
+
+    call = info;
+    Logger::getInstance().info("Call " + std::to_string(callId) + " accepted by " + callee);
+    return true;
+}
+
+bool CallManager::rejectCall(uint32_t callId, const std::string& callee, CallInfo& call) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = calls_.find(callId);
+    if (it == calls_.end() || it->second.callee != callee || it->second.state != CallState::RINGING) {
+        return false;
+    }
+
+    call = it->second;
+    eraseCall(it);
+    Logger::getInstance().info("Call " + std::to_string(callId) + " rejected by " + callee);
+    return true;
+}
+
+bool CallManager::endCall(uint32_t callId, const std::string& username, CallInfo& call) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = calls_.find(callId);
+    if (it == calls_.end() || (it->second.caller != username && it->second.callee != username)) {
+        return false;
+    }
+
+    call = it->second;
+    eraseCall(it);
+    Logger::getInstance().info("Call " + std::to_string(callId) + " ended by " + username);
+    return true;
+}
+
+std::vector<CallInfo> CallManager::endCallsFor(const std::string& username) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<CallInfo> ended;
+    auto userIt = userCalls_.find(username);
+    if (userIt == userCalls_.end()) {
+        return ended;
+    }
+
+    auto it = calls_.find(userIt->second);
+    if (it != calls_.end()) {
+        ended.push_back(it->second);
+        eraseCall(it);
+    } else {
+        userCalls_.erase(userIt);
+    }
+    return ended;
+}
+
+std::vector<CallInfo> CallManager::expireRinging(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Calls start in id order, so the oldest are in front; calls answered or ended since
+    // are skipped
+    std::vector<CallInfo> expired;
+    while (!ringing_.empty() && now - ringing_.front().first >= RING_TIMEOUT) {
+        auto it = calls_.find(ringing_.front().second);
+        ringing_.pop_front();
+        if (it == calls_.end() || it->second.state != CallState::RINGING) continue;
+
+        expired.push_back(it->second);
+        Logger::getInstance().info("Call " + std::to_string(it->first) + " not answered, dropped");
+        eraseCall(it);
+    }
+    return expired;
+}
+
+void CallManager::eraseCall(std::map<uint32_t, CallInfo>::iterator it) {
+    if (it->second.state == CallState::ACTIVE && relay_) {
+        relay_->removeCall(it->first);
+    }
+    userCalls_.erase(it->second.caller);
+    userCalls_.erase(it->second.callee);
+    calls_.erase(it);
+}
+
+uint32_t CallManager::nextToken() {
+    // Tokens authenticate media packets, so they must not be predictable from earlier ones
+    uint32_t token;
+    do {
+        std::string bytes = Crypto::randomBytes(sizeof(token));
+        std::memcpy(&token, bytes.data(), sizeof(token));
+    } while (token == 0);
+    return token;
+}
@@ -0,0 +1,77 @@
+#ifndef CALL_MANAGER_HPP
+#define CALL_MANAGER_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "../utils/Logger.hpp"
+#include "MediaRelay.hpp"
+#include <deque>
+
+enum class CallState : uint8_t {
+    RINGING = 1,
+    ACTIVE = 2
+};
+
+// One voice call between two users
+struct CallInfo {
+    uint32_t id = 0;
+    std::string caller;
+    std::string callee;
+    CallState state = CallState::RINGING;
+    uint32_t callerToken = 0;   // media relay credentials, one per side
+    uint32_t calleeToken = 0;
+
+    // The participant on the other end from username
+    const std::string& peerOf(const std::string& username) const {
+        return username == caller ? callee : caller;
+    }
+};
+
+// Tracks call signaling state and registers accepted calls with the media relay.
+// A user takes part in at most one call (ringing or active) at a time.
+class CallManager {
+public:
+    static CallManager& getInstance();
+
+    // Relay that carries the audio of accepted calls (may stay unset: signaling only)
+    void attachRelay(MediaRelay* relay);
+    int getRelayPort() const;
+
+    // Start ringing callee; fails with INVALID_PARAMETER when either side is already in a call
+    ErrorCode startCall(const std::string& caller, const std::string& callee, uint32_t& callId);
+
+    // Callee answers a ringing call
+    bool acceptCall(uint32_t callId, const std::string& callee, CallInfo& call);
+
+    // Callee declines a ringing call
+    bool rejectCall(uint32_t callId, const std::string& callee, CallInfo& call);
+
+    // Either participant hangs up (or the caller cancels while ringing)
+    bool endCall(uint32_t callId, const std::string& username, CallInfo& call);
+
+    // Drop every call the user takes part in (logout / disconnect)
+    std::vector<CallInfo> endCallsFor(const std::string& username);
+
+    // Drop calls that have been ringing for RING_TIMEOUT or longer; both sides are told
+    std::vector<CallInfo> expireRinging(std::chrono::steady_clock::time_point now);
+
+    static constexpr std::chrono::seconds RING_TIMEOUT{60};
+
+private:
+    CallManager();
+    CallManager(const CallManager&) = delete;
+    CallManager& operator=(const CallManager&) = delete;
+
+    // Caller must hold mutex_
+    void eraseCall(std::map<uint32_t, CallInfo>::iterator it);
+    uint32_t nextToken();
+
+    std::map<uint32_t, CallInfo> calls_;
+    std::map<std::string, uint32_t> userCalls_;   // username -> call id
+    std::deque<std::pair<std::chrono::steady_clock::time_point, uint32_t>> ringing_;   // by start time
+    uint32_t nextCallId_;
+    MediaRelay* relay_;
+    mutable std::mutex mutex_;
+};
+
+#endif // CALL_MANAGER_HPP
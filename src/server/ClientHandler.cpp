@@ -1,8 +1,120 @@
 #include "ClientHandler.hpp"
+#include "ResponseCache.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace {
+    // Decimal integer field; false when it does not start with a number
+    template <typename T>
+    bool parseNumber(std::string_view text, T& value) {
+        text = Utils::trimView(text);
+        auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+        return parsed.ec == std::errc() && parsed.ptr != text.data();
+    }
+    
+    // Call ids travel as decimal text
+    bool parseCallId(std::string_view text, uint32_t& callId) {
+        return parseNumber(text, callId) && callId != 0;
+    }
+    
+    // Review items travel as a list of strings
+    template <MessageType TYPE, typename Container>
+    Message textListMessage(const Container& items) {
+        TextList list;
+        list.items = PayloadCodec::List<std::string_view>::of(items);
+        return Message(TYPE, PayloadCodec::encode<TYPE>(list));
+    }
+    
+    // Feedback entries per page when the client does not say, and at most
+    const uint32_t DEFAULT_FEEDBACK_PAGE = 50;
+    const uint32_t MAX_FEEDBACK_PAGE = 200;
+    
+    // Search hits per reply when the client does not say, and at most
+    const uint32_t DEFAULT_SEARCH_RESULTS = 10;
+    const uint32_t MAX_SEARCH_RESULTS = 20;
+    
+    // Dictionary words per reply when the client does not say, and at most; lookups
+    // allow at most MAX_LOOKUP_DISTANCE edits
+    const uint32_t DEFAULT_DICTIONARY_RESULTS = 10;
+    const uint32_t MAX_DICTIONARY_RESULTS = 20;
+    const uint8_t MAX_LOOKUP_DISTANCE = 2;
+    
+    // Dictionary matches, as many as fit one message
+    template <MessageType TYPE>
+    Message dictionaryMessage(const std::vector<Dictionary::Match>& matches) {
+        const size_t budget = AppConstants::MAX_MESSAGE_SIZE - 32;   // list length
+        std::vector<DictionaryEntry> entries;
+        size_t bytes = 0;
+        for (const Dictionary::Match& match : matches) {
+            bytes += match.word.size() + match.gloss.size() + 11;   // varints, at most
+            if (bytes > budget) break;
+            entries.push_back({match.word, std::string(match.gloss), static_cast<uint8_t>(match.distance)});
+        }
+        
+        DictionaryEntries reply;
+        reply.entries = PayloadCodec::List<DictionaryEntry>::of(entries);
+        return Message(TYPE, PayloadCodec::encode<TYPE>(reply));
+    }
+    
+    // Lessons, with the version the client can ask again with. A list longer than one
+    // message carries the lessons that fit.
+    template <MessageType TYPE>
+    Message versionedListMessage(uint64_t version, const std::vector<std::string>& items) {
+        const size_t budget = AppConstants::MAX_MESSAGE_SIZE - 32;   // version and count
+        size_t bytes = 0;
+        size_t count = 0;
+        for (; count < items.size(); ++count) {
+            bytes += items[count].size() + 5;   // the length varint, at most
+            if (bytes > budget) break;
+        }
+        
+        VersionedList list;
+        list.version = version;
+        std::vector<std::string_view> fitting(items.begin(), items.begin() + count);
+        list.items = PayloadCodec::List<std::string_view>::of(fitting);
+        return Message(TYPE, PayloadCodec::encode<TYPE>(list));
+    }
+    
+    Message notModified(uint64_t version) {
+        ContentVersion current;
+        current.version = version;
+        return Message(MessageType::NOT_MODIFIED, PayloadCodec::encode<MessageType::NOT_MODIFIED>(current));
+    }
+    
+    // Per-record outcome of a batch write, in request order
+    template <MessageType TYPE>
+    Message batchResultMessage(const std::vector<uint16_t>& statuses) {
+        BatchResult result;
+        result.applied = static_cast<uint32_t>(
+            std::count(statuses.begin(), statuses.end(), static_cast<uint16_t>(ErrorCode::SUCCESS)));
+        result.statuses = PayloadCodec::List<uint16_t>::of(statuses);
+        return Message(TYPE, PayloadCodec::encode<TYPE>(result));
+    }
+    
+    std::string_view levelKey(ProficiencyLevel level) {
+        switch (level) {
+            case ProficiencyLevel::INTERMEDIATE: return "INTERMEDIATE";
+            case ProficiencyLevel::ADVANCED: return "ADVANCED";
+            default: return "BEGINNER";
+        }
+    }
+}
+
+std::atomic<uint64_t> ClientHandler::nextConnectionId_{1};
+std::atomic<uint64_t> ClientHandler::nextGameSession_{1};
+
+void PronunciationSession::drain() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pending.empty()) {
+        extractor.feed(pending.data(), pending.size());
+        pending.clear();
+    }
+}
 
 ClientHandler::ClientHandler(SOCKET socket, const std::string& address, int port)
-    : socket_(socket), clientAddress_(address), clientPort_(port),
-      authenticated_(false), role_(UserRole::STUDENT), level_(ProficiencyLevel::BEGINNER) {
+    : socket_(socket), connectionId_(nextConnectionId_++), clientAddress_(address), clientPort_(port),
+      authenticated_(false), role_(UserRole::STUDENT), level_(ProficiencyLevel::BEGINNER),
+      currentExecution_(ExecutionClass::INLINE) {
     
     lastActivity_ = std::chrono::steady_clock::now();
     Logger::getInstance().info("ClientHandler created for " + getClientInfo());
@@ -11,7 +123,7 @@ ClientHandler::ClientHandler(SOCKET socket, const std::string& address, int port
 ClientHandler::~ClientHandler() {
     Logger::getInstance().info("ClientHandler destroyed for " + getClientInfo());
     if (authenticated_) {
-        Database::getInstance().removeSession(username_);
+        Database::getInstance().removeSession(username_, connectionId_);
     }
 }
 
@@ -30,50 +142,98 @@ bool ClientHandler::isTimedOut(int timeoutSeconds) const {
     return elapsed > timeoutSeconds;
 }
 
+std::vector<std::pair<std::string, Message>> ClientHandler::takeNotifications() {
+    std::vector<std::pair<std::string, Message>> out;
+    out.swap(notifications_);
+    return out;
+}
+
+std::vector<ClientHandler::QueuedJob> ClientHandler::takeJobs() {
+    std::vector<QueuedJob> out;
+    out.swap(jobs_);
+    return out;
+}
+
+void ClientHandler::onDisconnect() {
+    // A connection whose session was resumed elsewhere leaves the user's calls alone
+    if (authenticated_ && Database::getInstance().holdsSession(username_, connectionId_)) {
+        endActiveCalls();
+    }
+}
+
+constexpr std::array<ClientHandler::HandlerBinding, MessagePolicies::COUNT> ClientHandler::HANDLERS = {{
+    {MessageType::REGISTER_REQUEST,            &ClientHandler::handleRegisterRequest},
+    {MessageType::LOGIN_REQUEST,               &ClientHandler::handleLoginRequest},
+    {MessageType::LOGOUT_REQUEST,              &ClientHandler::handleLogoutRequest},
+    {MessageType::RESUME_REQUEST,              &ClientHandler::handleResumeRequest},
+    {MessageType::SET_LEVEL_REQUEST,           &ClientHandler::handleSetLevelRequest},
+    {MessageType::GET_LESSON_LIST_REQUEST,     &ClientHandler::handleGetLessonListRequest},
+    {MessageType::GET_LESSON_CONTENT_REQUEST,  &ClientHandler::handleGetLessonContentRequest},
+    {MessageType::SEARCH_REQUEST,              &ClientHandler::handleSearchRequest},
+    {MessageType::AUTOCOMPLETE_REQUEST,        &ClientHandler::handleAutocompleteRequest},
+    {MessageType::LOOKUP_WORD_REQUEST,         &ClientHandler::handleLookupWordRequest},
+    {MessageType::SUBMIT_QUIZ_REQUEST,         &ClientHandler::handleSubmitQuizRequest},
+    {MessageType::SUBMIT_EXERCISE_REQUEST,     &ClientHandler::handleSubmitExerciseRequest},
+    {MessageType::PRONUNCIATION_START_REQUEST, &ClientHandler::handlePronunciationStart},
+    {MessageType::PRONUNCIATION_CHUNK,         &ClientHandler::handlePronunciationChunk},
+    {MessageType::PRONUNCIATION_END_REQUEST,   &ClientHandler::handlePronunciationEnd},
+    {MessageType::GAME_START_REQUEST,          &ClientHandler::handleGameStartRequest},
+    {MessageType::GAME_MOVE_REQUEST,           &ClientHandler::handleGameMoveRequest},
+    {MessageType::GET_SCORE_REQUEST,           &ClientHandler::handleGetScoreRequest},
+    {MessageType::GET_FEEDBACK_REQUEST,        &ClientHandler::handleGetFeedbackRequest},
+    {MessageType::GET_REVIEW_QUEUE_REQUEST,    &ClientHandler::handleGetReviewQueueRequest},
+    {MessageType::GET_LEADERBOARD_REQUEST,     &ClientHandler::handleGetLeaderboardRequest},
+    {MessageType::SEND_FEEDBACK_REQUEST,       &ClientHandler::handleSendFeedbackRequest},
+    {MessageType::SEND_FEEDBACK_BATCH_REQUEST, &ClientHandler::handleSendFeedbackBatchRequest},
+    {MessageType::CHAT_MESSAGE,                &ClientHandler::handleChatMessage},
+    {MessageType::VOICE_CALL_REQUEST,          &ClientHandler::handleVoiceCallRequest},
+    {MessageType::VOICE_CALL_ACCEPT,           &ClientHandler::handleVoiceCallAccept},
+    {MessageType::VOICE_CALL_REJECT,           &ClientHandler::handleVoiceCallReject},
+    {MessageType::VOICE_CALL_END,              &ClientHandler::handleVoiceCallEnd},
+    {MessageType::ADD_GAME_ITEM_REQUEST,       &ClientHandler::handleAddGameItemRequest},
+    {MessageType::ADD_GAME_ITEMS_REQUEST,      &ClientHandler::handleAddGameItemsRequest},
+    {MessageType::IMPORT_CONTENT_REQUEST,      &ClientHandler::handleImportContentRequest},
+    {MessageType::HEARTBEAT_REQUEST,           &ClientHandler::handleHeartbeatRequest},
+}};
+
 Message ClientHandler::processMessage(const Message& message) {
     updateActivity();
     
-    Logger::getInstance().info("Processing message from " + getClientInfo() + 
-                              ": " + std::to_string(static_cast<int>(message.header.type)));
-    
-    switch (message.header.type) {
-        case MessageType::REGISTER_REQUEST:
-            return handleRegisterRequest(message);
-        case MessageType::LOGIN_REQUEST:
-            return handleLoginRequest(message);
-        case MessageType::LOGOUT_REQUEST:
-            return handleLogoutRequest(message);
-        case MessageType::SET_LEVEL_REQUEST:
-            return handleSetLevelRequest(message);
-        case MessageType::GET_LESSON_LIST_REQUEST:
-            return handleGetLessonListRequest(message);
-        case MessageType::GET_LESSON_CONTENT_REQUEST:
-            return handleGetLessonContentRequest(message);
-        case MessageType::SUBMIT_QUIZ_REQUEST:
-            return handleSubmitQuizRequest(message);
-        case MessageType::SUBMIT_EXERCISE_REQUEST:
-            return handleSubmitExerciseRequest(message);
-        case MessageType::GAME_START_REQUEST:
-            return handleGameStartRequest(message);
-        case MessageType::GAME_MOVE_REQUEST:
-            return handleGameMoveRequest(message);
-        case MessageType::GET_SCORE_REQUEST:
-            return handleGetScoreRequest(message);
-        case MessageType::GET_FEEDBACK_REQUEST:
-            return handleGetFeedbackRequest(message);
-        case MessageType::SEND_FEEDBACK_REQUEST:
-            return handleSendFeedbackRequest(message);
-        case MessageType::CHAT_MESSAGE:
-            return handleChatMessage(message);
-        case MessageType::VOICE_CALL_REQUEST:
-            return handleVoiceCallRequest(message);
-        case MessageType::ADD_GAME_ITEM_REQUEST:
-            return handleAddGameItemRequest(message);
-        case MessageType::HEARTBEAT_REQUEST:
-            return handleHeartbeatRequest(message);
-        default:
-            return createErrorResponse(ErrorCode::INVALID_FORMAT, "Unknown message type");
+    // Scratch from the previous request is no longer referenced
+    arena_.reset();
+    
+    if (Logger::getInstance().isEnabled(LogLevel::DEBUG)) {
+        Logger::getInstance().debug("Processing message from " + getClientInfo() + 
+                                   ": " + std::string(Protocol::getMessageTypeName(message.header.type)));
+    }
+    
+    static_assert([] {
+        for (size_t i = 0; i < MessagePolicies::COUNT; ++i) {
+            if (HANDLERS[i].type != MessagePolicies::TABLE[i].type) return false;
+        }
+        return true;
+    }(), "ClientHandler::HANDLERS must follow MessagePolicies::TABLE order");
+    
+    // One table lookup: the policy says who may send it, the handler table what runs
+    int slot = MessagePolicies::slotOf(message.header.type);
+    if (slot < 0) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Unknown message type");
+    }
+    
+    const MessagePolicy& policy = MessagePolicies::TABLE[slot];
+    if (message.payload.size() > policy.maxPayload) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Payload too large");
+    }
+    if (policy.requiresAuth && !authenticated_) {
+        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    }
+    if (policy.requiresAuth && role_ < policy.minRole) {
+        return createErrorResponse(ErrorCode::PERMISSION_DENIED,
+                                   policy.minRole == UserRole::ADMIN ? "Admin access required" : "Teacher access required");
     }
+    
+    currentExecution_ = policy.execution;
+    return (this->*HANDLERS[slot].handler)(message);
 }
 
 Message ClientHandler::handleRegisterRequest(const Message& message) {
@@ -89,14 +249,23 @@ Message ClientHandler::handleRegisterRequest(const Message& message) {
                       Parser::createErrorMessage(ErrorCode::USER_ALREADY_EXISTS, "Username already exists"));
     }
     
-    std::string passwordHash = Database::getInstance().hashPassword(password);
+    // Hashing is deliberately slow; it runs on the hashing pool, not the event loop
+    defer([username, password, role]() -> Completion {
+        std::string passwordHash = Database::getInstance().hashPassword(password);
+        bool created = Database::getInstance().createUser(username, passwordHash, role);
+        
+        return [username, created](ClientHandler&) {
+            if (created) {
+                Logger::getInstance().info("User registered: " + username);
+                return Message(MessageType::REGISTER_SUCCESS, Parser::createSuccessMessage());
+            }
+            // Lost a race with another registration of the same name
+            return Message(MessageType::REGISTER_FAILED,
+                          Parser::createErrorMessage(ErrorCode::USER_ALREADY_EXISTS, "Username already exists"));
+        };
+    });
     
-    if (Database::getInstance().createUser(username, passwordHash, role)) {
-        Logger::getInstance().info("User registered: " + username);
-        return Message(MessageType::REGISTER_SUCCESS, Parser::createSuccessMessage());
-    }
-    
-    return createErrorResponse(ErrorCode::DATABASE_ERROR, "Failed to create user");
+    return Message();
 }
 
 Message ClientHandler::handleLoginRequest(const Message& message) {
@@ -106,9 +275,18 @@ Message ClientHandler::handleLoginRequest(const Message& message) {
         return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid login data");
     }
     
-    std::string passwordHash = Database::getInstance().hashPassword(password);
+    defer([username, password]() -> Completion {
+        bool valid = Database::getInstance().verifyPassword(username, password);
+        return [username, valid](ClientHandler& handler) {
+            return handler.finishLogin(username, valid);
+        };
+    });
     
-    if (!Database::getInstance().authenticateUser(username, passwordHash)) {
+    return Message();
+}
+
+Message ClientHandler::finishLogin(const std::string& username, bool passwordValid) {
+    if (!passwordValid) {
         Logger::getInstance().warning("Failed login attempt: " + username);
         return Message(MessageType::LOGIN_FAILED, 
                       Parser::createErrorMessage(ErrorCode::INVALID_CREDENTIALS, "Invalid username or password"));
@@ -126,13 +304,15 @@ Message ClientHandler::handleLoginRequest(const Message& message) {
     level_ = userData.level;
     
     // Create session in database
-    Database::getInstance().createSession(username, socket_);
+    Database::getInstance().createSession(username, socket_, connectionId_);
     
     Logger::getInstance().info("User logged in: " + username);
     
+    rotateResumeToken();
+    
     std::string response = std::to_string(static_cast<int>(userData.role)) + "|" + 
                           std::to_string(static_cast<int>(userData.level)) + "|" +
-                          std::to_string(userData.score);
+                          std::to_string(userData.score) + "|" + resumeToken_;
     
     Logger::getInstance().debug("Creating LOGIN_SUCCESS response: '" + response + "' (length: " + std::to_string(response.length()) + ")");
     
@@ -144,24 +324,56 @@ Message ClientHandler::handleLoginRequest(const Message& message) {
 }
 
 Message ClientHandler::handleLogoutRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Not logged in");
+    if (Database::getInstance().removeSession(username_, connectionId_)) {
+        endActiveCalls();
     }
-    
-    Database::getInstance().removeSession(username_);
+    SessionTokens::getInstance().revoke(resumeToken_);
     Logger::getInstance().info("User logged out: " + username_);
     
     authenticated_ = false;
     username_.clear();
+    resumeToken_.clear();
     
     return Message(MessageType::LOGOUT_SUCCESS, Parser::createSuccessMessage());
 }
 
-Message ClientHandler::handleSetLevelRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+void ClientHandler::rotateResumeToken() {
+    if (!resumeToken_.empty()) {
+        SessionTokens::getInstance().revoke(resumeToken_);
+    }
+    resumeToken_ = SessionTokens::getInstance().issue(username_, role_, level_);
+}
+
+Message ClientHandler::handleResumeRequest(const Message& message) {
+    if (authenticated_) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Already logged in");
+    }
+    
+    // Signature check only: no password hashing and no user table lookup
+    ResumeClaims claims;
+    if (!SessionTokens::getInstance().validate(Utils::trim(message.payload), claims)) {
+        Logger::getInstance().warning("Rejected session resume from " + getClientInfo());
+        return Message(MessageType::RESUME_FAILED,
+                      Parser::createErrorMessage(ErrorCode::INVALID_CREDENTIALS, "Session expired, please log in"));
     }
     
+    authenticated_ = true;
+    username_ = claims.username;
+    role_ = claims.role;
+    level_ = claims.level;
+    Database::getInstance().createSession(username_, socket_, connectionId_);
+    
+    // Rotate so a long-lived client keeps a fresh expiry; the presented token is spent
+    SessionTokens::getInstance().revoke(Utils::trim(message.payload));
+    rotateResumeToken();
+    Logger::getInstance().info("User resumed session: " + username_);
+    
+    return Message(MessageType::RESUME_SUCCESS,
+                  std::to_string(static_cast<int>(role_)) + "|" +
+                  std::to_string(static_cast<int>(level_)) + "|" + resumeToken_);
+}
+
+Message ClientHandler::handleSetLevelRequest(const Message& message) {
     ProficiencyLevel level;
     if (!Parser::parseSetLevelRequest(message.payload, level)) {
         return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid level");
@@ -169,153 +381,494 @@ Message ClientHandler::handleSetLevelRequest(const Message& message) {
     
     if (Database::getInstance().updateUserLevel(username_, level)) {
         level_ = level;
-        return Message(MessageType::SET_LEVEL_SUCCESS, Parser::createSuccessMessage());
+        // The level is part of the resume token, so hand out one that matches
+        rotateResumeToken();
+        return Message(MessageType::SET_LEVEL_SUCCESS, Parser::createSuccessMessage(resumeToken_));
     }
     
     return Message(MessageType::SET_LEVEL_FAILED, 
                   Parser::createErrorMessage(ErrorCode::DATABASE_ERROR, "Failed to update level"));
 }
 
-Message ClientHandler::handleGetLessonListRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+template <typename Build>
+Message ClientHandler::replyCached(const Message& request, std::string_view key, uint64_t knownVersion, Build build) {
+    MessageType type = MessageTypes::replyTo(request.header.type);
+    
+    // Read the version before building: a write in between leaves the entry stale, never wrong
+    uint64_t version = Database::getInstance().getLessonVersion();
+    if (knownVersion == version) {
+        return notModified(version);
     }
     
-    std::vector<std::string> lessons = Database::getInstance().getLessonList(level_);
+    ResponseCache& cache = ResponseCache::getInstance();
+    std::shared_ptr<const EncodedFrame> frame = cache.find(type, key, AppConstants::PROTOCOL_VERSION, version);
+    if (!frame) {
+        Message response = build(version);
+        if (response.header.type != type) {
+            return response;   // errors are not cached
+        }
+        frame = Protocol::encodeShared(response);
+        cache.store(type, key, AppConstants::PROTOCOL_VERSION, version, frame);
+    }
     
-    std::string response;
-    for (const auto& lesson : lessons) {
-        if (!response.empty()) response += ";";
-        response += lesson;
+    if (!output_.send(socket_, std::move(frame), request.header.sequenceNumber)) {
+        Logger::getInstance().error("Failed to send cached reply to " + getClientInfo());
+    }
+    return Message();
+}
+
+Message ClientHandler::handleGetLessonListRequest(const Message& message) {
+    // Payload: ContentVersion of the list the client has; empty for none
+    ContentVersion known;
+    if (!message.payload.empty() && !PayloadCodec::decode<MessageType::GET_LESSON_LIST_REQUEST>(message.payload, known)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid lesson list request");
     }
     
-    return Message(MessageType::GET_LESSON_LIST_RESPONSE, response);
+    return replyCached(message, levelKey(level_), known.version, [this](uint64_t version) {
+        // The catalog is read lock-free; the list is encoded straight from the snapshot
+        LessonCatalog::SnapshotPtr snapshot = Database::getInstance().getLessonSnapshot();
+        return versionedListMessage<MessageType::GET_LESSON_LIST_RESPONSE>(
+            version, snapshot->lists[LessonCatalog::levelIndex(level_)]);
+    });
 }
 
 Message ClientHandler::handleGetLessonContentRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    LessonQuery query;
+    if (!PayloadCodec::decode<MessageType::GET_LESSON_CONTENT_REQUEST>(message.payload, query) ||
+        Utils::trimView(query.lessonId).empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid lesson request");
     }
     
-    std::string lessonId = Utils::trim(message.payload);
-    std::string content = Database::getInstance().getLessonContent(lessonId);
+    // Unknown ids never reach the cache, so made-up ids cannot fill it
+    std::string lessonId(Utils::trimView(query.lessonId));
+    if (!Database::getInstance().hasLesson(lessonId)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "Unknown lesson: " + lessonId);
+    }
     
-    return Message(MessageType::GET_LESSON_CONTENT_RESPONSE, content);
+    return replyCached(message, lessonId, query.version, [this, &lessonId](uint64_t version) {
+        std::string text;
+        if (!Database::getInstance().getLessonContent(lessonId, text)) {
+            return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "Unknown lesson: " + lessonId);
+        }
+        LessonContent content;
+        content.version = version;
+        content.text = text;
+        return Message(MessageType::GET_LESSON_CONTENT_RESPONSE,
+                       PayloadCodec::encode<MessageType::GET_LESSON_CONTENT_RESPONSE>(content));
+    });
 }
 
-Message ClientHandler::handleSubmitQuizRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handleSearchRequest(const Message& message) {
+    SearchQuery query;
+    if (!PayloadCodec::decode<MessageType::SEARCH_REQUEST>(message.payload, query) ||
+        Utils::trimView(query.text).empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid search request");
+    }
+    if (query.level > 3 || query.limit > MAX_SEARCH_RESULTS) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid search level or limit");
+    }
+    size_t limit = query.limit > 0 ? query.limit : DEFAULT_SEARCH_RESULTS;
+    
+    return deferResponse([text = std::string(query.text), level = query.level, limit]() {
+        SearchIndex::SnapshotPtr snapshot = Database::getInstance().getSearchSnapshot();
+        size_t matches = 0;
+        std::vector<SearchIndex::Hit> hits = SearchIndex::search(*snapshot, text, level, limit, matches);
+        
+        // The best hits that fit one message
+        const size_t budget = AppConstants::MAX_MESSAGE_SIZE - 32;   // match count and list length
+        std::vector<SearchResult> results;
+        size_t bytes = 0;
+        for (const SearchIndex::Hit& hit : hits) {
+            const SearchIndex::Document& document = *hit.document;
+            bytes += document.key.size() + document.title.size() + 20;   // varints, at most
+            if (bytes > budget) break;
+            results.push_back({static_cast<uint8_t>(document.kind), document.key, document.title,
+                               static_cast<uint8_t>(document.level),
+                               static_cast<uint32_t>(std::lround(hit.score * 1000))});
+        }
+        
+        SearchResults reply;
+        reply.matches = matches;
+        reply.hits = PayloadCodec::List<SearchResult>::of(results);
+        return Message(MessageType::SEARCH_RESPONSE, PayloadCodec::encode<MessageType::SEARCH_RESPONSE>(reply));
+    });
+}
+
+Message ClientHandler::handleAutocompleteRequest(const Message& message) {
+    AutocompleteQuery query;
+    if (!PayloadCodec::decode<MessageType::AUTOCOMPLETE_REQUEST>(message.payload, query) ||
+        query.prefix.empty() || query.prefix.size() > Dictionary::MAX_WORD_BYTES) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid autocomplete request");
+    }
+    if (query.limit > MAX_DICTIONARY_RESULTS) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid autocomplete limit");
     }
     
-    // Parse quiz submission: quizId|answers
-    std::vector<std::string> parts = Utils::split(message.payload, '|');
-    if (parts.size() < 2) {
+    // Answered inline: a completion walks the prefix and at most limit words past it
+    std::shared_ptr<const Dictionary> dictionary = Database::getInstance().getDictionary();
+    if (!dictionary) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No dictionary loaded");
+    }
+    size_t limit = query.limit > 0 ? query.limit : DEFAULT_DICTIONARY_RESULTS;
+    return dictionaryMessage<MessageType::AUTOCOMPLETE_RESPONSE>(dictionary->complete(query.prefix, limit));
+}
+
+Message ClientHandler::handleLookupWordRequest(const Message& message) {
+    WordQuery query;
+    if (!PayloadCodec::decode<MessageType::LOOKUP_WORD_REQUEST>(message.payload, query) ||
+        Utils::trimView(query.word).empty() || query.word.size() > Dictionary::MAX_WORD_BYTES) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid word lookup request");
+    }
+    if (query.maxDistance > MAX_LOOKUP_DISTANCE || query.limit > MAX_DICTIONARY_RESULTS) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid lookup distance or limit");
+    }
+    
+    std::shared_ptr<const Dictionary> dictionary = Database::getInstance().getDictionary();
+    if (!dictionary) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No dictionary loaded");
+    }
+    
+    // An exact match is answered inline; the typo-tolerant walk (up to a few hundred
+    // microseconds on long words) runs on the worker pool
+    std::string_view word = Utils::trimView(query.word);
+    Dictionary::Match match;
+    bool found = dictionary->lookup(word, match);
+    if (found || query.maxDistance == 0) {
+        std::vector<Dictionary::Match> matches;
+        if (found) matches.push_back(std::move(match));
+        return dictionaryMessage<MessageType::LOOKUP_WORD_RESPONSE>(matches);
+    }
+    size_t limit = query.limit > 0 ? query.limit : DEFAULT_DICTIONARY_RESULTS;
+    return deferResponse([dictionary, word = std::string(word), maxDistance = query.maxDistance, limit]() {
+        return dictionaryMessage<MessageType::LOOKUP_WORD_RESPONSE>(dictionary->fuzzy(word, maxDistance, limit));
+    });
+}
+
+Message ClientHandler::handleSubmitQuizRequest(const Message& message) {
+    QuizSubmission submission;
+    if (!PayloadCodec::decode<MessageType::SUBMIT_QUIZ_REQUEST>(message.payload, submission)) {
         return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid quiz submission");
     }
     
-    std::string quizId = parts[0];
-    // Simple scoring: award 10 points per question
-    int score = 10;
+    std::string quizId(Utils::trimView(submission.quizId));
+    std::pmr::vector<std::string_view> answers(submission.answers.begin(), submission.answers.end(), arena_.resource());
+    GradeResult result;
+    if (!Database::getInstance().gradeQuiz(quizId, answers.data(), answers.size(), result)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "Unknown quiz: " + quizId);
+    }
+    
+    Database::getInstance().saveScore(username_, quizId, result.score);
     
-    Database::getInstance().saveScore(username_, quizId, score);
+    // Every question is scheduled for review on its own
+    for (size_t i = 0; i < result.perQuestion.size(); ++i) {
+        int quality = result.perQuestion[i] == '1' ? ReviewScheduler::QUALITY_PERFECT
+                                                   : ReviewScheduler::QUALITY_FAILED;
+        Database::getInstance().recordReview(username_, quizId + "#" + std::to_string(i + 1), quality);
+    }
     
-    std::string response = std::to_string(score) + "|Correct answers: 1/1";
-    return Message(MessageType::SUBMIT_QUIZ_RESPONSE, response);
+    QuizResult reply;
+    reply.score = result.score;
+    reply.correct = static_cast<uint32_t>(result.correct);
+    reply.total = static_cast<uint32_t>(result.total);
+    reply.perQuestion = result.perQuestion;
+    return Message(MessageType::SUBMIT_QUIZ_RESPONSE, PayloadCodec::encode<MessageType::SUBMIT_QUIZ_RESPONSE>(reply));
 }
 
 Message ClientHandler::handleSubmitExerciseRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    ExerciseSubmission submission;
+    if (!PayloadCodec::decode<MessageType::SUBMIT_EXERCISE_REQUEST>(message.payload, submission)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid exercise submission");
     }
     
-    // Similar to quiz submission
-    std::vector<std::string> parts = Utils::split(message.payload, '|');
-    if (parts.size() < 2) {
-        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid exercise submission");
+    std::string exerciseId(Utils::trimView(submission.exerciseId));
+    GradeResult result;
+    if (!Database::getInstance().gradeExercise(exerciseId, submission.answer, result)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "Unknown exercise: " + exerciseId);
     }
     
-    std::string exerciseId = parts[0];
-    int score = 5;
+    Database::getInstance().saveScore(username_, exerciseId, result.score);
     
-    Database::getInstance().saveScore(username_, exerciseId, score);
+    int quality = result.correct ? ReviewScheduler::QUALITY_PERFECT
+                : result.score > 0 ? ReviewScheduler::QUALITY_PARTIAL
+                : ReviewScheduler::QUALITY_FAILED;
+    Database::getInstance().recordReview(username_, exerciseId, quality);
     
-    return Message(MessageType::SUBMIT_EXERCISE_RESPONSE, std::to_string(score));
+    ExerciseResult reply;
+    reply.score = result.score;
+    reply.correct = result.correct != 0;
+    reply.distance = static_cast<uint32_t>(result.distance);
+    return Message(MessageType::SUBMIT_EXERCISE_RESPONSE,
+                  PayloadCodec::encode<MessageType::SUBMIT_EXERCISE_RESPONSE>(reply));
 }
 
-Message ClientHandler::handleGameStartRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handlePronunciationStart(const Message& message) {
+    RecordingStart start;
+    if (!PayloadCodec::decode<MessageType::PRONUNCIATION_START_REQUEST>(message.payload, start) ||
+        Utils::trimView(start.sentenceId).empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid recording request");
     }
     
-    std::string gameType = Utils::trim(message.payload);
-    std::vector<std::string> items = Database::getInstance().getGameItems(gameType);
+    std::string sentenceId(Utils::trimView(start.sentenceId));
+    int sampleRate = static_cast<int>(start.sampleRate);
+    if (start.sampleRate < 8000 || start.sampleRate > 48000) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Unsupported sample rate");
+    }
     
-    std::string response = "game_session_id_123|";
-    for (const auto& item : items) {
-        response += item + ";";
+    bool reference = start.reference;
+    if (reference && role_ == UserRole::STUDENT) {
+        return createErrorResponse(ErrorCode::PERMISSION_DENIED, "Only teachers can record references");
     }
+    if (!reference && !Database::getInstance().hasPronunciationReference(sentenceId)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No reference recording for: " + sentenceId);
+    }
+    
+    // Starting again discards an unfinished recording
+    pronunciation_ = std::make_shared<PronunciationSession>(sentenceId, sampleRate, reference, MAX_RECORDING_SECONDS);
     
-    return Message(MessageType::GAME_START_RESPONSE, response);
+    return Message(MessageType::PRONUNCIATION_START_RESPONSE, sentenceId);
 }
 
-Message ClientHandler::handleGameMoveRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handlePronunciationChunk(const Message& message) {
+    if (!pronunciation_) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "No recording in progress");
+    }
+    
+    std::pmr::string bytes(arena_.resource());
+    if (!Parser::decodeBase64(message.payload, bytes) || bytes.size() % 2 != 0) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid audio chunk");
+    }
+    
+    size_t count = bytes.size() / 2;
+    std::shared_ptr<PronunciationSession> session = pronunciation_;
+    if (session->totalSamples + count > session->maxSamples) {
+        pronunciation_.reset();
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Recording too long");
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t raw = static_cast<uint8_t>(bytes[2 * i]) | (static_cast<uint8_t>(bytes[2 * i + 1]) << 8);
+            session->pending.push_back(static_cast<int16_t>(raw));
+        }
     }
+    session->totalSamples += count;
     
-    // Simple game move validation
-    std::string result = "move_accepted|score:10";
-    return Message(MessageType::GAME_MOVE_RESPONSE, result);
+    // Feature extraction keeps pace with the upload instead of piling up for the end
+    runInBackground([session] { session->drain(); });
+    
+    return Message(MessageType::PRONUNCIATION_CHUNK_ACK, std::to_string(session->totalSamples));
 }
 
-Message ClientHandler::handleGetScoreRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handlePronunciationEnd(const Message& message) {
+    if (!pronunciation_) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "No recording in progress");
     }
     
-    UserData userData;
-    if (Database::getInstance().getUserData(username_, userData)) {
-        return Message(MessageType::GET_SCORE_RESPONSE, std::to_string(userData.score));
+    std::shared_ptr<PronunciationSession> session = std::move(pronunciation_);
+    std::string username = username_;
+    
+    return deferResponse([session, username]() {
+        session->drain();
+        std::vector<float> features;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            features = session->extractor.finish();
+        }
+        size_t frames = features.size() / MfccExtractor::NUM_COEFFS;
+        
+        if (session->reference) {
+            if (!Database::getInstance().setPronunciationReference(session->sentenceId, std::move(features))) {
+                return Message(MessageType::ERROR_MESSAGE,
+                              Parser::createErrorMessage(ErrorCode::INVALID_PARAMETER, "Recording contains no speech"));
+            }
+            Logger::getInstance().info("Pronunciation reference for " + session->sentenceId + " recorded by " + username);
+            PronunciationScore reply;
+            reply.similarity = 100;
+            reply.frames = frames;
+            return Message(MessageType::PRONUNCIATION_RESULT,
+                          PayloadCodec::encode<MessageType::PRONUNCIATION_RESULT>(reply));
+        }
+        
+        PronunciationResult result;
+        if (!Database::getInstance().scorePronunciation(session->sentenceId, features, result)) {
+            return Message(MessageType::ERROR_MESSAGE,
+                          Parser::createErrorMessage(ErrorCode::RESOURCE_NOT_FOUND, "No reference recording for: " + session->sentenceId));
+        }
+        
+        Database::getInstance().saveScore(username, session->sentenceId, result.score);
+        int quality = result.similarity >= 80 ? ReviewScheduler::QUALITY_PERFECT
+                    : result.similarity >= 50 ? ReviewScheduler::QUALITY_PARTIAL
+                    : ReviewScheduler::QUALITY_FAILED;
+        Database::getInstance().recordReview(username, "say:" + session->sentenceId, quality);
+        
+        PronunciationScore reply;
+        reply.score = result.score;
+        reply.similarity = static_cast<uint32_t>(result.similarity);
+        reply.frames = result.frames;
+        return Message(MessageType::PRONUNCIATION_RESULT, PayloadCodec::encode<MessageType::PRONUNCIATION_RESULT>(reply));
+    });
+}
+
+Message ClientHandler::handleGameStartRequest(const Message& message) {
+    GameQuery query;
+    if (!PayloadCodec::decode<MessageType::GAME_START_REQUEST>(message.payload, query)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid game request");
+    }
+    if (query.itemCount > 100) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid item count");
+    }
+    size_t itemCount = query.itemCount > 0 ? query.itemCount : GameCatalog::DEFAULT_SAMPLE_SIZE;
+    
+    // Every game deals a fresh sample, and its moves are graded against it.
+    // The snapshot is immutable, so sampling needs neither a copy nor a lock.
+    gameType_ = std::string(Utils::trimView(query.gameType));
+    gameItems_.clear();
+    GameCatalog::SnapshotPtr snapshot = Database::getInstance().getGameSnapshot(gameType_);
+    if (snapshot) {
+        for (uint32_t index : GameCatalog::sample(*snapshot, level_, itemCount)) {
+            gameItems_.push_back(snapshot->items[index].data);
+        }
+    }
+    
+    GameDeal deal;
+    deal.sessionId = nextGameSession_.fetch_add(1, std::memory_order_relaxed);
+    deal.items = PayloadCodec::List<std::string_view>::of(gameItems_);
+    return Message(MessageType::GAME_START_RESPONSE, PayloadCodec::encode<MessageType::GAME_START_RESPONSE>(deal));
+}
+
+Message ClientHandler::handleGameMoveRequest(const Message& message) {
+    // Parse: prompt=answer, for one of the items of the current game ("cat=animal")
+    std::string_view moveData = Utils::trimView(message.payload);
+    size_t sep = moveData.find('=');
+    std::string_view prompt = Utils::trimView(moveData.substr(0, sep));
+    std::string_view answer = sep == std::string_view::npos ? std::string_view() : Utils::trimView(moveData.substr(sep + 1));
+    if (prompt.empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid game move");
+    }
+    
+    // Only items this game was dealt are graded, so the review queue holds real items only
+    auto item = std::find_if(gameItems_.begin(), gameItems_.end(), [prompt](const std::string& data) {
+        return Utils::trimView(std::string_view(data).substr(0, data.find('='))) == prompt;
+    });
+    if (item == gameItems_.end()) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Item is not part of the current game");
+    }
+    
+    // An item without an answer part is answered by naming it
+    size_t itemSep = item->find('=');
+    std::string_view expected = itemSep == std::string::npos ? std::string_view()
+                                                             : Utils::trimView(std::string_view(*item).substr(itemSep + 1));
+    // Compared the way quiz answers are: case, punctuation and extra spaces do not count
+    std::string given, wanted;
+    QuizBank::normalize(answer, given);
+    QuizBank::normalize(expected, wanted);
+    bool correct = given == wanted;
+    Database::getInstance().recordReview(username_, "game:" + *item,
+                                         correct ? ReviewScheduler::QUALITY_PERFECT : ReviewScheduler::QUALITY_FAILED);
+    
+    return Message(MessageType::GAME_MOVE_RESPONSE, correct ? "correct|10" : "incorrect|0");
+}
+
+Message ClientHandler::handleGetScoreRequest(const Message& message) {
+    // Response: score and global rank (0 when not ranked)
+    int score = 0;
+    size_t rank = 0;
+    if (Database::getInstance().getUserScore(username_, score, rank)) {
+        ScoreReport report;
+        report.score = score;
+        report.rank = rank;
+        return Message(MessageType::GET_SCORE_RESPONSE, PayloadCodec::encode<MessageType::GET_SCORE_RESPONSE>(report));
     }
     
     return createErrorResponse(ErrorCode::DATABASE_ERROR, "Failed to retrieve score");
 }
 
 Message ClientHandler::handleGetFeedbackRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    // Payload: FeedbackQuery; empty asks for the first page
+    FeedbackQuery query;
+    if (!message.payload.empty() && !PayloadCodec::decode<MessageType::GET_FEEDBACK_REQUEST>(message.payload, query)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid feedback request");
+    }
+    if (query.limit > MAX_FEEDBACK_PAGE) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid entry count");
     }
     
-    std::vector<std::string> feedbacks = Database::getInstance().getFeedback(username_);
+    // Only the entries after the cursor are read and sent, as many as fit one message; a
+    // cursor from another run restarts
+    const size_t budget = AppConstants::MAX_MESSAGE_SIZE - 32;   // epoch, more and list length
+    Database& db = Database::getInstance();
+    FeedbackPage page;
+    page.epoch = db.getVersionEpoch();
+    uint64_t after = query.epoch == page.epoch ? query.after : 0;
+    std::vector<FeedbackEntry> entries = db.getFeedbackAfter(username_, after, query.limit ? query.limit : DEFAULT_FEEDBACK_PAGE,
+                                                             budget, page.more);
+    page.entries = PayloadCodec::List<FeedbackEntry>::of(entries);
     
-    std::string response;
-    for (const auto& feedback : feedbacks) {
-        if (!response.empty()) response += ";";
-        response += feedback;
+    return Message(MessageType::GET_FEEDBACK_RESPONSE, PayloadCodec::encode<MessageType::GET_FEEDBACK_RESPONSE>(page));
+}
+
+Message ClientHandler::handleGetReviewQueueRequest(const Message& message) {
+    // Payload: optional item count (default 10, max 100)
+    size_t count = 10;
+    if (!Utils::trimView(message.payload).empty()) {
+        int requested = 0;
+        if (!parseNumber(message.payload, requested) || requested <= 0 || requested > 100) {
+            return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid item count");
+        }
+        count = static_cast<size_t>(requested);
     }
     
-    return Message(MessageType::GET_FEEDBACK_RESPONSE, response);
+    std::pmr::vector<std::pmr::string> items = Database::getInstance().getReviewQueue(username_, count, arena_.resource());
+    return textListMessage<MessageType::GET_REVIEW_QUEUE_RESPONSE>(items);
 }
 
-Message ClientHandler::handleSendFeedbackRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handleGetLeaderboardRequest(const Message& message) {
+    // mode = top|around, board = global|level|level:N; empty fields take the defaults
+    LeaderboardQuery query;
+    if (!PayloadCodec::decode<MessageType::GET_LEADERBOARD_REQUEST>(message.payload, query)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid leaderboard request");
+    }
+    std::string_view mode = query.mode;
+    std::string board(query.board);
+    
+    if (mode.empty()) mode = "top";
+    if (mode != "top" && mode != "around") {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid leaderboard mode");
     }
     
-    if (role_ != UserRole::TEACHER && role_ != UserRole::ADMIN) {
-        return createErrorResponse(ErrorCode::PERMISSION_DENIED, "Only teachers can send feedback");
+    if (board.empty()) board = "global";
+    if (board == "level") board = Database::levelBoardName(level_);
+    
+    size_t count = mode == "top" ? 10 : 3;
+    if (query.count > 100) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid entry count");
+    }
+    if (query.count > 0) count = query.count;
+    
+    LeaderboardView view;
+    if (!Database::getInstance().queryLeaderboard(board, username_, mode == "around", count, view)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "Unknown leaderboard: " + board);
     }
     
-    // Parse: targetUser|exerciseId|feedback
-    std::vector<std::string> parts = Utils::split(message.payload, '|');
-    if (parts.size() < 3) {
+    LeaderboardPage page;
+    page.board = board;
+    page.rank = view.rank;
+    page.total = view.total;
+    page.entries = PayloadCodec::List<LeaderboardEntry>::of(view.entries);
+    return Message(MessageType::GET_LEADERBOARD_RESPONSE, PayloadCodec::encode<MessageType::GET_LEADERBOARD_RESPONSE>(page));
+}
+
+Message ClientHandler::handleSendFeedbackRequest(const Message& message) {
+    FeedbackNote note;
+    if (!PayloadCodec::decode<MessageType::SEND_FEEDBACK_REQUEST>(message.payload, note) ||
+        note.student.empty() || note.text.empty()) {
         return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid feedback format");
     }
     
-    std::string targetUser = parts[0];
-    std::string exerciseId = parts[1];
-    std::string feedback = parts[2];
+    std::string targetUser(note.student);
+    std::string exerciseId(note.exerciseId);
+    std::string feedback(note.text);
     
     if (Database::getInstance().saveFeedback(targetUser, exerciseId, feedback, username_)) {
         return Message(MessageType::SEND_FEEDBACK_SUCCESS, Parser::createSuccessMessage());
@@ -324,58 +877,230 @@ Message ClientHandler::handleSendFeedbackRequest(const Message& message) {
     return createErrorResponse(ErrorCode::DATABASE_ERROR, "Failed to save feedback");
 }
 
-Message ClientHandler::handleChatMessage(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+Message ClientHandler::handleSendFeedbackBatchRequest(const Message& message) {
+    FeedbackBatch batch;
+    if (!PayloadCodec::decode<MessageType::SEND_FEEDBACK_BATCH_REQUEST>(message.payload, batch) ||
+        batch.notes.empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid feedback batch");
+    }
+    
+    // Malformed notes fail on their own; the rest are saved together. A note is held to the
+    // size of a single SEND_FEEDBACK_REQUEST, so each entry fits a feedback page.
+    std::vector<uint16_t> statuses;
+    std::vector<size_t> positions;
+    std::vector<FeedbackSubmission> notes;
+    statuses.reserve(batch.notes.size());
+    for (const FeedbackNote& note : batch.notes) {
+        if (note.student.empty() || note.text.empty() ||
+            note.student.size() + note.exerciseId.size() + note.text.size() > MessagePolicies::TEXT) {
+            statuses.push_back(static_cast<uint16_t>(ErrorCode::INVALID_FORMAT));
+            continue;
+        }
+        positions.push_back(statuses.size());
+        statuses.push_back(static_cast<uint16_t>(ErrorCode::SUCCESS));
+        notes.push_back(FeedbackSubmission{std::string(note.student), std::string(note.exerciseId),
+                                           std::string(note.text)});
     }
     
-    std::string recipient, messageText;
-    if (!Parser::parseChatMessage(message.payload, recipient, messageText)) {
+    if (!notes.empty()) {
+        std::vector<ErrorCode> saved = Database::getInstance().saveFeedbackBatch(notes, username_);
+        for (size_t i = 0; i < saved.size(); ++i) {
+            statuses[positions[i]] = static_cast<uint16_t>(saved[i]);
+        }
+    }
+    
+    return batchResultMessage<MessageType::SEND_FEEDBACK_BATCH_RESPONSE>(statuses);
+}
+
+Message ClientHandler::handleChatMessage(const Message& message) {
+    ChatPayload chat;
+    if (!PayloadCodec::decode<MessageType::CHAT_MESSAGE>(message.payload, chat) ||
+        Utils::trimView(chat.recipient).empty() || chat.text.empty()) {
         return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid chat message");
     }
     
     // In a real implementation, this would forward the message to the recipient
-    Logger::getInstance().info("Chat from " + username_ + " to " + recipient + ": " + messageText);
+    Logger::getInstance().info("Chat from " + username_ + " to " + std::string(chat.recipient) + ": " + std::string(chat.text));
     
     return Message(MessageType::CHAT_MESSAGE_ACK, Parser::createSuccessMessage("Message sent"));
 }
 
 Message ClientHandler::handleVoiceCallRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    CallOffer offer;
+    if (!PayloadCodec::decode<MessageType::VOICE_CALL_REQUEST>(message.payload, offer)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid call request");
+    }
+    std::string targetUser(Utils::trimView(offer.user));
+    if (targetUser.empty() || targetUser == username_) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid call target");
+    }
+    
+    SessionData targetSession;
+    if (!Database::getInstance().getSessionByUsername(targetUser, targetSession)) {
+        return createErrorResponse(ErrorCode::USER_NOT_FOUND, "User is not online: " + targetUser);
+    }
+    
+    uint32_t callId = 0;
+    if (CallManager::getInstance().startCall(username_, targetUser, callId) != ErrorCode::SUCCESS) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "User is busy");
+    }
+    
+    // The callee gets the call's id and the caller; the caller waits for ACCEPT or REJECT
+    offer.callId = callId;
+    offer.user = username_;
+    notifyUser(targetUser, Message(MessageType::VOICE_CALL_REQUEST, PayloadCodec::encode<MessageType::VOICE_CALL_REQUEST>(offer)));
+    
+    return Message(MessageType::VOICE_CALL_RINGING, std::to_string(callId));
+}
+
+Message ClientHandler::handleVoiceCallAccept(const Message& message) {
+    CallAnswer answer;
+    if (!PayloadCodec::decode<MessageType::VOICE_CALL_ACCEPT>(message.payload, answer) || answer.callId == 0) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid call id");
     }
     
-    std::string targetUser = Utils::trim(message.payload);
+    CallInfo call;
+    if (!CallManager::getInstance().acceptCall(answer.callId, username_, call)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No incoming call " + std::to_string(answer.callId));
+    }
     
-    // In a real implementation, this would initiate WebRTC or similar
-    Logger::getInstance().info("Voice call request from " + username_ + " to " + targetUser);
+    // Each side gets the relay port and its own token for its media frames
+    answer.relayPort = static_cast<uint32_t>(CallManager::getInstance().getRelayPort());
+    answer.token = call.callerToken;
+    notifyUser(call.caller, Message(MessageType::VOICE_CALL_ACCEPT, PayloadCodec::encode<MessageType::VOICE_CALL_ACCEPT>(answer)));
     
-    return Message(MessageType::VOICE_CALL_ACCEPT, "call_session_id_123");
+    answer.token = call.calleeToken;
+    return Message(MessageType::VOICE_CALL_ACCEPT, PayloadCodec::encode<MessageType::VOICE_CALL_ACCEPT>(answer));
+}
+
+Message ClientHandler::handleVoiceCallReject(const Message& message) {
+    uint32_t callId = 0;
+    if (!parseCallId(message.payload, callId)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid call id");
+    }
+    
+    CallInfo call;
+    if (!CallManager::getInstance().rejectCall(callId, username_, call)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No incoming call " + std::to_string(callId));
+    }
+    
+    notifyUser(call.caller, Message(MessageType::VOICE_CALL_REJECT, std::to_string(call.id)));
+    
+    return Message(MessageType::VOICE_CALL_REJECT, std::to_string(call.id));
+}
+
+Message ClientHandler::handleVoiceCallEnd(const Message& message) {
+    uint32_t callId = 0;
+    if (!parseCallId(message.payload, callId)) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid call id");
+    }
+    
+    CallInfo call;
+    if (!CallManager::getInstance().endCall(callId, username_, call)) {
+        return createErrorResponse(ErrorCode::RESOURCE_NOT_FOUND, "No such call " + std::to_string(callId));
+    }
+    
+    notifyUser(call.peerOf(username_), Message(MessageType::VOICE_CALL_END, std::to_string(call.id)));
+    
+    return Message(MessageType::VOICE_CALL_END, std::to_string(call.id));
 }
 
 Message ClientHandler::handleAddGameItemRequest(const Message& message) {
-    if (!authenticated_) {
-        return createErrorResponse(ErrorCode::NOT_AUTHENTICATED, "Authentication required");
+    GameItemRecord record;
+    if (!PayloadCodec::decode<MessageType::ADD_GAME_ITEM_REQUEST>(message.payload, record)) {
+        return Message(MessageType::ADD_GAME_ITEM_FAILED,
+                      Parser::createErrorMessage(ErrorCode::INVALID_FORMAT, "Invalid format"));
     }
     
-    if (role_ != UserRole::ADMIN) {
+    // The same rules as for imported items
+    std::string_view gameType = Utils::trimView(record.gameType);
+    std::string_view itemData = Utils::trimView(record.data);
+    std::string error;
+    if (!ContentImporter::validItem(gameType, itemData, error)) {
+        return Message(MessageType::ADD_GAME_ITEM_FAILED,
+                      Parser::createErrorMessage(ErrorCode::INVALID_FORMAT, error));
+    }
+    if (record.level < 1 || record.level > GameCatalog::LEVEL_COUNT) {
         return Message(MessageType::ADD_GAME_ITEM_FAILED,
-                      Parser::createErrorMessage(ErrorCode::PERMISSION_DENIED, "Admin access required"));
+                      Parser::createErrorMessage(ErrorCode::INVALID_PARAMETER, "Invalid level"));
     }
+    ProficiencyLevel itemLevel = static_cast<ProficiencyLevel>(record.level);
     
-    // Parse: gameType|itemData
-    std::vector<std::string> parts = Utils::split(message.payload, '|');
-    if (parts.size() < 2) {
+    // Publishing copies the type's catalog and may merge search segments; that runs off the event loop
+    return deferResponse([gameType = std::string(gameType), itemData = std::string(itemData), itemLevel]() {
+        if (Database::getInstance().addGameItem(gameType, itemData, itemLevel)) {
+            return Message(MessageType::ADD_GAME_ITEM_SUCCESS, Parser::createSuccessMessage());
+        }
         return Message(MessageType::ADD_GAME_ITEM_FAILED,
-                      Parser::createErrorMessage(ErrorCode::INVALID_FORMAT, "Invalid format"));
+                      Parser::createErrorMessage(ErrorCode::ALREADY_EXISTS, "Item already exists"));
+    });
+}
+
+Message ClientHandler::handleAddGameItemsRequest(const Message& message) {
+    GameItemBatch batch;
+    if (!PayloadCodec::decode<MessageType::ADD_GAME_ITEMS_REQUEST>(message.payload, batch) || batch.items.empty()) {
+        return createErrorResponse(ErrorCode::INVALID_FORMAT, "Invalid game item batch");
     }
     
-    if (Database::getInstance().addGameItem(parts[0], parts[1])) {
-        return Message(MessageType::ADD_GAME_ITEM_SUCCESS, Parser::createSuccessMessage());
+    // Each record is checked like an imported item and fails on its own
+    std::vector<uint16_t> statuses;
+    std::vector<std::pair<std::string, GameItem>> items;
+    std::string error;
+    statuses.reserve(batch.items.size());
+    for (const GameItemRecord& record : batch.items) {
+        ErrorCode status = ErrorCode::SUCCESS;
+        std::string_view gameType = Utils::trimView(record.gameType);
+        std::string_view data = Utils::trimView(record.data);
+        if (!ContentImporter::validItem(gameType, data, error)) {
+            status = ErrorCode::INVALID_FORMAT;
+        } else if (record.level < 1 || record.level > GameCatalog::LEVEL_COUNT) {
+            status = ErrorCode::INVALID_PARAMETER;
+        } else {
+            items.emplace_back(std::string(gameType), GameItem(std::string(data),
+                                                               static_cast<ProficiencyLevel>(record.level)));
+        }
+        statuses.push_back(static_cast<uint16_t>(status));
     }
     
-    return Message(MessageType::ADD_GAME_ITEM_FAILED,
-                  Parser::createErrorMessage(ErrorCode::DATABASE_ERROR, "Failed to add item"));
+    // Publishing extends the snapshot of each type touched; that runs off the event loop.
+    // Valid records get their status from the catalog's duplicate check, in order.
+    return deferResponse([items = std::move(items), statuses = std::move(statuses)]() mutable {
+        if (!items.empty()) {
+            std::vector<ErrorCode> added = Database::getInstance().addGameItems(std::move(items));
+            size_t next = 0;
+            for (uint16_t& status : statuses) {
+                if (status == static_cast<uint16_t>(ErrorCode::SUCCESS)) {
+                    status = static_cast<uint16_t>(added[next++]);
+                }
+            }
+        }
+        return batchResultMessage<MessageType::ADD_GAME_ITEMS_RESPONSE>(statuses);
+    });
+}
+
+Message ClientHandler::handleImportContentRequest(const Message& message) {
+    // Payload: a file name inside the import directory; paths are not accepted
+    std::string name(Utils::trimView(message.payload));
+    if (name.empty() || name.front() == '.' || name.find_first_of("/\\") != std::string::npos) {
+        return createErrorResponse(ErrorCode::INVALID_PARAMETER, "Invalid file name");
+    }
+    std::string path = Database::getInstance().getImportDirectory() + "/" + name;
+    
+    // Parsing runs on its own threads; this worker waits for it and publishes the result
+    return deferResponse([path, name]() {
+        ImportReport report;
+        if (!Database::getInstance().importContent(path, report)) {
+            return Message(MessageType::ERROR_MESSAGE,
+                           Parser::createErrorMessage(ErrorCode::RESOURCE_NOT_FOUND, "Cannot import " + name));
+        }
+        
+        // Response: the summary, then the first errors, one per line
+        std::string summary = report.summary();
+        for (const std::string& error : report.errors) {
+            summary += "\n" + error;
+        }
+        return Message(MessageType::IMPORT_CONTENT_RESPONSE, Parser::createSuccessMessage(summary));
+    });
 }
 
 Message ClientHandler::handleHeartbeatRequest(const Message& message) {
@@ -386,3 +1111,33 @@ Message ClientHandler::createErrorResponse(ErrorCode code, const std::string& de
     return Message(MessageType::ERROR_MESSAGE, Parser::createErrorMessage(code, description));
 }
 
+void ClientHandler::notifyUser(const std::string& username, const Message& message) {
+    notifications_.emplace_back(username, message);
+}
+
+void ClientHandler::defer(DeferredJob job) {
+    ExecutionClass pool = currentExecution_ == ExecutionClass::HASHING ? ExecutionClass::HASHING : ExecutionClass::WORKER;
+    jobs_.push_back({pool, std::move(job)});
+}
+
+Message ClientHandler::deferResponse(std::function<Message()> job) {
+    defer([job = std::move(job)]() -> Completion {
+        Message reply = job();
+        return [reply](ClientHandler&) { return reply; };
+    });
+    return Message();
+}
+
+void ClientHandler::runInBackground(std::function<void()> task) {
+    defer([task = std::move(task)]() -> Completion {
+        task();
+        return nullptr;
+    });
+}
+
+void ClientHandler::endActiveCalls() {
+    for (const CallInfo& call : CallManager::getInstance().endCallsFor(username_)) {
+        notifyUser(call.peerOf(username_), Message(MessageType::VOICE_CALL_END, std::to_string(call.id)));
+    }
+}
+
@@ -7,21 +7,91 @@
 #include "../utils/Logger.hpp"
 #include "../utils/Parser.hpp"
 #include "../db/Database.hpp"
+#include "CallManager.hpp"
+#include "SessionTokens.hpp"
+#include "RateLimiter.hpp"
+#include "../utils/SpeechFeatures.hpp"
+#include "../utils/RequestArena.hpp"
+#include "OutputQueue.hpp"
+#include <atomic>
+#include <deque>
+#include <functional>
+
+// A recording being streamed in for pronunciation scoring.
+// Chunks are appended on the event loop and turned into MFCC frames on worker threads.
+struct PronunciationSession {
+    std::string sentenceId;
+    bool reference;                 // teacher recording that becomes the sentence's template
+    size_t maxSamples;
+    size_t totalSamples = 0;
+    
+    std::mutex mutex;               // guards pending and extractor
+    std::vector<int16_t> pending;   // samples not yet fed to the extractor
+    MfccExtractor extractor;
+    
+    PronunciationSession(const std::string& id, int sampleRate, bool isReference, size_t maxSeconds)
+        : sentenceId(id), reference(isReference),
+          maxSamples(static_cast<size_t>(sampleRate) * maxSeconds), extractor(sampleRate) {}
+    
+    // Feed everything received so far to the extractor
+    void drain();
+};
+
+// A framed message waiting in a connection's inbox
+struct InboundMessage {
+    Message message;
+    std::chrono::steady_clock::time_point received;
+};
 
 // Client handler class for managing individual client state and message processing
 class ClientHandler {
 public:
+    // Finishes deferred work on the event loop thread; a returned message other than UNKNOWN
+    // is sent as the reply
+    using Completion = std::function<Message(ClientHandler&)>;
+    
+    // Runs on a pool thread and hands back the completion (empty: nothing left to do)
+    using DeferredJob = std::function<Completion()>;
+    
+    // pool: WORKER or HASHING, from the request's MessagePolicy
+    struct QueuedJob {
+        ExecutionClass pool;
+        DeferredJob job;
+    };
+    
+    static constexpr size_t MAX_RECORDING_SECONDS = 30;
+    
     ClientHandler(SOCKET socket, const std::string& address, int port);
     ~ClientHandler();
     
-    // Process incoming message
+    // Process incoming message; returns an UNKNOWN message when the reply is deferred or
+    // was queued on the connection already (cached replies)
     Message processMessage(const Message& message);
     
+    // Unique for the server's lifetime (sockets are reused, ids are not)
+    uint64_t getConnectionId() const { return connectionId_; }
+    
+    // Bytes received but not yet framed into messages
+    std::string& getReceiveBuffer() { return receiveBuffer_; }
+    
+    // Framed messages waiting for this connection's turn on the event loop
+    std::deque<InboundMessage>& getInbox() { return inbox_; }
+    
+    // Replies waiting for the socket to take them
+    OutputQueue& getOutput() { return output_; }
+    
+    // This connection's token buckets
+    RateLimiter::Buckets& getRateBuckets() { return rateBuckets_; }
+    
+    // Jobs queued by the last processed message (or completion), for the pools
+    std::vector<QueuedJob> takeJobs();
+    
     // Get client socket
     SOCKET getSocket() const { return socket_; }
     
     // Get client info
     std::string getClientInfo() const;
+    const std::string& getAddress() const { return clientAddress_; }
     
     // Check if authenticated
     bool isAuthenticated() const { return authenticated_; }
@@ -37,31 +107,88 @@ public:
     
     // Check if session timed out
     bool isTimedOut(int timeoutSeconds) const;
+    
+    // Messages to push to other logged-in users: (username, message)
+    std::vector<std::pair<std::string, Message>> takeNotifications();
+    
+    // Connection is closing: hang up the calls of a session it still holds and queue the
+    // resulting notifications
+    void onDisconnect();
 
 private:
     // Message handlers
     Message handleRegisterRequest(const Message& message);
     Message handleLoginRequest(const Message& message);
+    Message finishLogin(const std::string& username, bool passwordValid);
+    
+    // Issue a resume token for the current user/role/level, revoking the previous one
+    void rotateResumeToken();
     Message handleLogoutRequest(const Message& message);
+    Message handleResumeRequest(const Message& message);
     Message handleSetLevelRequest(const Message& message);
     Message handleGetLessonListRequest(const Message& message);
     Message handleGetLessonContentRequest(const Message& message);
+    Message handleSearchRequest(const Message& message);
+    Message handleAutocompleteRequest(const Message& message);
+    Message handleLookupWordRequest(const Message& message);
     Message handleSubmitQuizRequest(const Message& message);
     Message handleSubmitExerciseRequest(const Message& message);
+    Message handlePronunciationStart(const Message& message);
+    Message handlePronunciationChunk(const Message& message);
+    Message handlePronunciationEnd(const Message& message);
     Message handleGameStartRequest(const Message& message);
     Message handleGameMoveRequest(const Message& message);
     Message handleGetScoreRequest(const Message& message);
     Message handleGetFeedbackRequest(const Message& message);
+    Message handleGetReviewQueueRequest(const Message& message);
+    Message handleGetLeaderboardRequest(const Message& message);
     Message handleSendFeedbackRequest(const Message& message);
+    Message handleSendFeedbackBatchRequest(const Message& message);
     Message handleChatMessage(const Message& message);
     Message handleVoiceCallRequest(const Message& message);
+    Message handleVoiceCallAccept(const Message& message);
+    Message handleVoiceCallReject(const Message& message);
+    Message handleVoiceCallEnd(const Message& message);
     Message handleAddGameItemRequest(const Message& message);
+    Message handleAddGameItemsRequest(const Message& message);
+    Message handleImportContentRequest(const Message& message);
     Message handleHeartbeatRequest(const Message& message);
     
     // Create error response
     Message createErrorResponse(ErrorCode code, const std::string& description);
     
+    // Queue a message for another user's connection
+    void notifyUser(const std::string& username, const Message& message);
+    
+    // Hang up this user's calls, telling the other participants
+    void endActiveCalls();
+    
+    // Run job on the pool the request's policy names; handlers return Message() after this
+    // and the completion replies
+    void defer(DeferredJob job);
+    
+    // Run job off the event loop and answer with its result
+    Message deferResponse(std::function<Message()> job);
+    
+    // Run task off the event loop without a reply
+    void runInBackground(std::function<void()> task);
+    
+    // Reply to a read-only content request with the shared frame cached under key, calling
+    // build(lessonVersion) to make it on a miss; returns Message() once the reply is queued.
+    // A client that already has the current version gets NOT_MODIFIED instead.
+    template <typename Build>
+    Message replyCached(const Message& request, std::string_view key, uint64_t knownVersion, Build build);
+    
+    // Handlers in MessagePolicies::TABLE order
+    using Handler = Message (ClientHandler::*)(const Message& message);
+    struct HandlerBinding {
+        MessageType type;
+        Handler handler;
+    };
+    static const std::array<HandlerBinding, MessagePolicies::COUNT> HANDLERS;
+    
     SOCKET socket_;
+    uint64_t connectionId_;
     std::string clientAddress_;
     int clientPort_;
     
@@ -69,8 +196,27 @@ private:
     std::string username_;
     UserRole role_;
     ProficiencyLevel level_;
+    std::string resumeToken_;   // last token issued to this connection
+    ExecutionClass currentExecution_;   // of the request being handled
+    RequestArena arena_;                // scratch for the request being handled
     
     std::chrono::steady_clock::time_point lastActivity_;
+    
+    std::vector<std::pair<std::string, Message>> notifications_;
+    std::vector<QueuedJob> jobs_;
+    std::string receiveBuffer_;
+    std::deque<InboundMessage> inbox_;
+    OutputQueue output_;
+    RateLimiter::Buckets rateBuckets_;
+    
+    std::shared_ptr<PronunciationSession> pronunciation_;
+    
+    // The current game: its type and the items sampled for it, which moves are graded against
+    std::string gameType_;
+    std::vector<std::string> gameItems_;
+    
+    static std::atomic<uint64_t> nextConnectionId_;
+    static std::atomic<uint64_t> nextGameSession_;   // game ids, unique for the server's lifetime
 };
 
 #endif // CLIENT_HANDLER_HPP
@@ -0,0 +1,62 @@
+#include "LoadMonitor.hpp"
+
+namespace {
+    const double LAG_SMOOTHING = 0.2;   // weight of the newest sample
+
+    const char* levelName(LoadLevel level) {
+        switch (level) {
+            case LoadLevel::NORMAL: return "normal";
+            case LoadLevel::ELEVATED: return "elevated";
+            case LoadLevel::CRITICAL: return "critical";
+            default: return "unknown";
+        }
+    }
+}
+
+LoadMonitor::LoadMonitor() : lagMs_(0), queueDepth_(0), level_(LoadLevel::NORMAL) {
+}
+
+LoadLevel LoadMonitor::levelFor(double lagMs, size_t queueDepth, double scale) const {
+    if (lagMs >= thresholds_.criticalLagMs * scale || queueDepth >= thresholds_.criticalQueueDepth * scale) {
+        return LoadLevel::CRITICAL;
+    }
+    if (lagMs >= thresholds_.elevatedLagMs * scale || queueDepth >= thresholds_.elevatedQueueDepth * scale) {
+        return LoadLevel::ELEVATED;
+    }
+    return LoadLevel::NORMAL;
+}
+
+void LoadMonitor::recordIteration(std::chrono::steady_clock::duration lag, size_t queueDepth) {
+    double sampleMs = std::chrono::duration<double, std::milli>(lag).count();
+    lagMs_ += LAG_SMOOTHING * (sampleMs - lagMs_);
+    queueDepth_ = queueDepth;
+
+    // Escalate at once; step down only when well clear, so the level does not flap
+    LoadLevel level = levelFor(lagMs_, queueDepth_, 1.0);
+    if (level < level_) {
+        level = std::max(level, levelFor(lagMs_, queueDepth_, 0.5));
+    }
+
+    if (level != level_) {
+        Logger::getInstance().warning(std::string("Server load ") + levelName(level) +
+                                      " (loop lag " + std::to_string(static_cast<int>(lagMs_)) +
+                                      " ms, queued " + std::to_string(queueDepth_) + ")");
+        level_ = level;
+    }
+}
+
+RequestPriority LoadMonitor::priorityOf(MessageType type) {
+    const MessagePolicy* policy = MessagePolicies::find(type);
+    return policy ? policy->priority : RequestPriority::NORMAL;
+}
+
+bool LoadMonitor::shouldShed(MessageType type) const {
+    switch (level_) {
+        case LoadLevel::CRITICAL:
+            return priorityOf(type) != RequestPriority::HIGH;
+        case LoadLevel::ELEVATED:
+            return priorityOf(type) == RequestPriority::LOW;
+        default:
+            return false;
+    }
+}
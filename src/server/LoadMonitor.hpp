@@ -0,0 +1,52 @@
+#ifndef LOAD_MONITOR_HPP
+#define LOAD_MONITOR_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "../protocol/MessagePolicy.hpp"
+#include "../utils/Logger.hpp"
+
+enum class LoadLevel : uint8_t {
+    NORMAL = 0,
+    ELEVATED = 1,   // shed LOW priority requests
+    CRITICAL = 2    // shed everything but HIGH priority requests
+};
+
+// Where overload starts; a level is left again once both measures fall below half its thresholds
+struct LoadThresholds {
+    double elevatedLagMs = 50;
+    double criticalLagMs = 250;
+    size_t elevatedQueueDepth = 256;
+    size_t criticalQueueDepth = 1024;
+};
+
+// Tracks how far the event loop is falling behind (smoothed lag) and how much work is
+// queued, and decides which requests to refuse with SERVER_BUSY. Event loop thread only.
+class LoadMonitor {
+public:
+    LoadMonitor();
+
+    void setThresholds(const LoadThresholds& thresholds) { thresholds_ = thresholds; }
+
+    // Once per loop iteration: how long work waited or ran, and the messages and jobs queued
+    void recordIteration(std::chrono::steady_clock::duration lag, size_t queueDepth);
+
+    LoadLevel getLevel() const { return level_; }
+    double getLagMs() const { return lagMs_; }
+    size_t getQueueDepth() const { return queueDepth_; }
+
+    static RequestPriority priorityOf(MessageType type);
+
+    // true when a request of this type should be refused at the current level
+    bool shouldShed(MessageType type) const;
+
+private:
+    LoadLevel levelFor(double lagMs, size_t queueDepth, double scale) const;
+
+    LoadThresholds thresholds_;
+    double lagMs_;        // exponentially weighted moving average
+    size_t queueDepth_;
+    LoadLevel level_;
+};
+
+#endif // LOAD_MONITOR_HPP
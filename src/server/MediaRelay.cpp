@@ -0,0 +1,323 @@
+#include "MediaRelay.hpp"
+#include "../protocol/Network.hpp"
+
+namespace {
+    inline uint32_t readU32(const uint8_t* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+
+    inline uint16_t readU16(const uint8_t* p) {
+        return static_cast<uint16_t>((p[0] << 8) | p[1]);
+    }
+
+    inline bool sameAddress(const struct sockaddr_in& a, const struct sockaddr_in& b) {
+        return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+    }
+}
+
+MediaRelay::MediaRelay()
+    : socket_(INVALID_SOCKET), port_(0), jitterDepth_(0), maxHold_(0), running_(false),
+      nextDeadline_(std::chrono::steady_clock::time_point::max()), outgoingCount_(0), forwardedFrames_(0), droppedFrames_(0) {
+}
+
+MediaRelay::~MediaRelay() {
+    stop();
+}
+
+bool MediaRelay::start(const std::string& address, int port, size_t jitterDepth) {
+    if (running_) return false;
+
+    socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (!Network::isValidSocket(socket_)) {
+        Logger::getInstance().error("Failed to create media relay socket: " + Network::getLastError());
+        return false;
+    }
+
+    if (!Network::bindSocket(socket_, address, port)) {
+        Network::closeSocket(socket_);
+        socket_ = INVALID_SOCKET;
+        return false;
+    }
+
+    port_ = port;
+    jitterDepth_ = std::min(jitterDepth, MAX_JITTER_DEPTH);
+    maxHold_ = FRAME_INTERVAL * static_cast<int>(jitterDepth_);
+
+    // Wake up periodically so stop() does not wait for traffic, and every frame interval
+    // when frames may be held for their deadline
+    long timeoutMs = jitterDepth_ > 0 ? static_cast<long>(FRAME_INTERVAL.count()) : 200;
+    #ifdef _WIN32
+        DWORD timeoutValue = static_cast<DWORD>(timeoutMs);
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeoutValue), sizeof(timeoutValue));
+    #else
+        struct timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = timeoutMs * 1000;
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    #endif
+    outgoing_.resize(BATCH_SIZE);
+    outgoingCount_ = 0;
+
+    running_ = true;
+    thread_ = std::thread(&MediaRelay::run, this);
+
+    Logger::getInstance().info("Media relay listening on UDP port " + std::to_string(port_) +
+                               (jitterDepth_ > 0 ? " (jitter buffer " + std::to_string(jitterDepth_) + " frames)" : ""));
+    return true;
+}
+
+void MediaRelay::stop() {
+    if (!running_) return;
+
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    Network::closeSocket(socket_);
+    socket_ = INVALID_SOCKET;
+    Logger::getInstance().info("Media relay stopped (" + std::to_string(forwardedFrames_.load()) + " frames forwarded)");
+}
+
+void MediaRelay::addCall(uint32_t callId, uint32_t callerToken, uint32_t calleeToken) {
+    std::lock_guard<std::mutex> lock(callsMutex_);
+
+    RelayCall& call = calls_[callId];
+    call.peers[0].token = callerToken;
+    call.peers[1].token = calleeToken;
+    if (jitterDepth_ > 0) {
+        call.buffers[0] = std::make_unique<JitterBuffer>();
+        call.buffers[1] = std::make_unique<JitterBuffer>();
+    }
+}
+
+void MediaRelay::removeCall(uint32_t callId) {
+    std::lock_guard<std::mutex> lock(callsMutex_);
+    calls_.erase(callId);
+}
+
+void MediaRelay::run() {
+    #ifdef __linux__
+    // One recvmmsg call drains up to BATCH_SIZE datagrams
+    std::vector<std::array<uint8_t, MAX_PACKET_SIZE>> buffers(BATCH_SIZE);
+    std::vector<struct mmsghdr> messages(BATCH_SIZE);
+    std::vector<struct iovec> iovecs(BATCH_SIZE);
+    std::vector<struct sockaddr_in> addresses(BATCH_SIZE);
+
+    while (running_) {
+        for (size_t i = 0; i < BATCH_SIZE; ++i) {
+            iovecs[i].iov_base = buffers[i].data();
+            iovecs[i].iov_len = MAX_PACKET_SIZE;
+            std::memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+        }
+
+        // On a timeout or EINTR nothing was received, but held frames may have come due
+        int received = recvmmsg(socket_, messages.data(), BATCH_SIZE, MSG_WAITFORONE, nullptr);
+        auto now = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(callsMutex_);
+            for (int i = 0; i < received; ++i) {
+                handleFrame(buffers[i].data(), messages[i].msg_len, addresses[i], now);
+            }
+            releaseExpired(now);
+        }
+        flushSends();
+    }
+    #else
+    std::array<uint8_t, MAX_PACKET_SIZE> buffer;
+    while (running_) {
+        struct sockaddr_in from;
+        socklen_t fromLen = sizeof(from);
+        int received = recvfrom(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                                reinterpret_cast<struct sockaddr*>(&from), &fromLen);
+        auto now = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(callsMutex_);
+            if (received > 0) {
+                handleFrame(buffer.data(), static_cast<size_t>(received), from, now);
+            }
+            releaseExpired(now);
+        }
+        flushSends();
+    }
+    #endif
+}
+
+void MediaRelay::handleFrame(const uint8_t* data, size_t length, const struct sockaddr_in& from,
+                             std::chrono::steady_clock::time_point now) {
+    if (length < HEADER_SIZE) {
+        droppedFrames_++;
+        return;
+    }
+
+    auto it = calls_.find(readU32(data));
+    if (it == calls_.end()) {
+        droppedFrames_++;
+        return;
+    }
+
+    RelayCall& call = it->second;
+    uint32_t token = readU32(data + 4);
+    int side = call.peers[0].token == token ? 0 : (call.peers[1].token == token ? 1 : -1);
+    if (side < 0) {
+        droppedFrames_++;
+        return;
+    }
+
+    // Learn (or follow a NAT rebinding of) the sender's address
+    Peer& sender = call.peers[side];
+    if (!sender.addressKnown || !sameAddress(sender.addr, from)) {
+        sender.addr = from;
+        sender.addressKnown = true;
+    }
+
+    const Peer& target = call.peers[1 - side];
+    if (!target.addressKnown) {
+        droppedFrames_++;   // the other side has not sent anything yet
+        return;
+    }
+
+    JitterBuffer* buffer = call.buffers[1 - side].get();
+    if (!buffer) {
+        queueSend(target.addr, data, length);
+        return;
+    }
+
+    uint16_t seq = readU16(data + 8);
+    if (!buffer->started) {
+        buffer->nextSeq = seq;
+        buffer->started = true;
+    }
+
+    int16_t ahead = static_cast<int16_t>(seq - buffer->nextSeq);
+    if (ahead < 0) {
+        droppedFrames_++;   // too late, already played past it
+        return;
+    }
+
+    // A frame beyond the window forces the buffer to give up on the missing ones
+    while (ahead >= static_cast<int16_t>(jitterDepth_)) {
+        size_t slot = buffer->nextSeq % jitterDepth_;
+        if (buffer->lengths[slot] > 0) {
+            queueSend(target.addr, buffer->frames[slot].data(), buffer->lengths[slot]);
+            buffer->lengths[slot] = 0;
+        }
+        buffer->nextSeq++;
+        ahead--;
+    }
+
+    size_t slot = seq % jitterDepth_;
+    std::memcpy(buffer->frames[slot].data(), data, length);
+    buffer->lengths[slot] = static_cast<uint16_t>(length);
+    buffer->arrived[slot] = now;
+
+    releaseInOrder(*buffer, target);
+    if (buffer->lengths[slot] > 0) {
+        nextDeadline_ = std::min(nextDeadline_, now + maxHold_);
+    }
+}
+
+void MediaRelay::releaseInOrder(JitterBuffer& buffer, const Peer& target) {
+    while (true) {
+        size_t slot = buffer.nextSeq % jitterDepth_;
+        if (buffer.lengths[slot] == 0) break;
+
+        queueSend(target.addr, buffer.frames[slot].data(), buffer.lengths[slot]);
+        buffer.lengths[slot] = 0;
+        buffer.nextSeq++;
+    }
+}
+
+void MediaRelay::releaseExpired(std::chrono::steady_clock::time_point now) {
+    if (now < nextDeadline_) return;
+
+    nextDeadline_ = std::chrono::steady_clock::time_point::max();
+    for (auto& entry : calls_) {
+        RelayCall& call = entry.second;
+        for (int side = 0; side < 2; ++side) {
+            JitterBuffer* buffer = call.buffers[side].get();
+            if (!buffer) continue;
+
+            while (true) {
+                // The frame held longest decides when this buffer is due
+                size_t oldest = jitterDepth_;
+                for (size_t slot = 0; slot < jitterDepth_; ++slot) {
+                    if (buffer->lengths[slot] > 0 &&
+                        (oldest == jitterDepth_ || buffer->arrived[slot] < buffer->arrived[oldest])) {
+                        oldest = slot;
+                    }
+                }
+                if (oldest == jitterDepth_) break;
+
+                auto deadline = buffer->arrived[oldest] + maxHold_;
+                if (deadline > now) {
+                    nextDeadline_ = std::min(nextDeadline_, deadline);
+                    break;
+                }
+
+                // Give up on the frames missing before the first one held
+                while (buffer->lengths[buffer->nextSeq % jitterDepth_] == 0) {
+                    buffer->nextSeq++;
+                }
+                releaseInOrder(*buffer, call.peers[side]);
+            }
+        }
+    }
+}
+
+void MediaRelay::queueSend(const struct sockaddr_in& addr, const uint8_t* data, size_t length) {
+    if (outgoingCount_ == outgoing_.size()) {
+        flushSends();
+    }
+
+    OutgoingFrame& frame = outgoing_[outgoingCount_++];
+    frame.addr = addr;
+    frame.length = length;
+    std::memcpy(frame.data.data(), data, length);
+}
+
+void MediaRelay::flushSends() {
+    if (outgoingCount_ == 0) return;
+
+    #ifdef __linux__
+    struct mmsghdr messages[BATCH_SIZE];
+    struct iovec iovecs[BATCH_SIZE];
+    for (size_t i = 0; i < outgoingCount_; ++i) {
+        iovecs[i].iov_base = outgoing_[i].data.data();
+        iovecs[i].iov_len = outgoing_[i].length;
+        std::memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &outgoing_[i].addr;
+        messages[i].msg_hdr.msg_namelen = sizeof(outgoing_[i].addr);
+    }
+
+    size_t sent = 0;
+    while (sent < outgoingCount_) {
+        int result = sendmmsg(socket_, messages + sent, static_cast<unsigned int>(outgoingCount_ - sent), 0);
+        if (result <= 0) {
+            droppedFrames_ += outgoingCount_ - sent;
+            break;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    forwardedFrames_ += sent;
+    #else
+    for (size_t i = 0; i < outgoingCount_; ++i) {
+        int result = sendto(socket_, reinterpret_cast<const char*>(outgoing_[i].data.data()),
+                            static_cast<int>(outgoing_[i].length), 0,
+                            reinterpret_cast<const struct sockaddr*>(&outgoing_[i].addr), sizeof(outgoing_[i].addr));
+        if (result < 0) droppedFrames_++;
+        else forwardedFrames_++;
+    }
+    #endif
+
+    outgoingCount_ = 0;
+}
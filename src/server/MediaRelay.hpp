@@ -0,0 +1,104 @@
+#ifndef MEDIA_RELAY_HPP
+#define MEDIA_RELAY_HPP
+
+#include "../../include/common.hpp"
+#include "../utils/Logger.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+// UDP relay forwarding voice frames between the two peers of a call.
+//
+// Datagram layout (big-endian): callId(4) | token(4) | sequence(2) | flags(2) | audio payload.
+// The token identifies which side of the call sent the frame; the relay learns each peer's
+// address from its first frame and forwards everything to the other side. Frames are read
+// and written in batches (recvmmsg/sendmmsg on Linux) on a dedicated thread.
+//
+// With a jitter buffer, a frame waits for the ones before it at most jitterDepth frame
+// intervals; then the missing ones are given up. The receive timeout is one frame interval,
+// so held frames go out on time even when no more traffic arrives.
+class MediaRelay {
+public:
+    static constexpr size_t HEADER_SIZE = 12;
+    static constexpr size_t MAX_PACKET_SIZE = 1500;
+    static constexpr size_t BATCH_SIZE = 64;
+    static constexpr size_t MAX_JITTER_DEPTH = 16;
+    static constexpr std::chrono::milliseconds FRAME_INTERVAL{20};
+
+    MediaRelay();
+    ~MediaRelay();
+
+    // Bind the UDP socket and start the relay thread.
+    // jitterDepth > 0 enables per-call reordering buffers of that many frames.
+    bool start(const std::string& address, int port, size_t jitterDepth);
+
+    // Stop the relay thread and close the socket
+    void stop();
+
+    bool isRunning() const { return running_; }
+    int getPort() const { return port_; }
+
+    // Register / unregister a call's tokens
+    void addCall(uint32_t callId, uint32_t callerToken, uint32_t calleeToken);
+    void removeCall(uint32_t callId);
+
+    uint64_t getForwardedFrames() const { return forwardedFrames_; }
+    uint64_t getDroppedFrames() const { return droppedFrames_; }
+
+private:
+    // Reorders frames of one direction by sequence number
+    struct JitterBuffer {
+        std::array<std::array<uint8_t, MAX_PACKET_SIZE>, MAX_JITTER_DEPTH> frames;
+        std::array<uint16_t, MAX_JITTER_DEPTH> lengths{};
+        std::array<std::chrono::steady_clock::time_point, MAX_JITTER_DEPTH> arrived{};
+        uint16_t nextSeq = 0;
+        bool started = false;
+    };
+
+    struct Peer {
+        uint32_t token = 0;
+        struct sockaddr_in addr{};
+        bool addressKnown = false;
+    };
+
+    struct RelayCall {
+        Peer peers[2];                                  // 0 = caller, 1 = callee
+        std::unique_ptr<JitterBuffer> buffers[2];       // frames heading to peers[i]
+    };
+
+    struct OutgoingFrame {
+        struct sockaddr_in addr;
+        size_t length;
+        std::array<uint8_t, MAX_PACKET_SIZE> data;
+    };
+
+    void run();
+    void handleFrame(const uint8_t* data, size_t length, const struct sockaddr_in& from,
+                     std::chrono::steady_clock::time_point now);
+    void releaseInOrder(JitterBuffer& buffer, const Peer& target);
+    // Release frames held past their deadline, skipping the missing ones before them
+    void releaseExpired(std::chrono::steady_clock::time_point now);
+    void queueSend(const struct sockaddr_in& addr, const uint8_t* data, size_t length);
+    void flushSends();
+
+    SOCKET socket_;
+    int port_;
+    size_t jitterDepth_;
+    std::chrono::steady_clock::duration maxHold_;   // jitterDepth_ frame intervals
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    std::unordered_map<uint32_t, RelayCall> calls_;
+    std::mutex callsMutex_;
+    std::chrono::steady_clock::time_point nextDeadline_;   // earliest a held frame may be due (under callsMutex_)
+
+    std::vector<OutgoingFrame> outgoing_;   // owned by the relay thread
+    size_t outgoingCount_;
+
+    std::atomic<uint64_t> forwardedFrames_;
+    std::atomic<uint64_t> droppedFrames_;
+};
+
+#endif // MEDIA_RELAY_HPP
@@ -0,0 +1,119 @@
+#include "OutputQueue.hpp"
+#include <charconv>
+
+namespace {
+    // Queued frames written per call once the socket drains
+    const size_t MAX_FRAMES_PER_WRITE = 8;
+
+    // Bytes written, 0 when the socket would block, -1 when the connection failed
+    int writeSlices(SOCKET sock, const std::string_view* slices, size_t count) {
+        int sent = Network::sendSlices(sock, slices, count);
+        if (sent < 0) {
+            return Network::wouldBlock() ? 0 : -1;
+        }
+        return sent;
+    }
+}
+
+size_t OutputQueue::Entry::length() const {
+    return shared ? shared->bytes.size() + sequenceLength : owned.size();
+}
+
+size_t OutputQueue::Entry::unsent(std::string_view* slices) const {
+    std::string_view parts[3];
+    size_t count = 0;
+    if (shared) {
+        std::string_view bytes(shared->bytes);
+        parts[count++] = bytes.substr(0, shared->sequenceAt);
+        parts[count++] = std::string_view(sequence.data(), sequenceLength);
+        parts[count++] = bytes.substr(shared->sequenceAt);
+    } else {
+        parts[count++] = owned;
+    }
+
+    size_t skip = sent;
+    size_t used = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (skip >= parts[i].size()) {
+            skip -= parts[i].size();
+            continue;
+        }
+        slices[used++] = parts[i].substr(skip);
+        skip = 0;
+    }
+    return used;
+}
+
+bool OutputQueue::send(SOCKET sock, std::string_view frame) {
+    if (entries_.empty()) {
+        int sent = writeSlices(sock, &frame, 1);
+        if (sent < 0) return false;
+        if (static_cast<size_t>(sent) == frame.size()) return true;
+        frame.remove_prefix(sent);
+    }
+
+    Entry entry;
+    entry.owned.assign(frame);
+    pendingBytes_ += frame.size();
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+bool OutputQueue::send(SOCKET sock, std::shared_ptr<const EncodedFrame> frame, uint32_t sequenceNumber) {
+    Entry entry;
+    entry.shared = std::move(frame);
+    char* end = std::to_chars(entry.sequence.data(), entry.sequence.data() + entry.sequence.size(), sequenceNumber).ptr;
+    entry.sequenceLength = static_cast<uint8_t>(end - entry.sequence.data());
+    return push(sock, std::move(entry));
+}
+
+bool OutputQueue::push(SOCKET sock, Entry&& entry) {
+    if (entries_.empty()) {
+        std::string_view slices[3];
+        size_t count = entry.unsent(slices);
+        int sent = writeSlices(sock, slices, count);
+        if (sent < 0) return false;
+        if (static_cast<size_t>(sent) == entry.length()) return true;
+        entry.sent = sent;
+    }
+
+    pendingBytes_ += entry.length() - entry.sent;
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+bool OutputQueue::flush(SOCKET sock) {
+    while (!entries_.empty()) {
+        // Several small frames go out in one call
+        std::string_view slices[MAX_FRAMES_PER_WRITE * 3];
+        size_t count = 0;
+        size_t wanted = 0;
+        for (size_t i = 0; i < entries_.size() && i < MAX_FRAMES_PER_WRITE; ++i) {
+            size_t added = entries_[i].unsent(slices + count);
+            for (size_t j = count; j < count + added; ++j) {
+                wanted += slices[j].size();
+            }
+            count += added;
+        }
+
+        int sent = writeSlices(sock, slices, count);
+        if (sent < 0) return false;
+        consume(sent);
+        if (static_cast<size_t>(sent) < wanted) break;   // the socket is full
+    }
+    return true;
+}
+
+void OutputQueue::consume(size_t count) {
+    pendingBytes_ -= count;
+    while (count > 0) {
+        Entry& front = entries_.front();
+        size_t left = front.length() - front.sent;
+        if (count < left) {
+            front.sent += count;
+            return;
+        }
+        count -= left;
+        entries_.pop_front();
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef OUTPUT_QUEUE_HPP
+#define OUTPUT_QUEUE_HPP
+
+#include "../../include/common.hpp"
+#include "../protocol/Network.hpp"
+#include "../protocol/Protocol.hpp"
+#include <array>
+#include <deque>
+
+// Frames waiting for a connection's socket to accept them. A send goes out at once when
+// nothing is queued ahead of it; whatever the socket does not take waits for POLLOUT, so a
+// partial send never loses or reorders bytes. Event loop thread only.
+class OutputQueue {
+public:
+    // Send an encoded frame (copied only if it has to wait); false when the connection failed
+    bool send(SOCKET sock, std::string_view frame);
+
+    // Send a shared frame with this sequence number; the frame itself is never copied
+    bool send(SOCKET sock, std::shared_ptr<const EncodedFrame> frame, uint32_t sequenceNumber);
+
+    // Write queued frames until the socket would block; false when the connection failed
+    bool flush(SOCKET sock);
+
+    bool empty() const { return entries_.empty(); }
+    size_t pendingBytes() const { return pendingBytes_; }
+
+private:
+    struct Entry {
+        std::string owned;                          // private frame
+        std::shared_ptr<const EncodedFrame> shared; // or a shared one plus its sequence number
+        std::array<char, 10> sequence;
+        uint8_t sequenceLength = 0;
+        size_t sent = 0;                            // bytes already written
+
+        size_t length() const;
+
+        // The unsent bytes as up to three slices; returns how many
+        size_t unsent(std::string_view* slices) const;
+    };
+
+    // Write entry now if the queue is empty, then queue what is left of it
+    bool push(SOCKET sock, Entry&& entry);
+
+    // Mark count bytes written from the front of the queue
+    void consume(size_t count);
+
+    std::deque<Entry> entries_;
+    size_t pendingBytes_ = 0;
+};
+
+#endif // OUTPUT_QUEUE_HPP
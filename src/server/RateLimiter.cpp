@@ -0,0 +1,82 @@
+#include "RateLimiter.hpp"
+
+double TokenBucket::refill(const RateLimit& limit, std::chrono::steady_clock::time_point now) {
+    if (tokens_ < 0) {
+        tokens_ = limit.burst;
+    } else {
+        double elapsed = std::chrono::duration<double>(now - last_).count();
+        tokens_ = std::min(limit.burst, tokens_ + elapsed * limit.perSecond);
+    }
+    last_ = now;
+    return tokens_;
+}
+
+RateLimiter::RateLimiter() : perUserFactor_(2.0) {
+    // Generous for people, tight enough that a looping client cannot monopolise the server
+    setLimit(MessageClass::AUTH, {1, 5});
+    setLimit(MessageClass::READ, {20, 40});
+    setLimit(MessageClass::WRITE, {5, 10});
+    setLimit(MessageClass::GAME, {10, 20});
+    setLimit(MessageClass::CHAT, {5, 20});
+    setLimit(MessageClass::STREAM, {200, 800});   // a 30 s recording is a few hundred chunks
+    setLimit(MessageClass::SYSTEM, {5, 10});
+}
+
+MessageClass RateLimiter::classify(MessageType type) {
+    const MessagePolicy* policy = MessagePolicies::find(type);
+    return policy ? policy->rateClass : MessageClass::SYSTEM;
+}
+
+const char* RateLimiter::className(MessageClass messageClass) {
+    switch (messageClass) {
+        case MessageClass::AUTH: return "auth";
+        case MessageClass::READ: return "read";
+        case MessageClass::WRITE: return "write";
+        case MessageClass::GAME: return "game";
+        case MessageClass::CHAT: return "chat";
+        case MessageClass::STREAM: return "stream";
+        case MessageClass::SYSTEM: return "system";
+        default: return "unknown";
+    }
+}
+
+void RateLimiter::setLimit(MessageClass messageClass, const RateLimit& limit) {
+    limits_[static_cast<size_t>(messageClass)] = limit;
+}
+
+const RateLimit& RateLimiter::getLimit(MessageClass messageClass) const {
+    return limits_[static_cast<size_t>(messageClass)];
+}
+
+bool RateLimiter::allow(Buckets& connection, const std::string& username, MessageType type) {
+    size_t index = static_cast<size_t>(classify(type));
+    const RateLimit& limit = limits_[index];
+    if (limit.perSecond <= 0) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    TokenBucket& connectionBucket = connection[index];
+    if (connectionBucket.refill(limit, now) < 1) return false;
+
+    if (!username.empty()) {
+        RateLimit userLimit{limit.perSecond * perUserFactor_, limit.burst * perUserFactor_};
+        TokenBucket& userBucket = users_[username][index];
+        if (userBucket.refill(userLimit, now) < 1) return false;
+        userBucket.consume();
+    }
+
+    connectionBucket.consume();
+    return true;
+}
+
+void RateLimiter::pruneIdleUsers() {
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto it = users_.begin(); it != users_.end(); ) {
+        bool idle = true;
+        for (size_t i = 0; i < it->second.size() && idle; ++i) {
+            RateLimit userLimit{limits_[i].perSecond * perUserFactor_, limits_[i].burst * perUserFactor_};
+            idle = it->second[i].refill(userLimit, now) >= userLimit.burst;
+        }
+        it = idle ? users_.erase(it) : std::next(it);
+    }
+}
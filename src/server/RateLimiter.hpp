@@ -0,0 +1,57 @@
+#ifndef RATE_LIMITER_HPP
+#define RATE_LIMITER_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "../protocol/MessagePolicy.hpp"
+#include <array>
+
+// Sustained rate and burst size of one bucket
+struct RateLimit {
+    double perSecond = 0;   // 0 = unlimited
+    double burst = 0;
+};
+
+// Token bucket refilled continuously at limit.perSecond up to limit.burst
+class TokenBucket {
+public:
+    // Add the tokens earned since the last refill; returns the tokens available
+    double refill(const RateLimit& limit, std::chrono::steady_clock::time_point now);
+    void consume() { tokens_ -= 1; }
+
+private:
+    double tokens_ = -1;   // < 0: untouched, starts full
+    std::chrono::steady_clock::time_point last_;
+};
+
+// Per-connection and per-user token buckets for each message class. A user's buckets are
+// shared by all their connections and allow perUserFactor times the per-connection rate,
+// so opening more connections does not buy more throughput. Event loop thread only.
+class RateLimiter {
+public:
+    using Buckets = std::array<TokenBucket, static_cast<size_t>(MessageClass::COUNT)>;
+
+    RateLimiter();
+
+    // The type's class from the message policy table (SYSTEM for unknown types)
+    static MessageClass classify(MessageType type);
+    static const char* className(MessageClass messageClass);
+
+    void setLimit(MessageClass messageClass, const RateLimit& limit);
+    const RateLimit& getLimit(MessageClass messageClass) const;
+    void setPerUserFactor(double factor) { perUserFactor_ = factor; }
+
+    // Charge one message; false when it is over the connection's or the user's limit
+    // (username empty: not logged in, connection limit only)
+    bool allow(Buckets& connection, const std::string& username, MessageType type);
+
+    // Forget users whose buckets have refilled completely
+    void pruneIdleUsers();
+
+private:
+    std::array<RateLimit, static_cast<size_t>(MessageClass::COUNT)> limits_;
+    double perUserFactor_;
+    std::map<std::string, Buckets> users_;
+};
+
+#endif // RATE_LIMITER_HPP
@@ -0,0 +1,41 @@
+#include "ResponseCache.hpp"
+
+ResponseCache& ResponseCache::getInstance() {
+    static ResponseCache instance;
+    return instance;
+}
+
+std::shared_ptr<const EncodedFrame> ResponseCache::find(MessageType type, std::string_view key,
+                                                        uint16_t protocolVersion, uint64_t contentVersion) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(KeyLess::View(type, protocolVersion, key));
+    if (it == entries_.end() || it->second.contentVersion != contentVersion) {
+        return nullptr;
+    }
+    return it->second.frame;
+}
+
+void ResponseCache::store(MessageType type, std::string_view key, uint16_t protocolVersion,
+                          uint64_t contentVersion, std::shared_ptr<const EncodedFrame> frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(KeyLess::View(type, protocolVersion, key));
+    if (it != entries_.end()) {
+        // An older build must not replace a newer one
+        if (it->second.contentVersion <= contentVersion) {
+            it->second = Entry{contentVersion, std::move(frame)};
+        }
+        return;
+    }
+
+    if (entries_.size() >= MAX_ENTRIES) {
+        // Make room by dropping what content writes have already invalidated
+        for (auto stale = entries_.begin(); stale != entries_.end(); ) {
+            stale = stale->second.contentVersion < contentVersion ? entries_.erase(stale) : std::next(stale);
+        }
+        if (entries_.size() >= MAX_ENTRIES) return;
+    }
+
+    entries_.emplace(Key{type, protocolVersion, std::string(key)}, Entry{contentVersion, std::move(frame)});
+}
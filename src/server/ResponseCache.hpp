@@ -0,0 +1,62 @@
+#ifndef RESPONSE_CACHE_HPP
+#define RESPONSE_CACHE_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "../protocol/Protocol.hpp"
+#include <tuple>
+
+// Encoded replies to read-only content requests, shared by every connection that asks.
+// An entry is keyed by (reply type, request key, protocol version) and remembers the
+// Database lesson version it was built from; any lesson write makes it stale. Only
+// replies for existing content are stored, so the keys are bounded by the catalog.
+class ResponseCache {
+public:
+    // Get singleton instance
+    static ResponseCache& getInstance();
+
+    // The cached frame if it was built from contentVersion, nullptr otherwise
+    std::shared_ptr<const EncodedFrame> find(MessageType type, std::string_view key,
+                                             uint16_t protocolVersion, uint64_t contentVersion);
+
+    // Remember frame, built from contentVersion; skipped while the cache is full of current entries
+    void store(MessageType type, std::string_view key, uint16_t protocolVersion,
+               uint64_t contentVersion, std::shared_ptr<const EncodedFrame> frame);
+
+    // Keys come from requests, so the number of entries is capped
+    static constexpr size_t MAX_ENTRIES = 1024;
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+private:
+    ResponseCache() = default;
+
+    struct Key {
+        MessageType type;
+        uint16_t protocolVersion;
+        std::string key;
+    };
+
+    struct Entry {
+        uint64_t contentVersion;
+        std::shared_ptr<const EncodedFrame> frame;
+    };
+
+    // Orders keys and allows lookups by string_view without building a Key
+    struct KeyLess {
+        using is_transparent = void;
+        using View = std::tuple<MessageType, uint16_t, std::string_view>;
+
+        static View view(const Key& key) { return View(key.type, key.protocolVersion, key.key); }
+        static const View& view(const View& key) { return key; }
+
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const { return view(a) < view(b); }
+    };
+
+    std::map<Key, Entry, KeyLess> entries_;
+    std::mutex mutex_;
+};
+
+#endif // RESPONSE_CACHE_HPP
@@ -1,14 +1,20 @@
 #include "Server.hpp"
 
 Server::Server() 
-    : listenSocket_(INVALID_SOCKET), serverPort_(0), running_(false) {
+    : listenSocket_(INVALID_SOCKET), serverPort_(0), running_(false),
+      maxClients_(0), maxClientsPerAddress_(0), messageBudget_(8),
+      lastPrune_(std::chrono::steady_clock::now()), hashingPool_("Hashing") {
+    #ifndef _WIN32
+    wakePipe_[0] = wakePipe_[1] = -1;
+    #endif
 }
 
 Server::~Server() {
     stop();
 }
 
-bool Server::initialize(const std::string& address, int port) {
+bool Server::initialize(const std::string& address, int port, size_t workerThreads,
+                        size_t hashThreads, size_t hashQueueDepth) {
     if (!Network::initialize()) {
         Logger::getInstance().error("Failed to initialize network subsystem");
         return false;
@@ -42,10 +48,36 @@ bool Server::initialize(const std::string& address, int port) {
         return false;
     }
     
+    #ifndef _WIN32
+    if (pipe(wakePipe_) != 0 || !Network::setNonBlocking(wakePipe_[0]) || !Network::setNonBlocking(wakePipe_[1])) {
+        Logger::getInstance().error("Failed to create wake-up pipe: " + Network::getLastError());
+        Network::closeSocket(listenSocket_);
+        return false;
+    }
+    #endif
+    
+    workerPool_.start(workerThreads);
+    hashingPool_.start(hashThreads, hashQueueDepth);
+    
     Logger::getInstance().info("Server initialized on " + serverAddress_ + ":" + std::to_string(serverPort_));
     return true;
 }
 
+bool Server::startMediaRelay(int port, size_t jitterDepth) {
+    if (!mediaRelay_.start(serverAddress_, port, jitterDepth)) {
+        Logger::getInstance().error("Failed to start media relay on UDP port " + std::to_string(port));
+        return false;
+    }
+    
+    CallManager::getInstance().attachRelay(&mediaRelay_);
+    return true;
+}
+
+void Server::setAdmissionLimits(size_t maxClients, size_t maxClientsPerAddress) {
+    maxClients_ = maxClients;
+    maxClientsPerAddress_ = maxClientsPerAddress;
+}
+
 void Server::run() {
     running_ = true;
     Logger::getInstance().info("Server started, entering main loop");
@@ -57,43 +89,71 @@ void Server::run() {
     
     while (running_) {
         fd_set readSet = masterSet_;
+        fd_set writeSet;
+        FD_ZERO(&writeSet);
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex_);
+            for (const auto& pair : clients_) {
+                if (!pair.second->getOutput().empty()) FD_SET(pair.first, &writeSet);
+            }
+        }
         struct timeval timeout;
-        timeout.tv_sec = 1;
+        timeout.tv_sec = queuedMessageCount() > 0 ? 0 : 1;
         timeout.tv_usec = 0;
         
-        int activity = select(0, &readSet, NULL, NULL, &timeout);
+        int activity = select(0, &readSet, &writeSet, NULL, &timeout);
         
         if (activity == SOCKET_ERROR) {
             Logger::getInstance().error("select() failed: " + Network::getLastError());
             break;
         }
+        auto iterationStart = std::chrono::steady_clock::now();
         
         // Check listen socket for new connections
         if (FD_ISSET(listenSocket_, &readSet)) {
             handleNewConnection();
         }
         
-        // Check client sockets for data
+        // Check client sockets for data (handleClientData takes the lock itself)
+        std::vector<SOCKET> readable, writable;
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex_);
+            for (const auto& pair : clients_) {
+                if (FD_ISSET(pair.first, &readSet)) readable.push_back(pair.first);
+                if (FD_ISSET(pair.first, &writeSet)) writable.push_back(pair.first);
+            }
+        }
+        for (SOCKET clientSock : writable) {
+            handleClientWritable(clientSock);
+        }
+        for (SOCKET clientSock : readable) {
+            handleClientData(clientSock);
+        }
+        auto longestWait = processInboxes();
+        
         std::lock_guard<std::mutex> lock(clientsMutex_);
         for (auto it = clients_.begin(); it != clients_.end(); ) {
             SOCKET clientSock = it->first;
             
-            if (FD_ISSET(clientSock, &readSet)) {
-                handleClientData(clientSock);
-            }
-            
-            // Check for timeout
-            if (it->second->isTimedOut(300)) {
-                Logger::getInstance().info("Client timed out: " + it->second->getClientInfo());
+            // Check for timeout, and for replies piling up faster than the client reads them
+            bool slow = it->second->getOutput().pendingBytes() > MAX_PENDING_OUTPUT;
+            if (slow || it->second->isTimedOut(300)) {
+                Logger::getInstance().info(std::string(slow ? "Client too slow to read replies: " : "Client timed out: ") +
+                                           it->second->getClientInfo());
+                closeClient(*it->second);
                 FD_CLR(clientSock, &masterSet_);
                 Network::closeSocket(clientSock);
-                it = clients_.erase(it);
+                it = eraseClient(it);
             } else {
                 ++it;
             }
         }
         
+        // No wake-up pipe with select(): worker replies go out within the 1 s timeout
+        drainCompletions();
+        recordLoad(iterationStart, longestWait);
         cleanupClients();
+        expireCalls();
     }
     
     #else
@@ -108,20 +168,33 @@ void Server::run() {
         listenPfd.revents = 0;
         pollFds_.push_back(listenPfd);
         
-        // Add client sockets
+        struct pollfd wakePfd;
+        wakePfd.fd = wakePipe_[0];
+        wakePfd.events = POLLIN;
+        wakePfd.revents = 0;
+        pollFds_.push_back(wakePfd);
+        
+        // Add client sockets; a connection with a full inbox or a reply backlog is not read
+        // until it drains, and one with queued replies waits for room to write them
+        bool queued = false;
         {
             std::lock_guard<std::mutex> lock(clientsMutex_);
             for (const auto& pair : clients_) {
+                size_t backlog = pair.second->getInbox().size();
+                const OutputQueue& output = pair.second->getOutput();
+                queued = queued || backlog > 0;
+                
                 struct pollfd pfd;
                 pfd.fd = pair.first;
-                pfd.events = POLLIN;
+                pfd.events = backlog < MAX_QUEUED_MESSAGES && output.pendingBytes() < OUTPUT_HIGH_WATER ? POLLIN : 0;
+                if (!output.empty()) pfd.events |= POLLOUT;
                 pfd.revents = 0;
                 pollFds_.push_back(pfd);
             }
         }
         
-        // Poll with 1 second timeout
-        int activity = poll(pollFds_.data(), pollFds_.size(), 1000);
+        // Poll with 1 second timeout (none while messages are waiting for their turn)
+        int activity = poll(pollFds_.data(), pollFds_.size(), queued ? 0 : 1000);
         
         if (activity < 0) {
             if (errno != EINTR) {
@@ -130,6 +203,7 @@ void Server::run() {
             }
             continue;
         }
+        auto iterationStart = std::chrono::steady_clock::now();
         
         // Check each socket
         for (size_t i = 0; i < pollFds_.size(); ++i) {
@@ -140,10 +214,17 @@ void Server::run() {
                 if (pollFds_[i].revents & POLLIN) {
                     handleNewConnection();
                 }
+            } else if (pollFds_[i].fd == wakePipe_[0]) {
+                char drain[64];
+                while (read(wakePipe_[0], drain, sizeof(drain)) > 0) {}
             } else {
                 // Client data or disconnect
                 SOCKET clientSock = pollFds_[i].fd;
                 
+                if (pollFds_[i].revents & POLLOUT) {
+                    handleClientWritable(clientSock);
+                }
+                
                 if (pollFds_[i].revents & POLLIN) {
                     handleClientData(clientSock);
                 }
@@ -154,21 +235,29 @@ void Server::run() {
             }
         }
         
+        auto longestWait = processInboxes();
+        
         // Check for timeouts
         {
             std::lock_guard<std::mutex> lock(clientsMutex_);
             for (auto it = clients_.begin(); it != clients_.end(); ) {
-                if (it->second->isTimedOut(300)) {
-                    Logger::getInstance().info("Client timed out: " + it->second->getClientInfo());
+                bool slow = it->second->getOutput().pendingBytes() > MAX_PENDING_OUTPUT;
+                if (slow || it->second->isTimedOut(300)) {
+                    Logger::getInstance().info(std::string(slow ? "Client too slow to read replies: " : "Client timed out: ") +
+                                               it->second->getClientInfo());
+                    closeClient(*it->second);
                     Network::closeSocket(it->first);
-                    it = clients_.erase(it);
+                    it = eraseClient(it);
                 } else {
                     ++it;
                 }
             }
         }
         
+        drainCompletions();
+        recordLoad(iterationStart, longestWait);
         cleanupClients();
+        expireCalls();
     }
     #endif
     
@@ -181,6 +270,11 @@ void Server::stop() {
     running_ = false;
     Logger::getInstance().info("Server stopping...");
     
+    CallManager::getInstance().attachRelay(nullptr);
+    mediaRelay_.stop();
+    workerPool_.stop();
+    hashingPool_.stop();
+    
     // Close all client connections
     {
         std::lock_guard<std::mutex> lock(clientsMutex_);
@@ -188,6 +282,8 @@ void Server::stop() {
             Network::closeSocket(pair.first);
         }
         clients_.clear();
+        connections_.clear();
+        connectionsPerAddress_.clear();
     }
     
     // Close listen socket
@@ -196,6 +292,15 @@ void Server::stop() {
         listenSocket_ = INVALID_SOCKET;
     }
     
+    #ifndef _WIN32
+    for (int& fd : wakePipe_) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    #endif
+    
     Network::cleanup();
     Logger::getInstance().info("Server stopped");
 }
@@ -217,9 +322,25 @@ void Server::handleNewConnection() {
         return;
     }
     
-    // Create client handler
     std::lock_guard<std::mutex> lock(clientsMutex_);
-    clients_[clientSocket] = std::make_unique<ClientHandler>(clientSocket, clientAddress, clientPort);
+    
+    // Refuse early, before any per-connection state exists
+    auto counted = connectionsPerAddress_.find(clientAddress);
+    size_t fromAddress = counted == connectionsPerAddress_.end() ? 0 : counted->second;
+    
+    bool full = maxClients_ > 0 && clients_.size() >= maxClients_;
+    bool addressFull = maxClientsPerAddress_ > 0 && fromAddress >= maxClientsPerAddress_;
+    if (full || addressFull) {
+        Logger::getInstance().warning("Refusing connection from " + clientAddress + ":" + std::to_string(clientPort) +
+                                      (full ? " (server full)" : " (too many connections from address)"));
+        sendMessage(clientSocket, Message(MessageType::ERROR_MESSAGE,
+                    Parser::createErrorMessage(ErrorCode::SERVER_BUSY, full ? "Server full" : "Too many connections")));
+        Network::closeSocket(clientSocket);
+        return;
+    }
+    
+    // Create client handler
+    addClient(clientSocket, std::make_unique<ClientHandler>(clientSocket, clientAddress, clientPort));
     
     #ifdef _WIN32
     FD_SET(clientSocket, &masterSet_);
@@ -237,22 +358,117 @@ void Server::handleClientData(SOCKET clientSocket) {
         return;
     }
     
-    buffer[bytesReceived] = '\0';
+    Logger::getInstance().debug("Received " + std::to_string(bytesReceived) + " bytes");
     
-    Logger::getInstance().debug("Received " + std::to_string(bytesReceived) + " bytes: " + std::string(buffer, bytesReceived));
+    // Frames may span reads (audio chunks often do), so bytes accumulate per connection
+    std::vector<Message> messages;
+    bool oversized = false;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        auto it = clients_.find(clientSocket);
+        if (it == clients_.end()) {
+            return;
+        }
+        
+        std::string& pending = it->second->getReceiveBuffer();
+        pending.append(buffer, bytesReceived);
+        messages = protocol_.extractMessages(pending);
+        
+        if (pending.size() > 2 * AppConstants::MAX_MESSAGE_SIZE) {
+            Logger::getInstance().warning("Oversized frame from " + it->second->getClientInfo() + ", disconnecting");
+            oversized = true;
+        }
+        
+        // Queued, not processed: processInboxes() gives every connection its turn.
+        // Heartbeats skip the queue so a busy server is not mistaken for a dead one.
+        ClientHandler& handler = *it->second;
+        auto received = std::chrono::steady_clock::now();
+        for (auto& message : messages) {
+            if (message.header.type != MessageType::HEARTBEAT_REQUEST) {
+                handler.getInbox().push_back({std::move(message), received});
+                continue;
+            }
+            if (!rateLimiter_.allow(handler.getRateBuckets(), handler.getUsername(), message.header.type)) {
+                continue;
+            }
+            Message pong = handler.processMessage(message);
+            pong.header.sequenceNumber = message.header.sequenceNumber;
+            sendMessage(clientSocket, pong);
+        }
+    }
     
-    // Extract messages (without holding the lock)
-    std::string tempBuffer(buffer, bytesReceived);
-    std::vector<Message> messages = protocol_.extractMessages(tempBuffer);
+    if (oversized) {
+        handleClientDisconnect(clientSocket);
+        return;
+    }
     
     Logger::getInstance().debug("Extracted " + std::to_string(messages.size()) + " messages");
+}
+
+void Server::handleClientWritable(SOCKET clientSocket) {
+    bool failed = false;
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        auto it = clients_.find(clientSocket);
+        if (it == clients_.end()) {
+            return;
+        }
+        failed = !it->second->getOutput().flush(clientSocket);
+    }
     
-    // Process each message (processMessage will acquire its own lock)
-    for (const auto& msg : messages) {
-        processMessage(clientSocket, msg);
+    if (failed) {
+        handleClientDisconnect(clientSocket);
     }
 }
 
+std::chrono::steady_clock::duration Server::processInboxes() {
+    // Take each connection's share first: processMessage() locks per message
+    std::vector<std::pair<SOCKET, std::vector<Message>>> turns;
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration longestWait{0};
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex_);
+        for (auto& pair : clients_) {
+            std::deque<InboundMessage>& inbox = pair.second->getInbox();
+            if (inbox.empty()) continue;
+            
+            longestWait = std::max(longestWait, now - inbox.front().received);
+            
+            size_t count = std::min(messageBudget_, inbox.size());
+            std::vector<Message> turn;
+            turn.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                turn.push_back(std::move(inbox[i].message));
+            }
+            inbox.erase(inbox.begin(), inbox.begin() + count);
+            turns.emplace_back(pair.first, std::move(turn));
+        }
+    }
+    
+    for (const auto& turn : turns) {
+        for (const auto& message : turn.second) {
+            processMessage(turn.first, message);
+        }
+    }
+    return longestWait;
+}
+
+size_t Server::queuedMessageCount() {
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    size_t count = 0;
+    for (const auto& pair : clients_) {
+        count += pair.second->getInbox().size();
+    }
+    return count;
+}
+
+void Server::recordLoad(std::chrono::steady_clock::time_point iterationStart,
+                        std::chrono::steady_clock::duration longestWait) {
+    // Lag: the longer of the oldest message's wait and the time this iteration spent working
+    auto busy = std::chrono::steady_clock::now() - iterationStart;
+    loadMonitor_.recordIteration(std::max(busy, longestWait), queuedMessageCount() + workerPool_.getQueueDepth());
+}
+
 void Server::handleClientDisconnect(SOCKET clientSocket) {
     Logger::getInstance().info("Client disconnected");
     
@@ -262,14 +478,31 @@ void Server::handleClientDisconnect(SOCKET clientSocket) {
     FD_CLR(clientSocket, &masterSet_);
     #endif
     
+    auto it = clients_.find(clientSocket);
+    if (it != clients_.end()) {
+        closeClient(*it->second);
+        eraseClient(it);
+    }
+    
     Network::closeSocket(clientSocket);
-    clients_.erase(clientSocket);
+}
+
+void Server::addClient(SOCKET clientSocket, std::unique_ptr<ClientHandler> handler) {
+    connections_[handler->getConnectionId()] = clientSocket;
+    ++connectionsPerAddress_[handler->getAddress()];
+    clients_[clientSocket] = std::move(handler);
+}
+
+Server::ClientMap::iterator Server::eraseClient(ClientMap::iterator it) {
+    connections_.erase(it->second->getConnectionId());
+    auto counted = connectionsPerAddress_.find(it->second->getAddress());
+    if (counted != connectionsPerAddress_.end() && --counted->second == 0) {
+        connectionsPerAddress_.erase(counted);
+    }
+    return clients_.erase(it);
 }
 
 void Server::processMessage(SOCKET clientSocket, const Message& message) {
-    Logger::getInstance().debug("processMessage called for message type " + 
-                               std::to_string(static_cast<int>(message.header.type)));
-    
     std::lock_guard<std::mutex> lock(clientsMutex_);
     
     auto it = clients_.find(clientSocket);
@@ -278,39 +511,167 @@ void Server::processMessage(SOCKET clientSocket, const Message& message) {
         return;
     }
     
-    Logger::getInstance().debug("Calling ClientHandler::processMessage");
+    ClientHandler& handler = *it->second;
+    if (!rateLimiter_.allow(handler.getRateBuckets(), handler.getUsername(), message.header.type)) {
+        Logger::getInstance().warning("Rate limited " + std::string(RateLimiter::className(RateLimiter::classify(message.header.type))) +
+                                      " request from " + handler.getClientInfo());
+        Message limited(MessageType::ERROR_MESSAGE,
+                        Parser::createErrorMessage(ErrorCode::RATE_LIMITED, "Too many requests, slow down"));
+        limited.header.sequenceNumber = message.header.sequenceNumber;
+        sendMessage(clientSocket, limited);
+        return;
+    }
+    
+    // Overloaded: refuse what can wait, cheaply, so the rest keeps flowing
+    if (loadMonitor_.shouldShed(message.header.type)) {
+        Message busy(MessageType::ERROR_MESSAGE,
+                     Parser::createErrorMessage(ErrorCode::SERVER_BUSY, "Server busy, try again"));
+        busy.header.sequenceNumber = message.header.sequenceNumber;
+        sendMessage(clientSocket, busy);
+        return;
+    }
     
     // Process message through client handler
     Message response = it->second->processMessage(message);
+    response.header.sequenceNumber = message.header.sequenceNumber;   // lets the client match replies
     
-    Logger::getInstance().debug("ClientHandler returned response type " + 
-                               std::to_string(static_cast<int>(response.header.type)));
-    
-    // Send response
-    sendMessage(clientSocket, response);
+    // Send response (UNKNOWN: the reply comes later from the worker pool)
+    if (response.header.type != MessageType::UNKNOWN) {
+        sendMessage(clientSocket, response);
+    }
+    deliverNotifications(*it->second);
+    submitJobs(*it->second, message.header.sequenceNumber);
 }
 
 bool Server::sendMessage(SOCKET clientSocket, const Message& message) {
-    std::string data = protocol_.encodeMessage(message);
+    // Event loop thread only: the buffer keeps its capacity between messages
+    sendBuffer_.clear();
+    protocol_.encodeMessage(message, sendBuffer_);
     
-    Logger::getInstance().debug("Sending message type " + 
-                               std::to_string(static_cast<int>(message.header.type)) +
-                               " payload: " + message.payload);
-    
-    int bytesSent = Network::sendData(clientSocket, data.c_str(), data.length());
+    // Replies queue behind earlier ones; a socket without a handler (refused connection)
+    // gets one best-effort write
+    auto it = clients_.find(clientSocket);
+    bool sent = it != clients_.end()
+        ? it->second->getOutput().send(clientSocket, sendBuffer_)
+        : Network::sendData(clientSocket, sendBuffer_.data(), sendBuffer_.length()) > 0;
     
-    if (bytesSent <= 0) {
+    if (!sent) {
         Logger::getInstance().error("Failed to send message to client");
         return false;
     }
     
-    Logger::getInstance().info("Sent message type " + 
-                              std::to_string(static_cast<int>(message.header.type)) +
-                              " (" + std::to_string(bytesSent) + " bytes)");
+    if (Logger::getInstance().isEnabled(LogLevel::DEBUG)) {
+        Logger::getInstance().debug("Sent message type " + 
+                                   std::string(Protocol::getMessageTypeName(message.header.type)) +
+                                   " (" + std::to_string(sendBuffer_.length()) + " bytes)");
+    }
     return true;
 }
 
+void Server::expireCalls() {
+    std::vector<CallInfo> expired = CallManager::getInstance().expireRinging(std::chrono::steady_clock::now());
+    if (expired.empty()) return;
+    
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    for (const CallInfo& call : expired) {
+        Message end(MessageType::VOICE_CALL_END, std::to_string(call.id));
+        for (const std::string* username : {&call.caller, &call.callee}) {
+            SessionData session;
+            if (Database::getInstance().getSessionByUsername(*username, session)) {
+                sendMessage(session.socket, end);
+            }
+        }
+    }
+}
+
+void Server::deliverNotifications(ClientHandler& handler) {
+    for (const auto& notification : handler.takeNotifications()) {
+        SessionData session;
+        if (!Database::getInstance().getSessionByUsername(notification.first, session)) {
+            Logger::getInstance().debug("Dropping notification for offline user " + notification.first);
+            continue;
+        }
+        sendMessage(session.socket, notification.second);
+    }
+}
+
+void Server::closeClient(ClientHandler& handler) {
+    handler.onDisconnect();
+    deliverNotifications(handler);
+}
+
+void Server::submitJobs(ClientHandler& handler, uint32_t sequenceNumber) {
+    uint64_t connectionId = handler.getConnectionId();
+    
+    for (auto& queued : handler.takeJobs()) {
+        bool hashing = queued.pool == ExecutionClass::HASHING;
+        WorkerPool& pool = hashing ? hashingPool_ : workerPool_;
+        
+        bool accepted = pool.submit([this, connectionId, sequenceNumber, job = std::move(queued.job)]() {
+            ClientHandler::Completion completion = job();
+            if (completion) {
+                postCompletion(connectionId, sequenceNumber, std::move(completion));
+            }
+        });
+        
+        if (accepted) continue;
+        
+        if (hashing) {
+            // Hashing jobs always owe the client a reply: shed the request instead of queueing without bound
+            Logger::getInstance().warning("Hashing pool full, rejecting request from " + handler.getClientInfo());
+            Message busy(MessageType::ERROR_MESSAGE, Parser::createErrorMessage(ErrorCode::SERVER_BUSY, "Server busy, try again"));
+            busy.header.sequenceNumber = sequenceNumber;
+            sendMessage(handler.getSocket(), busy);
+        } else {
+            Logger::getInstance().warning("Worker pool stopped, dropping job for " + handler.getClientInfo());
+        }
+    }
+}
+
+void Server::postCompletion(uint64_t connectionId, uint32_t sequenceNumber, ClientHandler::Completion completion) {
+    {
+        std::lock_guard<std::mutex> lock(completionsMutex_);
+        completions_.push_back({connectionId, sequenceNumber, std::move(completion)});
+    }
+    
+    #ifndef _WIN32
+    char byte = 1;
+    [[maybe_unused]] ssize_t written = write(wakePipe_[1], &byte, 1);   // a full pipe already means "wake up"
+    #endif
+}
+
+void Server::drainCompletions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionsMutex_);
+        ready.swap(completions_);
+    }
+    if (ready.empty()) return;
+    
+    std::lock_guard<std::mutex> lock(clientsMutex_);
+    for (auto& completion : ready) {
+        // The connection may have closed while the job ran
+        auto connection = connections_.find(completion.connectionId);
+        if (connection == connections_.end()) continue;
+        auto it = clients_.find(connection->second);
+        if (it == clients_.end()) continue;
+        
+        ClientHandler& handler = *it->second;
+        Message reply = completion.completion(handler);
+        if (reply.header.type != MessageType::UNKNOWN) {
+            reply.header.sequenceNumber = completion.sequenceNumber;
+            sendMessage(it->first, reply);
+        }
+        deliverNotifications(handler);
+        submitJobs(handler, completion.sequenceNumber);
+    }
+}
+
 void Server::cleanupClients() {
-    // Placeholder for additional cleanup tasks if needed
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPrune_ < std::chrono::seconds(60)) return;
+    
+    lastPrune_ = now;
+    rateLimiter_.pruneIdleUsers();
 }
 
@@ -8,6 +8,12 @@
 #include "../utils/Logger.hpp"
 #include "../db/Database.hpp"
 #include "ClientHandler.hpp"
+#include "MediaRelay.hpp"
+#include "CallManager.hpp"
+#include "WorkerPool.hpp"
+#include "RateLimiter.hpp"
+#include "LoadMonitor.hpp"
+#include <unordered_map>
 
 // Server class using I/O multiplexing for handling multiple clients
 class Server {
@@ -15,8 +21,23 @@ public:
     Server();
     ~Server();
     
-    // Initialize server with configuration
-    bool initialize(const std::string& address, int port);
+    // Initialize server with configuration (workerThreads 0 = one per hardware thread)
+    bool initialize(const std::string& address, int port, size_t workerThreads = 0,
+                    size_t hashThreads = 2, size_t hashQueueDepth = 64);
+    
+    // Start the UDP voice relay next to the TCP listener (jitterDepth 0 = plain forwarding)
+    bool startMediaRelay(int port, size_t jitterDepth);
+    
+    // Connection caps (0 = unlimited); connections over a cap are refused right after accept
+    void setAdmissionLimits(size_t maxClients, size_t maxClientsPerAddress);
+    
+    // Messages one connection may have processed per loop iteration before the others get a turn
+    void setMessageBudget(size_t budget) { messageBudget_ = std::max<size_t>(1, budget); }
+    
+    RateLimiter& getRateLimiter() { return rateLimiter_; }
+    
+    // Lag and queue depth beyond which low-priority requests are refused with SERVER_BUSY
+    void setLoadThresholds(const LoadThresholds& thresholds) { loadMonitor_.setThresholds(thresholds); }
     
     // Start server main loop
     void run();
@@ -34,32 +55,102 @@ private:
     // Handle client data reception
     void handleClientData(SOCKET clientSocket);
     
+    // Write a connection's queued replies now that its socket has room
+    void handleClientWritable(SOCKET clientSocket);
+    
     // Handle client disconnection
     void handleClientDisconnect(SOCKET clientSocket);
     
+    // Process up to messageBudget_ queued messages of each connection, round robin;
+    // returns the longest time one of them waited in its inbox
+    std::chrono::steady_clock::duration processInboxes();
+    
+    // Messages waiting in inboxes (non-zero: the loop must not block)
+    size_t queuedMessageCount();
+    
+    // Feed the load monitor at the end of a loop iteration
+    void recordLoad(std::chrono::steady_clock::time_point iterationStart, std::chrono::steady_clock::duration longestWait);
+    
     // Process received message
     void processMessage(SOCKET clientSocket, const Message& message);
     
-    // Send message to client
+    // Send message to client through its output queue (caller holds clientsMutex_)
     bool sendMessage(SOCKET clientSocket, const Message& message);
     
+    // Push a handler's queued notifications to the target users' connections
+    void deliverNotifications(ClientHandler& handler);
+    
+    // Let the handler wind down (hang up calls) before its connection goes away
+    void closeClient(ClientHandler& handler);
+    
+    using ClientMap = std::map<SOCKET, std::unique_ptr<ClientHandler>>;
+    
+    // Register a connection in clients_ and the indexes over it (caller holds clientsMutex_)
+    void addClient(SOCKET clientSocket, std::unique_ptr<ClientHandler> handler);
+    
+    // Drop a connection from clients_ and the indexes; returns the next entry (caller holds clientsMutex_)
+    ClientMap::iterator eraseClient(ClientMap::iterator it);
+    
+    // Hand a handler's queued jobs to their pools; results come back as completions
+    void submitJobs(ClientHandler& handler, uint32_t sequenceNumber);
+    
+    // Called from worker threads: queue a reply and wake the event loop
+    void postCompletion(uint64_t connectionId, uint32_t sequenceNumber, ClientHandler::Completion completion);
+    
+    // Run finished jobs' completions and send their replies (event loop thread)
+    void drainCompletions();
+    
+    // Finished job waiting for the event loop
+    struct Completion {
+        uint64_t connectionId;
+        uint32_t sequenceNumber;
+        ClientHandler::Completion completion;
+    };
+    
     // Clean up disconnected clients
     void cleanupClients();
     
+    // Hang up calls nobody answered and tell both sides (event loop thread)
+    void expireCalls();
+    
+    // A connection stops being read once this many messages are queued for it (TCP backpressure)
+    static constexpr size_t MAX_QUEUED_MESSAGES = 64;
+    
+    // A connection is not read while more reply bytes than this wait for it, and is dropped
+    // as a slow consumer past MAX_PENDING_OUTPUT
+    static constexpr size_t OUTPUT_HIGH_WATER = 256 * 1024;
+    static constexpr size_t MAX_PENDING_OUTPUT = 4 * 1024 * 1024;
+    
     SOCKET listenSocket_;
     std::string serverAddress_;
     int serverPort_;
     bool running_;
     
-    std::map<SOCKET, std::unique_ptr<ClientHandler>> clients_;
+    ClientMap clients_;
+    std::unordered_map<uint64_t, SOCKET> connections_;               // connection id -> socket
+    std::unordered_map<std::string, size_t> connectionsPerAddress_;  // open connections per client address
     std::mutex clientsMutex_;
     
     Protocol protocol_;
+    std::string sendBuffer_;    // reused encode buffer for sendMessage (copied only when the socket is full)
+    RateLimiter rateLimiter_;
+    LoadMonitor loadMonitor_;
+    size_t maxClients_;
+    size_t maxClientsPerAddress_;
+    size_t messageBudget_;
+    std::chrono::steady_clock::time_point lastPrune_;
+    MediaRelay mediaRelay_;
+    WorkerPool workerPool_;
+    WorkerPool hashingPool_;   // password hashing, bounded so a login storm cannot starve other work
+    
+    std::vector<Completion> completions_;
+    std::mutex completionsMutex_;
     
     #ifdef _WIN32
         fd_set masterSet_;
     #else
         std::vector<struct pollfd> pollFds_;
+        int wakePipe_[2];   // workers write a byte to interrupt poll()
     #endif
 };
 
@@ -0,0 +1,97 @@
+#include "SessionTokens.hpp"
+#include "../utils/Crypto.hpp"
+
+SessionTokens& SessionTokens::getInstance() {
+    static SessionTokens instance;
+    return instance;
+}
+
+SessionTokens::SessionTokens()
+    : key_(Crypto::randomBytes(32)), ttlSeconds_(DEFAULT_TTL_SECONDS) {
+}
+
+void SessionTokens::configure(const std::string& secret, uint32_t ttlSeconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!secret.empty()) key_ = secret;
+    ttlSeconds_ = ttlSeconds > 0 ? ttlSeconds : DEFAULT_TTL_SECONDS;
+}
+
+int64_t SessionTokens::now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string SessionTokens::sign(const std::string& signedPart) const {
+    Crypto::Digest mac = Crypto::hmacSha256(key_, signedPart);
+    return Crypto::toHex(std::string(reinterpret_cast<const char*>(mac.data()), mac.size()));
+}
+
+std::string SessionTokens::issue(const std::string& username, UserRole role, ProficiencyLevel level) {
+    std::string nonceBytes = Crypto::randomBytes(8);
+    uint64_t nonce = 0;
+    std::memcpy(&nonce, nonceBytes.data(), sizeof(nonce));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string signedPart = username + "." +
+                             std::to_string(static_cast<int>(role)) + "." +
+                             std::to_string(static_cast<int>(level)) + "." +
+                             std::to_string(now() + ttlSeconds_) + "." +
+                             std::to_string(nonce);
+    return signedPart + "." + sign(signedPart);
+}
+
+bool SessionTokens::parse(const std::string& token, ResumeClaims& claims, std::string& signedPart,
+                          std::string& mac) const {
+    size_t macStart = token.rfind('.');
+    if (macStart == std::string::npos) return false;
+
+    signedPart = token.substr(0, macStart);
+    mac = token.substr(macStart + 1);
+
+    std::vector<std::string> fields = Utils::split(signedPart, '.');
+    if (fields.size() != 5 || fields[0].empty()) return false;
+
+    try {
+        int role = std::stoi(fields[1]);
+        int level = std::stoi(fields[2]);
+        if (role < 1 || role > 3 || level < 1 || level > 3) return false;
+
+        claims.username = fields[0];
+        claims.role = static_cast<UserRole>(role);
+        claims.level = static_cast<ProficiencyLevel>(level);
+        claims.expiresAt = std::stoll(fields[3]);
+        claims.nonce = std::stoull(fields[4]);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool SessionTokens::validate(const std::string& token, ResumeClaims& claims) {
+    std::string signedPart, mac;
+    if (!parse(token, claims, signedPart, mac)) return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Crypto::constantTimeEquals(mac, sign(signedPart))) return false;
+    if (claims.expiresAt <= now()) return false;
+    return revoked_.count(claims.nonce) == 0;
+}
+
+void SessionTokens::revoke(const std::string& token) {
+    ResumeClaims claims;
+    std::string signedPart, mac;
+    if (!parse(token, claims, signedPart, mac)) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Crypto::constantTimeEquals(mac, sign(signedPart))) return;
+
+    // Expired entries are useless: the expiry check already rejects those tokens
+    int64_t current = now();
+    while (!revokedByExpiry_.empty() && revokedByExpiry_.begin()->first <= current) {
+        revoked_.erase(revokedByExpiry_.begin()->second);
+        revokedByExpiry_.erase(revokedByExpiry_.begin());
+    }
+    if (claims.expiresAt > current && revoked_.insert(claims.nonce).second) {
+        revokedByExpiry_.emplace(claims.expiresAt, claims.nonce);
+    }
+}
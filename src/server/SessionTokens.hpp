@@ -0,0 +1,57 @@
+#ifndef SESSION_TOKENS_HPP
+#define SESSION_TOKENS_HPP
+
+#include "../../include/common.hpp"
+#include "../../include/message_structs.hpp"
+#include "../utils/Logger.hpp"
+#include <set>
+
+// What a resume token vouches for
+struct ResumeClaims {
+    std::string username;
+    UserRole role = UserRole::STUDENT;
+    ProficiencyLevel level = ProficiencyLevel::BEGINNER;
+    int64_t expiresAt = 0;   // unix seconds
+    uint64_t nonce = 0;
+};
+
+// Issues and checks signed session resume tokens, so a reconnecting client can skip the
+// password check. A token is "username.role.level.expiry.nonce.mac" with an HMAC-SHA256
+// mac over the other fields; checking one needs no user table access.
+class SessionTokens {
+public:
+    static constexpr uint32_t DEFAULT_TTL_SECONDS = 3600;
+
+    static SessionTokens& getInstance();
+
+    // secret empty: a random key, so tokens die with the process
+    void configure(const std::string& secret, uint32_t ttlSeconds);
+
+    std::string issue(const std::string& username, UserRole role, ProficiencyLevel level);
+
+    // true when token is well formed, correctly signed, unexpired and not revoked
+    bool validate(const std::string& token, ResumeClaims& claims);
+
+    // Invalidate a token before it expires (logout)
+    void revoke(const std::string& token);
+
+private:
+    SessionTokens();
+    SessionTokens(const SessionTokens&) = delete;
+    SessionTokens& operator=(const SessionTokens&) = delete;
+
+    static int64_t now();
+    bool parse(const std::string& token, ResumeClaims& claims, std::string& signedPart,
+               std::string& mac) const;
+    std::string sign(const std::string& signedPart) const;
+
+    std::string key_;
+    uint32_t ttlSeconds_;
+    // Revoked nonces, kept until the token would expire anyway; expiries in order, so
+    // dropping the expired ones only touches those
+    std::set<uint64_t> revoked_;
+    std::multimap<int64_t, uint64_t> revokedByExpiry_;   // expiry -> nonce
+    mutable std::mutex mutex_;
+};
+
+#endif // SESSION_TOKENS_HPP
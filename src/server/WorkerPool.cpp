@@ -0,0 +1,73 @@
+#include "WorkerPool.hpp"
+
+WorkerPool::WorkerPool(const std::string& name) : name_(name), maxQueueDepth_(0), running_(false) {
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::start(size_t threadCount, size_t maxQueueDepth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    maxQueueDepth_ = maxQueueDepth;
+    running_ = true;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+    Logger::getInstance().info(name_ + " pool started with " + std::to_string(threadCount) + " threads");
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    available_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    threads_.clear();
+}
+
+bool WorkerPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return false;
+        if (maxQueueDepth_ > 0 && tasks_.size() >= maxQueueDepth_) return false;
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+    return true;
+}
+
+size_t WorkerPool::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return !running_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;   // stopped and drained
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            Logger::getInstance().error(name_ + " task failed: " + e.what());
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include "../../include/common.hpp"
+#include "../utils/Logger.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+// Fixed set of threads running CPU-heavy request work off the event loop
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkerPool(const std::string& name = "Worker");
+    ~WorkerPool();
+
+    // Start threadCount workers (0 = one per hardware thread); maxQueueDepth 0 = unbounded
+    void start(size_t threadCount, size_t maxQueueDepth = 0);
+
+    // Finish queued tasks and join the workers
+    void stop();
+
+    // Queue a task; returns false when the queue is full or the pool is stopped
+    bool submit(Task task);
+
+    size_t getThreadCount() const { return threads_.size(); }
+    size_t getQueueDepth() const;
+
+private:
+    void workerLoop();
+
+    std::string name_;
+    std::vector<std::thread> threads_;
+    std::deque<Task> tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    size_t maxQueueDepth_;
+    bool running_;
+};
+
+#endif // WORKER_POOL_HPP
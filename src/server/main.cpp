@@ -3,6 +3,7 @@
 #include <csignal>
 #include <iostream>
 #include <cstdlib>
+#include <charconv>
 
 // Global server pointer for signal handling
 Server* g_server = nullptr;
@@ -41,6 +42,11 @@ int main(int argc, char* argv[]) {
         std::cout << "Using default configuration" << std::endl;
     }
     
+    LogLevel logLevel;
+    if (config.count("log_level") && Logger::parseLevel(config["log_level"], logLevel)) {
+        Logger::getInstance().setLogLevel(logLevel);
+    }
+    
     std::string host = config.count("host") ? config["host"] : "0.0.0.0";
     int port = config.count("port") ? std::stoi(config["port"]) : AppConstants::DEFAULT_PORT;
     
@@ -52,11 +58,83 @@ int main(int argc, char* argv[]) {
         port = std::stoi(argv[2]);
     }
     
+    // Voice relay defaults to the next port up; jitter_depth 0 forwards frames as they arrive
+    int mediaPort = config.count("media_port") ? std::stoi(config["media_port"]) : port + 1;
+    size_t jitterDepth = config.count("jitter_depth") ? std::stoul(config["jitter_depth"]) : 0;
+    
+    // Threads for pronunciation scoring and other CPU-heavy requests (0 = one per core)
+    size_t workerThreads = config.count("worker_threads") ? std::stoul(config["worker_threads"]) : 0;
+    
+    // Password hashing runs on its own bounded pool; logins beyond the queue depth get SERVER_BUSY
+    size_t hashThreads = config.count("hash_threads") ? std::stoul(config["hash_threads"]) : 2;
+    size_t hashQueueDepth = config.count("hash_queue_depth") ? std::stoul(config["hash_queue_depth"]) : 64;
+    
+    // scrypt cost; existing hashes are upgraded on the next successful login. Hashes made
+    // with parameters verifyPassword refuses would lock users out, so those fall back
+    PasswordHashParams hashParams;
+    bool hashParamsRead = true;
+    for (auto [key, value] : {std::make_pair("scrypt_n", &hashParams.n), std::make_pair("scrypt_r", &hashParams.r),
+                              std::make_pair("scrypt_p", &hashParams.p)}) {
+        if (!config.count(key)) continue;
+        const std::string& text = config[key];
+        auto parsed = std::from_chars(text.data(), text.data() + text.size(), *value);
+        hashParamsRead = hashParamsRead && parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+    }
+    if (!hashParamsRead || !Crypto::validParams(hashParams)) {
+        std::cerr << "WARNING: Invalid scrypt_n/scrypt_r/scrypt_p (n must be a power of two >= 2), using defaults"
+                  << std::endl;
+        Logger::getInstance().warning("Invalid scrypt parameters in config, using defaults");
+        hashParams = PasswordHashParams();
+    }
+    Database::getInstance().setPasswordHashParams(hashParams);
+    
+    // Resume tokens; without a configured secret they stop working when the server restarts
+    uint32_t resumeTtl = config.count("resume_ttl_seconds") ? std::stoul(config["resume_ttl_seconds"])
+                                                            : SessionTokens::DEFAULT_TTL_SECONDS;
+    SessionTokens::getInstance().configure(config.count("resume_secret") ? config["resume_secret"] : "", resumeTtl);
+    
     // Initialize database
     std::cout << "Initializing database..." << std::endl;
     std::cout.flush();
     Database::getInstance().initialize("data/users.db");
     
+    // Curriculum files loaded before clients connect ("content_import", comma separated);
+    // admins can import more from import_dir while the server runs
+    Database::getInstance().setImportOptions(config.count("import_dir") ? config["import_dir"] : "content",
+                                             config.count("import_threads") ? std::stoul(config["import_threads"]) : 0);
+    if (config.count("content_import")) {
+        std::stringstream files(config["content_import"]);
+        std::string file;
+        while (std::getline(files, file, ',')) {
+            file = Utils::trim(file);
+            if (file.empty()) continue;
+            
+            ImportReport report;
+            if (Database::getInstance().importContent(file, report)) {
+                std::cout << "Imported " << file << ": " << report.summary() << std::endl;
+            } else {
+                std::cerr << "WARNING: Could not import " << file << std::endl;
+            }
+            for (const std::string& error : report.errors) {
+                std::cerr << "  " << error << std::endl;
+            }
+        }
+    }
+    
+    // Vocabulary for autocomplete and word lookups: a word list (compiled next to it on
+    // first use) or a compiled .dict image
+    std::string dictionaryPath = config.count("dictionary") ? Utils::trim(config["dictionary"]) : "";
+    if (!dictionaryPath.empty()) {
+        std::string error;
+        if (Database::getInstance().loadDictionary(dictionaryPath, error)) {
+            auto dictionary = Database::getInstance().getDictionary();
+            std::cout << "Dictionary " << dictionaryPath << ": " << dictionary->size() << " words, "
+                      << dictionary->bytes() / 1024 << " KB" << std::endl;
+        } else {
+            std::cerr << "WARNING: Could not load dictionary " << dictionaryPath << ": " << error << std::endl;
+        }
+    }
+    
     // Create and initialize server
     std::cout << "Creating server instance..." << std::endl;
     std::cout.flush();
@@ -70,13 +148,42 @@ int main(int argc, char* argv[]) {
     std::cout << "Initializing server on " << host << ":" << port << "..." << std::endl;
     std::cout.flush();
     
-    if (!server.initialize(host, port)) {
+    if (!server.initialize(host, port, workerThreads, hashThreads, hashQueueDepth)) {
         Logger::getInstance().error("Failed to initialize server");
         std::cerr << "ERROR: Failed to initialize server!" << std::endl;
         std::cerr << "Check logs/server.log for details" << std::endl;
         return 1;
     }
     
+    // Admission control and fairness
+    server.setAdmissionLimits(config.count("max_clients") ? std::stoul(config["max_clients"]) : 100,
+                              config.count("max_clients_per_address") ? std::stoul(config["max_clients_per_address"]) : 0);
+    if (config.count("message_budget")) server.setMessageBudget(std::stoul(config["message_budget"]));
+    
+    // Per-class limits: "<class>_rate" messages per second, "<class>_burst" bucket size
+    RateLimiter& rateLimiter = server.getRateLimiter();
+    for (size_t i = 0; i < static_cast<size_t>(MessageClass::COUNT); ++i) {
+        MessageClass messageClass = static_cast<MessageClass>(i);
+        std::string name = RateLimiter::className(messageClass);
+        RateLimit limit = rateLimiter.getLimit(messageClass);
+        if (config.count(name + "_rate")) limit.perSecond = std::stod(config[name + "_rate"]);
+        if (config.count(name + "_burst")) limit.burst = std::stod(config[name + "_burst"]);
+        rateLimiter.setLimit(messageClass, limit);
+    }
+    if (config.count("per_user_factor")) rateLimiter.setPerUserFactor(std::stod(config["per_user_factor"]));
+    
+    // Overload shedding
+    LoadThresholds loadThresholds;
+    if (config.count("lag_elevated_ms")) loadThresholds.elevatedLagMs = std::stod(config["lag_elevated_ms"]);
+    if (config.count("lag_critical_ms")) loadThresholds.criticalLagMs = std::stod(config["lag_critical_ms"]);
+    if (config.count("queue_elevated")) loadThresholds.elevatedQueueDepth = std::stoul(config["queue_elevated"]);
+    if (config.count("queue_critical")) loadThresholds.criticalQueueDepth = std::stoul(config["queue_critical"]);
+    server.setLoadThresholds(loadThresholds);
+    
+    if (!server.startMediaRelay(mediaPort, jitterDepth)) {
+        std::cerr << "WARNING: Voice relay unavailable, calls will be signaling only" << std::endl;
+    }
+    
     std::cout << "\n✓ Server listening on " << host << ":" << port << std::endl;
     std::cout << "✓ Database initialized with default accounts:" << std::endl;
     std::cout << "  - admin / admin123 (Admin)" << std::endl;
@@ -0,0 +1,367 @@
+#include "Crypto.hpp"
+#include <random>
+
+namespace {
+    constexpr size_t SALT_BYTES = 16;
+    constexpr size_t HASH_BYTES = 32;
+
+    // Upper bounds accepted from stored hashes (and configuration)
+    constexpr uint32_t MAX_N = 1u << 20;
+    constexpr uint32_t MAX_R = 32;
+    constexpr uint32_t MAX_P = 16;
+
+    constexpr uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+    inline uint32_t rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+    class Sha256 {
+    public:
+        Sha256() {
+            state_ = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        }
+
+        void update(const uint8_t* data, size_t length) {
+            totalBytes_ += length;
+            while (length > 0) {
+                size_t take = std::min(length, 64 - used_);
+                std::memcpy(block_ + used_, data, take);
+                used_ += take;
+                data += take;
+                length -= take;
+                if (used_ == 64) {
+                    compress(block_);
+                    used_ = 0;
+                }
+            }
+        }
+
+        Crypto::Digest finish() {
+            uint64_t bits = totalBytes_ * 8;
+            uint8_t pad = 0x80;
+            update(&pad, 1);
+            uint8_t zero = 0;
+            while (used_ != 56) update(&zero, 1);
+
+            uint8_t length[8];
+            for (int i = 0; i < 8; ++i) length[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+            update(length, 8);
+
+            Crypto::Digest digest;
+            for (int i = 0; i < 8; ++i) {
+                for (int b = 0; b < 4; ++b) digest[4 * i + b] = static_cast<uint8_t>(state_[i] >> (24 - 8 * b));
+            }
+            return digest;
+        }
+
+    private:
+        void compress(const uint8_t* block) {
+            uint32_t w[64];
+            for (int i = 0; i < 16; ++i) {
+                w[i] = (static_cast<uint32_t>(block[4 * i]) << 24) | (block[4 * i + 1] << 16) |
+                       (block[4 * i + 2] << 8) | block[4 * i + 3];
+            }
+            for (int i = 16; i < 64; ++i) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+            uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+            for (int i = 0; i < 64; ++i) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+
+            state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+            state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+        }
+
+        std::array<uint32_t, 8> state_;
+        uint8_t block_[64];
+        size_t used_ = 0;
+        uint64_t totalBytes_ = 0;
+    };
+
+    // HMAC with the key pads absorbed once, reused for every PBKDF2 block
+    class HmacSha256 {
+    public:
+        explicit HmacSha256(const std::string& key) {
+            uint8_t padded[64] = {};
+            if (key.size() > 64) {
+                Crypto::Digest hashed = Crypto::sha256(key);
+                std::memcpy(padded, hashed.data(), hashed.size());
+            } else {
+                std::memcpy(padded, key.data(), key.size());
+            }
+
+            uint8_t ipad[64], opad[64];
+            for (int i = 0; i < 64; ++i) {
+                ipad[i] = padded[i] ^ 0x36;
+                opad[i] = padded[i] ^ 0x5c;
+            }
+            inner_.update(ipad, 64);
+            outer_.update(opad, 64);
+        }
+
+        Crypto::Digest mac(const uint8_t* data, size_t length) const {
+            Sha256 inner = inner_;
+            inner.update(data, length);
+            Crypto::Digest innerDigest = inner.finish();
+
+            Sha256 outer = outer_;
+            outer.update(innerDigest.data(), innerDigest.size());
+            return outer.finish();
+        }
+
+    private:
+        Sha256 inner_;
+        Sha256 outer_;
+    };
+
+    // Salsa20/8 core on a 64-byte block, in place
+    void salsa208(uint32_t b[16]) {
+        uint32_t x[16];
+        std::memcpy(x, b, sizeof(x));
+        for (int i = 0; i < 8; i += 2) {
+            x[4] ^= rotl(x[0] + x[12], 7);   x[8] ^= rotl(x[4] + x[0], 9);
+            x[12] ^= rotl(x[8] + x[4], 13);  x[0] ^= rotl(x[12] + x[8], 18);
+            x[9] ^= rotl(x[5] + x[1], 7);    x[13] ^= rotl(x[9] + x[5], 9);
+            x[1] ^= rotl(x[13] + x[9], 13);  x[5] ^= rotl(x[1] + x[13], 18);
+            x[14] ^= rotl(x[10] + x[6], 7);  x[2] ^= rotl(x[14] + x[10], 9);
+            x[6] ^= rotl(x[2] + x[14], 13);  x[10] ^= rotl(x[6] + x[2], 18);
+            x[3] ^= rotl(x[15] + x[11], 7);  x[7] ^= rotl(x[3] + x[15], 9);
+            x[11] ^= rotl(x[7] + x[3], 13);  x[15] ^= rotl(x[11] + x[7], 18);
+            x[1] ^= rotl(x[0] + x[3], 7);    x[2] ^= rotl(x[1] + x[0], 9);
+            x[3] ^= rotl(x[2] + x[1], 13);   x[0] ^= rotl(x[3] + x[2], 18);
+            x[6] ^= rotl(x[5] + x[4], 7);    x[7] ^= rotl(x[6] + x[5], 9);
+            x[4] ^= rotl(x[7] + x[6], 13);   x[5] ^= rotl(x[4] + x[7], 18);
+            x[11] ^= rotl(x[10] + x[9], 7);  x[8] ^= rotl(x[11] + x[10], 9);
+            x[9] ^= rotl(x[8] + x[11], 13);  x[10] ^= rotl(x[9] + x[8], 18);
+            x[12] ^= rotl(x[15] + x[14], 7); x[13] ^= rotl(x[12] + x[15], 9);
+            x[14] ^= rotl(x[13] + x[12], 13); x[15] ^= rotl(x[14] + x[13], 18);
+        }
+        for (int i = 0; i < 16; ++i) b[i] += x[i];
+    }
+
+    // scryptBlockMix: in (2r blocks of 16 words) -> out, interleaving even/odd results
+    void blockMix(const uint32_t* in, uint32_t* out, uint32_t r) {
+        uint32_t x[16];
+        std::memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+        for (uint32_t i = 0; i < 2 * r; ++i) {
+            for (int k = 0; k < 16; ++k) x[k] ^= in[i * 16 + k];
+            salsa208(x);
+            uint32_t dest = (i % 2 == 0 ? i / 2 : r + i / 2) * 16;
+            std::memcpy(out + dest, x, sizeof(x));
+        }
+    }
+
+    // scryptROMix over one 128*r byte block (as little-endian words)
+    void roMix(uint32_t* block, uint32_t n, uint32_t r, std::vector<uint32_t>& v, std::vector<uint32_t>& scratch) {
+        const size_t words = 32 * static_cast<size_t>(r);
+        uint32_t* x = block;
+        uint32_t* y = scratch.data();
+
+        for (uint32_t i = 0; i < n; ++i) {
+            std::memcpy(v.data() + i * words, x, words * sizeof(uint32_t));
+            blockMix(x, y, r);
+            std::swap(x, y);
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t j = x[(2 * r - 1) * 16] & (n - 1);   // Integerify
+            const uint32_t* vj = v.data() + static_cast<size_t>(j) * words;
+            for (size_t k = 0; k < words; ++k) x[k] ^= vj[k];
+            blockMix(x, y, r);
+            std::swap(x, y);
+        }
+
+        if (x != block) {
+            std::memcpy(block, x, words * sizeof(uint32_t));
+        }
+    }
+}
+
+Crypto::Digest Crypto::sha256(const std::string& data) {
+    Sha256 sha;
+    sha.update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    return sha.finish();
+}
+
+Crypto::Digest Crypto::hmacSha256(const std::string& key, const std::string& data) {
+    return HmacSha256(key).mac(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+std::string Crypto::pbkdf2HmacSha256(const std::string& password, const std::string& salt,
+                                     uint32_t iterations, size_t length) {
+    HmacSha256 prf(password);
+    std::string out;
+    out.reserve(length);
+
+    std::vector<uint8_t> input(salt.begin(), salt.end());
+    input.resize(salt.size() + 4);
+
+    for (uint32_t blockIndex = 1; out.size() < length; ++blockIndex) {
+        for (int i = 0; i < 4; ++i) input[salt.size() + i] = static_cast<uint8_t>(blockIndex >> (24 - 8 * i));
+
+        Digest u = prf.mac(input.data(), input.size());
+        Digest t = u;
+        for (uint32_t iter = 1; iter < iterations; ++iter) {
+            u = prf.mac(u.data(), u.size());
+            for (size_t k = 0; k < t.size(); ++k) t[k] ^= u[k];
+        }
+
+        size_t take = std::min(t.size(), length - out.size());
+        out.append(reinterpret_cast<const char*>(t.data()), take);
+    }
+    return out;
+}
+
+std::string Crypto::scrypt(const std::string& password, const std::string& salt,
+                           uint32_t n, uint32_t r, uint32_t p, size_t length) {
+    const size_t blockBytes = 128 * static_cast<size_t>(r);
+    std::string b = pbkdf2HmacSha256(password, salt, 1, blockBytes * p);
+
+    std::vector<uint32_t> words(blockBytes / 4);
+    std::vector<uint32_t> v(static_cast<size_t>(n) * words.size());
+    std::vector<uint32_t> scratch(words.size());
+
+    for (uint32_t i = 0; i < p; ++i) {
+        uint8_t* chunk = reinterpret_cast<uint8_t*>(&b[i * blockBytes]);
+        for (size_t k = 0; k < words.size(); ++k) {
+            words[k] = chunk[4 * k] | (chunk[4 * k + 1] << 8) | (chunk[4 * k + 2] << 16) |
+                       (static_cast<uint32_t>(chunk[4 * k + 3]) << 24);
+        }
+
+        roMix(words.data(), n, r, v, scratch);
+
+        for (size_t k = 0; k < words.size(); ++k) {
+            for (int byte = 0; byte < 4; ++byte) chunk[4 * k + byte] = static_cast<uint8_t>(words[k] >> (8 * byte));
+        }
+    }
+
+    return pbkdf2HmacSha256(password, b, 1, length);
+}
+
+std::string Crypto::hashPassword(const std::string& password, const PasswordHashParams& params) {
+    std::string salt = randomBytes(SALT_BYTES);
+    std::string hash = scrypt(password, salt, params.n, params.r, params.p, HASH_BYTES);
+
+    return "$scrypt$" + std::to_string(params.n) + "$" + std::to_string(params.r) + "$" +
+           std::to_string(params.p) + "$" + toHex(salt) + "$" + toHex(hash);
+}
+
+bool Crypto::verifyPassword(const std::string& password, const std::string& stored) {
+    PasswordHashParams params;
+    std::string salt, expected;
+    if (!parseHash(stored, params, salt, expected)) {
+        return false;
+    }
+
+    std::string actual = scrypt(password, salt, params.n, params.r, params.p, expected.size());
+    return constantTimeEquals(actual, expected);
+}
+
+bool Crypto::needsRehash(const std::string& stored, const PasswordHashParams& params) {
+    PasswordHashParams current;
+    std::string salt, hash;
+    if (!parseHash(stored, current, salt, hash)) {
+        return true;
+    }
+    return current.n != params.n || current.r != params.r || current.p != params.p;
+}
+
+bool Crypto::constantTimeEquals(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff |= static_cast<uint8_t>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+std::string Crypto::randomBytes(size_t count) {
+    static thread_local std::random_device device;
+    std::string out(count, '\0');
+    for (size_t i = 0; i < count; i += 4) {
+        uint32_t value = device();
+        for (size_t k = 0; k < 4 && i + k < count; ++k) {
+            out[i + k] = static_cast<char>(value >> (8 * k));
+        }
+    }
+    return out;
+}
+
+std::string Crypto::toHex(const std::string& bytes) {
+    static const char* digits = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        out += digits[c >> 4];
+        out += digits[c & 0x0F];
+    }
+    return out;
+}
+
+bool Crypto::fromHex(const std::string& hex, std::string& bytes) {
+    if (hex.size() % 2 != 0) return false;
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    bytes.clear();
+    bytes.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int high = nibble(hex[i]), low = nibble(hex[i + 1]);
+        if (high < 0 || low < 0) return false;
+        bytes += static_cast<char>((high << 4) | low);
+    }
+    return true;
+}
+
+bool Crypto::validParams(const PasswordHashParams& params) {
+    return params.n >= 2 && params.n <= MAX_N && (params.n & (params.n - 1)) == 0 &&
+           params.r >= 1 && params.r <= MAX_R && params.p >= 1 && params.p <= MAX_P;
+}
+
+bool Crypto::parseHash(const std::string& stored, PasswordHashParams& params,
+                       std::string& salt, std::string& hash) {
+    // "$scrypt$n$r$p$salt$hash" splits into "", "scrypt", n, r, p, salt, hash
+    std::vector<std::string> parts = Utils::split(stored, '$');
+    if (parts.size() != 7 || !parts[0].empty() || parts[1] != "scrypt") {
+        return false;
+    }
+
+    try {
+        unsigned long n = std::stoul(parts[2]), r = std::stoul(parts[3]), p = std::stoul(parts[4]);
+        if (n > MAX_N || r > MAX_R || p > MAX_P) {
+            return false;
+        }
+        params.n = static_cast<uint32_t>(n);
+        params.r = static_cast<uint32_t>(r);
+        params.p = static_cast<uint32_t>(p);
+    } catch (...) {
+        return false;
+    }
+    if (!validParams(params)) {
+        return false;
+    }
+
+    return fromHex(parts[5], salt) && fromHex(parts[6], hash) && !hash.empty();
+}
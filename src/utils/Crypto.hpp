@@ -0,0 +1,51 @@
+#ifndef CRYPTO_HPP
+#define CRYPTO_HPP
+
+#include "../../include/common.hpp"
+#include <array>
+
+// Cost parameters for scrypt password hashing. Memory use per hash is 128 * r * n bytes.
+struct PasswordHashParams {
+    uint32_t n = 16384;   // CPU/memory cost, power of two
+    uint32_t r = 8;       // block size
+    uint32_t p = 1;       // parallelization
+};
+
+// Self-contained primitives for password storage: SHA-256, HMAC-SHA256, PBKDF2 and scrypt.
+class Crypto {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    static Digest sha256(const std::string& data);
+    static Digest hmacSha256(const std::string& key, const std::string& data);
+    static std::string pbkdf2HmacSha256(const std::string& password, const std::string& salt,
+                                        uint32_t iterations, size_t length);
+    static std::string scrypt(const std::string& password, const std::string& salt,
+                              uint32_t n, uint32_t r, uint32_t p, size_t length);
+
+    // Salted password hash: $scrypt$n$r$p$<salt hex>$<hash hex>
+    static std::string hashPassword(const std::string& password, const PasswordHashParams& params);
+
+    // Check a password against a stored hash (using the parameters recorded in it)
+    static bool verifyPassword(const std::string& password, const std::string& stored);
+
+    // Parameters verifyPassword accepts: n a power of two >= 2, and n, r, p within the
+    // bounds it allows (which keep r * p far below scrypt's 2^30 limit)
+    static bool validParams(const PasswordHashParams& params);
+
+    // true when stored was produced with parameters other than params
+    static bool needsRehash(const std::string& stored, const PasswordHashParams& params);
+
+    // Compare without an early exit, so timing does not reveal the matching prefix
+    static bool constantTimeEquals(const std::string& a, const std::string& b);
+
+    static std::string randomBytes(size_t count);
+    static std::string toHex(const std::string& bytes);
+    static bool fromHex(const std::string& hex, std::string& bytes);
+
+private:
+    static bool parseHash(const std::string& stored, PasswordHashParams& params,
+                          std::string& salt, std::string& hash);
+};
+
+#endif // CRYPTO_HPP
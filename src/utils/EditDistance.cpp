@@ -0,0 +1,104 @@
+#include "EditDistance.hpp"
+
+EditDistancePattern::EditDistancePattern(std::string_view pattern) : pattern_(pattern) {
+    if (pattern_.size() <= MAX_BIT_PARALLEL_LENGTH) {
+        for (size_t i = 0; i < pattern_.size(); ++i) {
+            peq_[static_cast<unsigned char>(pattern_[i])] |= uint64_t(1) << i;
+        }
+    }
+}
+
+size_t EditDistancePattern::levenshtein(std::string_view text, size_t maxDistance) const {
+    if (pattern_.size() <= MAX_BIT_PARALLEL_LENGTH) {
+        return bitParallel(text, maxDistance, false);
+    }
+    return bandedDp(text, maxDistance, false);
+}
+
+size_t EditDistancePattern::damerau(std::string_view text, size_t maxDistance) const {
+    if (pattern_.size() <= MAX_BIT_PARALLEL_LENGTH) {
+        return bitParallel(text, maxDistance, true);
+    }
+    return bandedDp(text, maxDistance, true);
+}
+
+size_t EditDistancePattern::bitParallel(std::string_view text, size_t maxDistance, bool transpositions) const {
+    const size_t m = pattern_.size();
+    const size_t n = text.size();
+    const size_t lengthGap = m > n ? m - n : n - m;
+    if (lengthGap > maxDistance) return maxDistance + 1;
+    if (m == 0) return n;
+
+    // Vertical deltas of the last DP column are kept as bit vectors (VP = +1, VN = -1);
+    // the distance is tracked at the bottom row through the horizontal deltas.
+    const uint64_t lastBit = uint64_t(1) << (m - 1);
+    uint64_t vp = ~uint64_t(0);
+    uint64_t vn = 0;
+    uint64_t d0 = 0;
+    uint64_t prevEq = 0;
+    size_t distance = m;
+
+    for (size_t j = 0; j < n; ++j) {
+        const uint64_t eq = peq_[static_cast<unsigned char>(text[j])];
+        const uint64_t x = eq | vn;
+
+        // Transpositions are detected against the previous column's diagonal deltas
+        const uint64_t transposed = transpositions ? ((((~d0) & eq) << 1) & prevEq) : 0;
+        d0 = (((x & vp) + vp) ^ vp) | x | transposed;
+
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = d0 & vp;
+        if (hp & lastBit) ++distance;
+        if (hn & lastBit) --distance;
+
+        // Row 0 of the DP matrix grows by one per text character
+        hp = (hp << 1) | 1;
+        hn = hn << 1;
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        prevEq = eq;
+
+        // Each remaining text character can lower the distance by at most one
+        const size_t remaining = n - j - 1;
+        if (distance > maxDistance + remaining) return maxDistance + 1;
+    }
+
+    return distance <= maxDistance ? distance : maxDistance + 1;
+}
+
+size_t EditDistancePattern::bandedDp(std::string_view text, size_t maxDistance, bool transpositions) const {
+    const size_t m = pattern_.size();
+    const size_t n = text.size();
+    const size_t lengthGap = m > n ? m - n : n - m;
+    if (lengthGap > maxDistance) return maxDistance + 1;
+
+    // Cells farther than maxDistance from the diagonal can never be within the bound
+    const size_t limit = maxDistance + 1;
+    std::vector<size_t> prevPrev(n + 1, limit), prev(n + 1, limit), curr(n + 1, limit);
+    for (size_t j = 0; j <= std::min(n, maxDistance); ++j) prev[j] = j;
+
+    for (size_t i = 1; i <= m; ++i) {
+        const size_t lo = i > maxDistance ? i - maxDistance : 1;
+        const size_t hi = std::min(n, i + maxDistance);
+        std::fill(curr.begin(), curr.end(), limit);
+        curr[0] = i <= maxDistance ? i : limit;
+
+        size_t rowMin = curr[0];
+        for (size_t j = lo; j <= hi; ++j) {
+            const size_t cost = pattern_[i - 1] == text[j - 1] ? 0 : 1;
+            size_t value = std::min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
+            if (transpositions && i > 1 && j > 1 &&
+                pattern_[i - 1] == text[j - 2] && pattern_[i - 2] == text[j - 1]) {
+                value = std::min(value, prevPrev[j - 2] + 1);
+            }
+            curr[j] = std::min(value, limit);
+            rowMin = std::min(rowMin, curr[j]);
+        }
+
+        if (rowMin >= limit) return limit;
+        std::swap(prevPrev, prev);
+        std::swap(prev, curr);
+    }
+
+    return std::min(prev[n], limit);
+}
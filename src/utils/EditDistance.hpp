@@ -0,0 +1,34 @@
+#ifndef EDIT_DISTANCE_HPP
+#define EDIT_DISTANCE_HPP
+
+#include "../../include/common.hpp"
+#include <array>
+#include <string_view>
+
+// Precompiled pattern for bounded edit distance.
+// Patterns up to 64 bytes use the bit-parallel algorithm of Myers/Hyyrö, which processes one
+// text character per handful of word operations; longer patterns fall back to a banded DP.
+class EditDistancePattern {
+public:
+    static constexpr size_t MAX_BIT_PARALLEL_LENGTH = 64;
+
+    EditDistancePattern() = default;
+    explicit EditDistancePattern(std::string_view pattern);
+
+    // Levenshtein distance to text, or maxDistance + 1 if it is larger than maxDistance
+    size_t levenshtein(std::string_view text, size_t maxDistance) const;
+
+    // Damerau (optimal string alignment) distance: adjacent transpositions cost 1
+    size_t damerau(std::string_view text, size_t maxDistance) const;
+
+    const std::string& pattern() const { return pattern_; }
+
+private:
+    size_t bitParallel(std::string_view text, size_t maxDistance, bool transpositions) const;
+    size_t bandedDp(std::string_view text, size_t maxDistance, bool transpositions) const;
+
+    std::string pattern_;
+    std::array<uint64_t, 256> peq_{};   // bit i set when pattern_[i] == c
+};
+
+#endif // EDIT_DISTANCE_HPP
@@ -95,3 +95,11 @@ std::string Logger::levelToString(LogLevel level) {
     }
 }
 
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    if (name == "DEBUG") level = LogLevel::DEBUG;
+    else if (name == "INFO") level = LogLevel::INFO;
+    else if (name == "WARNING") level = LogLevel::WARNING;
+    else if (name == "ERROR") level = LogLevel::ERROR;
+    else return false;
+    return true;
+}
@@ -29,6 +29,12 @@ public:
     // Set log level
     void setLogLevel(LogLevel level);
     
+    // Whether a message at this level would be written; lets hot paths skip building it
+    bool isEnabled(LogLevel level) const { return initialized_ && level >= logLevel_; }
+    
+    // "DEBUG", "INFO", "WARNING" or "ERROR"; false for anything else
+    static bool parseLevel(const std::string& name, LogLevel& level);
+    
     // Disable copy and assignment
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
@@ -1,4 +1,6 @@
 #include "Parser.hpp"
+#include <array>
+#include <charconv>
 #include <fstream>
 #include <sstream>
 
@@ -55,54 +57,52 @@ bool Parser::parseConfigFile(const std::string& filePath,
     return !config.empty();
 }
 
-bool Parser::parseLoginRequest(const std::string& payload, 
+bool Parser::parseLoginRequest(std::string_view payload, 
                                std::string& username, std::string& password) {
-    std::vector<std::string> parts = Utils::split(payload, '|');
-    if (parts.size() < 2) return false;
+    size_t sep = payload.find('|');
+    if (sep == std::string_view::npos) return false;
     
-    username = Utils::trim(parts[0]);
-    password = Utils::trim(parts[1]);
+    std::string_view rest = payload.substr(sep + 1);
+    std::string_view user = Utils::trimView(payload.substr(0, sep));
+    std::string_view pass = Utils::trimView(rest.substr(0, rest.find('|')));
+    if (!validateUsername(user) || !validatePassword(pass)) return false;
     
-    return validateUsername(username) && validatePassword(password);
+    username.assign(user);
+    password.assign(pass);
+    return true;
 }
 
-bool Parser::parseRegisterRequest(const std::string& payload,
+bool Parser::parseRegisterRequest(std::string_view payload,
                                   std::string& username, std::string& password, UserRole& role) {
-    std::vector<std::string> parts = Utils::split(payload, '|');
-    if (parts.size() < 3) return false;
+    size_t sep1 = payload.find('|');
+    if (sep1 == std::string_view::npos) return false;
+    size_t sep2 = payload.find('|', sep1 + 1);
+    if (sep2 == std::string_view::npos || sep2 + 1 == payload.size()) return false;
     
-    username = Utils::trim(parts[0]);
-    password = Utils::trim(parts[1]);
+    std::string_view rest = payload.substr(sep2 + 1);
+    std::string_view roleText = Utils::trimView(rest.substr(0, rest.find('|')));
+    int roleValue = 0;
+    auto parsed = std::from_chars(roleText.data(), roleText.data() + roleText.size(), roleValue);
+    if (parsed.ec != std::errc() || parsed.ptr == roleText.data()) return false;
     
-    try {
-        role = static_cast<UserRole>(std::stoi(parts[2]));
-    } catch (...) {
-        return false;
-    }
+    std::string_view user = Utils::trimView(payload.substr(0, sep1));
+    std::string_view pass = Utils::trimView(payload.substr(sep1 + 1, sep2 - sep1 - 1));
+    if (!validateUsername(user) || !validatePassword(pass)) return false;
     
-    return validateUsername(username) && validatePassword(password);
-}
-
-bool Parser::parseSetLevelRequest(const std::string& payload, ProficiencyLevel& level) {
-    try {
-        int levelValue = std::stoi(Utils::trim(payload));
-        if (levelValue < 1 || levelValue > 3) return false;
-        level = static_cast<ProficiencyLevel>(levelValue);
-        return true;
-    } catch (...) {
-        return false;
-    }
+    username.assign(user);
+    password.assign(pass);
+    role = static_cast<UserRole>(roleValue);
+    return true;
 }
 
-bool Parser::parseChatMessage(const std::string& payload,
-                             std::string& recipient, std::string& message) {
-    size_t pos = payload.find('|');
-    if (pos == std::string::npos) return false;
-    
-    recipient = Utils::trim(payload.substr(0, pos));
-    message = payload.substr(pos + 1);
-    
-    return !recipient.empty() && !message.empty();
+bool Parser::parseSetLevelRequest(std::string_view payload, ProficiencyLevel& level) {
+    std::string_view text = Utils::trimView(payload);
+    int levelValue = 0;
+    auto parsed = std::from_chars(text.data(), text.data() + text.size(), levelValue);
+    if (parsed.ec != std::errc() || parsed.ptr == text.data()) return false;
+    if (levelValue < 1 || levelValue > 3) return false;
+    level = static_cast<ProficiencyLevel>(levelValue);
+    return true;
 }
 
 std::string Parser::createLoginRequest(const std::string& username, const std::string& password) {
@@ -118,10 +118,6 @@ std::string Parser::createSetLevelRequest(ProficiencyLevel level) {
     return std::to_string(static_cast<int>(level));
 }
 
-std::string Parser::createChatMessage(const std::string& recipient, const std::string& message) {
-    return recipient + "|" + message;
-}
-
 std::string Parser::createErrorMessage(ErrorCode code, const std::string& description) {
     return std::to_string(static_cast<int>(code)) + "|" + description;
 }
@@ -131,18 +127,91 @@ std::string Parser::createSuccessMessage(const std::string& data) {
            (data.empty() ? "" : "|" + data);
 }
 
-bool Parser::validateUsername(const std::string& username) {
+std::string Parser::encodeBase64(const std::string& data) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        uint32_t triple = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8) |
+                          static_cast<uint8_t>(data[i + 2]);
+        out += alphabet[(triple >> 18) & 0x3F];
+        out += alphabet[(triple >> 12) & 0x3F];
+        out += alphabet[(triple >> 6) & 0x3F];
+        out += alphabet[triple & 0x3F];
+    }
+    
+    size_t rest = data.size() - i;
+    if (rest > 0) {
+        uint32_t triple = static_cast<uint8_t>(data[i]) << 16;
+        if (rest == 2) triple |= static_cast<uint8_t>(data[i + 1]) << 8;
+        out += alphabet[(triple >> 18) & 0x3F];
+        out += alphabet[(triple >> 12) & 0x3F];
+        out += rest == 2 ? alphabet[(triple >> 6) & 0x3F] : '=';
+        out += '=';
+    }
+    
+    return out;
+}
+
+namespace {
+    template <typename Bytes>
+    bool decodeBase64Into(std::string_view text, Bytes& data) {
+        static const auto table = [] {
+            std::array<int8_t, 256> t;
+            t.fill(-1);
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; ++i) t[static_cast<uint8_t>(alphabet[i])] = static_cast<int8_t>(i);
+            return t;
+        }();
+    
+        data.clear();
+        if (text.size() % 4 != 0) return false;
+        data.reserve(text.size() / 4 * 3);
+    
+        for (size_t i = 0; i < text.size(); i += 4) {
+            bool last = i + 4 == text.size();
+            size_t padding = 0;
+            if (last && text[i + 3] == '=') padding = text[i + 2] == '=' ? 2 : 1;
+        
+            uint32_t quad = 0;
+            for (size_t k = 0; k < 4 - padding; ++k) {
+                int8_t value = table[static_cast<uint8_t>(text[i + k])];
+                if (value < 0) return false;
+                quad |= static_cast<uint32_t>(value) << (18 - 6 * k);
+            }
+        
+            data += static_cast<char>((quad >> 16) & 0xFF);
+            if (padding < 2) data += static_cast<char>((quad >> 8) & 0xFF);
+            if (padding < 1) data += static_cast<char>(quad & 0xFF);
+        }
+    
+        return true;
+    }
+}
+
+bool Parser::decodeBase64(std::string_view text, std::string& data) {
+    return decodeBase64Into(text, data);
+}
+
+bool Parser::decodeBase64(std::string_view text, std::pmr::string& data) {
+    return decodeBase64Into(text, data);
+}
+
+bool Parser::validateUsername(std::string_view username) {
     if (username.empty() || username.length() > 50) return false;
     
     // Username should contain only alphanumeric characters and underscores
     for (char c : username) {
-        if (!std::isalnum(c) && c != '_') return false;
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') return false;
     }
     
     return true;
 }
 
-bool Parser::validatePassword(const std::string& password) {
+bool Parser::validatePassword(std::string_view password) {
     // Password should be at least 4 characters (simple validation)
     return password.length() >= 4 && password.length() <= 100;
 }
@@ -11,17 +11,14 @@ public:
     static bool parseConfigFile(const std::string& filePath, 
                                 std::map<std::string, std::string>& config);
     
-    // Parse message payload for specific message types
-    static bool parseLoginRequest(const std::string& payload, 
+    // Parse message payload for specific message types (no scratch copies of the payload)
+    static bool parseLoginRequest(std::string_view payload, 
                                   std::string& username, std::string& password);
     
-    static bool parseRegisterRequest(const std::string& payload,
+    static bool parseRegisterRequest(std::string_view payload,
                                      std::string& username, std::string& password, UserRole& role);
     
-    static bool parseSetLevelRequest(const std::string& payload, ProficiencyLevel& level);
-    
-    static bool parseChatMessage(const std::string& payload,
-                                std::string& recipient, std::string& message);
+    static bool parseSetLevelRequest(std::string_view payload, ProficiencyLevel& level);
     
     // Create message payloads
     static std::string createLoginRequest(const std::string& username, const std::string& password);
@@ -31,15 +28,18 @@ public:
     
     static std::string createSetLevelRequest(ProficiencyLevel level);
     
-    static std::string createChatMessage(const std::string& recipient, const std::string& message);
-    
     static std::string createErrorMessage(ErrorCode code, const std::string& description);
     
     static std::string createSuccessMessage(const std::string& data = "");
     
+    // Base64 for binary payloads (audio chunks); decode returns false on malformed input
+    static std::string encodeBase64(const std::string& data);
+    static bool decodeBase64(std::string_view text, std::string& data);
+    static bool decodeBase64(std::string_view text, std::pmr::string& data);   // e.g. into request scratch
+    
     // Validate input
-    static bool validateUsername(const std::string& username);
-    static bool validatePassword(const std::string& password);
+    static bool validateUsername(std::string_view username);
+    static bool validatePassword(std::string_view password);
     
 private:
     Parser() = default;
@@ -0,0 +1,24 @@
+#include "RequestArena.hpp"
+
+RequestArena::RequestArena(size_t capacity)
+    : capacity_(capacity), buffer_(new std::byte[capacity]),
+      arena_(buffer_.get(), capacity, &spills_) {
+}
+
+void RequestArena::reset() {
+    // Frees any spill and rewinds to the start of the buffer
+    arena_.release();
+}
+
+void* RequestArena::SpillCounter::do_allocate(size_t bytes, size_t alignment) {
+    ++count;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RequestArena::SpillCounter::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool RequestArena::SpillCounter::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,45 @@
+#ifndef REQUEST_ARENA_HPP
+#define REQUEST_ARENA_HPP
+
+#include "../../include/common.hpp"
+
+// Monotonic scratch memory for decoding one request and building its response. Allocation
+// is a pointer bump into a buffer owned by the arena; reset() takes everything back at once,
+// so a request that fits performs no heap allocation for its scratch. A request that does not
+// fit spills to the heap and the spill is freed by the next reset. Owning thread only.
+class RequestArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    explicit RequestArena(size_t capacity = DEFAULT_CAPACITY);
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena_; }
+
+    // Release everything allocated since the last reset
+    void reset();
+
+    size_t getCapacity() const { return capacity_; }
+    size_t getSpillCount() const { return spills_.count; }   // heap allocations past the buffer
+
+private:
+    // Heap upstream that counts how often the buffer was outgrown
+    class SpillCounter : public std::pmr::memory_resource {
+    public:
+        size_t count = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    size_t capacity_;
+    std::unique_ptr<std::byte[]> buffer_;
+    SpillCounter spills_;
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+#endif // REQUEST_ARENA_HPP
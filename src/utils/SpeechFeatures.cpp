@@ -0,0 +1,294 @@
+#include "SpeechFeatures.hpp"
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define SPEECH_FEATURES_SSE 1
+#endif
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+    constexpr float PRE_EMPHASIS = 0.97f;
+    constexpr float LOG_FLOOR = 1e-10f;
+    constexpr float SILENCE_RANGE = 9.21f;   // 40 dB below the loudest frame, in ln(power)
+
+    inline float hzToMel(float hz) { return 1127.0f * std::log(1.0f + hz / 700.0f); }
+    inline float melToHz(float mel) { return 700.0f * (std::exp(mel / 1127.0f) - 1.0f); }
+
+    inline float frameDistance(const float* a, const float* b, size_t dims) {
+        float sum = 0.0f;
+        for (size_t d = 0; d < dims; ++d) {
+            float diff = a[d] - b[d];
+            sum += diff * diff;
+        }
+        return std::sqrt(sum);
+    }
+}
+
+// ==================== Fft ====================
+
+Fft::Fft(size_t size) : size_(size) {
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < size_) bits++;
+
+    bitReverse_.resize(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (static_cast<size_t>(1) << b)) reversed |= 1u << (bits - 1 - b);
+        }
+        bitReverse_[i] = reversed;
+    }
+
+    for (size_t half = 1; half < size_; half <<= 1) {
+        std::vector<float> re(half), im(half);
+        for (size_t j = 0; j < half; ++j) {
+            double angle = -3.14159265358979323846 * static_cast<double>(j) / static_cast<double>(half);
+            re[j] = static_cast<float>(std::cos(angle));
+            im[j] = static_cast<float>(std::sin(angle));
+        }
+        twiddleRe_.push_back(std::move(re));
+        twiddleIm_.push_back(std::move(im));
+    }
+}
+
+void Fft::transform(float* re, float* im) const {
+    for (size_t i = 0; i < size_; ++i) {
+        size_t j = bitReverse_[i];
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    size_t stage = 0;
+    for (size_t half = 1; half < size_; half <<= 1, ++stage) {
+        const float* wr = twiddleRe_[stage].data();
+        const float* wi = twiddleIm_[stage].data();
+
+        for (size_t k = 0; k < size_; k += 2 * half) {
+            float* ar = re + k;
+            float* ai = im + k;
+            float* br = re + k + half;
+            float* bi = im + k + half;
+
+            size_t j = 0;
+            #ifdef SPEECH_FEATURES_SSE
+            for (; j + 4 <= half; j += 4) {
+                __m128 twr = _mm_loadu_ps(wr + j);
+                __m128 twi = _mm_loadu_ps(wi + j);
+                __m128 xr = _mm_loadu_ps(br + j);
+                __m128 xi = _mm_loadu_ps(bi + j);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, twr), _mm_mul_ps(xi, twi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(xr, twi), _mm_mul_ps(xi, twr));
+                __m128 ur = _mm_loadu_ps(ar + j);
+                __m128 ui = _mm_loadu_ps(ai + j);
+                _mm_storeu_ps(ar + j, _mm_add_ps(ur, tr));
+                _mm_storeu_ps(ai + j, _mm_add_ps(ui, ti));
+                _mm_storeu_ps(br + j, _mm_sub_ps(ur, tr));
+                _mm_storeu_ps(bi + j, _mm_sub_ps(ui, ti));
+            }
+            #endif
+            for (; j < half; ++j) {
+                float tr = br[j] * wr[j] - bi[j] * wi[j];
+                float ti = br[j] * wi[j] + bi[j] * wr[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+            }
+        }
+    }
+}
+
+// ==================== MfccExtractor ====================
+
+namespace {
+    size_t nextPowerOfTwo(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+}
+
+MfccExtractor::MfccExtractor(int sampleRate)
+    : frameLength_(static_cast<size_t>(sampleRate) * 25 / 1000),
+      hopLength_(static_cast<size_t>(sampleRate) / 100),
+      fft_(nextPowerOfTwo(static_cast<size_t>(sampleRate) * 25 / 1000)),
+      lastSample_(0.0f) {
+    const size_t fftSize = fft_.size();
+    re_.resize(fftSize);
+    im_.resize(fftSize);
+
+    window_.resize(frameLength_);
+    for (size_t i = 0; i < frameLength_; ++i) {
+        window_[i] = 0.54f - 0.46f * std::cos(2.0f * PI * static_cast<float>(i) / static_cast<float>(frameLength_ - 1));
+    }
+
+    // Mel filter bank: NUM_FILTERS triangles evenly spaced on the mel scale up to Nyquist
+    float melHigh = hzToMel(static_cast<float>(sampleRate) / 2.0f);
+    std::vector<size_t> bins(NUM_FILTERS + 2);
+    for (size_t i = 0; i < bins.size(); ++i) {
+        float hz = melToHz(melHigh * static_cast<float>(i) / static_cast<float>(NUM_FILTERS + 1));
+        bins[i] = std::min(fftSize / 2, static_cast<size_t>(std::floor((fftSize + 1) * hz / sampleRate)));
+    }
+
+    filterStart_.resize(NUM_FILTERS);
+    filterWeights_.resize(NUM_FILTERS);
+    for (size_t f = 0; f < NUM_FILTERS; ++f) {
+        size_t left = bins[f], center = std::max(bins[f + 1], left + 1), right = std::max(bins[f + 2], center + 1);
+        right = std::min(right, fftSize / 2);
+        filterStart_[f] = left;
+        for (size_t k = left; k <= right; ++k) {
+            float weight = k <= center
+                ? static_cast<float>(k - left) / static_cast<float>(center - left)
+                : static_cast<float>(right - k) / static_cast<float>(std::max<size_t>(1, right - center));
+            filterWeights_[f].push_back(std::max(0.0f, weight));
+        }
+    }
+
+    // DCT-II rows for c1..c12; row 0 is replaced by the frame log energy
+    dct_.assign(NUM_COEFFS * NUM_FILTERS, 0.0f);
+    for (size_t c = 1; c < NUM_COEFFS; ++c) {
+        for (size_t f = 0; f < NUM_FILTERS; ++f) {
+            dct_[c * NUM_FILTERS + f] = std::cos(PI * static_cast<float>(c) * (static_cast<float>(f) + 0.5f) / NUM_FILTERS);
+        }
+    }
+}
+
+void MfccExtractor::feed(const int16_t* samples, size_t count) {
+    buffer_.reserve(buffer_.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        float x = static_cast<float>(samples[i]) / 32768.0f;
+        buffer_.push_back(x - PRE_EMPHASIS * lastSample_);
+        lastSample_ = x;
+    }
+
+    size_t offset = 0;
+    while (buffer_.size() - offset >= frameLength_) {
+        computeFrame(buffer_.data() + offset);
+        offset += hopLength_;
+    }
+    buffer_.erase(buffer_.begin(), buffer_.begin() + offset);
+}
+
+void MfccExtractor::computeFrame(const float* samples) {
+    float energy = 0.0f;
+    for (size_t i = 0; i < frameLength_; ++i) {
+        energy += samples[i] * samples[i];
+        re_[i] = samples[i] * window_[i];
+    }
+    std::fill(re_.begin() + frameLength_, re_.end(), 0.0f);
+    std::fill(im_.begin(), im_.end(), 0.0f);
+
+    fft_.transform(re_.data(), im_.data());
+
+    const size_t bins = fft_.size() / 2 + 1;
+    for (size_t k = 0; k < bins; ++k) {
+        re_[k] = re_[k] * re_[k] + im_[k] * im_[k];   // power spectrum, reusing re_
+    }
+
+    float logMel[NUM_FILTERS];
+    for (size_t f = 0; f < NUM_FILTERS; ++f) {
+        const float* power = re_.data() + filterStart_[f];
+        const std::vector<float>& weights = filterWeights_[f];
+        float sum = 0.0f;
+        for (size_t k = 0; k < weights.size(); ++k) {
+            sum += weights[k] * power[k];
+        }
+        logMel[f] = std::log(std::max(sum, LOG_FLOOR));
+    }
+
+    features_.push_back(std::log(std::max(energy, LOG_FLOOR)));
+    for (size_t c = 1; c < NUM_COEFFS; ++c) {
+        const float* row = dct_.data() + c * NUM_FILTERS;
+        float sum = 0.0f;
+        for (size_t f = 0; f < NUM_FILTERS; ++f) {
+            sum += row[f] * logMel[f];
+        }
+        features_.push_back(sum);
+    }
+}
+
+std::vector<float> MfccExtractor::finish() {
+    std::vector<float> out;
+    size_t frames = frameCount();
+    if (frames > 0) {
+        float maxEnergy = features_[0];
+        for (size_t i = 1; i < frames; ++i) {
+            maxEnergy = std::max(maxEnergy, features_[i * NUM_COEFFS]);
+        }
+
+        size_t first = 0, last = frames;
+        while (first < last && features_[first * NUM_COEFFS] < maxEnergy - SILENCE_RANGE) first++;
+        while (last > first && features_[(last - 1) * NUM_COEFFS] < maxEnergy - SILENCE_RANGE) last--;
+
+        out.assign(features_.begin() + first * NUM_COEFFS, features_.begin() + last * NUM_COEFFS);
+
+        // Cepstral mean normalization removes the channel (microphone) and loudness offset
+        size_t kept = last - first;
+        float mean[NUM_COEFFS] = {};
+        for (size_t i = 0; i < kept; ++i) {
+            for (size_t c = 0; c < NUM_COEFFS; ++c) mean[c] += out[i * NUM_COEFFS + c];
+        }
+        for (size_t c = 0; c < NUM_COEFFS; ++c) mean[c] /= static_cast<float>(kept);
+        for (size_t i = 0; i < kept; ++i) {
+            for (size_t c = 0; c < NUM_COEFFS; ++c) out[i * NUM_COEFFS + c] -= mean[c];
+        }
+    }
+
+    features_.clear();
+    buffer_.clear();
+    lastSample_ = 0.0f;
+    return out;
+}
+
+// ==================== DTW ====================
+
+float dtwDistance(const float* a, size_t framesA, const float* b, size_t framesB, size_t dims, size_t band) {
+    if (framesA == 0 || framesB == 0) return -1.0f;
+
+    const float INF = std::numeric_limits<float>::infinity();
+    const size_t n = framesA, m = framesB;
+
+    // Consecutive rows must overlap for a path to exist, so the band is at least the diagonal's slope
+    size_t width = std::max<size_t>(band, (m + n - 1) / n + 1);
+
+    std::vector<float> prev(m, INF), cur(m, INF);
+    size_t prevLo = 0, prevHi = 0;          // cells written in prev
+    size_t staleLo = 1, staleHi = 0;        // cells cur still holds from two rows ago (empty)
+
+    for (size_t i = 0; i < n; ++i) {
+        size_t center = n > 1 ? (i * (m - 1) + (n - 1) / 2) / (n - 1) : 0;
+        size_t lo = center > width ? center - width : 0;
+        size_t hi = std::min(m - 1, center + width);
+
+        for (size_t j = staleLo; j <= staleHi; ++j) cur[j] = INF;
+
+        const float* rowA = a + i * dims;
+        for (size_t j = lo; j <= hi; ++j) {
+            float best;
+            if (i == 0 && j == 0) {
+                best = 0.0f;
+            } else {
+                best = j > 0 ? cur[j - 1] : INF;
+                if (i > 0) {
+                    best = std::min(best, prev[j]);
+                    if (j > 0) best = std::min(best, prev[j - 1]);
+                }
+            }
+            cur[j] = best + frameDistance(rowA, b + j * dims, dims);
+        }
+
+        std::swap(prev, cur);
+        staleLo = prevLo;
+        staleHi = prevHi;
+        prevLo = lo;
+        prevHi = hi;
+    }
+
+    float total = prev[m - 1];
+    if (total == INF) return -1.0f;
+    return total / static_cast<float>(n + m);
+}
@@ -0,0 +1,69 @@
+#ifndef SPEECH_FEATURES_HPP
+#define SPEECH_FEATURES_HPP
+
+#include "../../include/common.hpp"
+
+// In-place radix-2 complex FFT over split real/imaginary arrays.
+// Twiddles are stored per stage with unit stride so the butterflies run four lanes at a
+// time with SSE where available (scalar otherwise).
+class Fft {
+public:
+    // size must be a power of two
+    explicit Fft(size_t size);
+
+    size_t size() const { return size_; }
+
+    // Forward transform of size() points
+    void transform(float* re, float* im) const;
+
+private:
+    size_t size_;
+    std::vector<uint32_t> bitReverse_;
+    std::vector<std::vector<float>> twiddleRe_;   // [stage][j] = cos(-pi j / half)
+    std::vector<std::vector<float>> twiddleIm_;   // [stage][j] = sin(-pi j / half)
+};
+
+// Streaming MFCC extractor for 16-bit mono PCM.
+// Audio may arrive in arbitrary chunk sizes; every complete 25 ms frame (10 ms hop) is turned
+// into NUM_COEFFS values: log frame energy followed by cepstra c1..c12.
+class MfccExtractor {
+public:
+    static constexpr size_t NUM_COEFFS = 13;
+    static constexpr size_t NUM_FILTERS = 26;
+
+    explicit MfccExtractor(int sampleRate = 16000);
+
+    // Append samples; computes all frames they complete
+    void feed(const int16_t* samples, size_t count);
+
+    size_t frameCount() const { return features_.size() / NUM_COEFFS; }
+    const std::vector<float>& features() const { return features_; }
+
+    // Trim leading/trailing silence and apply cepstral mean normalization.
+    // Returns the finished feature matrix (frames x NUM_COEFFS); the extractor is left empty.
+    std::vector<float> finish();
+
+private:
+    void computeFrame(const float* samples);
+
+    size_t frameLength_;
+    size_t hopLength_;
+    Fft fft_;
+    std::vector<float> window_;
+    std::vector<size_t> filterStart_;               // first FFT bin of each mel filter
+    std::vector<std::vector<float>> filterWeights_; // triangular weights from filterStart_
+    std::vector<float> dct_;                        // NUM_COEFFS x NUM_FILTERS
+
+    std::vector<float> buffer_;     // pre-emphasized samples not yet consumed
+    float lastSample_;
+    std::vector<float> re_, im_;    // FFT scratch
+    std::vector<float> features_;
+};
+
+// Dynamic time warping distance between two feature sequences of dims-wide frames.
+// Only cells within band frames of the (rescaled) diagonal are evaluated, so the cost is
+// O(max(n, m) * band). Returns the accumulated Euclidean distance divided by the path
+// normalization (n + m), or a negative value if either sequence is empty.
+float dtwDistance(const float* a, size_t framesA, const float* b, size_t framesB, size_t dims, size_t band);
+
+#endif // SPEECH_FEATURES_HPP
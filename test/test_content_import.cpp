@@ -0,0 +1,195 @@
+// Test program for curriculum imports (CSV/JSONL parsing) and the lesson catalog
+
+#include "../src/db/ContentImporter.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <thread>
+
+std::string writeFile(const std::string& name, const std::string& text) {
+    std::string path = "/tmp/" + name;
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+}
+
+void testCsv() {
+    std::cout << "Testing CSV..." << std::endl;
+
+    std::string path = writeFile("elp_import_test.csv",
+        "kind,level,id_or_game,title_or_data,body\n"
+        "lesson,1,l1,\"Hello, world\",\"Say \"\"hi\"\"\"\r\n"
+        "# comment\n"
+        "\n"
+        "item,advanced,Word Matching,cat=animal\n"
+        "item,2,Word Matching\n"
+        "lesson,4,l2,Bad level\n"
+        "item,1,Word Matching,a;b");
+
+    ImportedContent content;
+    ImportReport report;
+    assert(ContentImporter::parseFile(path, content, report, 2));
+    assert(report.records == 5 && report.rejected == 3);
+    assert(content.lessons.size() == 1 && content.lessons[0].title == "Hello, world" &&
+           content.lessons[0].body == "Say \"hi\"");
+    assert(content.items.size() == 1 && content.items[0].first == "Word Matching" &&
+           content.items[0].second.level == ProficiencyLevel::ADVANCED);
+    assert(report.errors.size() == 3 && report.errors[0] == "line 6: wrong number of fields" &&
+           report.errors[1] == "line 7: invalid level" && report.errors[2].rfind("line 8:", 0) == 0);
+    std::remove(path.c_str());
+
+    std::cout << "✓ CSV test passed" << std::endl;
+}
+
+void testJsonl() {
+    std::cout << "Testing JSONL..." << std::endl;
+
+    std::string path = writeFile("elp_import_test.jsonl",
+        "{\"kind\":\"lesson\",\"level\":\"intermediate\",\"id\":\"l1\",\"title\":\"Caf\\u00e9 \\ud83d\\ude00\",\"body\":\"a\\nb\",\"extra\":7}\n"
+        "{ \"kind\" : \"item\", \"level\" : 3, \"game\" : \"G\", \"data\" : \"x=y\" }\n"
+        "{\"kind\":\"item\",\"level\":1,\"game\":\"G\",\"data\":[1]}\n"
+        "{\"kind\":\"item\",\"level\":1,\"game\":\"G\",\"data\":\"unterminated}\n"
+        "{\"kind\":\"quiz\"}\n");
+
+    ImportedContent content;
+    ImportReport report;
+    assert(ContentImporter::parseFile(path, content, report));
+    assert(report.records == 5 && report.rejected == 3);
+    assert(content.lessons.size() == 1 && content.lessons[0].title == "Caf\xc3\xa9 \xf0\x9f\x98\x80" &&
+           content.lessons[0].body == "a\nb" && content.lessons[0].level == ProficiencyLevel::INTERMEDIATE);
+    assert(content.items.size() == 1 && content.items[0].second.data == "x=y");
+    assert(report.errors[2] == "line 5: unknown kind \"quiz\"");
+    std::remove(path.c_str());
+
+    ImportReport missing;
+    assert(!ContentImporter::parseFile("/tmp/elp_no_such_file.csv", content, missing));
+    assert(!ContentImporter::parseFile("/tmp/elp_import_test.txt", content, missing));
+
+    std::cout << "✓ JSONL test passed" << std::endl;
+}
+
+void testItemRules() {
+    std::cout << "Testing item rules..." << std::endl;
+
+    // The rules ADD_GAME_ITEM(S) share with imports
+    std::string error;
+    assert(ContentImporter::validItem("Word Matching", "cat=animal", error));
+    assert(!ContentImporter::validItem("Word Matching", "a;b", error) && error.find("';'") != std::string::npos);
+    assert(!ContentImporter::validItem("Word Matching", "a\nb", error));
+    assert(!ContentImporter::validItem("Word|Matching", "cat=animal", error));
+    assert(!ContentImporter::validItem("", "cat=animal", error) && !ContentImporter::validItem("G", "", error));
+    assert(ContentImporter::validItem("G", std::string(ContentImporter::MAX_ITEM_BYTES, 'x'), error));
+    assert(!ContentImporter::validItem("G", std::string(ContentImporter::MAX_ITEM_BYTES + 1, 'x'), error) &&
+           error == "item data too large");
+
+    std::cout << "✓ Item rule test passed" << std::endl;
+}
+
+void testLessonCatalog() {
+    std::cout << "Testing lesson catalog..." << std::endl;
+
+    LessonCatalog catalog;
+    catalog.addLessons({{"a", "A", "", ProficiencyLevel::BEGINNER},
+                        {"b", "B", "", ProficiencyLevel::BEGINNER},
+                        {"c", "C", "", ProficiencyLevel::BEGINNER}});
+
+    // Replaced in place, moved to another level, and the last of two records for an id wins
+    LessonCatalog::SnapshotPtr before = catalog.getSnapshot();
+    catalog.addLessons({{"a", "A2", "body", ProficiencyLevel::BEGINNER},
+                        {"b", "B2", "", ProficiencyLevel::ADVANCED},
+                        {"d", "D", "", ProficiencyLevel::BEGINNER},
+                        {"d", "D2", "", ProficiencyLevel::BEGINNER}});
+    LessonCatalog::SnapshotPtr after = catalog.getSnapshot();
+
+    assert((after->lists[0] == std::vector<std::string>{"a:A2", "c:C", "d:D2"}));
+    assert((after->lists[2] == std::vector<std::string>{"b:B2"}));
+    assert(after->lessons.at("a").body == "body" && after->version == before->version + 1);
+    assert(before->lists[0].size() == 3 && before->lessons.at("a").title == "A");   // old snapshot untouched
+
+    std::cout << "✓ Lesson catalog test passed" << std::endl;
+}
+
+void testNewItems() {
+    std::cout << "Testing duplicate-free item adds..." << std::endl;
+
+    GameCatalog catalog;
+    assert(catalog.addItem("G", "a=1", ProficiencyLevel::BEGINNER));
+    assert(!catalog.addItem("G", "a=1", ProficiencyLevel::ADVANCED));
+
+    // Already in the catalog or repeated in the list: only the first copy is added
+    std::vector<bool> kept;
+    auto added = catalog.addNewItems({{"G", GameItem("a=1", ProficiencyLevel::BEGINNER)},
+                                      {"G", GameItem("b=2", ProficiencyLevel::BEGINNER)},
+                                      {"G", GameItem("b=2", ProficiencyLevel::ADVANCED)},
+                                      {"H", GameItem("a=1", ProficiencyLevel::BEGINNER)}}, &kept);
+    assert(added.size() == 2 && added["G"].size() == 1 && added["H"].size() == 1);
+    assert((kept == std::vector<bool>{false, true, false, true}));
+    assert(catalog.getSnapshot("G")->items.size() == 2);
+
+    // Items added by a batch are duplicates for the next single add
+    assert(!catalog.addItem("G", "b=2", ProficiencyLevel::BEGINNER) && catalog.addItem("G", "c=3", ProficiencyLevel::BEGINNER));
+
+    // Concurrent imports of the same items add each of them once
+    std::vector<std::pair<std::string, GameItem>> items;
+    for (int i = 0; i < 500; ++i) {
+        items.emplace_back("Race", GameItem("w" + std::to_string(i) + "=x", ProficiencyLevel::BEGINNER));
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&catalog, items]() { catalog.addNewItems(items); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(catalog.getSnapshot("Race")->items.size() == 500);
+
+    std::cout << "✓ Duplicate-free add test passed" << std::endl;
+}
+
+void testSharedSnapshots() {
+    std::cout << "Testing snapshots that share storage..." << std::endl;
+
+    // Single adds extend the type in place; older snapshots keep seeing only their items
+    GameCatalog catalog;
+    GameCatalog::SnapshotPtr early;
+    for (int i = 0; i < 1000; ++i) {
+        ProficiencyLevel level = static_cast<ProficiencyLevel>(i % 3 + 1);
+        catalog.addItem("G", "w" + std::to_string(i), level);
+        if (i == 299) early = catalog.getSnapshot("G");
+    }
+    GameCatalog::SnapshotPtr late = catalog.getSnapshot("G");
+    assert(early->items.size() == 300 && early->upToLevel[2].size() == 300);
+    assert(late->items.size() == 1000 && late->exactLevel[0].size() == 334 && late->upToLevel[1].size() == 667);
+    for (size_t i = 0; i < late->items.size(); ++i) {
+        assert(late->items[i].data == "w" + std::to_string(i));
+        assert(i >= 300 || early->items[i].data == late->items[i].data);
+    }
+    for (uint32_t index : GameCatalog::sample(*early, ProficiencyLevel::ADVANCED, 50)) {
+        assert(index < 300 && early->items[index].level == ProficiencyLevel::ADVANCED);
+    }
+
+    // Two copies appended to separately do not see each other's items
+    SharedArray<std::string> base;
+    base.push_back("a");
+    SharedArray<std::string> left = base, right = base;
+    left.push_back("left");
+    right.push_back("right");
+    right.push_back("more");
+    assert(base.size() == 1 && left.size() == 2 && right.size() == 3);
+    assert(left[1] == "left" && right[1] == "right" && right[0] == "a");
+
+    std::cout << "✓ Shared snapshot test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Content Import Tests ===" << std::endl;
+
+    testCsv();
+    testJsonl();
+    testItemRules();
+    testLessonCatalog();
+    testNewItems();
+    testSharedSnapshots();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Test program for the password hashing primitives (published test vectors)
+
+#include "../src/utils/Crypto.hpp"
+#include <iostream>
+#include <cassert>
+
+std::string hexOf(const Crypto::Digest& digest) {
+    return Crypto::toHex(std::string(reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+void testSha256() {
+    std::cout << "Testing SHA-256..." << std::endl;
+
+    assert(hexOf(Crypto::sha256("")) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(hexOf(Crypto::sha256("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    assert(hexOf(Crypto::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    std::cout << "✓ SHA-256 test passed" << std::endl;
+}
+
+void testHmac() {
+    std::cout << "Testing HMAC-SHA256 (RFC 4231)..." << std::endl;
+
+    assert(hexOf(Crypto::hmacSha256("Jefe", "what do ya want for nothing?")) ==
+           "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    // Key longer than the block size is hashed first
+    assert(hexOf(Crypto::hmacSha256(std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First")) ==
+           "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+
+    std::cout << "✓ HMAC test passed" << std::endl;
+}
+
+void testPbkdf2() {
+    std::cout << "Testing PBKDF2-HMAC-SHA256..." << std::endl;
+
+    assert(Crypto::toHex(Crypto::pbkdf2HmacSha256("password", "salt", 1, 32)) ==
+           "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b");
+    assert(Crypto::toHex(Crypto::pbkdf2HmacSha256("password", "salt", 4096, 32)) ==
+           "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a");
+
+    std::cout << "✓ PBKDF2 test passed" << std::endl;
+}
+
+void testScrypt() {
+    std::cout << "Testing scrypt (RFC 7914)..." << std::endl;
+
+    assert(Crypto::toHex(Crypto::scrypt("", "", 16, 1, 1, 64)) ==
+           "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442"
+           "fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906");
+    assert(Crypto::toHex(Crypto::scrypt("password", "NaCl", 1024, 8, 16, 64)) ==
+           "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b373162"
+           "2eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640");
+
+    std::cout << "✓ scrypt test passed" << std::endl;
+}
+
+void testPasswordHashes() {
+    std::cout << "Testing password hash format..." << std::endl;
+
+    PasswordHashParams params;
+    params.n = 1024;
+
+    std::string first = Crypto::hashPassword("correct horse", params);
+    std::string second = Crypto::hashPassword("correct horse", params);
+
+    assert(first.compare(0, 13, "$scrypt$1024$") == 0);
+    assert(first != second);   // per-user random salt
+    assert(Crypto::verifyPassword("correct horse", first));
+    assert(Crypto::verifyPassword("correct horse", second));
+    assert(!Crypto::verifyPassword("correct horsf", first));
+    assert(!Crypto::verifyPassword("correct horse", "not a hash"));
+    assert(!Crypto::verifyPassword("correct horse", "$scrypt$1000$8$1$00$00"));   // n not a power of two
+
+    assert(!Crypto::needsRehash(first, params));
+    params.n = 2048;
+    assert(Crypto::needsRehash(first, params));
+
+    std::cout << "✓ Password hash test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Crypto Tests ===" << std::endl;
+
+    testSha256();
+    testHmac();
+    testPbkdf2();
+    testScrypt();
+    testPasswordHashes();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Test program for the vocabulary dictionary (DAWG image, completion, fuzzy lookup)
+
+#include "../src/db/Dictionary.hpp"
+#include "../src/utils/EditDistance.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <set>
+
+std::vector<std::pair<std::string, std::string>> sampleEntries() {
+    std::vector<std::pair<std::string, std::string>> entries;
+    const char* stems[] = {"walk", "talk", "play", "stay", "read", "cook", "look", "book", "work", "jump"};
+    const char* endings[] = {"", "s", "ed", "ing", "er", "ers"};
+    for (const char* stem : stems) {
+        for (const char* ending : endings) {
+            std::string word = std::string(stem) + ending;
+            entries.emplace_back(word, "gloss of " + word);
+        }
+    }
+    return entries;
+}
+
+std::shared_ptr<Dictionary> build(std::vector<std::pair<std::string, std::string>> entries) {
+    size_t rejected = 0;
+    auto dictionary = std::make_shared<Dictionary>();
+    std::string error;
+    bool assigned = dictionary->assign(Dictionary::compile(std::move(entries), rejected), error);
+    assert(assigned);
+    return dictionary;
+}
+
+void testLookup() {
+    std::cout << "Testing lookup..." << std::endl;
+
+    size_t rejected = 0;
+    std::string image = Dictionary::compile({{"Apple", "fruit"}, {"apple", "second"}, {"", "empty"},
+                                             {std::string(100, 'x'), "long"}, {"bad\nword", "ctl"}, {"a", "first"}},
+                                            rejected);
+    assert(rejected == 3);
+    Dictionary dictionary;
+    std::string error;
+    assert(dictionary.assign(image, error) && dictionary.size() == 2);
+
+    // Lower-cased, first gloss kept, only whole words
+    Dictionary::Match match;
+    assert(dictionary.lookup("APPLE", match) && match.word == "apple" && match.gloss == "fruit");
+    assert(dictionary.lookup("a", match) && match.gloss == "first");
+    assert(!dictionary.lookup("app", match) && !dictionary.lookup("apples", match) && !dictionary.lookup("", match));
+
+    // Shared suffixes are merged: 60 words need far fewer states than a trie
+    auto entries = sampleEntries();
+    std::shared_ptr<Dictionary> words = build(entries);
+    assert(words->size() == 60 && words->states() < 40);
+    for (const auto& entry : entries) {
+        assert(words->lookup(entry.first, match) && match.gloss == entry.second);
+    }
+
+    std::cout << "✓ Lookup test passed" << std::endl;
+}
+
+void testComplete() {
+    std::cout << "Testing completion..." << std::endl;
+
+    std::shared_ptr<Dictionary> dictionary = build(sampleEntries());
+    std::vector<Dictionary::Match> matches = dictionary->complete("Wor", 10);
+    std::vector<std::string> words;
+    for (const auto& match : matches) {
+        words.push_back(match.word);
+        assert(match.gloss == "gloss of " + match.word);
+    }
+    assert((words == std::vector<std::string>{"work", "worked", "worker", "workers", "working", "works"}));
+
+    assert(dictionary->complete("wa", 2).size() == 2 && dictionary->complete("wa", 2)[1].word == "walked");
+    assert(dictionary->complete("x", 10).empty());
+    assert(dictionary->complete("", 100).size() == 60);
+
+    std::cout << "✓ Completion test passed" << std::endl;
+}
+
+void testFuzzy() {
+    std::cout << "Testing fuzzy lookup..." << std::endl;
+
+    auto entries = sampleEntries();
+    std::shared_ptr<Dictionary> dictionary = build(entries);
+
+    // Same results as checking every word
+    for (const char* query : {"wlak", "talkd", "boook", "x", "jumpng", "readers", ""}) {
+        for (size_t distance = 0; distance <= 2; ++distance) {
+            EditDistancePattern pattern(query);
+            std::set<std::pair<size_t, std::string>> expected;
+            for (const auto& entry : entries) {
+                size_t d = pattern.levenshtein(entry.first, distance);
+                if (d <= distance) expected.emplace(d, entry.first);
+            }
+            std::vector<Dictionary::Match> matches = dictionary->fuzzy(query, distance, 100);
+            assert(matches.size() == expected.size());
+            auto it = expected.begin();
+            for (const auto& match : matches) {
+                assert(match.distance == it->first && match.word == it->second);
+                assert(match.gloss == "gloss of " + match.word);
+                ++it;
+            }
+        }
+    }
+
+    // Closest first, then alphabetical, cut at the limit
+    std::vector<Dictionary::Match> matches = dictionary->fuzzy("look", 1, 2);
+    assert(matches.size() == 2 && matches[0].word == "look" && matches[1].word == "book");
+
+    std::cout << "✓ Fuzzy test passed" << std::endl;
+}
+
+void testFiles() {
+    std::cout << "Testing word list and image files..." << std::endl;
+
+    std::string listPath = "test_dictionary_words.txt";
+    std::string imagePath = listPath + ".dict";
+    {
+        std::ofstream list(listPath);
+        list << "# vocabulary\n\nhouse\tcasa\nDog = perro\ncat\n";
+    }
+    std::remove(imagePath.c_str());
+
+    std::string error;
+    std::shared_ptr<const Dictionary> dictionary = Dictionary::load(listPath, error);
+    assert(dictionary && dictionary->size() == 3);
+    assert(std::filesystem::exists(imagePath) && !std::filesystem::exists(imagePath + ".tmp"));
+    Dictionary::Match match;
+    assert(dictionary->lookup("dog", match) && match.gloss == "perro");
+    assert(dictionary->lookup("cat", match) && match.gloss.empty());
+
+    // The compiled image maps directly
+    dictionary = Dictionary::load(imagePath, error);
+    assert(dictionary && dictionary->lookup("house", match) && match.gloss == "casa");
+
+    // A cut image is refused
+    std::string image;
+    {
+        std::ifstream in(imagePath, std::ios::binary);
+        image.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    Dictionary broken;
+    assert(!broken.assign(image.substr(0, image.size() - 1), error));
+    assert(!broken.assign("not a dictionary", error));
+
+    // Sections with the right sizes but inconsistent contents are refused too
+    uint32_t fields[5];   // states, arcs, words, root, glossBytes
+    std::memcpy(fields, image.data() + 8, sizeof(fields));
+    size_t firstArcs = 28;
+    size_t counts = firstArcs + 4 * (fields[0] + 1);
+    size_t targets = counts + 4 * fields[0];
+    size_t glossOffsets = targets + 4 * fields[1];
+    auto corrupted = [&image](size_t offset, uint32_t value) {
+        std::string copy = image;
+        std::memcpy(&copy[offset], &value, sizeof(value));
+        return copy;
+    };
+    assert(!broken.assign(corrupted(targets, fields[0]), error));
+    assert(!broken.assign(corrupted(targets + 4 * (fields[1] - 1), fields[3]), error));   // a cycle
+    assert(!broken.assign(corrupted(firstArcs + 4, fields[1] + 1), error));
+    assert(!broken.assign(corrupted(counts + 4 * fields[3], fields[2] + 1), error));
+    assert(!broken.assign(corrupted(glossOffsets + 4, 7), error));
+    assert(!broken.assign(corrupted(8 + 12, fields[0]), error));   // the root
+
+    std::remove(listPath.c_str());
+    std::remove(imagePath.c_str());
+    std::cout << "✓ File test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Dictionary Tests ===" << std::endl;
+
+    testLookup();
+    testComplete();
+    testFuzzy();
+    testFiles();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Test program for bounded edit distance (bit-parallel and banded DP paths)
+
+#include "../src/utils/EditDistance.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+
+// Reference optimal string alignment / Levenshtein distance (full DP)
+size_t referenceDistance(const std::string& a, const std::string& b, bool transpositions) {
+    std::vector<std::vector<size_t>> d(a.size() + 1, std::vector<size_t>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i) d[i][0] = i;
+    for (size_t j = 0; j <= b.size(); ++j) d[0][j] = j;
+
+    for (size_t i = 1; i <= a.size(); ++i) {
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost});
+            if (transpositions && i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+void testKnownDistances() {
+    std::cout << "Testing known distances..." << std::endl;
+
+    EditDistancePattern kitten("kitten");
+    assert(kitten.levenshtein("sitting", 10) == 3);
+    assert(kitten.levenshtein("kitten", 10) == 0);
+    assert(kitten.levenshtein("sitting", 2) == 3);   // bounded: maxDistance + 1
+
+    EditDistancePattern receive("receive");
+    assert(receive.levenshtein("recieve", 5) == 2);
+    assert(receive.damerau("recieve", 5) == 1);
+
+    EditDistancePattern empty("");
+    assert(empty.levenshtein("abc", 5) == 3);
+
+    std::cout << "✓ Known distances test passed" << std::endl;
+}
+
+void testAgainstReference() {
+    std::cout << "Testing random strings against reference DP..." << std::endl;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> letter('a', 'd');
+
+    for (int round = 0; round < 2000; ++round) {
+        size_t lenA = rng() % 90;   // covers both the bit-parallel and banded DP paths
+        size_t lenB = lenA + (rng() % 7) - 3;
+        if (lenB > 100) lenB = 0;
+
+        std::string a, b;
+        for (size_t i = 0; i < lenA; ++i) a += static_cast<char>(letter(rng));
+        b = a.substr(0, std::min(lenA, lenB));
+        while (b.size() < lenB) b += static_cast<char>(letter(rng));
+        for (size_t k = 0; k < 3 && !b.empty(); ++k) b[rng() % b.size()] = static_cast<char>(letter(rng));
+
+        EditDistancePattern pattern(a);
+        size_t bound = rng() % 8;
+        for (bool transpositions : {false, true}) {
+            size_t expected = std::min(referenceDistance(a, b, transpositions), bound + 1);
+            size_t actual = transpositions ? pattern.damerau(b, bound) : pattern.levenshtein(b, bound);
+            assert(actual == expected);
+        }
+    }
+
+    std::cout << "✓ Reference comparison test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Edit Distance Tests ===" << std::endl;
+
+    testKnownDistances();
+    testAgainstReference();
+
+    std::cout << "\n=== All tests passed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Test program for the per-user feedback log (cursor reads, page limits)
+
+#include "../src/db/FeedbackLog.hpp"
+#include <iostream>
+#include <cassert>
+
+// Read the whole log page by page, checking every page against the limits
+size_t readAll(const FeedbackLog& log, const std::string& username, size_t limit, size_t maxBytes,
+               size_t& pages) {
+    uint64_t after = 0;
+    pages = 0;
+    while (true) {
+        bool more = false;
+        std::vector<FeedbackEntry> page = log.readAfter(username, after, limit, maxBytes, more);
+        if (page.empty()) {
+            assert(!more);
+            return static_cast<size_t>(after);
+        }
+        ++pages;
+        assert(page.size() <= limit);
+
+        size_t bytes = 0;
+        for (const FeedbackEntry& entry : page) {
+            assert(entry.id == ++after);
+            bytes += FeedbackLog::pageBytes(entry);
+        }
+        assert(bytes <= maxBytes || page.size() == 1);
+        if (!more) return static_cast<size_t>(after);
+    }
+}
+
+void testCursor() {
+    std::cout << "Testing cursor reads..." << std::endl;
+
+    FeedbackLog log;
+    for (int i = 1; i <= 10; ++i) {
+        assert(log.append("alice", "note " + std::to_string(i)) == static_cast<uint64_t>(i));
+    }
+    log.appendAll({{"bob", "first"}, {"alice", "note 11"}});
+
+    bool more = false;
+    std::vector<FeedbackEntry> page = log.readAfter("alice", 0, 4, 8192, more);
+    assert(page.size() == 4 && page.front().id == 1 && page.back().text == "note 4" && more);
+    page = log.readAfter("alice", 8, 4, 8192, more);
+    assert(page.size() == 3 && page.back().id == 11 && !more);
+    assert(log.readAfter("alice", 11, 4, 8192, more).empty() && !more);
+    assert(log.readAfter("carol", 0, 4, 8192, more).empty() && !more);
+
+    size_t pages = 0;
+    assert(readAll(log, "alice", 3, 8192, pages) == 11 && pages == 4);
+    assert(readAll(log, "bob", 3, 8192, pages) == 1 && pages == 1);
+
+    std::cout << "✓ Cursor test passed" << std::endl;
+}
+
+void testLargeNotes() {
+    std::cout << "Testing pages of large notes..." << std::endl;
+
+    // Notes of a few kilobytes: a page holds only as many as fit the byte budget
+    FeedbackLog log;
+    for (int i = 0; i < 20; ++i) {
+        log.append("alice", std::string(3000 + i * 50, static_cast<char>('a' + i)));
+    }
+
+    const size_t budget = 8160;
+    bool more = false;
+    std::vector<FeedbackEntry> page = log.readAfter("alice", 0, 200, budget, more);
+    assert(page.size() == 2 && more);
+    assert(page[1].text == std::string(3050, 'b'));
+
+    size_t pages = 0;
+    assert(readAll(log, "alice", 200, budget, pages) == 20 && pages == 10);
+
+    // An entry larger than the budget still goes out alone, so the reader moves on
+    log.append("bob", "short");
+    log.append("bob", std::string(10000, 'x'));
+    log.append("bob", "after");
+    page = log.readAfter("bob", 0, 200, budget, more);
+    assert(page.size() == 1 && page[0].text == "short" && more);
+    page = log.readAfter("bob", 1, 200, budget, more);
+    assert(page.size() == 1 && page[0].text.size() == 10000 && more);
+    page = log.readAfter("bob", 2, 200, budget, more);
+    assert(page.size() == 1 && page[0].text == "after" && !more);
+
+    std::cout << "✓ Large note test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Feedback Log Tests ===" << std::endl;
+
+    testCursor();
+    testLargeNotes();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
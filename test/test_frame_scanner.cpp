@@ -0,0 +1,93 @@
+// Test program for frame and delimiter scanning
+
+#include "../src/protocol/FrameScanner.hpp"
+#include <iostream>
+#include <cassert>
+
+void testFindAny() {
+    std::cout << "Testing delimiter search (" << FrameScanner::implementation() << ")..." << std::endl;
+
+    // Every length and position, so both the vector loop and the scalar tail are covered
+    for (size_t size = 0; size < 80; ++size) {
+        std::string data(size, 'x');
+        assert(FrameScanner::findAny(data.data(), data.size(), '|', '\n') == size);
+        for (size_t at = 0; at < size; ++at) {
+            std::string hit = data;
+            hit[at] = at % 2 ? '|' : '\n';
+            if (at + 3 < size) hit[at + 3] = '|';
+            assert(FrameScanner::findAny(hit.data(), hit.size(), '|', '\n') == at);
+            assert(FrameScanner::find(hit.data(), hit.size(), hit[at]) == at);
+        }
+    }
+
+    std::cout << "✓ Delimiter search test passed" << std::endl;
+}
+
+void testParseFrame() {
+    std::cout << "Testing frame parsing..." << std::endl;
+
+    MessageHeader header;
+    std::string_view payload;
+    size_t length = 0;
+
+    // Payloads are taken by length, so they may hold delimiters
+    std::string frame = "786|9|7|a|b\nc|d\ne\n273|0|8|\n";
+    assert(FrameScanner::parseFrame(frame, header, payload, length) == FrameStatus::COMPLETE);
+    assert(header.type == MessageType::GET_LESSON_CONTENT_RESPONSE);
+    assert(header.sequenceNumber == 7);
+    assert(payload == "a|b\nc|d\ne");
+    assert(length == 18);
+    assert(FrameScanner::parseFrame(std::string_view(frame).substr(length), header, payload, length) == FrameStatus::COMPLETE);
+    assert(header.type == MessageType::LOGIN_REQUEST && payload.empty() && header.sequenceNumber == 8);
+
+    assert(FrameScanner::parseFrame("2305|2|1|pi\r\n", header, payload, length) == FrameStatus::COMPLETE);
+    assert(payload == "pi" && length == 13);
+
+    // Split anywhere: never complete early, never malformed
+    for (size_t cut = 0; cut < 18; ++cut) {
+        assert(FrameScanner::parseFrame(std::string_view(frame).substr(0, cut), header, payload, length) ==
+               FrameStatus::INCOMPLETE);
+    }
+
+    // Malformed frames are skipped up to the next newline
+    assert(FrameScanner::parseFrame("hello\n273|0|1|\n", header, payload, length) == FrameStatus::MALFORMED);
+    assert(length == 6);
+    assert(FrameScanner::parseFrame("27x|0|1|\n", header, payload, length) == FrameStatus::MALFORMED);
+    assert(length == 9);
+    assert(FrameScanner::parseFrame("273|3|1|toolong\n", header, payload, length) == FrameStatus::MALFORMED);
+    assert(length == 16);
+    assert(FrameScanner::parseFrame("273|9000|1|x\n", header, payload, length) == FrameStatus::MALFORMED);
+    assert(FrameScanner::parseFrame("70000|0|1|\n", header, payload, length) == FrameStatus::MALFORMED);
+    assert(FrameScanner::parseFrame(std::string(40, '7'), header, payload, length) == FrameStatus::MALFORMED);
+    assert(length == 40);
+
+    std::cout << "✓ Frame parsing test passed" << std::endl;
+}
+
+void testDeserialize() {
+    std::cout << "Testing header parsing without exceptions..." << std::endl;
+
+    Message message = Message::deserialize("273|9|42|user|pass");
+    assert(message.header.type == MessageType::LOGIN_REQUEST);
+    assert(message.header.payloadLength == 9);
+    assert(message.header.sequenceNumber == 42);
+    assert(message.payload == "user|pass");
+
+    assert(Message::deserialize("273|9").header.type == MessageType::UNKNOWN);
+    assert(Message::deserialize("abc|9|1|x").header.type == MessageType::UNKNOWN);
+    assert(Message::deserialize("273|-1|1|x").header.type == MessageType::UNKNOWN);
+    assert(Message::deserialize("273|1|99999999999|x").header.type == MessageType::UNKNOWN);
+
+    std::cout << "✓ Header parsing test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Frame Scanner Tests ===" << std::endl;
+
+    testFindAny();
+    testParseFrame();
+    testDeserialize();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
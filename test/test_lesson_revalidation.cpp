@@ -0,0 +1,125 @@
+// Test program for lesson content revalidation against a scripted server
+
+#include "../src/client/Client.hpp"
+#include <iostream>
+#include <cassert>
+#include <thread>
+
+// Answers lesson requests like the server does: NOT_MODIFIED when the client sends the
+// current version, the content otherwise. The version moves only when the test says so.
+class LessonServer {
+public:
+    std::atomic<uint64_t> version{5};
+    std::atomic<int> contentRequests{0};
+    std::atomic<uint64_t> lastSentVersion{0};   // the version the client's last content request carried
+
+    bool start() {
+        Network::initialize();
+        listener_ = Network::createSocket();
+        Network::setSocketOption(listener_, SOL_SOCKET, SO_REUSEADDR, 1);
+        if (!Network::bindSocket(listener_, "127.0.0.1", PORT) || !Network::listenSocket(listener_)) {
+            return false;
+        }
+        thread_ = std::thread(&LessonServer::serve, this);
+        return true;
+    }
+
+    void stop() {
+        if (thread_.joinable()) thread_.join();
+        Network::closeSocket(listener_);
+    }
+
+    static constexpr int PORT = 9766;
+
+private:
+    void serve() {
+        std::string address;
+        int port = 0;
+        SOCKET client = Network::acceptConnection(listener_, address, port);
+        Protocol protocol;
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            int received = Network::receiveData(client, chunk, sizeof(chunk));
+            if (received <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(received));
+            for (const Message& request : protocol.extractMessages(buffer)) {
+                Message reply = answer(request);
+                reply.header.sequenceNumber = request.header.sequenceNumber;
+                std::string bytes = protocol.encodeMessage(reply);
+                Network::sendData(client, bytes.data(), bytes.size());
+            }
+        }
+        Network::closeSocket(client);
+    }
+
+    Message answer(const Message& request) {
+        uint64_t current = version.load();
+        if (request.header.type == MessageType::GET_LESSON_LIST_REQUEST) {
+            std::vector<std::string> lessons = {"lesson_b1:Greetings"};
+            VersionedList list;
+            list.version = current;
+            list.items = PayloadCodec::List<std::string_view>::of(lessons);
+            return Message(MessageType::GET_LESSON_LIST_RESPONSE,
+                           PayloadCodec::encode<MessageType::GET_LESSON_LIST_RESPONSE>(list));
+        }
+
+        LessonQuery query;
+        assert(request.header.type == MessageType::GET_LESSON_CONTENT_REQUEST);
+        assert(PayloadCodec::decode<MessageType::GET_LESSON_CONTENT_REQUEST>(request.payload, query));
+        contentRequests++;
+        lastSentVersion = query.version;
+        if (query.version == current) {
+            ContentVersion same;
+            same.version = current;
+            return Message(MessageType::NOT_MODIFIED, PayloadCodec::encode<MessageType::NOT_MODIFIED>(same));
+        }
+
+        std::string text = "Lesson text v" + std::to_string(current);
+        LessonContent content;
+        content.version = current;
+        content.text = text;
+        return Message(MessageType::GET_LESSON_CONTENT_RESPONSE,
+                       PayloadCodec::encode<MessageType::GET_LESSON_CONTENT_RESPONSE>(content));
+    }
+
+    SOCKET listener_ = INVALID_SOCKET;
+    std::thread thread_;
+};
+
+void testChangedLessonIsRefetched() {
+    std::cout << "Testing a lesson that changed after the list was fetched..." << std::endl;
+
+    LessonServer server;
+    assert(server.start());
+    Client client;
+    assert(client.connect("127.0.0.1", LessonServer::PORT));
+
+    // Content, then a list at the same version: the client holds both at version 5
+    assert(client.getLessonContent("lesson_b1") == "Lesson text v5");
+    assert(server.lastSentVersion == 0);
+    assert(client.getLessonList().size() == 1);
+
+    // The lesson changes on the server; the client has not listed lessons since
+    server.version = 6;
+    assert(client.getLessonContent("lesson_b1") == "Lesson text v6");
+    assert(server.contentRequests == 2 && server.lastSentVersion == 5);
+
+    // Unchanged now: the server answers NOT_MODIFIED and the kept text is used
+    assert(client.getLessonContent("lesson_b1") == "Lesson text v6");
+    assert(server.contentRequests == 3 && server.lastSentVersion == 6);
+
+    client.disconnect();
+    server.stop();
+
+    std::cout << "✓ Changed lesson test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Lesson Revalidation Tests ===" << std::endl;
+
+    testChangedLessonIsRefetched();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
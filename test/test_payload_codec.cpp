@@ -0,0 +1,251 @@
+// Test program for schema-encoded payloads
+
+#include "../src/protocol/Payloads.hpp"
+#include <iostream>
+#include <cassert>
+
+void testVarints() {
+    std::cout << "Testing varints..." << std::endl;
+
+    for (uint64_t value : {0ULL, 1ULL, 127ULL, 128ULL, 300ULL, 16383ULL, 16384ULL, ~0ULL}) {
+        std::string out;
+        PayloadCodec::putVarint(out, value);
+        assert(out.size() == (value == ~0ULL ? 10 : value < 128 ? 1 : value < 16384 ? 2 : 3));
+        std::string_view in(out);
+        uint64_t decoded = 0;
+        assert(PayloadCodec::getVarint(in, decoded) && decoded == value && in.empty());
+    }
+
+    // Truncated and over-long encodings are rejected
+    std::string_view truncated("\x80\x80", 2);
+    uint64_t value = 0;
+    assert(!PayloadCodec::getVarint(truncated, value));
+    std::string_view overlong("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x02", 10);
+    assert(!PayloadCodec::getVarint(overlong, value));
+
+    // Zigzag keeps small negative numbers short
+    for (int32_t number : {0, -1, 1, -64, 63, -2147483647 - 1, 2147483647}) {
+        std::string out;
+        PayloadCodec::Codec<int32_t>::put(out, number);
+        if (number >= -64 && number <= 63) assert(out.size() == 1);
+        std::string_view in(out);
+        int32_t decoded = 0;
+        assert(PayloadCodec::Codec<int32_t>::get(in, decoded) && decoded == number);
+    }
+
+    std::cout << "✓ Varint test passed" << std::endl;
+}
+
+void testRecords() {
+    std::cout << "Testing records..." << std::endl;
+
+    // Delimiters and newlines in text need no escaping
+    FeedbackNote note{"student1", "ex|1", "Good work;\nbut check | and ;"};
+    std::string payload = PayloadCodec::encode<MessageType::SEND_FEEDBACK_REQUEST>(note);
+
+    FeedbackNote decoded;
+    assert(PayloadCodec::decode<MessageType::SEND_FEEDBACK_REQUEST>(payload, decoded));
+    assert(decoded.student == "student1" && decoded.exerciseId == "ex|1" && decoded.text == note.text);
+    assert(decoded.text.data() >= payload.data() && decoded.text.data() < payload.data() + payload.size());
+
+    // Every truncation and any trailing byte is an error
+    for (size_t size = 0; size < payload.size(); ++size) {
+        assert(!PayloadCodec::decode<MessageType::SEND_FEEDBACK_REQUEST>(std::string_view(payload).substr(0, size), decoded));
+    }
+    assert(!PayloadCodec::decode<MessageType::SEND_FEEDBACK_REQUEST>(payload + "x", decoded));
+
+    // The known version is a field of its own: an id that looks like one stays the id
+    LessonQuery query{"v2", 7};
+    payload = PayloadCodec::encode<MessageType::GET_LESSON_CONTENT_REQUEST>(query);
+    LessonQuery decodedQuery;
+    assert(PayloadCodec::decode<MessageType::GET_LESSON_CONTENT_REQUEST>(payload, decodedQuery));
+    assert(decodedQuery.lessonId == "v2" && decodedQuery.version == 7);
+
+    std::cout << "✓ Record test passed" << std::endl;
+}
+
+void testLists() {
+    std::cout << "Testing lists..." << std::endl;
+
+    std::vector<std::string> lessons = {"lesson_b1:Greetings; hello", "", "lesson_b2:Numbers|Time"};
+    VersionedList list;
+    list.version = 1700000000000042ULL;
+    list.items = PayloadCodec::List<std::string_view>::of(lessons);
+    std::string payload = PayloadCodec::encode<MessageType::GET_LESSON_LIST_RESPONSE>(list);
+
+    VersionedList decoded;
+    assert(PayloadCodec::decode<MessageType::GET_LESSON_LIST_RESPONSE>(payload, decoded));
+    assert(decoded.version == list.version);
+    assert(decoded.items.size() == 3);
+    std::vector<std::string> items(decoded.items.begin(), decoded.items.end());
+    assert(items == lessons);
+
+    // Nested records, and re-encoding a decoded list gives the same bytes
+    std::vector<LeaderboardEntry> entries = {{1, "alice", 950}, {2, "bob", -5}};
+    LeaderboardPage page;
+    page.board = "global";
+    page.rank = 2;
+    page.total = 40;
+    page.entries = PayloadCodec::List<LeaderboardEntry>::of(entries);
+    payload = PayloadCodec::encode<MessageType::GET_LEADERBOARD_RESPONSE>(page);
+
+    LeaderboardPage decodedPage;
+    assert(PayloadCodec::decode<MessageType::GET_LEADERBOARD_RESPONSE>(payload, decodedPage));
+    assert(decodedPage.board == "global" && decodedPage.rank == 2 && decodedPage.total == 40);
+    size_t row = 0;
+    for (const LeaderboardEntry& entry : decodedPage.entries) {
+        assert(entry.rank == entries[row].rank && entry.username == entries[row].username &&
+               entry.score == entries[row].score);
+        ++row;
+    }
+    assert(row == 2);
+    assert(PayloadCodec::encode<MessageType::GET_LEADERBOARD_RESPONSE>(decodedPage) == payload);
+
+    // Batch records; a level that does not fit its uint8_t field is malformed
+    std::vector<GameItemRecord> records = {{"Word Matching", "cat=animal", 1}, {"Picture Matching", "a.png=A", 3}};
+    GameItemBatch batch;
+    batch.items = PayloadCodec::List<GameItemRecord>::of(records);
+    payload = PayloadCodec::encode<MessageType::ADD_GAME_ITEMS_REQUEST>(batch);
+
+    GameItemBatch decodedBatch;
+    assert(PayloadCodec::decode<MessageType::ADD_GAME_ITEMS_REQUEST>(payload, decodedBatch));
+    assert(decodedBatch.items.size() == 2);
+    row = 0;
+    for (const GameItemRecord& record : decodedBatch.items) {
+        assert(record.gameType == records[row].gameType && record.data == records[row].data &&
+               record.level == records[row].level);
+        ++row;
+    }
+    std::string wide = payload.substr(0, payload.size() - 1);
+    PayloadCodec::putVarint(wide, 300);
+    assert(!PayloadCodec::decode<MessageType::ADD_GAME_ITEMS_REQUEST>(wide, decodedBatch));
+
+    // A count larger than the bytes left cannot be valid
+    std::string bogus;
+    PayloadCodec::putVarint(bogus, 1000);
+    TextList reviews;
+    assert(!PayloadCodec::decode<MessageType::GET_REVIEW_QUEUE_RESPONSE>(bogus, reviews));
+
+    std::cout << "✓ List test passed" << std::endl;
+}
+
+void testSeparatorsInFields() {
+    std::cout << "Testing fields that contain separators..." << std::endl;
+
+    // Answers that used to be split on ';' and '|' come back whole
+    std::vector<std::string> answers = {"B", "a;b", "free|text\nsecond line", ""};
+    QuizSubmission submission;
+    submission.quizId = "quiz|1";
+    submission.answers = PayloadCodec::List<std::string_view>::of(answers);
+    std::string payload = PayloadCodec::encode<MessageType::SUBMIT_QUIZ_REQUEST>(submission);
+
+    QuizSubmission decodedSubmission;
+    assert(PayloadCodec::decode<MessageType::SUBMIT_QUIZ_REQUEST>(payload, decodedSubmission));
+    assert(decodedSubmission.quizId == "quiz|1");
+    assert(std::vector<std::string>(decodedSubmission.answers.begin(), decodedSubmission.answers.end()) == answers);
+
+    QuizResult result;
+    result.score = -3;
+    result.correct = 1;
+    result.total = 4;
+    result.perQuestion = "1000";
+    payload = PayloadCodec::encode<MessageType::SUBMIT_QUIZ_RESPONSE>(result);
+    QuizResult decodedResult;
+    assert(PayloadCodec::decode<MessageType::SUBMIT_QUIZ_RESPONSE>(payload, decodedResult));
+    assert(decodedResult.score == -3 && decodedResult.correct == 1 && decodedResult.total == 4 &&
+           decodedResult.perQuestion == "1000");
+
+    ExerciseSubmission exercise;
+    exercise.exerciseId = "ex_1";
+    exercise.answer = "Dear Sir|Madam;\nI write...";
+    payload = PayloadCodec::encode<MessageType::SUBMIT_EXERCISE_REQUEST>(exercise);
+    ExerciseSubmission decodedExercise;
+    assert(PayloadCodec::decode<MessageType::SUBMIT_EXERCISE_REQUEST>(payload, decodedExercise));
+    assert(decodedExercise.exerciseId == "ex_1" && decodedExercise.answer == exercise.answer);
+
+    ExerciseResult grade;
+    grade.score = 5;
+    grade.distance = 2;
+    payload = PayloadCodec::encode<MessageType::SUBMIT_EXERCISE_RESPONSE>(grade);
+    ExerciseResult decodedGrade;
+    assert(PayloadCodec::decode<MessageType::SUBMIT_EXERCISE_RESPONSE>(payload, decodedGrade));
+    assert(decodedGrade.score == 5 && !decodedGrade.correct && decodedGrade.distance == 2);
+
+    RecordingStart start;
+    start.sentenceId = "s|1;\n";
+    start.sampleRate = 16000;
+    start.reference = true;
+    payload = PayloadCodec::encode<MessageType::PRONUNCIATION_START_REQUEST>(start);
+    RecordingStart decodedStart;
+    assert(PayloadCodec::decode<MessageType::PRONUNCIATION_START_REQUEST>(payload, decodedStart));
+    assert(decodedStart.sentenceId == "s|1;\n" && decodedStart.sampleRate == 16000 && decodedStart.reference);
+
+    PronunciationScore score;
+    score.score = 72;
+    score.similarity = 81;
+    score.frames = 5000000000ULL;
+    payload = PayloadCodec::encode<MessageType::PRONUNCIATION_RESULT>(score);
+    PronunciationScore decodedScore;
+    assert(PayloadCodec::decode<MessageType::PRONUNCIATION_RESULT>(payload, decodedScore));
+    assert(decodedScore.score == 72 && decodedScore.similarity == 81 && decodedScore.frames == score.frames);
+
+    // Game items join prompt and answer with '=' and may hold ';' or '|' themselves
+    GameQuery query;
+    query.gameType = "Word|Matching";
+    query.itemCount = 20;
+    payload = PayloadCodec::encode<MessageType::GAME_START_REQUEST>(query);
+    GameQuery decodedQuery;
+    assert(PayloadCodec::decode<MessageType::GAME_START_REQUEST>(payload, decodedQuery));
+    assert(decodedQuery.gameType == "Word|Matching" && decodedQuery.itemCount == 20);
+
+    std::vector<std::string> items = {"cat=animal;pet", "a|b=c", "line\nbreak=x"};
+    GameDeal deal;
+    deal.sessionId = 1ULL << 40;
+    deal.items = PayloadCodec::List<std::string_view>::of(items);
+    payload = PayloadCodec::encode<MessageType::GAME_START_RESPONSE>(deal);
+    GameDeal decodedDeal;
+    assert(PayloadCodec::decode<MessageType::GAME_START_RESPONSE>(payload, decodedDeal));
+    assert(decodedDeal.sessionId == deal.sessionId);
+    assert(std::vector<std::string>(decodedDeal.items.begin(), decodedDeal.items.end()) == items);
+
+    GameItemRecord item{"Sentence Matching", "I have; you have|=tengo", 2};
+    payload = PayloadCodec::encode<MessageType::ADD_GAME_ITEM_REQUEST>(item);
+    GameItemRecord decodedItem;
+    assert(PayloadCodec::decode<MessageType::ADD_GAME_ITEM_REQUEST>(payload, decodedItem));
+    assert(decodedItem.gameType == item.gameType && decodedItem.data == item.data && decodedItem.level == 2);
+
+    CallOffer offer;
+    offer.callId = 9;
+    offer.user = "bob|admin";
+    payload = PayloadCodec::encode<MessageType::VOICE_CALL_REQUEST>(offer);
+    CallOffer decodedOffer;
+    assert(PayloadCodec::decode<MessageType::VOICE_CALL_REQUEST>(payload, decodedOffer));
+    assert(decodedOffer.callId == 9 && decodedOffer.user == "bob|admin");
+
+    CallAnswer answer;
+    answer.callId = 9;
+    answer.relayPort = 9556;
+    answer.token = 0xFFFFFFFFu;
+    payload = PayloadCodec::encode<MessageType::VOICE_CALL_ACCEPT>(answer);
+    CallAnswer decodedAnswer;
+    assert(PayloadCodec::decode<MessageType::VOICE_CALL_ACCEPT>(payload, decodedAnswer));
+    assert(decodedAnswer.callId == 9 && decodedAnswer.relayPort == 9556 && decodedAnswer.token == 0xFFFFFFFFu);
+
+    // The old text forms are not valid payloads
+    assert(!PayloadCodec::decode<MessageType::SUBMIT_QUIZ_REQUEST>("quiz_1|A;B", decodedSubmission));
+    assert(!PayloadCodec::decode<MessageType::VOICE_CALL_ACCEPT>("9", decodedAnswer));
+
+    std::cout << "✓ Separator test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Payload Codec Tests ===" << std::endl;
+
+    testVarints();
+    testRecords();
+    testLists();
+    testSeparatorsInFields();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
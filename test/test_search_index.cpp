@@ -0,0 +1,145 @@
+// Test program for the full-text search index (posting lists, merges, BM25 ranking)
+
+#include "../src/db/SearchIndex.hpp"
+#include <iostream>
+#include <cassert>
+
+std::vector<SearchIndex::Hit> find(const SearchIndex& index, const std::string& query, uint8_t level = 0,
+                                   size_t limit = 10) {
+    size_t matches = 0;
+    static SearchIndex::SnapshotPtr snapshot;   // keeps the hits' documents alive
+    snapshot = index.getSnapshot();
+    return SearchIndex::search(*snapshot, query, level, limit, matches);
+}
+
+void testTokenize() {
+    std::cout << "Testing tokenizer..." << std::endl;
+
+    std::vector<std::string> words = SearchIndex::tokenize("Hello, WORLD! cat=animal caf\xc3\xa9 x2");
+    assert((words == std::vector<std::string>{"hello", "world", "cat", "animal", "caf\xc3\xa9", "x2"}));
+    assert(SearchIndex::tokenize(" ,;- ").empty());
+    assert(SearchIndex::tokenize(std::string(100, 'a'))[0].size() == SearchIndex::MAX_TERM_BYTES);
+
+    std::cout << "✓ Tokenizer test passed" << std::endl;
+}
+
+void testRanking() {
+    std::cout << "Testing ranking..." << std::endl;
+
+    SearchIndex index;
+    index.addLessons({{"l1", "Food and Cooking", "Recipes for soup and bread", ProficiencyLevel::INTERMEDIATE},
+                      {"l2", "Travel", "Ordering food at a restaurant", ProficiencyLevel::BEGINNER}});
+    index.addItems({{"Word Matching", {GameItem("apple=fruit", ProficiencyLevel::BEGINNER),
+                                       GameItem("bread=food", ProficiencyLevel::BEGINNER)}}});
+
+    // A title word outweighs a body word; every query word must match
+    std::vector<SearchIndex::Hit> hits = find(index, "FOOD");
+    assert(hits.size() == 3);
+    auto rankOf = [&hits](const std::string& title) {
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (hits[i].document->title == title) return i;
+        }
+        return hits.size();
+    };
+    assert(rankOf("Food and Cooking") < rankOf("Travel"));
+    hits = find(index, "food bread");
+    assert(hits.size() == 2);
+    hits = find(index, "soup restaurant");
+    assert(hits.empty());
+    hits = find(index, "apple");
+    assert(hits.size() == 1 && hits[0].document->kind == SearchKind::GAME_ITEM &&
+           hits[0].document->title == "apple=fruit" && hits[0].document->key == "Word Matching");
+
+    // Level filter and limit
+    hits = find(index, "food", 2);
+    assert(hits.size() == 1 && hits[0].document->key == "l1");
+    size_t matches = 0;
+    SearchIndex::SnapshotPtr snapshot = index.getSnapshot();
+    hits = SearchIndex::search(*snapshot, "food", 0, 1, matches);
+    assert(hits.size() == 1 && matches == 3);
+
+    std::cout << "✓ Ranking test passed" << std::endl;
+}
+
+void testIncremental() {
+    std::cout << "Testing incremental updates..." << std::endl;
+
+    // Single items one at a time: segments merge, and long lists span many blocks
+    SearchIndex index;
+    for (int i = 0; i < 1000; ++i) {
+        std::string data = "word" + std::to_string(i) + (i % 3 == 0 ? " fizz" : "") + (i % 5 == 0 ? " buzz" : "");
+        index.addItems({{"G", {GameItem(data, ProficiencyLevel::BEGINNER)}}});
+    }
+    SearchIndex::SnapshotPtr snapshot = index.getSnapshot();
+    assert(snapshot->segments.size() <= 10 && snapshot->liveDocuments == 1000);
+
+    size_t matches = 0;
+    SearchIndex::search(*snapshot, "fizz buzz", 0, 5, matches);
+    assert(matches == 67);
+    std::vector<SearchIndex::Hit> hits = SearchIndex::search(*snapshot, "word999", 0, 5, matches);
+    assert(hits.size() == 1 && hits[0].document->title == "word999 fizz");
+
+    // A replaced lesson is found by its new text only
+    index.addLessons({{"l1", "Old title", "", ProficiencyLevel::BEGINNER}});
+    index.addLessons({{"l1", "New title", "", ProficiencyLevel::ADVANCED}});
+    assert(find(index, "old").empty());
+    hits = find(index, "title");
+    assert(hits.size() == 1 && hits[0].document->title == "New title" &&
+           hits[0].document->level == ProficiencyLevel::ADVANCED);
+    assert(index.getSnapshot()->liveDocuments == 1001);
+
+    // Merges drop the replaced lesson's postings
+    for (int i = 0; i < 20; ++i) {
+        index.addItems({{"G", {GameItem("extra", ProficiencyLevel::BEGINNER)}}});
+    }
+    assert(find(index, "old").empty() && find(index, "title").size() == 1);
+
+    std::cout << "✓ Incremental test passed" << std::endl;
+}
+
+void testCompaction() {
+    std::cout << "Testing compaction of replaced lessons..." << std::endl;
+
+    // One lesson replaced many times: merges drop the old documents and their deleted bits
+    SearchIndex index;
+    index.addItems({{"G", {GameItem("first item", ProficiencyLevel::BEGINNER)}}});
+    for (int i = 0; i < 1000; ++i) {
+        index.addLessons({{"l1", "Version " + std::to_string(i), "lesson body", ProficiencyLevel::BEGINNER},
+                          {"l" + std::to_string(i % 7 + 2), "Other", "lesson body", ProficiencyLevel::BEGINNER}});
+    }
+    index.addItems({{"G", {GameItem("last item", ProficiencyLevel::BEGINNER)}}});
+
+    SearchIndex::SnapshotPtr snapshot = index.getSnapshot();
+    assert(snapshot->liveDocuments == 10);
+    size_t documents = 0;
+    for (const SearchIndex::SegmentPtr& segment : snapshot->segments) {
+        documents += segment->documents.size();
+    }
+    assert(documents < 40 && (!snapshot->deleted || snapshot->deleted->size() <= 1));
+
+    // Ids stay consistent: lookups, replacements and ranking after renumbering
+    std::vector<SearchIndex::Hit> hits = find(index, "version");
+    assert(hits.size() == 1 && hits[0].document->title == "Version 999");
+    assert(&snapshot->document(hits[0].id) == hits[0].document);
+    assert(find(index, "lesson body").size() == 8 && find(index, "item").size() == 2);
+    hits = find(index, "item");
+    assert(hits[0].document->title == "first item" && hits[0].id < hits[1].id);
+
+    index.addLessons({{"l1", "Final", "", ProficiencyLevel::ADVANCED}});
+    assert(find(index, "version").empty() && find(index, "final").size() == 1);
+    assert(index.getSnapshot()->liveDocuments == 10);
+
+    std::cout << "✓ Compaction test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Search Index Tests ===" << std::endl;
+
+    testTokenize();
+    testRanking();
+    testIncremental();
+    testCompaction();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Test program for session ownership across a resume on a new connection
+
+#include "../src/server/ClientHandler.hpp"
+#include <iostream>
+#include <cassert>
+
+// Resume as the token's user on handler; returns the rotated token
+std::string resume(ClientHandler& handler, const std::string& token) {
+    Message reply = handler.processMessage(Message(MessageType::RESUME_REQUEST, token));
+    assert(reply.header.type == MessageType::RESUME_SUCCESS);
+    return reply.payload.substr(reply.payload.rfind('|') + 1);
+}
+
+void testOldConnectionCloses() {
+    std::cout << "Testing a replaced connection closing..." << std::endl;
+
+    Database& database = Database::getInstance();
+    CallManager& calls = CallManager::getInstance();
+    std::string token = SessionTokens::getInstance().issue("alice", UserRole::STUDENT, ProficiencyLevel::BEGINNER);
+
+    auto old = std::make_unique<ClientHandler>(static_cast<SOCKET>(101), "127.0.0.1", 40001);
+    token = resume(*old, token);
+
+    uint32_t callId = 0;
+    CallInfo call;
+    assert(calls.startCall("alice", "bob", callId) == ErrorCode::SUCCESS);
+    assert(calls.acceptCall(callId, "bob", call));
+
+    // The client reconnects and resumes before the old connection is noticed dead
+    auto fresh = std::make_unique<ClientHandler>(static_cast<SOCKET>(102), "127.0.0.1", 40002);
+    resume(*fresh, token);
+    old->onDisconnect();
+    assert(old->takeNotifications().empty());
+    old.reset();
+
+    // The new connection keeps the session and the call
+    SessionData session;
+    assert(database.getSessionByUsername("alice", session));
+    assert(session.connectionId == fresh->getConnectionId() && session.socket == static_cast<SOCKET>(102));
+    assert(database.getSessionBySocket(static_cast<SOCKET>(102), session) && session.username == "alice");
+    assert(!database.getSessionBySocket(static_cast<SOCKET>(101), session));
+    assert(calls.startCall("alice", "carol", callId) == ErrorCode::INVALID_PARAMETER);
+
+    // The holder closing ends both
+    fresh->onDisconnect();
+    std::vector<std::pair<std::string, Message>> notifications = fresh->takeNotifications();
+    assert(notifications.size() == 1 && notifications[0].first == "bob" &&
+           notifications[0].second.header.type == MessageType::VOICE_CALL_END);
+    fresh.reset();
+    assert(!database.getSessionByUsername("alice", session));
+    assert(calls.startCall("alice", "carol", callId) == ErrorCode::SUCCESS);
+
+    std::cout << "✓ Replaced connection test passed" << std::endl;
+}
+
+void testOldConnectionLogsOut() {
+    std::cout << "Testing a logout on a replaced connection..." << std::endl;
+
+    std::string token = SessionTokens::getInstance().issue("dave", UserRole::STUDENT, ProficiencyLevel::BEGINNER);
+    ClientHandler old(static_cast<SOCKET>(201), "127.0.0.1", 40003);
+    token = resume(old, token);
+    ClientHandler fresh(static_cast<SOCKET>(202), "127.0.0.1", 40004);
+    resume(fresh, token);
+
+    assert(old.processMessage(Message(MessageType::LOGOUT_REQUEST, "")).header.type == MessageType::LOGOUT_SUCCESS);
+    SessionData session;
+    assert(Database::getInstance().getSessionByUsername("dave", session) &&
+           session.connectionId == fresh.getConnectionId());
+
+    std::cout << "✓ Replaced logout test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Session Resume Tests ===" << std::endl;
+
+    testOldConnectionCloses();
+    testOldConnectionLogsOut();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}
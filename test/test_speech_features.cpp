@@ -0,0 +1,116 @@
+// Test program for the pronunciation DSP pipeline (FFT, streaming MFCC, banded DTW)
+
+#include "../src/utils/SpeechFeatures.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+// Synthetic "utterance": a sequence of vowel-like segments, each a pair of formant tones
+std::vector<int16_t> synthesize(const std::vector<std::pair<float, float>>& formants,
+                                float segmentSeconds, int sampleRate, float noise, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gauss(0.0f, noise);
+    std::vector<int16_t> pcm;
+
+    size_t segment = static_cast<size_t>(segmentSeconds * sampleRate);
+    for (const auto& f : formants) {
+        for (size_t i = 0; i < segment; ++i) {
+            float t = static_cast<float>(pcm.size()) / sampleRate;
+            float x = 0.4f * std::sin(2.0f * 3.14159265f * f.first * t) +
+                      0.2f * std::sin(2.0f * 3.14159265f * f.second * t) + gauss(rng);
+            pcm.push_back(static_cast<int16_t>(std::max(-1.0f, std::min(1.0f, x)) * 32000.0f));
+        }
+    }
+    return pcm;
+}
+
+std::vector<float> extract(const std::vector<int16_t>& pcm, size_t chunk) {
+    MfccExtractor extractor(16000);
+    for (size_t i = 0; i < pcm.size(); i += chunk) {
+        extractor.feed(pcm.data() + i, std::min(chunk, pcm.size() - i));
+    }
+    return extractor.finish();
+}
+
+void testFftMatchesDft() {
+    std::cout << "Testing FFT against a direct DFT..." << std::endl;
+
+    const size_t n = 64;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> re(n), im(n), inRe(n), inIm(n);
+    for (size_t i = 0; i < n; ++i) {
+        inRe[i] = re[i] = dist(rng);
+        inIm[i] = im[i] = dist(rng);
+    }
+
+    Fft fft(n);
+    fft.transform(re.data(), im.data());
+
+    for (size_t k = 0; k < n; ++k) {
+        double sumRe = 0.0, sumIm = 0.0;
+        for (size_t t = 0; t < n; ++t) {
+            double angle = -2.0 * 3.14159265358979 * static_cast<double>(k * t) / n;
+            sumRe += inRe[t] * std::cos(angle) - inIm[t] * std::sin(angle);
+            sumIm += inRe[t] * std::sin(angle) + inIm[t] * std::cos(angle);
+        }
+        assert(std::fabs(sumRe - re[k]) < 1e-3);
+        assert(std::fabs(sumIm - im[k]) < 1e-3);
+    }
+
+    std::cout << "✓ FFT test passed" << std::endl;
+}
+
+void testStreamingIsChunkInvariant() {
+    std::cout << "Testing streaming MFCC..." << std::endl;
+
+    auto pcm = synthesize({{700, 1200}, {300, 2300}, {500, 1500}}, 0.3f, 16000, 0.01f, 1);
+    std::vector<float> whole = extract(pcm, pcm.size());
+    std::vector<float> chunked = extract(pcm, 333);
+
+    assert(!whole.empty());
+    assert(whole.size() % MfccExtractor::NUM_COEFFS == 0);
+    assert(whole.size() == chunked.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        assert(std::fabs(whole[i] - chunked[i]) < 1e-4f);
+    }
+
+    std::cout << "✓ Streaming test passed" << std::endl;
+}
+
+void testDtwRanksUtterances() {
+    std::cout << "Testing DTW scoring..." << std::endl;
+
+    const size_t dims = MfccExtractor::NUM_COEFFS;
+    std::vector<std::pair<float, float>> sentence = {{700, 1200}, {300, 2300}, {500, 1500}, {400, 800}};
+    std::vector<std::pair<float, float>> other = {{300, 2300}, {700, 1200}, {250, 600}, {600, 2600}};
+
+    auto reference = extract(synthesize(sentence, 0.25f, 16000, 0.01f, 1), 1024);
+    auto sameSlower = extract(synthesize(sentence, 0.32f, 16000, 0.02f, 2), 1024);
+    auto different = extract(synthesize(other, 0.25f, 16000, 0.01f, 3), 1024);
+
+    float self = dtwDistance(reference.data(), reference.size() / dims, reference.data(), reference.size() / dims, dims, 20);
+    float same = dtwDistance(reference.data(), reference.size() / dims, sameSlower.data(), sameSlower.size() / dims, dims, 20);
+    float diff = dtwDistance(reference.data(), reference.size() / dims, different.data(), different.size() / dims, dims, 20);
+
+    std::cout << "  self=" << self << " same=" << same << " different=" << diff << std::endl;
+    assert(self == 0.0f);
+    assert(same > 0.0f && same < diff);
+
+    assert(dtwDistance(reference.data(), 0, reference.data(), 1, dims, 20) < 0.0f);
+
+    std::cout << "✓ DTW test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Speech Feature Tests ===" << std::endl;
+
+    testFftMatchesDft();
+    testStreamingIsChunkInvariant();
+    testDtwRanksUtterances();
+
+    std::cout << "\n✓ All tests passed!" << std::endl;
+    return 0;
+}